@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Helpers shared by the benchmark drivers.
+namespace bench {
+
+// A field of /proc/self/status (e.g. "VmRSS", "VmHWM", "Threads"), with kB
+// values converted to bytes. Returns 0 when the field is unavailable.
+inline std::uint64_t proc_status(std::string_view field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.size() > field.size() && line.compare(0, field.size(), field) == 0 && line[field.size()] == ':') {
+            char* end = nullptr;
+            const std::uint64_t value = std::strtoull(line.c_str() + field.size() + 1, &end, 10);
+            return std::string_view(end).find("kB") != std::string_view::npos ? value * 1024 : value;
+        }
+    }
+    return 0;
+}
+
+// Start a new VmHWM (peak RSS) window. A no-op where clear_refs is not
+// writable, leaving the process-lifetime peak.
+inline void reset_peak_rss() {
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+}
+
+// Nearest-rank percentile of an ascending sample; 0 for an empty one.
+inline double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}  // namespace bench
@@ -0,0 +1,569 @@
+#include "bench_util.hpp"
+
+#include "service/job_service.hpp"
+#include "service/json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Load generator for JobService. Client threads drive submit, status and
+// poll_result with a weighted mix of jobs, either closed-loop (each client
+// waits for its job before submitting the next) or open-loop (Poisson
+// arrivals at --rate jobs/s, with latency measured from the intended
+// arrival time so a stalled service cannot hide its queueing delay).
+//
+//   vm_service_load --mode closed --clients 8 --duration 10
+//   vm_service_load --mode open --rate 200 --mix bell=4,ghz=2,wide=1
+//
+// Thread and RSS counts are sampled before the service starts, after the
+// run drains and after the service is destroyed. The exit status is 1 when
+// threads outlive the service or, with --max-retained-bytes-per-job, when
+// RSS grows faster than that per completed job.
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Mode {
+    kClosed,
+    kOpen,
+};
+
+struct Options {
+    Mode mode = Mode::kClosed;
+    int clients = 4;
+    double rate = 50.0;
+    double duration = 5.0;
+    double warmup = 1.0;
+    double drain_timeout = 60.0;
+    std::size_t workers = 0;
+    int tenants = 1;
+    int poll_interval_us = 200;
+    double max_retained_bytes_per_job = 0.0;
+    std::vector<std::pair<std::string, double>> mix{{"bell", 4.0}, {"ghz", 2.0}, {"wide", 1.0}};
+    std::string output;
+};
+
+double seconds_between(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+Instruction gate(const char* name, std::vector<int> targets) {
+    return {Op::ApplyGate, Gate{name, std::move(targets), 0.0}};
+}
+
+// Chain of `sites` atoms 1.0 apart; neighbours are inside the blockade.
+service::JobRequest chain_job(int sites, int shots) {
+    service::JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "benchmark_chain";
+    for (int site = 0; site < sites; ++site) {
+        job.hardware.positions.push_back(static_cast<double>(site));
+    }
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.program.push_back({Op::AllocArray, sites});
+    return job;
+}
+
+std::vector<int> all_sites(int sites) {
+    std::vector<int> targets;
+    for (int site = 0; site < sites; ++site) {
+        targets.push_back(site);
+    }
+    return targets;
+}
+
+// bell: 2 qubits, 32 ideal shots. ghz: 10 qubits, 64 noisy shots. wide: a
+// 16-qubit entangling layer, 16 shots.
+service::JobRequest make_job(const std::string& kind) {
+    if (kind == "bell") {
+        auto job = chain_job(2, 32);
+        job.program.push_back(gate("H", {0}));
+        job.program.push_back(gate("CX", {0, 1}));
+        job.program.push_measure(all_sites(2));
+        return job;
+    }
+    if (kind == "ghz") {
+        auto job = chain_job(10, 64);
+        job.program.push_back(gate("H", {0}));
+        for (int site = 1; site < 10; ++site) {
+            job.program.push_back(gate("CX", {site - 1, site}));
+        }
+        job.program.push_measure(all_sites(10));
+        SimpleNoiseConfig noise;
+        noise.gate.single_qubit = {0.002, 0.002, 0.001};
+        noise.gate.two_qubit_control = {0.006, 0.006, 0.004};
+        noise.gate.two_qubit_target = {0.006, 0.006, 0.004};
+        noise.readout = {0.01, 0.01};
+        job.noise_config = noise;
+        return job;
+    }
+    if (kind == "wide") {
+        auto job = chain_job(16, 16);
+        for (int site = 0; site < 16; ++site) {
+            job.program.push_back(gate("H", {site}));
+        }
+        for (int site = 1; site < 16; ++site) {
+            job.program.push_back(gate("CX", {site - 1, site}));
+        }
+        job.program.push_measure(all_sites(16));
+        return job;
+    }
+    throw std::invalid_argument("unknown job kind: " + kind);
+}
+
+// Requests of each mix entry, built once, and a sampler over their weights.
+class JobMix {
+  public:
+    explicit JobMix(const std::vector<std::pair<std::string, double>>& mix) {
+        std::vector<double> weights;
+        for (const auto& [kind, weight] : mix) {
+            jobs_.push_back(make_job(kind));
+            weights.push_back(weight);
+        }
+        pick_ = std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+    }
+
+    service::JobRequest next(std::mt19937_64& rng, int tenants) {
+        service::JobRequest job = jobs_[pick_(rng)];
+        job.seed = rng();
+        job.metadata["tenant"] = "tenant-" + std::to_string(rng() % static_cast<std::uint64_t>(tenants));
+        return job;
+    }
+
+  private:
+    std::vector<service::JobRequest> jobs_;
+    std::discrete_distribution<std::size_t> pick_;
+};
+
+// Per-thread latency samples in seconds; merged after the run.
+struct Samples {
+    std::vector<double> submit;
+    std::vector<double> status;
+    std::vector<double> poll_result;
+    std::vector<double> job;
+    std::uint64_t completed = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t unfinished = 0;  // still running at the drain deadline
+    std::uint64_t shots = 0;
+    Clock::time_point last_finish{};
+
+    void merge(const Samples& other) {
+        submit.insert(submit.end(), other.submit.begin(), other.submit.end());
+        status.insert(status.end(), other.status.begin(), other.status.end());
+        poll_result.insert(poll_result.end(), other.poll_result.begin(), other.poll_result.end());
+        job.insert(job.end(), other.job.begin(), other.job.end());
+        completed += other.completed;
+        failed += other.failed;
+        rejected += other.rejected;
+        unfinished += other.unfinished;
+        shots += other.shots;
+        last_finish = std::max(last_finish, other.last_finish);
+    }
+};
+
+struct InFlight {
+    std::string job_id;
+    Clock::time_point arrival;
+    bool measured = false;
+};
+
+// One status + poll_result round for `job`. Returns true once it finished.
+bool poll_once(const service::JobService& jobs, const InFlight& job, Samples& samples) {
+    auto start = Clock::now();
+    (void)jobs.status(job.job_id);
+    auto end = Clock::now();
+    if (job.measured) {
+        samples.status.push_back(seconds_between(start, end));
+    }
+    start = end;
+    const auto result = jobs.poll_result(job.job_id);
+    end = Clock::now();
+    if (job.measured) {
+        samples.poll_result.push_back(seconds_between(start, end));
+    }
+    if (!result) {
+        return false;
+    }
+    if (job.measured) {
+        samples.job.push_back(seconds_between(job.arrival, end));
+        samples.last_finish = std::max(samples.last_finish, end);
+        if (result->status == service::JobStatus::Completed) {
+            ++samples.completed;
+            samples.shots += result->measurements.size();
+        } else {
+            ++samples.failed;
+        }
+    }
+    return true;
+}
+
+std::optional<std::string> timed_submit(service::JobService& jobs, service::JobRequest job, bool measured, Samples& samples) {
+    const auto start = Clock::now();
+    try {
+        std::string job_id = jobs.submit(std::move(job));
+        if (measured) {
+            samples.submit.push_back(seconds_between(start, Clock::now()));
+        }
+        return job_id;
+    } catch (const service::QuotaExceeded&) {
+        if (measured) {
+            ++samples.rejected;
+        }
+        return std::nullopt;
+    }
+}
+
+struct RunWindow {
+    Clock::time_point measure_start;
+    Clock::time_point deadline;
+    Clock::time_point drain_deadline;
+};
+
+Samples run_closed(const Options& options, service::JobService& jobs, JobMix& mix, const RunWindow& window) {
+    std::vector<Samples> per_client(static_cast<std::size_t>(options.clients));
+    std::mutex mix_mutex;
+    std::mt19937_64 shared_rng(1);
+    std::vector<std::thread> clients;
+    for (int client = 0; client < options.clients; ++client) {
+        clients.emplace_back([&, client]() {
+            Samples& samples = per_client[static_cast<std::size_t>(client)];
+            std::mt19937_64 rng;
+            {
+                std::lock_guard<std::mutex> lock(mix_mutex);
+                rng.seed(shared_rng());
+            }
+            while (Clock::now() < window.deadline) {
+                InFlight job;
+                job.arrival = Clock::now();
+                job.measured = job.arrival >= window.measure_start;
+                const auto job_id = timed_submit(jobs, mix.next(rng, options.tenants), job.measured, samples);
+                if (!job_id) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(options.poll_interval_us));
+                    continue;
+                }
+                job.job_id = *job_id;
+                while (!poll_once(jobs, job, samples)) {
+                    if (Clock::now() >= window.drain_deadline) {
+                        ++samples.unfinished;
+                        return;
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(options.poll_interval_us));
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    Samples merged;
+    for (const auto& samples : per_client) {
+        merged.merge(samples);
+    }
+    return merged;
+}
+
+// A dispatcher submits on a Poisson schedule and hands jobs to the client
+// threads round-robin; each client polls its own in-flight set.
+Samples run_open(const Options& options, service::JobService& jobs, JobMix& mix, const RunWindow& window) {
+    struct Shard {
+        std::mutex mutex;
+        std::vector<InFlight> pending;
+    };
+    const auto shard_count = static_cast<std::size_t>(options.clients);
+    std::vector<Shard> shards(shard_count);
+    std::vector<Samples> per_client(shard_count);
+    std::atomic<bool> arrivals_done{false};
+    Samples dispatch_samples;
+
+    std::vector<std::thread> clients;
+    for (std::size_t client = 0; client < shard_count; ++client) {
+        clients.emplace_back([&, client]() {
+            Shard& shard = shards[client];
+            Samples& samples = per_client[client];
+            std::vector<InFlight> batch;
+            while (Clock::now() < window.drain_deadline) {
+                {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    batch.insert(batch.end(), shard.pending.begin(), shard.pending.end());
+                    shard.pending.clear();
+                }
+                std::erase_if(batch, [&](const InFlight& job) { return poll_once(jobs, job, samples); });
+                if (batch.empty() && arrivals_done.load(std::memory_order_acquire)) {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    if (shard.pending.empty()) {
+                        return;
+                    }
+                    continue;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(options.poll_interval_us));
+            }
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            samples.unfinished += batch.size() + shard.pending.size();
+        });
+    }
+
+    std::mt19937_64 rng(1);
+    std::exponential_distribution<double> gap(options.rate);
+    auto arrival = Clock::now();
+    std::size_t next_shard = 0;
+    while (arrival < window.deadline) {
+        std::this_thread::sleep_until(arrival);
+        InFlight job;
+        job.arrival = arrival;
+        job.measured = arrival >= window.measure_start;
+        if (const auto job_id = timed_submit(jobs, mix.next(rng, options.tenants), job.measured, dispatch_samples)) {
+            job.job_id = *job_id;
+            Shard& shard = shards[next_shard];
+            next_shard = (next_shard + 1) % shard_count;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.pending.push_back(std::move(job));
+        }
+        arrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(rng)));
+    }
+    arrivals_done.store(true, std::memory_order_release);
+    for (auto& client : clients) {
+        client.join();
+    }
+    Samples merged = dispatch_samples;
+    for (const auto& samples : per_client) {
+        merged.merge(samples);
+    }
+    return merged;
+}
+
+void write_latency(service::JsonWriter& out, const char* name, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    out.key(name).begin_object()
+        .field("count", static_cast<unsigned long long>(samples.size()))
+        .field("p50", bench::percentile(samples, 0.50))
+        .field("p99", bench::percentile(samples, 0.99))
+        .field("p999", bench::percentile(samples, 0.999))
+        .field("max", samples.empty() ? 0.0 : samples.back())
+        .end_object();
+}
+
+struct ProcessSample {
+    std::uint64_t threads = 0;
+    std::uint64_t rss_bytes = 0;
+
+    static ProcessSample now() {
+        return {bench::proc_status("Threads"), bench::proc_status("VmRSS")};
+    }
+};
+
+std::vector<std::pair<std::string, double>> parse_mix(const std::string& text) {
+    std::vector<std::pair<std::string, double>> mix;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const auto eq = item.find('=');
+        const std::string kind = item.substr(0, eq);
+        const double weight = eq == std::string::npos ? 1.0 : std::stod(item.substr(eq + 1));
+        (void)make_job(kind);  // reject unknown kinds up front
+        if (weight > 0.0) {
+            mix.emplace_back(kind, weight);
+        }
+    }
+    if (mix.empty()) {
+        throw std::invalid_argument("--mix selects no jobs");
+    }
+    return mix;
+}
+
+void print_usage(const char* argv0) {
+    std::cerr << "usage: " << argv0
+              << " [--mode closed|open] [--clients N] [--rate JOBS_PER_S] [--duration S]"
+                 " [--warmup S] [--drain-timeout S] [--workers N] [--tenants N]"
+                 " [--poll-interval-us N] [--mix bell=W,ghz=W,wide=W]"
+                 " [--max-retained-bytes-per-job N] [--output FILE]\n";
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int idx = 1; idx < argc; ++idx) {
+        const std::string arg = argv[idx];
+        auto next = [&]() -> std::string {
+            if (idx + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++idx];
+        };
+        if (arg == "--mode") {
+            const std::string mode = next();
+            if (mode == "closed") {
+                options.mode = Mode::kClosed;
+            } else if (mode == "open") {
+                options.mode = Mode::kOpen;
+            } else {
+                throw std::invalid_argument("--mode must be closed or open");
+            }
+        } else if (arg == "--clients") {
+            options.clients = std::stoi(next());
+        } else if (arg == "--rate") {
+            options.rate = std::stod(next());
+        } else if (arg == "--duration") {
+            options.duration = std::stod(next());
+        } else if (arg == "--warmup") {
+            options.warmup = std::stod(next());
+        } else if (arg == "--drain-timeout") {
+            options.drain_timeout = std::stod(next());
+        } else if (arg == "--workers") {
+            options.workers = static_cast<std::size_t>(std::stoul(next()));
+        } else if (arg == "--tenants") {
+            options.tenants = std::stoi(next());
+        } else if (arg == "--poll-interval-us") {
+            options.poll_interval_us = std::stoi(next());
+        } else if (arg == "--mix") {
+            options.mix = parse_mix(next());
+        } else if (arg == "--max-retained-bytes-per-job") {
+            options.max_retained_bytes_per_job = std::stod(next());
+        } else if (arg == "--output") {
+            options.output = next();
+        } else {
+            throw std::invalid_argument("unknown argument: " + arg);
+        }
+    }
+    if (options.clients < 1 || options.tenants < 1 || options.rate <= 0.0 || options.duration <= 0.0) {
+        throw std::invalid_argument("--clients, --tenants, --rate and --duration must be positive");
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& ex) {
+        std::cerr << "vm_service_load: " << ex.what() << "\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    JobMix mix(options.mix);
+    const ProcessSample before = ProcessSample::now();
+    ProcessSample measured;
+    ProcessSample drained;
+    Samples samples;
+    // From the end of warm-up to the last measured job finishing, so an
+    // overloaded open-loop run is not credited with its arrival rate.
+    double window_seconds = 0.0;
+    {
+        service::FairShareOptions scheduler;
+        scheduler.worker_threads = options.workers;
+        service::JobService jobs(scheduler);
+
+        const auto start = Clock::now();
+        auto at = [&](double offset) {
+            return start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(offset));
+        };
+        RunWindow window{at(options.warmup), at(options.warmup + options.duration),
+            at(options.warmup + options.duration + options.drain_timeout)};
+        // Sample RSS once warm-up traffic has started; the measured growth
+        // then excludes one-time allocations of the first jobs.
+        std::thread sampler([&]() {
+            std::this_thread::sleep_until(window.measure_start);
+            measured = ProcessSample::now();
+        });
+        if (options.mode == Mode::kClosed) {
+            samples = run_closed(options, jobs, mix, window);
+        } else {
+            samples = run_open(options, jobs, mix, window);
+        }
+        sampler.join();
+        window_seconds = std::max(options.duration, seconds_between(window.measure_start, samples.last_finish));
+        drained = ProcessSample::now();
+    }
+    const ProcessSample after = ProcessSample::now();
+
+    const std::uint64_t finished = samples.completed + samples.failed;
+    const double retained_per_job = finished > 0 && drained.rss_bytes > measured.rss_bytes
+        ? static_cast<double>(drained.rss_bytes - measured.rss_bytes) / static_cast<double>(finished)
+        : 0.0;
+    const bool thread_leak = after.threads > before.threads;
+    const bool memory_leak = options.max_retained_bytes_per_job > 0.0 &&
+        retained_per_job > options.max_retained_bytes_per_job;
+
+    service::JsonWriter out;
+    out.begin_object();
+    out.key("config").begin_object()
+        .field("mode", options.mode == Mode::kClosed ? "closed" : "open")
+        .field("clients", options.clients)
+        .field("rate", options.rate)
+        .field("duration_seconds", options.duration)
+        .field("warmup_seconds", options.warmup)
+        .field("workers", static_cast<unsigned long long>(options.workers))
+        .field("tenants", options.tenants);
+    out.key("mix").begin_object();
+    for (const auto& [kind, weight] : options.mix) {
+        out.field(kind, weight);
+    }
+    out.end_object().end_object();
+    out.field("completed", static_cast<unsigned long long>(samples.completed))
+        .field("failed", static_cast<unsigned long long>(samples.failed))
+        .field("rejected", static_cast<unsigned long long>(samples.rejected))
+        .field("unfinished", static_cast<unsigned long long>(samples.unfinished))
+        .field("jobs_per_second", static_cast<double>(finished) / window_seconds)
+        .field("shots_per_second", static_cast<double>(samples.shots) / window_seconds);
+    out.key("latency_seconds").begin_object();
+    write_latency(out, "job", samples.job);
+    write_latency(out, "submit", samples.submit);
+    write_latency(out, "status", samples.status);
+    write_latency(out, "poll_result", samples.poll_result);
+    out.end_object();
+    out.key("process").begin_object()
+        .field("threads_before", static_cast<unsigned long long>(before.threads))
+        .field("threads_drained", static_cast<unsigned long long>(drained.threads))
+        .field("threads_after", static_cast<unsigned long long>(after.threads))
+        .field("rss_before_bytes", static_cast<unsigned long long>(before.rss_bytes))
+        .field("rss_measure_start_bytes", static_cast<unsigned long long>(measured.rss_bytes))
+        .field("rss_drained_bytes", static_cast<unsigned long long>(drained.rss_bytes))
+        .field("rss_after_bytes", static_cast<unsigned long long>(after.rss_bytes))
+        .field("retained_bytes_per_job", retained_per_job)
+        .field("thread_leak", thread_leak)
+        .field("memory_leak", memory_leak)
+        .end_object();
+    out.end_object();
+
+    if (options.output.empty()) {
+        std::cout << out.str() << "\n";
+    } else {
+        std::ofstream(options.output) << out.str() << "\n";
+    }
+
+    std::sort(samples.job.begin(), samples.job.end());
+    std::fprintf(stderr,
+        "%llu jobs (%.1f jobs/s), job latency p50 %.2f ms p99 %.2f ms p999 %.2f ms; "
+        "%llu failed, %llu rejected, %llu unfinished; %.0f bytes retained per job\n",
+        static_cast<unsigned long long>(finished), static_cast<double>(finished) / window_seconds,
+        bench::percentile(samples.job, 0.50) * 1e3, bench::percentile(samples.job, 0.99) * 1e3,
+        bench::percentile(samples.job, 0.999) * 1e3, static_cast<unsigned long long>(samples.failed),
+        static_cast<unsigned long long>(samples.rejected), static_cast<unsigned long long>(samples.unfinished),
+        retained_per_job);
+    if (thread_leak) {
+        std::fprintf(stderr, "thread leak: %llu threads before the service, %llu after it was destroyed\n",
+            static_cast<unsigned long long>(before.threads), static_cast<unsigned long long>(after.threads));
+    }
+    if (memory_leak) {
+        std::fprintf(stderr, "memory growth above --max-retained-bytes-per-job\n");
+    }
+    return thread_leak || memory_leak ? 1 : 0;
+}
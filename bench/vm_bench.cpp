@@ -0,0 +1,281 @@
+#include "cpu_state_backend.hpp"
+#include "engine_statevector.hpp"
+#include "noise.hpp"
+#include "noise/amplitude_damping_source.hpp"
+#include "noise/correlated_pauli_source.hpp"
+#include "noise/idle_dephasing_source.hpp"
+#include "noise/idle_phase_drift_source.hpp"
+#include "noise/loss_tracking_source.hpp"
+#include "noise/measurement_noise_source.hpp"
+#include "noise/phase_kick_noise_source.hpp"
+#include "noise/single_qubit_pauli_source.hpp"
+#include "noise/two_qubit_pauli_source.hpp"
+#include "service/scheduler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <unistd.h>
+
+// Microbenchmarks of the state, noise and scheduling kernels. Kernel
+// benchmarks report bytes_per_second (statevector bytes read and written)
+// and amplitude_updates (amplitudes touched per second), so runs on
+// different register sizes compare directly. Filter large registers out
+// with --benchmark_filter; registers that do not fit in free memory are
+// skipped.
+namespace {
+
+using Amplitude = std::complex<double>;
+
+constexpr int kMinQubits = 10;
+constexpr int kMaxQubits = 28;
+constexpr int kQubitStep = 2;
+constexpr int kNoiseQubits = 10;
+
+bool fits_in_memory(std::size_t bytes) {
+    const long pages = ::sysconf(_SC_AVPHYS_PAGES);
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || page_size <= 0) {
+        return true;
+    }
+    return bytes < static_cast<std::size_t>(pages) * static_cast<std::size_t>(page_size);
+}
+
+// Allocates an n-qubit register, or skips the benchmark when it cannot.
+bool alloc_register(benchmark::State& state, CpuStateBackend& backend, int qubits) {
+    const std::size_t bytes = (std::size_t{1} << qubits) * sizeof(Amplitude);
+    if (!fits_in_memory(bytes)) {
+        state.SkipWithError("statevector does not fit in free memory");
+        return false;
+    }
+    backend.alloc_array(qubits);
+    return true;
+}
+
+void report_amplitudes(benchmark::State& state, std::size_t amplitudes_per_iteration) {
+    const auto updates = static_cast<double>(state.iterations()) * static_cast<double>(amplitudes_per_iteration);
+    state.counters["amplitude_updates"] = benchmark::Counter(updates, benchmark::Counter::kIsRate);
+    // Each amplitude is read and written once.
+    state.SetBytesProcessed(static_cast<std::int64_t>(updates * 2.0 * sizeof(Amplitude)));
+}
+
+// Every target position of every register size.
+void qubit_targets(benchmark::internal::Benchmark* bench) {
+    for (int qubits = kMinQubits; qubits <= kMaxQubits; qubits += kQubitStep) {
+        for (int target = 0; target < qubits; ++target) {
+            bench->Args({qubits, target});
+        }
+    }
+}
+
+void BM_SingleQubitGate(benchmark::State& state) {
+    const int qubits = static_cast<int>(state.range(0));
+    const int target = static_cast<int>(state.range(1));
+    CpuStateBackend backend;
+    if (!alloc_register(state, backend, qubits)) {
+        return;
+    }
+    const double inv_sqrt2 = 1.0 / std::sqrt(2.0);
+    const std::array<Amplitude, 4> h{{{inv_sqrt2, 0.0}, {inv_sqrt2, 0.0}, {inv_sqrt2, 0.0}, {-inv_sqrt2, 0.0}}};
+    for (auto _ : state) {
+        backend.apply_single_qubit_unitary(target, h);
+        benchmark::DoNotOptimize(backend.state().data());
+    }
+    report_amplitudes(state, backend.state().size());
+}
+BENCHMARK(BM_SingleQubitGate)->Apply(qubit_targets);
+
+// CZ on (target, target + 1 mod n), so every position is a control and a
+// target once.
+void BM_TwoQubitGate(benchmark::State& state) {
+    const int qubits = static_cast<int>(state.range(0));
+    const int q0 = static_cast<int>(state.range(1));
+    const int q1 = (q0 + 1) % qubits;
+    CpuStateBackend backend;
+    if (!alloc_register(state, backend, qubits)) {
+        return;
+    }
+    std::array<Amplitude, 16> cz{};
+    cz[0] = cz[5] = cz[10] = 1.0;
+    cz[15] = -1.0;
+    for (auto _ : state) {
+        backend.apply_two_qubit_unitary(q0, q1, cz);
+        benchmark::DoNotOptimize(backend.state().data());
+    }
+    report_amplitudes(state, backend.state().size());
+}
+BENCHMARK(BM_TwoQubitGate)->Apply(qubit_targets);
+
+// Measure the first k qubits of a 16-qubit register, kMeasurements times
+// per engine run; the allocation is amortized over the measurements.
+void BM_Measure(benchmark::State& state) {
+    constexpr int kQubits = 16;
+    constexpr int kMeasurements = 64;
+    const int targets = static_cast<int>(state.range(0));
+    std::vector<int> measured(static_cast<std::size_t>(targets));
+    for (int idx = 0; idx < targets; ++idx) {
+        measured[static_cast<std::size_t>(idx)] = idx;
+    }
+    HardwareConfig hw;
+    hw.positions.assign(kQubits, 0.0);
+    Program program{{Op::AllocArray, kQubits}};
+    for (int idx = 0; idx < kMeasurements; ++idx) {
+        program.push_measure(measured);
+    }
+    std::uint64_t seed = 0;
+    for (auto _ : state) {
+        StatevectorEngine engine(hw, nullptr, ++seed);
+        engine.run(program);
+        benchmark::DoNotOptimize(engine.state().measurements.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kMeasurements);
+    report_amplitudes(state, (std::size_t{1} << kQubits) * kMeasurements);
+}
+BENCHMARK(BM_Measure)->DenseRange(1, 8);
+
+enum class NoiseHook {
+    kSingleQubitGate,
+    kTwoQubitGate,
+    kIdle,
+    kMeasurement,
+};
+
+// Cost of one noise event of `source` on a kNoiseQubits register.
+void run_noise_source(benchmark::State& state, const NoiseEngine& prototype, NoiseHook hook) {
+    const auto source = prototype.clone();
+    std::vector<Amplitude> amplitudes(std::size_t{1} << kNoiseQubits);
+    amplitudes[0] = 1.0;
+    std::mt19937_64 rng(11);
+    StdRandomStream stream(rng);
+    MeasurementRecord record{{0, 1, 2, 3}, {0, 1, 0, 1}};
+    int target = 0;
+    for (auto _ : state) {
+        target = (target + 1) % (kNoiseQubits - 1);
+        switch (hook) {
+            case NoiseHook::kSingleQubitGate:
+                source->apply_single_qubit_gate_noise(target, kNoiseQubits, amplitudes, stream);
+                break;
+            case NoiseHook::kTwoQubitGate:
+                source->apply_two_qubit_gate_noise(target, target + 1, kNoiseQubits, amplitudes, stream);
+                break;
+            case NoiseHook::kIdle:
+                source->apply_idle_noise(kNoiseQubits, amplitudes, 1e-6, stream);
+                break;
+            case NoiseHook::kMeasurement:
+                record.bits = {0, 1, 0, 1};
+                source->apply_measurement_noise(record, stream);
+                break;
+        }
+        benchmark::DoNotOptimize(amplitudes.data());
+        benchmark::DoNotOptimize(record.bits.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+constexpr SingleQubitPauliConfig kPauli{0.01, 0.01, 0.01};
+
+void BM_NoiseSingleQubitPauli(benchmark::State& state) {
+    run_noise_source(state, SingleQubitPauliSource(kPauli), NoiseHook::kSingleQubitGate);
+}
+BENCHMARK(BM_NoiseSingleQubitPauli);
+
+void BM_NoiseTwoQubitPauli(benchmark::State& state) {
+    run_noise_source(state, TwoQubitPauliSource(kPauli, kPauli), NoiseHook::kTwoQubitGate);
+}
+BENCHMARK(BM_NoiseTwoQubitPauli);
+
+void BM_NoiseCorrelatedPauli(benchmark::State& state) {
+    TwoQubitCorrelatedPauliConfig config;
+    for (std::size_t idx = 1; idx < config.matrix.size(); ++idx) {
+        config.matrix[idx] = 0.002;
+    }
+    run_noise_source(state, CorrelatedPauliSource(config), NoiseHook::kTwoQubitGate);
+}
+BENCHMARK(BM_NoiseCorrelatedPauli);
+
+void BM_NoiseIdleDephasing(benchmark::State& state) {
+    run_noise_source(state, IdleDephasingSource(1000.0), NoiseHook::kIdle);
+}
+BENCHMARK(BM_NoiseIdleDephasing);
+
+void BM_NoiseIdlePhaseDrift(benchmark::State& state) {
+    run_noise_source(state, IdlePhaseDriftSource(1000.0), NoiseHook::kIdle);
+}
+BENCHMARK(BM_NoiseIdlePhaseDrift);
+
+void BM_NoisePhaseKick(benchmark::State& state) {
+    run_noise_source(state, PhaseKickNoiseSource(PhaseNoiseConfig{0.01, 0.01, 0.01, 0.01}),
+        NoiseHook::kSingleQubitGate);
+}
+BENCHMARK(BM_NoisePhaseKick);
+
+void BM_NoiseAmplitudeDampingGate(benchmark::State& state) {
+    run_noise_source(state, AmplitudeDampingSource(AmplitudeDampingConfig{0.01, 1000.0}),
+        NoiseHook::kSingleQubitGate);
+}
+BENCHMARK(BM_NoiseAmplitudeDampingGate);
+
+void BM_NoiseAmplitudeDampingIdle(benchmark::State& state) {
+    run_noise_source(state, AmplitudeDampingSource(AmplitudeDampingConfig{0.01, 1000.0}), NoiseHook::kIdle);
+}
+BENCHMARK(BM_NoiseAmplitudeDampingIdle);
+
+void BM_NoiseLossTracking(benchmark::State& state) {
+    run_noise_source(state, LossTrackingSource(0.01, LossRuntimeConfig{0.001, 10.0}),
+        NoiseHook::kSingleQubitGate);
+}
+BENCHMARK(BM_NoiseLossTracking);
+
+void BM_NoiseMeasurement(benchmark::State& state) {
+    run_noise_source(state, MeasurementNoiseSource(0.01, MeasurementNoiseConfig{0.01, 0.01}),
+        NoiseHook::kMeasurement);
+}
+BENCHMARK(BM_NoiseMeasurement);
+
+// Gates cycling over a 16-atom chain, with a measurement every 64
+// instructions so the scheduler also inserts cooldown waits.
+Program synthetic_program(std::size_t instructions) {
+    constexpr int kAtoms = 16;
+    Program program;
+    program.reserve(instructions);
+    program.push_back({Op::AllocArray, kAtoms});
+    for (std::size_t idx = 1; idx < instructions; ++idx) {
+        const int atom = static_cast<int>(idx % kAtoms);
+        if (idx % 64 == 0) {
+            program.push_back({Op::Measure, std::vector<int>{atom}});
+        } else if (idx % 2 == 0) {
+            program.push_back({Op::ApplyGate, Gate{"CZ", {atom, (atom + 1) % kAtoms}, 0.0}});
+        } else {
+            program.push_back({Op::ApplyGate, Gate{"H", {atom}, 0.0}});
+        }
+    }
+    return program;
+}
+
+void BM_ScheduleProgram(benchmark::State& state) {
+    const auto program = synthetic_program(static_cast<std::size_t>(state.range(0)));
+    HardwareConfig hw;
+    for (int atom = 0; atom < 16; ++atom) {
+        hw.positions.push_back(static_cast<double>(atom));
+    }
+    hw.blockade_radius = 1.5;
+    hw.timing_limits.measurement_cooldown_ns = 1000.0;
+    hw.timing_limits.measurement_duration_ns = 500.0;
+    for (auto _ : state) {
+        auto scheduled = service::schedule_program(program, hw);
+        benchmark::DoNotOptimize(scheduled.program.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScheduleProgram)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,595 @@
+#include "bench_util.hpp"
+
+#include "service/job.hpp"
+#include "service/json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// End-to-end throughput of JobRunner::run on canonical workloads across the
+// built-in device profiles. Geometry and noise mirror the Python presets in
+// neutral_atom_vm/device.py; programs and seeds are fixed, so two runs on the
+// same machine and build differ only by timing noise.
+//
+//   vm_workload_bench --output results.json
+//   vm_workload_bench --baseline results.json --tolerance 0.1
+//
+// With --baseline the exit status is 1 when any case lost more than
+// `tolerance` of its baseline shots/s.
+namespace {
+
+constexpr std::uint64_t kJobSeed = 20240611;
+constexpr std::uint64_t kCircuitSeed = 7;
+
+struct Options {
+    int shots = 100;
+    int repeat = 5;
+    std::size_t threads = 0;
+    int max_qubits = 0;
+    double tolerance = 0.10;
+    std::vector<std::string> profiles;
+    std::vector<std::string> workloads;
+    std::string output;
+    std::string baseline;
+};
+
+// A device profile: the request fields the Python preset fills in, plus the
+// couplers its connectivity allows and a path visiting every site along them.
+struct Profile {
+    std::string name;
+    std::string device_id;
+    std::string preset;
+    std::vector<double> positions;
+    std::vector<std::vector<double>> coordinates;
+    double blockade_radius = 0.0;
+    std::optional<SimpleNoiseConfig> noise;
+    std::vector<std::pair<int, int>> edges;
+    std::vector<int> path;
+};
+
+std::vector<std::pair<int, int>> chain_edges(int sites) {
+    std::vector<std::pair<int, int>> edges;
+    for (int site = 0; site + 1 < sites; ++site) {
+        edges.emplace_back(site, site + 1);
+    }
+    return edges;
+}
+
+std::vector<int> chain_path(int sites) {
+    std::vector<int> path(static_cast<std::size_t>(sites));
+    std::iota(path.begin(), path.end(), 0);
+    return path;
+}
+
+Profile benchmark_chain() {
+    Profile profile;
+    profile.name = "benchmark_chain";
+    profile.device_id = "state-vector";
+    profile.preset = "benchmark_chain";
+    for (int site = 0; site < 20; ++site) {
+        profile.positions.push_back(site * 1.3);
+    }
+    profile.blockade_radius = 1.6;
+    SimpleNoiseConfig noise;
+    noise.gate.single_qubit = {0.002, 0.002, 0.001};
+    noise.gate.two_qubit_control = {0.006, 0.006, 0.004};
+    noise.gate.two_qubit_target = {0.006, 0.006, 0.004};
+    noise.phase = {0.001, 0.004, 0.004, 0.012};
+    noise.amplitude_damping = {0.0015, 0.08};
+    noise.idle_rate = 120.0;
+    noise.correlated_gate.matrix[5] = 0.002;
+    noise.correlated_gate.matrix[10] = 0.002;
+    noise.correlated_gate.matrix[15] = 0.0005;
+    profile.noise = noise;
+    profile.edges = chain_edges(20);
+    profile.path = chain_path(20);
+    return profile;
+}
+
+// Couplers between neighbouring sites of a cols x rows x layers lattice
+// (site = col + cols * (row + rows * layer)), and a boustrophedon path that
+// visits every site through them.
+void lattice(Profile& profile, int cols, int rows, int layers) {
+    auto site = [&](int col, int row, int layer) { return col + cols * (row + rows * layer); };
+    for (int layer = 0; layer < layers; ++layer) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                if (col + 1 < cols) {
+                    profile.edges.emplace_back(site(col, row, layer), site(col + 1, row, layer));
+                }
+                if (row + 1 < rows) {
+                    profile.edges.emplace_back(site(col, row, layer), site(col, row + 1, layer));
+                }
+                if (layer + 1 < layers) {
+                    profile.edges.emplace_back(site(col, row, layer), site(col, row, layer + 1));
+                }
+            }
+        }
+    }
+    for (int line = 0; line < rows * layers; ++line) {
+        const int layer = line / rows;
+        const int row = layer % 2 == 0 ? line % rows : rows - 1 - line % rows;
+        for (int step = 0; step < cols; ++step) {
+            profile.path.push_back(site(line % 2 == 0 ? step : cols - 1 - step, row, layer));
+        }
+    }
+}
+
+Profile noisy_square_array() {
+    constexpr int kSide = 4;
+    Profile profile;
+    profile.name = "noisy_square_array";
+    profile.device_id = "state-vector";
+    profile.preset = "noisy_square_array";
+    for (int site = 0; site < kSide * kSide; ++site) {
+        profile.positions.push_back(static_cast<double>(site % kSide));
+        profile.coordinates.push_back({static_cast<double>(site % kSide), static_cast<double>(site / kSide)});
+    }
+    profile.blockade_radius = 2.0;
+    SimpleNoiseConfig noise;
+    noise.gate.single_qubit = {0.005, 0.005, 0.005};
+    noise.gate.two_qubit_control = {0.01, 0.01, 0.01};
+    noise.gate.two_qubit_target = {0.01, 0.01, 0.01};
+    noise.idle_rate = 200.0;
+    noise.phase.idle = 0.02;
+    profile.noise = noise;
+    lattice(profile, kSide, kSide, 1);
+    return profile;
+}
+
+// A 4 x 2 x 2 block, 1.5 apart along x and 1.0 along y and z.
+Profile lossy_block() {
+    Profile profile;
+    profile.name = "lossy_block";
+    profile.device_id = "state-vector";
+    profile.preset = "lossy_block";
+    for (int site = 0; site < 16; ++site) {
+        profile.positions.push_back(static_cast<double>(site));
+        profile.coordinates.push_back({(site % 4) * 1.5, static_cast<double>(site / 4 % 2), static_cast<double>(site / 8)});
+    }
+    profile.blockade_radius = 1.5;
+    SimpleNoiseConfig noise;
+    noise.p_loss = 0.1;
+    noise.loss_runtime = {0.05, 5.0};
+    profile.noise = noise;
+    // All-to-all connectivity, but only lattice neighbours are inside the
+    // blockade radius.
+    lattice(profile, 4, 2, 2);
+    return profile;
+}
+
+// The stabilizer alias of benchmark_chain. Like the Python preset it keeps
+// only the Pauli gate channels, which a tableau simulator can sample.
+Profile stabilizer() {
+    Profile profile = benchmark_chain();
+    profile.name = "stabilizer";
+    profile.device_id = "stabilizer";
+    SimpleNoiseConfig noise;
+    noise.gate = profile.noise->gate;
+    profile.noise = noise;
+    return profile;
+}
+
+std::vector<Profile> all_profiles() {
+    return {benchmark_chain(), noisy_square_array(), lossy_block(), stabilizer()};
+}
+
+// Keep the first `sites` sites and the couplers among them. The path stops
+// at its first dropped site, so path workloads may leave sites idle.
+void truncate(Profile& profile, int sites) {
+    if (sites <= 0 || static_cast<std::size_t>(sites) >= profile.positions.size()) {
+        return;
+    }
+    profile.positions.resize(static_cast<std::size_t>(sites));
+    if (!profile.coordinates.empty()) {
+        profile.coordinates.resize(static_cast<std::size_t>(sites));
+    }
+    std::erase_if(profile.edges, [&](const auto& edge) { return edge.first >= sites || edge.second >= sites; });
+    const auto dropped = std::find_if(profile.path.begin(), profile.path.end(), [&](int site) { return site >= sites; });
+    profile.path.erase(dropped, profile.path.end());
+}
+
+Instruction gate(const char* name, std::vector<int> targets) {
+    return {Op::ApplyGate, Gate{name, std::move(targets), 0.0}};
+}
+
+void measure_all(Program& program, int sites) {
+    std::vector<int> targets(static_cast<std::size_t>(sites));
+    std::iota(targets.begin(), targets.end(), 0);
+    program.push_measure(targets);
+}
+
+// H on the first path site, then CX down the path.
+Program ghz(const Profile& profile) {
+    const int sites = static_cast<int>(profile.positions.size());
+    Program program{{Op::AllocArray, sites}, gate("H", {profile.path.front()})};
+    for (std::size_t idx = 1; idx < profile.path.size(); ++idx) {
+        program.push_back(gate("CX", {profile.path[idx - 1], profile.path[idx]}));
+    }
+    measure_all(program, sites);
+    return program;
+}
+
+// Bit-flip repetition code along the path: data on even steps, ancillas on
+// odd ones, three syndrome rounds, then a data readout.
+Program repetition_code(const Profile& profile) {
+    constexpr int kRounds = 3;
+    const int sites = static_cast<int>(profile.positions.size());
+    Program program{{Op::AllocArray, sites}};
+    std::vector<int> ancillas;
+    std::vector<int> data;
+    for (std::size_t idx = 0; idx < profile.path.size(); ++idx) {
+        (idx % 2 == 0 ? data : ancillas).push_back(profile.path[idx]);
+    }
+    for (int round = 0; round < kRounds; ++round) {
+        for (std::size_t idx = 1; idx + 1 < profile.path.size(); idx += 2) {
+            program.push_back(gate("CX", {profile.path[idx - 1], profile.path[idx]}));
+            program.push_back(gate("CX", {profile.path[idx + 1], profile.path[idx]}));
+        }
+        program.push_measure(ancillas);
+    }
+    program.push_measure(data);
+    return program;
+}
+
+// python/examples/maxcut_ring.py: |+> on every site, CX along every coupler.
+Program maxcut_ring(const Profile& profile) {
+    const int sites = static_cast<int>(profile.positions.size());
+    Program program{{Op::AllocArray, sites}};
+    for (int site = 0; site < sites; ++site) {
+        program.push_back(gate("H", {site}));
+    }
+    for (const auto& [control, target] : profile.edges) {
+        program.push_back(gate("CX", {control, target}));
+    }
+    measure_all(program, sites);
+    return program;
+}
+
+// Layers of random single-qubit gates followed by CX on a random matching
+// of the couplers.
+Program random_circuit(const Profile& profile) {
+    constexpr int kLayers = 12;
+    static const char* const kSingleQubitGates[] = {"H", "X", "Z"};
+    const int sites = static_cast<int>(profile.positions.size());
+    std::mt19937_64 rng(kCircuitSeed);
+    Program program{{Op::AllocArray, sites}};
+    auto edges = profile.edges;
+    for (int layer = 0; layer < kLayers; ++layer) {
+        for (int site = 0; site < sites; ++site) {
+            program.push_back(gate(kSingleQubitGates[rng() % 3], {site}));
+        }
+        std::shuffle(edges.begin(), edges.end(), rng);
+        std::vector<bool> busy(static_cast<std::size_t>(sites), false);
+        for (const auto& [control, target] : edges) {
+            if (busy[control] || busy[target] || rng() % 2 == 0) {
+                continue;
+            }
+            busy[control] = busy[target] = true;
+            program.push_back(gate("CX", {control, target}));
+        }
+    }
+    measure_all(program, sites);
+    return program;
+}
+
+// Shuttle every other path site out and back around each entangling gate,
+// so transport and idle noise dominate.
+Program rearrangement(const Profile& profile) {
+    constexpr int kRounds = 4;
+    constexpr double kOffset = 0.25;
+    const int sites = static_cast<int>(profile.positions.size());
+    Program program{{Op::AllocArray, sites}};
+    for (int round = 0; round < kRounds; ++round) {
+        for (std::size_t idx = 0; idx + 1 < profile.path.size(); idx += 2) {
+            const int atom = profile.path[idx];
+            const double home = profile.positions[static_cast<std::size_t>(atom)];
+            program.push_back({Op::MoveAtom, MoveAtomInstruction{atom, home + kOffset}});
+            program.push_back({Op::Wait, WaitInstruction{1000.0}});
+            program.push_back({Op::MoveAtom, MoveAtomInstruction{atom, home}});
+            program.push_back(gate("CX", {atom, profile.path[idx + 1]}));
+        }
+    }
+    measure_all(program, sites);
+    return program;
+}
+
+using WorkloadBuilder = Program (*)(const Profile&);
+
+const std::vector<std::pair<std::string, WorkloadBuilder>>& all_workloads() {
+    static const std::vector<std::pair<std::string, WorkloadBuilder>> workloads{
+        {"ghz", ghz},
+        {"repetition_code", repetition_code},
+        {"maxcut_ring", maxcut_ring},
+        {"random_circuit", random_circuit},
+        {"rearrangement", rearrangement},
+    };
+    return workloads;
+}
+
+bool selected(const std::vector<std::string>& filter, const std::string& name) {
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+struct CaseResult {
+    std::string profile;
+    std::string device_id;
+    std::string workload;
+    int qubits = 0;
+    std::size_t instructions = 0;
+    bool completed = false;
+    std::string message;
+    std::vector<double> latencies;
+    double shots_per_second = 0.0;
+    std::uint64_t peak_rss_bytes = 0;
+};
+
+CaseResult run_case(const Options& options, const Profile& profile, const std::string& workload, WorkloadBuilder build) {
+    CaseResult out;
+    out.profile = profile.name;
+    out.device_id = profile.device_id;
+    out.workload = workload;
+    out.qubits = static_cast<int>(profile.positions.size());
+
+    service::JobRequest job;
+    job.job_id = profile.name + "/" + workload;
+    job.device_id = profile.device_id;
+    job.profile = profile.preset;
+    job.hardware.positions = profile.positions;
+    job.hardware.coordinates = profile.coordinates;
+    job.hardware.blockade_radius = profile.blockade_radius;
+    job.noise_config = profile.noise;
+    job.program = build(profile);
+    job.shots = options.shots;
+    job.seed = kJobSeed;
+    out.instructions = job.program.size();
+
+    bench::reset_peak_rss();
+    service::JobRunner runner;
+    double total_seconds = 0.0;
+    for (int rep = 0; rep < options.repeat; ++rep) {
+        const auto start = std::chrono::steady_clock::now();
+        const service::JobResult result = runner.run(job, options.threads);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (result.status != service::JobStatus::Completed) {
+            out.message = result.message;
+            return out;
+        }
+        out.latencies.push_back(seconds);
+        total_seconds += seconds;
+    }
+    out.completed = true;
+    out.peak_rss_bytes = bench::proc_status("VmHWM");
+    out.shots_per_second = total_seconds > 0.0
+        ? static_cast<double>(options.shots) * options.repeat / total_seconds
+        : 0.0;
+    return out;
+}
+
+struct Comparison {
+    std::string profile;
+    std::string workload;
+    double baseline = 0.0;
+    double current = 0.0;
+    bool regressed = false;
+};
+
+std::vector<Comparison> compare(const std::vector<CaseResult>& cases, const service::JsonValue& baseline, double tolerance) {
+    std::map<std::pair<std::string, std::string>, double> reference;
+    if (const auto* entries = baseline.find("cases")) {
+        for (const auto& entry : entries->as_array()) {
+            const auto* status = entry.find("status");
+            const auto* rate = entry.find_non_null("shots_per_second");
+            if (!status || status->as_string() != "completed" || !rate) {
+                continue;
+            }
+            reference[{entry.find("profile")->as_string(), entry.find("workload")->as_string()}] = rate->as_double();
+        }
+    }
+    std::vector<Comparison> out;
+    for (const auto& result : cases) {
+        const auto it = reference.find({result.profile, result.workload});
+        if (!result.completed || it == reference.end() || it->second <= 0.0) {
+            continue;
+        }
+        Comparison row;
+        row.profile = result.profile;
+        row.workload = result.workload;
+        row.baseline = it->second;
+        row.current = result.shots_per_second;
+        row.regressed = row.current < row.baseline * (1.0 - tolerance);
+        out.push_back(row);
+    }
+    return out;
+}
+
+std::string to_json(const Options& options, const std::vector<CaseResult>& cases,
+    const std::vector<Comparison>* comparison) {
+    service::JsonWriter out;
+    out.begin_object();
+    out.key("config").begin_object()
+        .field("shots", options.shots)
+        .field("repeat", options.repeat)
+        .field("threads", static_cast<unsigned long long>(options.threads))
+        .field("seed", static_cast<unsigned long long>(kJobSeed))
+        .end_object();
+    out.key("cases").begin_array();
+    for (const auto& result : cases) {
+        out.begin_object()
+            .field("profile", result.profile)
+            .field("device_id", result.device_id)
+            .field("workload", result.workload)
+            .field("qubits", result.qubits)
+            .field("instructions", static_cast<unsigned long long>(result.instructions))
+            .field("status", result.completed ? "completed" : "failed");
+        if (result.completed) {
+            std::vector<double> sorted = result.latencies;
+            std::sort(sorted.begin(), sorted.end());
+            out.field("shots_per_second", result.shots_per_second);
+            out.key("latency_seconds").begin_object()
+                .field("min", sorted.front())
+                .field("p50", bench::percentile(sorted, 0.50))
+                .field("p90", bench::percentile(sorted, 0.90))
+                .field("p99", bench::percentile(sorted, 0.99))
+                .field("max", sorted.back())
+                .end_object();
+            out.field("peak_rss_bytes", static_cast<unsigned long long>(result.peak_rss_bytes));
+        } else {
+            out.field("message", result.message);
+        }
+        out.end_object();
+    }
+    out.end_array();
+    if (comparison) {
+        out.key("comparison").begin_object().field("tolerance", options.tolerance).key("cases").begin_array();
+        for (const auto& row : *comparison) {
+            out.begin_object()
+                .field("profile", row.profile)
+                .field("workload", row.workload)
+                .field("baseline_shots_per_second", row.baseline)
+                .field("shots_per_second", row.current)
+                .field("ratio", row.current / row.baseline)
+                .field("regressed", row.regressed)
+                .end_object();
+        }
+        out.end_array().end_object();
+    }
+    out.end_object();
+    return out.take();
+}
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char* argv0) {
+    std::cerr << "usage: " << argv0
+              << " [--shots N] [--repeat N] [--threads N] [--max-qubits N]"
+                 " [--profiles a,b] [--workloads a,b] [--output FILE]"
+                 " [--baseline FILE] [--tolerance F]\n";
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int idx = 1; idx < argc; ++idx) {
+        const std::string arg = argv[idx];
+        auto next = [&]() -> std::string {
+            if (idx + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++idx];
+        };
+        if (arg == "--shots") {
+            options.shots = std::stoi(next());
+        } else if (arg == "--repeat") {
+            options.repeat = std::stoi(next());
+        } else if (arg == "--threads") {
+            options.threads = static_cast<std::size_t>(std::stoul(next()));
+        } else if (arg == "--max-qubits") {
+            options.max_qubits = std::stoi(next());
+        } else if (arg == "--profiles") {
+            options.profiles = split(next());
+        } else if (arg == "--workloads") {
+            options.workloads = split(next());
+        } else if (arg == "--output") {
+            options.output = next();
+        } else if (arg == "--baseline") {
+            options.baseline = next();
+        } else if (arg == "--tolerance") {
+            options.tolerance = std::stod(next());
+        } else {
+            throw std::invalid_argument("unknown argument: " + arg);
+        }
+    }
+    if (options.shots < 1 || options.repeat < 1) {
+        throw std::invalid_argument("--shots and --repeat must be positive");
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& ex) {
+        std::cerr << "vm_workload_bench: " << ex.what() << "\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<CaseResult> cases;
+    for (auto profile : all_profiles()) {
+        if (!selected(options.profiles, profile.name)) {
+            continue;
+        }
+        truncate(profile, options.max_qubits);
+        for (const auto& [name, build] : all_workloads()) {
+            if (!selected(options.workloads, name)) {
+                continue;
+            }
+            cases.push_back(run_case(options, profile, name, build));
+            const auto& result = cases.back();
+            if (result.completed) {
+                std::fprintf(stderr, "%-20s %-16s %3d qubits %12.1f shots/s\n",
+                    result.profile.c_str(), result.workload.c_str(), result.qubits, result.shots_per_second);
+            } else {
+                std::fprintf(stderr, "%-20s %-16s failed: %s\n",
+                    result.profile.c_str(), result.workload.c_str(), result.message.c_str());
+            }
+        }
+    }
+
+    std::optional<std::vector<Comparison>> comparison;
+    if (!options.baseline.empty()) {
+        std::ifstream in(options.baseline);
+        if (!in) {
+            std::cerr << "vm_workload_bench: cannot read baseline " << options.baseline << "\n";
+            return 2;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        comparison = compare(cases, service::parse_json(buffer.str()), options.tolerance);
+    }
+
+    const std::string json = to_json(options, cases, comparison ? &*comparison : nullptr);
+    if (options.output.empty()) {
+        std::cout << json << "\n";
+    } else {
+        std::ofstream(options.output) << json << "\n";
+    }
+
+    bool regressed = false;
+    if (comparison) {
+        for (const auto& row : *comparison) {
+            std::fprintf(stderr, "%-20s %-16s %12.1f -> %12.1f shots/s (%+.1f%%)%s\n",
+                row.profile.c_str(), row.workload.c_str(), row.baseline, row.current,
+                (row.current / row.baseline - 1.0) * 100.0, row.regressed ? "  REGRESSION" : "");
+            regressed = regressed || row.regressed;
+        }
+    }
+    return regressed ? 1 : 0;
+}
@@ -13,9 +13,26 @@ set(NA_VM_SOURCE_FILES
     src/noise/idle_phase_drift_source.cpp
     src/noise/loss_tracking_source.cpp
     src/hardware_vm.cpp
+    src/perf_counters.cpp
     src/stabilizer_backend.cpp
+    src/trace.cpp
     src/service/job.cpp
+    src/service/fair_scheduler.cpp
+    src/service/http_server.cpp
+    src/service/job_codec.cpp
+    src/service/job_http_service.cpp
+    src/service/job_journal.cpp
+    src/service/job_json.cpp
+    src/service/json.cpp
+    src/service/packed_measurements.cpp
+    src/service/packed_program.cpp
+    src/service/result_cache.cpp
+    src/service/shot_stream.cpp
     src/service/job_validation.cpp
+    src/service/metrics.cpp
+    src/service/pipeline_stage.cpp
     src/service/scheduler.cpp
+    src/service/shard_coordinator.cpp
+    src/service/shared_result.cpp
     src/service/job_service.cpp
 )
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Measure request throughput and tail latency of a Neutral Atom VM job service.
+
+Point it at the native ``vm_server`` and at ``vm_service.py`` to compare the
+two front ends on identical traffic::
+
+    vm_server --port 8090 &
+    python python/scripts/vm_service.py --port 8091 &
+    python python/scripts/bench_service.py http://127.0.0.1:8090 http://127.0.0.1:8091
+
+Each client thread keeps one persistent connection (HTTP/1.1 keep-alive) and
+issues requests back to back; latencies are wall-clock per request.
+"""
+
+from __future__ import annotations
+
+import argparse
+import http.client
+import json
+import threading
+import time
+from typing import Callable, Dict, List
+from urllib.parse import urlparse
+
+
+BELL_JOB = {
+    "device_id": "state-vector",
+    "profile": "ideal_small_array",
+    "shots": 16,
+    "hardware": {"positions": [0.0, 1.0], "blockade_radius": 1.5},
+    "program": [
+        {"op": "AllocArray", "n_qubits": 2},
+        {"op": "ApplyGate", "name": "H", "targets": [0], "param": 0.0},
+        {"op": "ApplyGate", "name": "CX", "targets": [0, 1], "param": 0.0},
+        {"op": "Measure", "targets": [0, 1]},
+    ],
+}
+
+
+def _connect(url: str) -> http.client.HTTPConnection:
+    parsed = urlparse(url)
+    return http.client.HTTPConnection(parsed.hostname, parsed.port or 80, timeout=30)
+
+
+def _request(conn: http.client.HTTPConnection, method: str, path: str, body: bytes | None = None) -> bytes:
+    headers = {"Content-Type": "application/json"} if body is not None else {}
+    conn.request(method, path, body=body, headers=headers)
+    response = conn.getresponse()
+    payload = response.read()
+    if response.status >= 500:
+        raise RuntimeError(f"{method} {path} -> {response.status}: {payload[:200]!r}")
+    return payload
+
+
+def _percentile(sorted_values: List[float], fraction: float) -> float:
+    if not sorted_values:
+        return float("nan")
+    index = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def run_scenario(
+    url: str,
+    name: str,
+    make_request: Callable[[http.client.HTTPConnection], None],
+    clients: int,
+    duration: float,
+) -> Dict[str, float | str | int]:
+    latencies: List[List[float]] = [[] for _ in range(clients)]
+    errors = [0] * clients
+    deadline = time.perf_counter() + duration
+
+    def worker(slot: int) -> None:
+        conn = _connect(url)
+        samples = latencies[slot]
+        while time.perf_counter() < deadline:
+            start = time.perf_counter()
+            try:
+                make_request(conn)
+            except Exception:  # reconnect and keep measuring
+                errors[slot] += 1
+                conn.close()
+                conn = _connect(url)
+                continue
+            samples.append(time.perf_counter() - start)
+        conn.close()
+
+    threads = [threading.Thread(target=worker, args=(slot,)) for slot in range(clients)]
+    begin = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - begin
+
+    merged = sorted(sample for samples in latencies for sample in samples)
+    return {
+        "url": url,
+        "scenario": name,
+        "requests": len(merged),
+        "errors": sum(errors),
+        "requests_per_s": len(merged) / elapsed if elapsed > 0 else 0.0,
+        "p50_ms": _percentile(merged, 0.50) * 1e3,
+        "p99_ms": _percentile(merged, 0.99) * 1e3,
+    }
+
+
+def scenarios(url: str) -> Dict[str, Callable[[http.client.HTTPConnection], None]]:
+    conn = _connect(url)
+    job_id = json.loads(_request(conn, "POST", "/job", json.dumps(BELL_JOB).encode()))["job_id"]
+    conn.close()
+    body = json.dumps(BELL_JOB).encode()
+    return {
+        "healthz": lambda c: _request(c, "GET", "/healthz"),
+        "status": lambda c: _request(c, "GET", f"/job/{job_id}/status"),
+        "submit": lambda c: _request(c, "POST", "/job", body),
+    }
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("urls", nargs="+", help="Base URLs of the services to compare")
+    parser.add_argument("--clients", type=int, default=8, help="Concurrent keep-alive connections")
+    parser.add_argument("--duration", type=float, default=5.0, help="Seconds per scenario")
+    parser.add_argument("--scenario", action="append", help="Limit to healthz, status, or submit")
+    parser.add_argument("--json", action="store_true", help="Emit results as JSON lines")
+    args = parser.parse_args()
+
+    for url in args.urls:
+        for name, make_request in scenarios(url).items():
+            if args.scenario and name not in args.scenario:
+                continue
+            row = run_scenario(url, name, make_request, args.clients, args.duration)
+            if args.json:
+                print(json.dumps(row), flush=True)
+            else:
+                print(
+                    f"{url:<28} {name:<8} {row['requests_per_s']:>10.0f} req/s"
+                    f"  p50 {row['p50_ms']:7.2f} ms  p99 {row['p99_ms']:7.2f} ms"
+                    f"  errors {row['errors']}",
+                    flush=True,
+                )
+
+
+if __name__ == "__main__":
+    main()
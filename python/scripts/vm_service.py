@@ -12,7 +12,13 @@ from typing import Any, Mapping
 from urllib.parse import urlparse
 
 from neutral_atom_vm.device import available_presets
-from neutral_atom_vm.job import job_result, job_status, submit_job_async
+from neutral_atom_vm.job import (
+    job_result,
+    job_status,
+    service_metrics,
+    stream_job,
+    submit_job_async,
+)
 
 
 logger = logging.getLogger("neutral_atom_vm.vm_service")
@@ -49,7 +55,7 @@ class VMJobRequestHandler(BaseHTTPRequestHandler):
         if len(parts) != 2:
             return None
         job_id, verb = parts
-        if verb not in {"status", "result"}:
+        if verb not in {"status", "result", "stream"}:
             return None
         return job_id, verb
 
@@ -66,11 +72,16 @@ class VMJobRequestHandler(BaseHTTPRequestHandler):
         if normalized == "/healthz":
             self._send_json({"status": "ok"})
             return
+        if normalized == "/metrics":
+            self._handle_metrics()
+            return
         match = self._match_job_suffix(normalized, job_base)
         if match:
             job_id, verb = match
             if verb == "status":
                 self._handle_job_status(job_id)
+            elif verb == "stream":
+                self._handle_job_stream(job_id)
             else:
                 self._handle_job_result(job_id)
             return
@@ -140,6 +151,32 @@ class VMJobRequestHandler(BaseHTTPRequestHandler):
             return
         self._send_json(payload)
 
+    def _handle_job_stream(self, job_id: str) -> None:
+        """Stream finished shot batches as newline-delimited JSON.
+
+        The response has no Content-Length and ends when the job does. Writes
+        block when the client reads slowly, which in turn throttles the job
+        through the bounded native shot stream.
+        """
+        try:
+            stream = stream_job(job_id)
+        except RuntimeError as exc:
+            self.send_error(404, f"job not found: {exc}")
+            return
+        self.send_response(200)
+        self.send_header("Content-Type", "application/x-ndjson")
+        self.send_header("Cache-Control", "no-cache")
+        self.end_headers()
+        try:
+            for batch in stream:
+                self.wfile.write(json.dumps(batch).encode("utf-8") + b"\n")
+                self.wfile.flush()
+        except (BrokenPipeError, ConnectionResetError):
+            logger.info("Stream client for %s disconnected", job_id)
+        finally:
+            stream.close()
+        self.close_connection = True
+
     def _send_json(self, body: Any, status: int = 200) -> None:
         payload = json.dumps(body).encode("utf-8")
         self.send_response(status)
@@ -148,6 +185,20 @@ class VMJobRequestHandler(BaseHTTPRequestHandler):
         self.end_headers()
         self.wfile.write(payload)
 
+    def _handle_metrics(self) -> None:
+        try:
+            text = service_metrics()
+        except Exception as exc:  # pragma: no cover - defensive guard
+            logger.exception("Unable to render metrics")
+            self.send_error(500, f"failed to render metrics: {exc}")
+            return
+        payload = text.encode("utf-8")
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain; version=0.0.4")
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+
     def _handle_devices(self) -> None:
         try:
             presets = available_presets()
@@ -22,15 +22,35 @@ from .job import (
     TransportEdge,
     submit_job,
     submit_job_async,
+    job_future,
+    run_job_async,
+    submit_batch_async,
+    submit_sweep_async,
+    batch_status,
+    iter_batch_results,
+    stream_job,
     job_result,
+    job_result_segment,
+    open_result_segment,
     job_status,
+    service_metrics,
+    start_trace,
+    stop_trace,
+    set_tenant_policy,
     JobResult,
+    EngineSession,
     has_stabilizer_backend,
+    configure_result_cache,
+    configure_hardware_counters,
+    result_cache_stats,
 )
 from .qec import (
+    repetition_code_program,
     repetition_code_job,
     compute_repetition_code_metrics,
 )
+from .packed_program import pack_program
+from .records import MeasurementRecords, RecordArray
 from .squin_lowering import to_vm_program, LoweringError
 from . import cli
 from .widgets import ProfileConfigurator, JobResultViewer
@@ -54,8 +74,19 @@ __all__ = [
     "JobRequest",
     "JobResult",
     "submit_job_async",
+    "submit_batch_async",
+    "submit_sweep_async",
+    "batch_status",
+    "iter_batch_results",
+    "stream_job",
     "job_status",
     "job_result",
+    "job_result_segment",
+    "open_result_segment",
+    "service_metrics",
+    "start_trace",
+    "stop_trace",
+    "set_tenant_policy",
     "to_vm_program",
     "LoweringError",
     "submit_job",
@@ -63,6 +94,16 @@ __all__ = [
     "ProfileConfigurator",
     "JobResultViewer",
     "has_stabilizer_backend",
+    "configure_result_cache",
+    "configure_hardware_counters",
+    "result_cache_stats",
+    "EngineSession",
+    "job_future",
+    "run_job_async",
+    "MeasurementRecords",
+    "pack_program",
+    "RecordArray",
+    "repetition_code_program",
     "repetition_code_job",
     "compute_repetition_code_metrics",
 ]
@@ -16,6 +16,7 @@ from typing import Any, Callable, Mapping, Sequence
 from .device import connect_device, build_device_from_config
 from .job import JobRequest, job_result, job_status, submit_job_async
 from .layouts import GridLayout, grid_layout_for_profile
+from .records import json_default
 from .service_client import RemoteServiceError, submit_job_to_service
 
 
@@ -399,7 +400,7 @@ def _cmd_run(args: argparse.Namespace) -> int:
         result.pop("log_time_units", None)
 
     if args.output == "json":
-        print(json.dumps(result, indent=2, sort_keys=True))
+        print(json.dumps(result, indent=2, sort_keys=True, default=json_default))
     else:
         summary_text = _summarize_result(
             result,
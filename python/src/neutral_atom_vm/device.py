@@ -605,6 +605,8 @@ class Device:
     def _normalize_program(self, program_or_kernel: Union[ProgramType, KernelType]) -> ProgramType:
         if callable(program_or_kernel):
             return to_vm_program(program_or_kernel)
+        if isinstance(program_or_kernel, (Mapping, bytes, bytearray, memoryview)):
+            return program_or_kernel  # packed program, see packed_program.py
         return list(program_or_kernel)
 
 
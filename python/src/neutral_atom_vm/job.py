@@ -9,12 +9,16 @@ import importlib
 import importlib.util
 import os
 import sys
+import weakref
 
 from .display import render_job_result_html
 from .layouts import grid_layout_for_profile
+from .packed_program import _flatten
+from .records import RecordArray, wrap_native_result
 
 
-Program = Sequence[Dict[str, Any]]
+# Instruction dicts, or a packed program (see packed_program.py).
+Program = Sequence[Dict[str, Any]] | Mapping[str, Any] | bytes
 
 
 def _to_float(value: Any, default: float = 0.0) -> float:
@@ -578,13 +582,16 @@ class JobRequest:
     metadata: Dict[str, str] = field(default_factory=dict)
     noise: SimpleNoiseConfig | None = None
     stim_circuit: str | None = None
+    seed: Optional[int] = None
+    # Values for symbolic gate parameters (``"param": "theta"``).
+    parameters: Dict[str, float] = field(default_factory=dict)
 
     def to_dict(self) -> Dict[str, Any]:
         data: Dict[str, Any] = {
             "job_id": self.job_id,
             "device_id": self.device_id,
             "profile": self.profile,
-            "program": list(self.program),
+            "program": _program_payload(self.program),
             "hardware": self.hardware.to_dict(),
             "shots": int(self.shots),
         }
@@ -596,6 +603,12 @@ class JobRequest:
             data["noise"] = self.noise.to_dict()
         if self.stim_circuit:
             data["stim_circuit"] = self.stim_circuit
+        if self.seed is not None:
+            data["seed"] = int(self.seed)
+        if self.parameters:
+            data["parameters"] = {
+                str(name): float(value) for name, value in self.parameters.items()
+            }
         return data
 
 
@@ -618,9 +631,9 @@ class JobResult(dict):
         self.shots = shots
         self.layout = layout
         self.coordinates = coordinates
-        self.timeline = list(payload.get("timeline", []))
+        self.timeline = payload.get("timeline", [])
         self.timeline_units = payload.get("timeline_units", "ns")
-        self.scheduler_timeline = list(payload.get("scheduler_timeline", []))
+        self.scheduler_timeline = payload.get("scheduler_timeline", [])
         self.scheduler_timeline_units = payload.get("scheduler_timeline_units", "ns")
         self.log_time_units = payload.get("log_time_units", payload.get("time_units", "ns"))
 
@@ -635,12 +648,27 @@ class JobResult(dict):
         )
 
 
+def _program_payload(program: Any) -> Any:
+    # Packed programs (see packed_program.py) go to the binding as-is.
+    if isinstance(program, Mapping):
+        return dict(program)
+    if isinstance(program, (bytes, bytearray, memoryview)):
+        return program
+    # Repeat blocks with a nested "body" reach the binding in the flat
+    # header-plus-body_size form.
+    flat: list = []
+    _flatten(program, flat)
+    return flat
+
+
 def _normalize_job_mapping(job: JobRequest | Mapping[str, Any]) -> Dict[str, Any]:
     if isinstance(job, JobRequest):
         return job.to_dict()
     # Accept plain mappings/dicts for flexibility; copy into a mutable dict so
     # we can safely add defaults.
     normalized = dict(job)
+    if "program" in normalized:
+        normalized["program"] = _program_payload(normalized["program"])
     noise = normalized.get("noise")
     if isinstance(noise, SimpleNoiseConfig):
         normalized["noise"] = noise.to_dict()
@@ -677,7 +705,7 @@ def submit_job(job: JobRequest | Mapping[str, Any]) -> Dict[str, Any]:
 
     if isinstance(result, MutableMapping) and "job_id" in job_dict:
         result["job_id"] = job_dict["job_id"]
-    return dict(result) if isinstance(result, MutableMapping) else result
+    return wrap_native_result(dict(result)) if isinstance(result, MutableMapping) else result
 
 
 def submit_job_async(job: JobRequest | Mapping[str, Any]) -> Dict[str, Any]:
@@ -708,4 +736,359 @@ def job_result(job_id: str) -> Dict[str, Any]:
     result = module.job_result(job_id)
     if not isinstance(result, Mapping):
         raise RemoteServiceError("Job result response is unexpected")
-    return dict(result)
+    return wrap_native_result(dict(result))
+
+
+def job_result_segment(job_id: str) -> Any:
+    """Return the measurements of a completed async job in shared memory.
+
+    The segment exposes its value bit plane through the buffer protocol
+    (``memoryview(segment)`` is a read-only array of uint64 words); bit
+    ``shot * segment.bits_per_shot + k`` holds the k-th bit of ``shot`` in
+    ``segment.layout`` order, and ``segment.lost`` marks lost atoms. Another
+    process can map it with :func:`open_result_segment` using
+    ``segment.name`` while the service keeps the job. Returns ``None`` when
+    the job has not completed.
+    """
+    module = _load_native_module()
+    if not hasattr(module, "job_result_segment"):
+        raise RemoteServiceError("Shared-memory results are unavailable in this build")
+    return module.job_result_segment(job_id)
+
+
+def open_result_segment(name: str) -> Any:
+    """Map a result segment published by another process by its name."""
+    module = _load_native_module()
+    if not hasattr(module, "open_result_segment"):
+        raise RemoteServiceError("Shared-memory results are unavailable in this build")
+    return module.open_result_segment(name)
+
+
+def service_metrics() -> str:
+    """Return the in-process service metrics as Prometheus exposition text."""
+    module = _load_native_module()
+    if not hasattr(module, "metrics_text"):
+        raise RemoteServiceError("Service metrics are unavailable in this build")
+    return str(module.metrics_text())
+
+
+def start_trace(*, events_per_thread: int = 1 << 16) -> None:
+    """Start recording execution spans of in-process jobs.
+
+    Each thread keeps its first ``events_per_thread`` spans. Load the string
+    returned by :func:`stop_trace` in chrome://tracing or ui.perfetto.dev.
+    """
+    module = _load_native_module()
+    if not hasattr(module, "start_trace"):
+        raise RemoteServiceError("Tracing is unavailable in this build")
+    module.start_trace(int(events_per_thread))
+
+
+def stop_trace() -> str:
+    """Stop tracing and return the recorded spans as Chrome trace JSON."""
+    module = _load_native_module()
+    if not hasattr(module, "stop_trace"):
+        raise RemoteServiceError("Tracing is unavailable in this build")
+    return str(module.stop_trace())
+
+
+def set_tenant_policy(
+    tenant: str,
+    *,
+    weight: float = 1.0,
+    max_threads: int = 0,
+    max_memory_bytes: int = 0,
+    max_queued_jobs: int = 0,
+) -> None:
+    """Set the fair-share weight and caps of a tenant (0 leaves a cap unlimited).
+
+    Async jobs are scheduled under ``metadata["tenant"]`` (``"default"`` when
+    absent); submissions beyond ``max_queued_jobs`` raise ``RuntimeError``.
+    """
+    module = _load_native_module()
+    if not hasattr(module, "set_tenant_policy"):
+        raise RemoteServiceError("Tenant policies are unavailable in this build")
+    module.set_tenant_policy(
+        tenant,
+        weight=weight,
+        max_threads=max_threads,
+        max_memory_bytes=max_memory_bytes,
+        max_queued_jobs=max_queued_jobs,
+    )
+
+
+def _normalize_override(item: Mapping[str, Any]) -> Dict[str, Any]:
+    normalized = dict(item)
+    noise = normalized.get("noise")
+    if isinstance(noise, SimpleNoiseConfig):
+        normalized["noise"] = noise.to_dict()
+    gate_params = normalized.get("gate_params")
+    if gate_params is not None:
+        normalized["gate_params"] = {
+            int(index): float(param) for index, param in dict(gate_params).items()
+        }
+    parameters = normalized.get("parameters")
+    if parameters is not None:
+        normalized["parameters"] = {
+            str(name): float(value) for name, value in dict(parameters).items()
+        }
+    return normalized
+
+
+def submit_batch_async(
+    job: JobRequest | Mapping[str, Any],
+    overrides: Sequence[Mapping[str, Any]],
+) -> Dict[str, Any]:
+    """Submit a parameter/seed sweep over one base job.
+
+    The base program is validated and scheduled once. Each override mapping
+    may set ``seed``, ``shots``, ``noise``, ``gate_params`` (a mapping from
+    program instruction index to the new gate parameter) and ``parameters``
+    (values for symbolic gate parameters) and runs as its own async job.
+    Returns ``{"batch_id": ..., "job_ids": [...]}``.
+    """
+    job_dict, _ = _prepare_job_dict(job)
+    module = _load_native_module()
+    if not hasattr(module, "submit_batch_async"):
+        raise RuntimeError("Batch submission is unavailable in this build")
+    items = [_normalize_override(item) for item in overrides]
+    return dict(module.submit_batch_async(job_dict, items))
+
+
+def submit_sweep_async(
+    job: JobRequest | Mapping[str, Any],
+    parameter_sets: Sequence[Mapping[str, float]],
+) -> Dict[str, Any]:
+    """Run one parametric program once per parameter set.
+
+    Gates written with a string parameter (``"param": "theta"``) are bound
+    from each set, on top of the job's own ``parameters``. The program is
+    validated and scheduled once; every set runs as its own async job of the
+    returned batch.
+    """
+    return submit_batch_async(job, [{"parameters": values} for values in parameter_sets])
+
+
+def batch_status(batch_id: str) -> Dict[str, Any]:
+    module = _load_native_module()
+    if not hasattr(module, "batch_status"):
+        raise RuntimeError("Batch status queries are unavailable in this build")
+    return dict(module.batch_status(batch_id))
+
+
+def iter_batch_results(batch_id: str, poll_interval: float = 0.01):
+    """Yield batch item results as they finish, in completion order."""
+    import time
+
+    module = _load_native_module()
+    if not hasattr(module, "batch_results"):
+        raise RuntimeError("Batch result queries are unavailable in this build")
+    total = int(module.batch_status(batch_id)["total"])
+    cursor = 0
+    while cursor < total:
+        fresh = module.batch_results(batch_id, cursor)
+        for result in fresh:
+            yield wrap_native_result(dict(result))
+        cursor += len(fresh)
+        if cursor < total and not fresh:
+            time.sleep(poll_interval)
+
+
+class _CompletionWatcher:
+    """Resolves asyncio futures of one event loop from a CompletionNotifier.
+
+    The notifier's eventfd is registered with ``loop.add_reader``; the
+    service signals it from its completion callbacks, so awaiting any number
+    of jobs costs no status polling.
+    """
+
+    def __init__(self, loop, module) -> None:
+        self._loop = loop
+        self._notifier = module.CompletionNotifier()
+        self._futures: Dict[str, list] = {}
+        loop.add_reader(self._notifier.fileno(), self._on_ready)
+
+    def watch(self, job_id: str):
+        future = self._loop.create_future()
+        pending = self._futures.setdefault(job_id, [])
+        pending.append(future)
+        if len(pending) == 1:
+            try:
+                self._notifier.watch(job_id)
+            except Exception:
+                del self._futures[job_id]
+                raise
+        return future
+
+    def _on_ready(self) -> None:
+        for job_id in self._notifier.drain():
+            futures = self._futures.pop(job_id, [])
+            try:
+                result: Any = job_result(job_id)
+                error = None
+            except Exception as exc:  # pragma: no cover - result evicted
+                error = exc
+            for future in futures:
+                if future.done():
+                    continue
+                if error is not None:
+                    future.set_exception(error)
+                else:
+                    future.set_result(result)
+
+
+_completion_watchers: "weakref.WeakKeyDictionary[Any, _CompletionWatcher]" = weakref.WeakKeyDictionary()
+
+
+def job_future(job_id: str):
+    """Return an asyncio future resolved with the job's final result.
+
+    Must be called from a running event loop. The future completes for both
+    completed and failed jobs; check ``result["status"]``.
+    """
+
+    import asyncio
+
+    loop = asyncio.get_running_loop()
+    watcher = _completion_watchers.get(loop)
+    if watcher is None:
+        module = _load_native_module()
+        if not hasattr(module, "CompletionNotifier"):
+            raise RuntimeError("Job completion notifications are unavailable in this build")
+        watcher = _CompletionWatcher(loop, module)
+        _completion_watchers[loop] = watcher
+    return watcher.watch(job_id)
+
+
+async def run_job_async(job: JobRequest | Mapping[str, Any]) -> Dict[str, Any]:
+    """Submit a job and await its result without polling."""
+
+    submitted = submit_job_async(job)
+    return await job_future(submitted["job_id"])
+
+
+def stream_job(job_id: str, capacity: int = 1024):
+    """Iterate over shot batches of an async job as they finish.
+
+    Each item is ``{"shots": ..., "measurements": {"bits": ..., "layout": [...]},
+    "counts": {...}, "coalesced_shots": n, "completed_shots": n,
+    "total_shots": n}``. ``shots`` is an int64 array of shot indices and
+    ``measurements`` has the same form as in :func:`submit_job` results, one
+    ``bits`` row per shot (``records.wrap_native_result(batch)`` gives the
+    ``list[dict]`` view). ``counts`` is the cumulative outcome histogram of
+    the streamed shots (at most 4096 outcomes, the rest under ``"other"``). At most ``capacity``
+    shots are buffered and the job never waits for the consumer: shots that
+    finish while the buffer is full only reach ``counts``, and
+    ``coalesced_shots`` says how many so far.
+    """
+    module = _load_native_module()
+    if not hasattr(module, "subscribe_job"):
+        raise RuntimeError("Shot streaming is unavailable in this build")
+    return module.subscribe_job(job_id, int(capacity))
+
+
+class EngineSession:
+    """Step through one shot of a job on the statevector engine.
+
+    The job is compiled like :func:`submit_job` (profile enrichment,
+    validation, scheduling); ``step``/``run`` then execute the scheduled
+    program with the GIL released. ``state_vector()`` is a writable NumPy
+    view of the engine's amplitudes, not a copy. Drop such views before
+    stepping onto an ``AllocArray`` or calling ``reset()``, which would
+    reallocate the buffer. Seeded jobs reproduce shot 0 of ``submit_job``.
+    """
+
+    def __init__(self, job: JobRequest | Mapping[str, Any]) -> None:
+        job_dict, _ = _prepare_job_dict(job)
+        module = _load_native_module()
+        if not hasattr(module, "EngineSession"):
+            raise RuntimeError("Engine sessions are unavailable in this build")
+        self._native = module.EngineSession(job_dict)
+
+    def step(self, count: int = 1) -> int:
+        return int(self._native.step(int(count)))
+
+    def run(self) -> int:
+        return int(self._native.run())
+
+    def reset(self) -> None:
+        self._native.reset()
+
+    def state_vector(self):
+        return self._native.state_vector()
+
+    @property
+    def measurements(self):
+        return wrap_native_result({"measurements": self._native.measurements()})["measurements"]
+
+    @property
+    def logs(self):
+        return RecordArray(self._native.logs())
+
+    @property
+    def timeline(self):
+        return RecordArray(self._native.timeline())
+
+    @property
+    def position(self) -> int:
+        return int(self._native.position)
+
+    @property
+    def program_size(self) -> int:
+        return int(self._native.program_size)
+
+    @property
+    def done(self) -> bool:
+        return bool(self._native.done)
+
+    @property
+    def n_qubits(self) -> int:
+        return int(self._native.n_qubits)
+
+    @property
+    def logical_time(self) -> float:
+        return float(self._native.logical_time)
+
+
+def configure_result_cache(
+    memory_budget_bytes: int = 64 * 1024 * 1024,
+    disk_directory: str | None = None,
+    disk_budget_bytes: int = 1024 * 1024 * 1024,
+) -> None:
+    """Enable the native result cache for seeded (deterministic) jobs.
+
+    Resubmitting a job with the same program, hardware, noise, shots, seed and
+    backend returns the stored result immediately; ``result["metadata"]``
+    reports ``cache_hit``.
+    """
+    module = _load_native_module()
+    if not hasattr(module, "configure_result_cache"):
+        raise RuntimeError("Result caching is unavailable in this build")
+    module.configure_result_cache(
+        int(memory_budget_bytes),
+        disk_directory or "",
+        int(disk_budget_bytes),
+    )
+
+
+def configure_hardware_counters(scope: str = "run") -> bool:
+    """Collect CPU hardware counters for in-process jobs.
+
+    ``scope`` is ``"off"``, ``"run"`` (cycles, instructions and LLC
+    references/misses per job) or ``"kernels"`` (also per gate kernel and
+    measurement). Results report them under
+    ``result["profile"]["hardware_counters"]``. Returns False when the
+    kernel does not expose the counters to this process; jobs still run and
+    report ``available: False``.
+    """
+    module = _load_native_module()
+    if not hasattr(module, "configure_hardware_counters"):
+        raise RuntimeError("Hardware counters are unavailable in this build")
+    return bool(module.configure_hardware_counters(scope))
+
+
+def result_cache_stats() -> Dict[str, Any]:
+    module = _load_native_module()
+    if not hasattr(module, "result_cache_stats"):
+        return {"enabled": False}
+    return dict(module.result_cache_stats())
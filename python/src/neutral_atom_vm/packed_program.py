@@ -0,0 +1,121 @@
+"""Packed program layout accepted by ``submit_job`` as ``program``.
+
+Large programs (e.g. 10^5 lowered gates) are slow to pass as a list of
+instruction dicts, since the binding parses every dict. A packed program
+is read by the extension straight from three buffers:
+
+``gates``
+    Gate table; ``ApplyGate`` rows refer to names by index.
+``instructions``
+    Structured array of :data:`INSTRUCTION_DTYPE`, one row per instruction.
+``targets``
+    Flat ``int32`` operands. Each row takes the next ``target_count``
+    entries: gate and measure targets, the ``AllocArray`` qubit count, the
+    ``MoveAtom`` atom, the ``Pulse`` target, or the ``Repeat`` count and
+    body size (the body is the next ``body_size`` rows).
+
+``value0`` holds the gate parameter, ``MoveAtom`` position, ``Wait``
+duration or ``Pulse`` detuning; ``value1`` holds the ``Pulse`` duration.
+Generators can fill these arrays directly; :func:`pack_program` converts
+an existing instruction list. The wire form produced by the C++
+``service::encode_packed_program`` is accepted as ``bytes`` as well.
+"""
+
+from __future__ import annotations
+
+from typing import Any, Dict, List, Mapping, Sequence
+
+OPCODES = {
+    "AllocArray": 0,
+    "ApplyGate": 1,
+    "Measure": 2,
+    "MoveAtom": 3,
+    "Wait": 4,
+    "Pulse": 5,
+    "Repeat": 6,
+}
+
+INSTRUCTION_FIELDS = [
+    ("op", "u1"),
+    ("reserved", "u1"),
+    ("gate", "<u2"),
+    ("target_count", "<u4"),
+    ("value0", "<f8"),
+    ("value1", "<f8"),
+]
+
+
+def instruction_dtype():
+    import numpy as np
+
+    return np.dtype(INSTRUCTION_FIELDS)
+
+
+def _flatten(program: Sequence[Mapping[str, Any]], out: List[Mapping[str, Any]]) -> None:
+    for instr in program:
+        if instr["op"] == "Repeat" and "body" in instr:
+            header = {"op": "Repeat", "count": int(instr["count"]), "body_size": 0}
+            out.append(header)
+            start = len(out)
+            _flatten(instr["body"], out)
+            header["body_size"] = len(out) - start
+        else:
+            out.append(instr)
+
+
+def pack_program(program: Sequence[Mapping[str, Any]]) -> Dict[str, Any]:
+    """Convert a list of instruction dicts into the packed layout.
+
+    ``Repeat`` blocks with a nested ``body`` are flattened into a header row
+    followed by the body rows.
+    """
+
+    import numpy as np
+
+    flat: List[Mapping[str, Any]] = []
+    _flatten(program, flat)
+    program = flat
+    gates: list[str] = []
+    gate_index: Dict[str, int] = {}
+    rows = np.zeros(len(program), dtype=instruction_dtype())
+    targets: list[int] = []
+    for idx, instr in enumerate(program):
+        op = instr["op"]
+        if op not in OPCODES:
+            raise ValueError(f"Unsupported op: {op}")
+        row = rows[idx]
+        row["op"] = OPCODES[op]
+        if op == "AllocArray":
+            operands = [int(instr["n_qubits"])]
+        elif op == "ApplyGate":
+            name = instr["name"]
+            if name not in gate_index:
+                gate_index[name] = len(gates)
+                gates.append(name)
+            row["gate"] = gate_index[name]
+            param = instr.get("param", 0.0)
+            if isinstance(param, str):
+                raise ValueError(f"Symbolic gate parameter {param!r} cannot be packed")
+            row["value0"] = float(param)
+            operands = [int(target) for target in instr["targets"]]
+        elif op == "Measure":
+            operands = [int(target) for target in instr["targets"]]
+        elif op == "MoveAtom":
+            row["value0"] = float(instr["position"])
+            operands = [int(instr["atom"])]
+        elif op == "Wait":
+            row["value0"] = float(instr["duration"])
+            operands = []
+        elif op == "Repeat":
+            operands = [int(instr["count"]), int(instr["body_size"])]
+        else:
+            row["value0"] = float(instr["detuning"])
+            row["value1"] = float(instr["duration"])
+            operands = [int(instr["target"])]
+        row["target_count"] = len(operands)
+        targets.extend(operands)
+    return {
+        "gates": gates,
+        "instructions": rows,
+        "targets": np.asarray(targets, dtype=np.int32),
+    }
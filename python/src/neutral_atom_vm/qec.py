@@ -2,40 +2,46 @@
 
 from __future__ import annotations
 
-from typing import Mapping
-
-from bloqade import squin
+from typing import Any, Dict, List, Mapping
 
 from .device import available_presets, build_device_from_config
 from .job import SimpleNoiseConfig, JobResult, has_stabilizer_backend
 
 
-def _build_repetition_kernel(
+def repetition_code_program(
     distance: int,
     rounds: int,
-    logical_state: int,
-) -> squin.Method | None:
+    logical_state: int = 0,
+) -> List[Dict[str, Any]]:
+    """
+    VM program for a bit-flip repetition code.
+
+    The syndrome-extraction round is a single ``Repeat`` block, so the
+    program size does not grow with ``rounds``; the VM schedules and runs
+    the round without unrolling it.
+    """
+
     if distance <= 0:
         raise ValueError("distance must be positive")
     if rounds <= 0:
         raise ValueError("rounds must be positive")
 
+    ancilla = distance
     data_targets = list(range(distance))
-
-    @squin.kernel
-    def _kernel():
-        squin.qalloc(distance + 1)
-        ancilla_idx = distance
-        if logical_state:
-            for idx in range(distance):
-                squin.x(idx)
-        for _ in range(rounds):
-            for idx in range(distance):
-                squin.cx(idx, ancilla_idx)
-            squin.measure(ancilla_idx)
-        squin.measure(data_targets)
-
-    return _kernel
+    program: List[Dict[str, Any]] = [{"op": "AllocArray", "n_qubits": distance + 1}]
+    if logical_state:
+        program.extend(
+            {"op": "ApplyGate", "name": "X", "targets": [idx], "param": 0.0}
+            for idx in data_targets
+        )
+    syndrome_round: List[Dict[str, Any]] = [
+        {"op": "ApplyGate", "name": "CX", "targets": [idx, ancilla], "param": 0.0}
+        for idx in data_targets
+    ]
+    syndrome_round.append({"op": "Measure", "targets": [ancilla]})
+    program.append({"op": "Repeat", "count": rounds, "body": syndrome_round})
+    program.append({"op": "Measure", "targets": data_targets})
+    return program
 
 
 def repetition_code_job(
@@ -70,8 +76,8 @@ def repetition_code_job(
         device = build_device_from_config(target_device, profile=profile, config=modified)
     if noise is not None:
         device.noise = noise
-    kernel = _build_repetition_kernel(distance, rounds, logical_state)
-    handle = device.submit(kernel, shots=shots, max_threads=max_threads)
+    program = repetition_code_program(distance, rounds, logical_state)
+    handle = device.submit(program, shots=shots, max_threads=max_threads)
     return handle.result()
 
 
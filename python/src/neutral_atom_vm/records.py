@@ -0,0 +1,120 @@
+"""Record views over the NumPy arrays returned by the native bindings.
+
+The extension returns measurements as one ``int8`` array of shape
+``(rows, bits_per_row)`` plus the per-row target layout, and logs and
+timelines as structured arrays, so no Python object is created per shot.
+These wrappers keep the historical ``list[dict]`` reading API (indexing,
+iteration, ``len``) on top of those arrays; use ``.array`` for vectorised
+access and ``to_list()`` for plain Python data.
+"""
+
+from __future__ import annotations
+
+from typing import Any, Dict, Iterator, List, Mapping, MutableMapping, Sequence
+
+
+class RecordArray(Sequence):
+    """Sequence of dicts backed by a NumPy structured array."""
+
+    def __init__(self, array: Any) -> None:
+        self.array = array
+        self._names = tuple(array.dtype.names or ())
+
+    def __len__(self) -> int:
+        return int(self.array.shape[0])
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return RecordArray(self.array[index])
+        row = self.array[index]
+        return {name: row[name].item() for name in self._names}
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        for idx in range(len(self)):
+            yield self[idx]
+
+    def to_list(self) -> List[Dict[str, Any]]:
+        return list(self)
+
+    def __repr__(self) -> str:
+        return f"RecordArray({self.to_list()!r})"
+
+
+class MeasurementRecords(Sequence):
+    """Measurement records backed by an ``int8`` bit matrix.
+
+    Row ``r`` of ``array`` holds the records ``layout[0]``, ``layout[1]``,
+    ... of one shot (or one repetition of the program's measurement layout)
+    back to back; ``-1`` marks a lost atom. Item ``i`` is the record
+    ``{"targets": layout[i % k], "bits": [...]}`` with ``k = len(layout)``,
+    matching the order the runner produced them in.
+    """
+
+    def __init__(self, bits: Any, layout: Sequence[Sequence[int]]) -> None:
+        self.array = bits
+        self.layout = [list(targets) for targets in layout]
+        self._offsets = []
+        offset = 0
+        for targets in self.layout:
+            self._offsets.append(offset)
+            offset += len(targets)
+
+    def __len__(self) -> int:
+        return int(self.array.shape[0]) * len(self.layout)
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [self[idx] for idx in range(*index.indices(len(self)))]
+        count = len(self)
+        if index < 0:
+            index += count
+        if not 0 <= index < count:
+            raise IndexError("measurement index out of range")
+        row, slot = divmod(index, len(self.layout))
+        targets = self.layout[slot]
+        start = self._offsets[slot]
+        return {
+            "targets": list(targets),
+            "bits": self.array[row, start : start + len(targets)].tolist(),
+        }
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        for idx in range(len(self)):
+            yield self[idx]
+
+    def to_list(self) -> List[Dict[str, Any]]:
+        return list(self)
+
+    def __repr__(self) -> str:
+        return f"MeasurementRecords(rows={self.array.shape[0]}, layout={self.layout!r})"
+
+
+def wrap_native_result(result: Any) -> Any:
+    """Wrap the array-valued fields of a native job result in record views.
+
+    Payloads that already carry Python lists (remote services, older
+    extensions, test doubles) are returned unchanged.
+    """
+
+    if not isinstance(result, MutableMapping):
+        return result
+    measurements = result.get("measurements")
+    if isinstance(measurements, Mapping) and "bits" in measurements:
+        result["measurements"] = MeasurementRecords(
+            measurements["bits"], measurements.get("layout", [])
+        )
+    for key in ("logs", "timeline", "scheduler_timeline"):
+        value = result.get(key)
+        if hasattr(value, "dtype") and getattr(value.dtype, "names", None):
+            result[key] = RecordArray(value)
+    return result
+
+
+def json_default(value: Any) -> Any:
+    """``json.dumps`` fallback for record views and NumPy values."""
+
+    if isinstance(value, (RecordArray, MeasurementRecords)):
+        return value.to_list()
+    if hasattr(value, "tolist"):
+        return value.tolist()
+    raise TypeError(f"Object of type {type(value).__name__} is not JSON serializable")
@@ -1,8 +1,9 @@
 from __future__ import annotations
 
+import json
 import logging
 import time
-from typing import Any, Callable, Mapping
+from typing import Any, Callable, Iterator, Mapping
 
 import requests
 from requests import RequestException
@@ -60,6 +61,32 @@ def submit_job_to_service(
     return _poll_result(result_url, timeout)
 
 
+def stream_job_from_service(
+    service_url: str,
+    job_id: str,
+    *,
+    timeout: float | int | None = 30.0,
+) -> Iterator[Mapping[str, Any]]:
+    """Yield shot batches of a remote job as the service streams them."""
+    stream_url = _job_item_url(service_url, job_id, "stream")
+    try:
+        response = requests.get(stream_url, stream=True, timeout=timeout)
+        response.raise_for_status()
+    except RequestException as exc:
+        logger.exception("Failed to open stream at %s", stream_url)
+        raise RemoteServiceError(f"failed to stream from {stream_url}: {exc}") from exc
+
+    with response:
+        for line in response.iter_lines():
+            if not line:
+                continue
+            try:
+                batch = json.loads(line)
+            except ValueError as exc:
+                raise RemoteServiceError("remote service streamed invalid JSON") from exc
+            yield batch
+
+
 def _poll_status(status_url: str, timeout: float | int | None) -> Mapping[str, Any]:
     while True:
         try:
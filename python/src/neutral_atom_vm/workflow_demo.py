@@ -8,6 +8,7 @@ from typing import Sequence
 from bloqade import squin
 
 from . import HardwareConfig, JobRequest, submit_job, to_vm_program
+from .records import json_default
 
 
 @squin.kernel
@@ -44,7 +45,7 @@ def run_demo(*, positions: Sequence[float] | None = None, blockade_radius: float
 
 def main():
     result = run_demo()
-    print(json.dumps(result, indent=2))
+    print(json.dumps(result, indent=2, default=json_default))
 
 
 if __name__ == "__main__":
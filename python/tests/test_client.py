@@ -34,6 +34,154 @@ def test_submit_job_accepts_job_request():
     assert result["measurements"][0]["bits"] == [0, 1]
 
 
+def test_submit_job_returns_numpy_measurements():
+    np = pytest.importorskip("numpy")
+    program = [
+        {"op": "AllocArray", "n_qubits": 2},
+        {"op": "ApplyGate", "name": "X", "targets": [1], "param": 0.0},
+        {"op": "Measure", "targets": [0, 1]},
+    ]
+    job = neutral_atom_vm.JobRequest(
+        program=program,
+        hardware=neutral_atom_vm.HardwareConfig(positions=[0.0, 1.0], blockade_radius=1.0),
+        device_id="state-vector",
+        profile=None,
+        shots=16,
+    )
+
+    result = neutral_atom_vm.submit_job(job)
+    measurements = result["measurements"]
+    assert isinstance(measurements, neutral_atom_vm.MeasurementRecords)
+    assert measurements.array.dtype == np.int8
+    assert measurements.array.shape == (16, 2)
+    assert measurements.layout == [[0, 1]]
+    assert (measurements.array == np.array([0, 1], dtype=np.int8)).all()
+    assert len(measurements) == 16
+    assert measurements[-1] == {"targets": [0, 1], "bits": [0, 1]}
+
+    logs = result["logs"]
+    assert isinstance(logs, neutral_atom_vm.RecordArray)
+    assert set(logs.array.dtype.names) == {"shot", "time", "category", "message"}
+    assert all(isinstance(entry["message"], str) for entry in logs)
+
+
+def test_submit_job_accepts_packed_program():
+    pytest.importorskip("numpy")
+    program = [
+        {"op": "AllocArray", "n_qubits": 2},
+        {"op": "ApplyGate", "name": "X", "targets": [1], "param": 0.0},
+        {"op": "Wait", "duration": 10.0},
+        {"op": "Measure", "targets": [0, 1]},
+    ]
+    hardware = neutral_atom_vm.HardwareConfig(positions=[0.0, 1.0], blockade_radius=1.0)
+    packed = neutral_atom_vm.pack_program(program)
+    assert packed["gates"] == ["X"]
+    assert packed["targets"].tolist() == [2, 1, 0, 1]
+
+    job = neutral_atom_vm.JobRequest(program=packed, hardware=hardware, shots=4)
+    result = neutral_atom_vm.submit_job(job)
+    assert result["status"] == "completed"
+    assert all(record["bits"] == [0, 1] for record in result["measurements"])
+
+    packed["targets"] = packed["targets"][:-1]
+    with pytest.raises(RuntimeError, match="packed program"):
+        neutral_atom_vm.submit_job(
+            neutral_atom_vm.JobRequest(program=packed, hardware=hardware, shots=1)
+        )
+
+
+def test_engine_session_steps_and_exposes_state_view():
+    np = pytest.importorskip("numpy")
+    program = [
+        {"op": "AllocArray", "n_qubits": 2},
+        {"op": "ApplyGate", "name": "H", "targets": [0], "param": 0.0},
+        {"op": "ApplyGate", "name": "CX", "targets": [0, 1], "param": 0.0},
+        {"op": "Measure", "targets": [0, 1]},
+    ]
+    job = neutral_atom_vm.JobRequest(
+        program=program,
+        hardware=neutral_atom_vm.HardwareConfig(positions=[0.0, 1.0], blockade_radius=1.5),
+        shots=1,
+        seed=5,
+    )
+    session = neutral_atom_vm.EngineSession(job)
+    assert session.step() == 1
+    assert session.n_qubits == 2
+
+    # Everything but the final Measure.
+    session.step(session.program_size - 2)
+    state = session.state_vector()
+    assert np.count_nonzero(np.abs(state) > 1e-9) == 2
+    # The view aliases the engine's amplitudes, so writes reach the engine.
+    state[:] = [1.0, 0.0, 0.0, 0.0]
+    with pytest.raises(RuntimeError, match="views"):
+        session.reset()
+    del state
+
+    session.run()
+    assert session.done
+    assert session.measurements[0]["bits"] == [0, 0]
+
+    session.reset()
+    assert session.position == 0
+    session.run()
+    expected = neutral_atom_vm.submit_job(job)["measurements"][0]["bits"]
+    assert session.measurements[0]["bits"] == expected
+
+
+def test_run_job_async_awaits_many_jobs_without_polling():
+    import asyncio
+
+    program = [
+        {"op": "AllocArray", "n_qubits": 1},
+        {"op": "ApplyGate", "name": "X", "targets": [0], "param": 0.0},
+        {"op": "Measure", "targets": [0]},
+    ]
+    job = neutral_atom_vm.JobRequest(
+        program=program,
+        hardware=neutral_atom_vm.HardwareConfig(positions=[0.0], blockade_radius=1.0),
+        shots=2,
+    )
+
+    async def main():
+        results = await asyncio.gather(*(neutral_atom_vm.run_job_async(job) for _ in range(32)))
+        # Awaiting a job that already finished resolves as well.
+        again = await neutral_atom_vm.job_future(results[0]["job_id"])
+        return results, again
+
+    results, again = asyncio.run(main())
+    assert len({result["job_id"] for result in results}) == 32
+    assert all(result["status"] == "completed" for result in results)
+    assert all(record["bits"] == [1] for record in results[0]["measurements"])
+    assert again["job_id"] == results[0]["job_id"]
+
+
+def test_submit_sweep_async_binds_each_parameter_set():
+    program = [
+        {"op": "AllocArray", "n_qubits": 1},
+        {"op": "ApplyGate", "name": "X", "targets": [0], "param": "theta"},
+        {"op": "Measure", "targets": [0]},
+    ]
+    job = neutral_atom_vm.JobRequest(
+        program=program,
+        hardware=neutral_atom_vm.HardwareConfig(positions=[0.0], blockade_radius=1.0),
+        shots=2,
+    )
+    angles = [0.1, 0.2, 0.3]
+    batch = neutral_atom_vm.submit_sweep_async(job, [{"theta": angle} for angle in angles])
+    assert len(batch["job_ids"]) == 3
+
+    results = {result["job_id"]: result for result in neutral_atom_vm.iter_batch_results(batch["batch_id"])}
+    for job_id, angle in zip(batch["job_ids"], angles):
+        details = [entry["detail"] for entry in results[job_id].scheduler_timeline]
+        assert any(f"param={angle}" in detail for detail in details)
+
+    with pytest.raises(ValueError, match="theta"):
+        neutral_atom_vm.submit_sweep_async(job, [{}])
+    with pytest.raises(ValueError, match="Symbolic"):
+        neutral_atom_vm.pack_program(program)
+
+
 def test_submit_job_preserves_job_id_roundtrip():
     program = [
         {"op": "AllocArray", "n_qubits": 1},
@@ -70,3 +70,26 @@ def test_repetition_code_metrics_counts_only_data_targets():
         rounds=1,
     )
     assert metrics["shots"] == shots
+
+
+def test_repetition_code_program_keeps_rounds_in_a_repeat_block():
+    short = qec.repetition_code_program(distance=3, rounds=2)
+    long = qec.repetition_code_program(distance=3, rounds=1000)
+    assert len(short) == len(long)
+    repeat = long[1]
+    assert repeat["op"] == "Repeat"
+    assert repeat["count"] == 1000
+    assert [instr["op"] for instr in repeat["body"]] == ["ApplyGate"] * 3 + ["Measure"]
+
+    result = qec.repetition_code_job(
+        distance=3,
+        rounds=4,
+        shots=4,
+        device_id="state-vector",
+        profile="lossy_block",
+        profile_noise=False,
+    )
+    ancilla_records = [
+        record for record in result["measurements"] if tuple(record["targets"]) == (3,)
+    ]
+    assert len(ancilla_records) == 4 * 4
@@ -3,12 +3,30 @@
 #include "noise.hpp"
 #include "service/job.hpp"
 #include "service/job_service.hpp"
+#include "service/packed_program.hpp"
+#include "service/result_cache.hpp"
+#include "service/shared_result.hpp"
+#include "trace.hpp"
 
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
 #include <stdexcept>
 #include <utility>
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 namespace py = pybind11;
 
 ConnectivityKind parse_connectivity(py::handle value) {
@@ -169,9 +187,15 @@ void fill_pulse_limits(const py::dict& src, PulseLimits& dst) {
 }
 namespace {
 
-Instruction instruction_from_dict(const py::dict& obj) {
+// Appends the instruction `obj` describes. A Repeat gives "body_size" and
+// is followed by its body; the Python layer flattens nested "body" lists.
+void append_instruction_from_dict(const py::dict& obj, Program& out) {
     const std::string op = py::cast<std::string>(obj["op"]);
     Instruction instr;
+    if (op == "Repeat") {
+        out.push_back({Op::Repeat, RepeatInstruction{py::cast<int>(obj["count"]), py::cast<int>(obj["body_size"])}});
+        return;
+    }
     if (op == "AllocArray") {
         instr.op = Op::AllocArray;
         instr.payload = py::cast<int>(obj["n_qubits"]);
@@ -180,13 +204,15 @@ Instruction instruction_from_dict(const py::dict& obj) {
         Gate gate;
         gate.name = py::cast<std::string>(obj["name"]);
         gate.targets = py::cast<std::vector<int>>(obj["targets"]);
-        if (obj.contains("param")) {
+        if (obj.contains("param") && py::isinstance<py::str>(obj["param"])) {
+            gate.symbol = py::cast<std::string>(obj["param"]);
+        } else if (obj.contains("param")) {
             gate.param = py::cast<double>(obj["param"]);
         }
         instr.payload = gate;
     } else if (op == "Measure") {
-        instr.op = Op::Measure;
-        instr.payload = py::cast<std::vector<int>>(obj["targets"]);
+        out.push_measure(py::cast<std::vector<int>>(obj["targets"]));
+        return;
     } else if (op == "MoveAtom") {
         instr.op = Op::MoveAtom;
         MoveAtomInstruction move;
@@ -208,71 +234,297 @@ Instruction instruction_from_dict(const py::dict& obj) {
     } else {
         throw std::runtime_error("Unsupported op: " + op);
     }
-    return instr;
+    out.push_back(std::move(instr));
 }
 
-std::vector<Instruction> instructions_from_list(const py::list& program) {
-    std::vector<Instruction> out;
+Program instructions_from_list(const py::list& program) {
+    Program out;
     out.reserve(py::len(program));
     for (const auto& item : program) {
-        out.push_back(instruction_from_dict(py::cast<py::dict>(item)));
+        append_instruction_from_dict(py::cast<py::dict>(item), out);
     }
     return out;
 }
 
-py::dict job_result_to_dict(const service::JobResult& result) {
+// 1-D C-contiguous view of a buffer whose items are `T`, e.g. a NumPy array
+// with a structured dtype laid out like `T`. The view lives as long as `info`.
+template <typename T>
+std::span<const T> contiguous_items(const py::buffer_info& info, const char* what) {
+    if (info.ndim != 1 || info.itemsize != static_cast<py::ssize_t>(sizeof(T)) ||
+        (info.shape[0] > 1 && info.strides[0] != info.itemsize)) {
+        throw std::runtime_error(std::string("packed program: '") + what + "' must be a contiguous 1-D array of " +
+                                 std::to_string(sizeof(T)) + "-byte items");
+    }
+    return {static_cast<const T*>(info.ptr), static_cast<std::size_t>(info.shape[0])};
+}
+
+// Packed program given as {"gates": [...], "instructions": <buffer of
+// PackedInstruction>, "targets": <int32 buffer>}; see
+// service/packed_program.hpp. Only the gate table is read through Python.
+Program instructions_from_packed(const py::dict& packed) {
+    const auto gates = py::cast<std::vector<std::string>>(packed["gates"]);
+    const py::buffer_info instructions = py::cast<py::buffer>(packed["instructions"]).request();
+    const py::buffer_info targets = py::cast<py::buffer>(packed["targets"]).request();
+    if (targets.format.empty() || (targets.format.back() != 'i' && targets.format.back() != 'l')) {
+        throw std::runtime_error("packed program: 'targets' must hold int32 values");
+    }
+    const service::PackedProgramView view{
+        gates,
+        contiguous_items<service::PackedInstruction>(instructions, "instructions"),
+        contiguous_items<std::int32_t>(targets, "targets"),
+    };
+    py::gil_scoped_release release;
+    return service::unpack_program(view);
+}
+
+// Packed program in its encode_packed_program() wire form.
+Program instructions_from_wire(const py::buffer& buffer) {
+    const py::buffer_info info = buffer.request();
+    const auto bytes = contiguous_items<char>(info, "program");
+    py::gil_scoped_release release;
+    return service::unpack_program(
+        service::decode_packed_program(std::string_view(bytes.data(), bytes.size())).view());
+}
+
+py::dict stage_timing_to_dict(const service::StageTiming& timing) {
+    py::dict out;
+    out["wall_seconds"] = timing.wall_seconds;
+    out["cpu_seconds"] = timing.cpu_seconds;
+    return out;
+}
+
+py::dict hardware_counters_to_dict(const HardwareCounters& counters) {
+    py::dict out;
+    out["cycles"] = counters.cycles;
+    out["instructions"] = counters.instructions;
+    out["cache_references"] = counters.cache_references;
+    out["cache_misses"] = counters.cache_misses;
+    return out;
+}
+
+py::dict job_profile_to_dict(const service::JobProfile& profile) {
+    py::dict stages;
+    stages["enrich"] = stage_timing_to_dict(profile.enrich);
+    stages["validate"] = stage_timing_to_dict(profile.validate);
+    stages["schedule"] = stage_timing_to_dict(profile.schedule);
+    stages["simulate"] = stage_timing_to_dict(profile.simulate);
+    stages["convert"] = stage_timing_to_dict(profile.convert);
+    py::dict out;
+    out["stages"] = stages;
+    out["peak_statevector_bytes"] = profile.peak_statevector_bytes;
+    out["amplitude_updates"] = profile.amplitude_updates;
+    out["shots_per_second"] = profile.shots_per_second;
+    out["threads"] = profile.threads;
+    out["backend"] = profile.backend;
+    out["cache_hit"] = profile.cache_hit;
+    py::dict counters = hardware_counters_to_dict(profile.counters);
+    counters["available"] = profile.counters.available;
+    counters["memory_bandwidth_bytes_per_second"] = profile.memory_bandwidth_bytes_per_second;
+    py::dict kernels;
+    for (const auto& [name, kernel] : profile.kernels) {
+        py::dict entry = hardware_counters_to_dict(kernel.counters);
+        entry["calls"] = kernel.calls;
+        kernels[py::str(name)] = entry;
+    }
+    counters["kernels"] = kernels;
+    out["hardware_counters"] = counters;
+    return out;
+}
+
+// Records in one row of the measurement array: one shot when `shots`
+// divides the records and every shot measures the same targets, otherwise
+// the shortest repeating run of records (the whole job when none repeats).
+std::size_t records_per_row(const std::vector<MeasurementRecord>& records, std::size_t shots) {
+    const std::size_t count = records.size();
+    auto repeats_every = [&](std::size_t period) {
+        for (std::size_t idx = period; idx < count; ++idx) {
+            if (records[idx].targets != records[idx - period].targets) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (shots > 0 && count % shots == 0 && repeats_every(count / shots)) {
+        return count / shots;
+    }
+    for (std::size_t period = 1; period < count; ++period) {
+        if (count % period == 0 && repeats_every(period)) {
+            return period;
+        }
+    }
+    return count;
+}
+
+// {"bits": int8 array of shape (rows, bits per row) with -1 for lost atoms,
+// "layout": the targets of each record of a row}. No Python object is made
+// per shot; the copy runs without the GIL.
+py::dict measurements_to_arrays(const std::vector<MeasurementRecord>& records, std::size_t shots) {
+    const std::size_t per_row = records_per_row(records, shots);
+    const std::size_t rows = per_row == 0 ? 0 : records.size() / per_row;
+    py::list layout;
+    std::size_t width = 0;
+    for (std::size_t idx = 0; idx < per_row; ++idx) {
+        layout.append(py::cast(records[idx].targets));
+        width += records[idx].bits.size();
+    }
+    py::array_t<std::int8_t> bits(std::vector<py::ssize_t>{
+        static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(width)});
+    std::int8_t* out = bits.mutable_data();
+    {
+        py::gil_scoped_release release;
+        for (const auto& record : records) {
+            for (const int bit : record.bits) {
+                *out++ = static_cast<std::int8_t>(bit);
+            }
+        }
+    }
+    py::dict result;
+    result["bits"] = bits;
+    result["layout"] = layout;
+    return result;
+}
+
+std::size_t utf8_length(const std::string& text) {
+    return static_cast<std::size_t>(std::count_if(text.begin(), text.end(), [](char byte) {
+        return (static_cast<unsigned char>(byte) & 0xC0) != 0x80;
+    }));
+}
+
+// Decode UTF-8 into a zeroed NumPy 'U' field (UCS-4 code units). Malformed
+// sequences become U+FFFD.
+void put_ucs4(char* field, const std::string& text) {
+    std::size_t idx = 0;
+    while (idx < text.size()) {
+        const auto lead = static_cast<unsigned char>(text[idx]);
+        std::size_t extra = lead < 0x80 ? 0 : lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 4;
+        std::uint32_t code = extra == 0 ? lead : extra == 1 ? lead & 0x1F : extra == 2 ? lead & 0x0F : lead & 0x07;
+        bool valid = extra < 4 && idx + extra < text.size();
+        for (std::size_t k = 1; valid && k <= extra; ++k) {
+            const auto byte = static_cast<unsigned char>(text[idx + k]);
+            valid = (byte & 0xC0) == 0x80;
+            code = (code << 6) | (byte & 0x3F);
+        }
+        if (!valid) {
+            code = 0xFFFD;
+            extra = 0;
+        }
+        std::memcpy(field, &code, sizeof(code));
+        field += sizeof(code);
+        idx += extra + 1;
+    }
+}
+
+std::string unicode_format(std::size_t width) {
+    return "<U" + std::to_string(std::max<std::size_t>(width, 1));
+}
+
+// Zeroed NumPy structured array; fields are (name, numpy format) pairs.
+py::array structured_array(std::size_t rows, const std::vector<std::pair<const char*, std::string>>& fields) {
+    py::list spec;
+    for (const auto& [name, format] : fields) {
+        spec.append(py::make_tuple(name, format));
+    }
+    py::array out(py::dtype::from_args(spec), std::vector<py::ssize_t>{static_cast<py::ssize_t>(rows)});
+    std::memset(out.mutable_data(), 0, static_cast<std::size_t>(out.nbytes()));
+    return out;
+}
+
+std::size_t field_offset(const py::array& array, const char* name) {
+    return py::cast<std::size_t>(py::cast<py::tuple>(array.dtype().attr("fields")[name])[1]);
+}
+
+// Structured array with fields shot (int32), time (float64), category and
+// message (unicode, as wide as the longest value).
+py::array logs_to_array(const std::vector<ExecutionLog>& logs) {
+    std::size_t category_width = 0;
+    std::size_t message_width = 0;
+    for (const auto& entry : logs) {
+        category_width = std::max(category_width, utf8_length(entry.category));
+        message_width = std::max(message_width, utf8_length(entry.message));
+    }
+    py::array out = structured_array(logs.size(), {
+        {"shot", "<i4"},
+        {"time", "<f8"},
+        {"category", unicode_format(category_width)},
+        {"message", unicode_format(message_width)},
+    });
+    const std::size_t stride = static_cast<std::size_t>(out.itemsize());
+    const std::size_t shot = field_offset(out, "shot");
+    const std::size_t time = field_offset(out, "time");
+    const std::size_t category = field_offset(out, "category");
+    const std::size_t message = field_offset(out, "message");
+    char* row = static_cast<char*>(out.mutable_data());
+    py::gil_scoped_release release;
+    for (const auto& entry : logs) {
+        const std::int32_t shot_value = entry.shot;
+        std::memcpy(row + shot, &shot_value, sizeof(shot_value));
+        std::memcpy(row + time, &entry.logical_time, sizeof(entry.logical_time));
+        put_ucs4(row + category, entry.category);
+        put_ucs4(row + message, entry.message);
+        row += stride;
+    }
+    return out;
+}
+
+// Structured array with fields start_time, duration (float64), op and
+// detail (unicode).
+py::array timeline_to_array(const std::vector<TimelineEntry>& timeline) {
+    std::size_t op_width = 0;
+    std::size_t detail_width = 0;
+    for (const auto& entry : timeline) {
+        op_width = std::max(op_width, utf8_length(entry.op));
+        detail_width = std::max(detail_width, utf8_length(entry.detail));
+    }
+    py::array out = structured_array(timeline.size(), {
+        {"start_time", "<f8"},
+        {"duration", "<f8"},
+        {"op", unicode_format(op_width)},
+        {"detail", unicode_format(detail_width)},
+    });
+    const std::size_t stride = static_cast<std::size_t>(out.itemsize());
+    const std::size_t start_time = field_offset(out, "start_time");
+    const std::size_t duration = field_offset(out, "duration");
+    const std::size_t op = field_offset(out, "op");
+    const std::size_t detail = field_offset(out, "detail");
+    char* row = static_cast<char*>(out.mutable_data());
+    py::gil_scoped_release release;
+    for (const auto& entry : timeline) {
+        std::memcpy(row + start_time, &entry.start_time, sizeof(entry.start_time));
+        std::memcpy(row + duration, &entry.duration, sizeof(entry.duration));
+        put_ucs4(row + op, entry.op);
+        put_ucs4(row + detail, entry.detail);
+        row += stride;
+    }
+    return out;
+}
+
+// Measurements, logs and timelines come back as NumPy arrays (see
+// measurements_to_arrays, logs_to_array and timeline_to_array); the Python
+// package wraps them in record views. `shots` (0 when unknown) shapes the
+// measurement array.
+py::dict job_result_to_dict(const service::JobResult& result, std::size_t shots = 0) {
     py::dict out;
     out["job_id"] = result.job_id;
     out["status"] = service::status_to_string(result.status);
     out["elapsed_time"] = result.elapsed_time;
-    py::list measurements;
-    for (const auto& record : result.measurements) {
-        py::dict rec;
-        rec["targets"] = record.targets;
-        rec["bits"] = record.bits;
-        measurements.append(rec);
-    }
-    out["measurements"] = measurements;
+    out["measurements"] = measurements_to_arrays(result.measurements, shots);
     out["message"] = result.message;
     if (!result.log_time_units.empty()) {
         out["log_time_units"] = result.log_time_units;
     }
-    py::list log_list;
-    for (const auto& entry : result.logs) {
-        py::dict log;
-        log["shot"] = entry.shot;
-        log["time"] = entry.logical_time;
-        log["category"] = entry.category;
-        log["message"] = entry.message;
-        log_list.append(log);
-    }
-    out["logs"] = log_list;
+    out["logs"] = logs_to_array(result.logs);
     if (!result.timeline_units.empty()) {
         out["timeline_units"] = result.timeline_units;
     }
-    py::list timeline_list;
-    for (const auto& entry : result.timeline) {
-        py::dict item;
-        item["start_time"] = entry.start_time;
-        item["duration"] = entry.duration;
-        item["op"] = entry.op;
-        item["detail"] = entry.detail;
-        timeline_list.append(item);
-    }
-    out["timeline"] = timeline_list;
+    out["timeline"] = timeline_to_array(result.timeline);
     if (!result.scheduler_timeline_units.empty()) {
         out["scheduler_timeline_units"] = result.scheduler_timeline_units;
     }
-    py::list scheduler_timeline_list;
-    for (const auto& entry : result.scheduler_timeline) {
-        py::dict item;
-        item["start_time"] = entry.start_time;
-        item["duration"] = entry.duration;
-        item["op"] = entry.op;
-        item["detail"] = entry.detail;
-        scheduler_timeline_list.append(item);
+    out["scheduler_timeline"] = timeline_to_array(result.scheduler_timeline);
+    if (!result.metadata.empty()) {
+        out["metadata"] = result.metadata;
     }
-    out["scheduler_timeline"] = scheduler_timeline_list;
+    out["profile"] = job_profile_to_dict(result.profile);
     return out;
 }
 
@@ -384,6 +636,47 @@ void fill_amplitude_damping_config(
     }
 }
 
+SimpleNoiseConfig noise_config_from_dict(const py::dict& noise) {
+    SimpleNoiseConfig cfg;
+    if (noise.contains("p_quantum_flip")) {
+        cfg.p_quantum_flip = py::cast<double>(noise["p_quantum_flip"]);
+    }
+    if (noise.contains("p_loss")) {
+        cfg.p_loss = py::cast<double>(noise["p_loss"]);
+    }
+    if (noise.contains("readout")) {
+        fill_measurement_noise_config(py::cast<py::dict>(noise["readout"]), cfg.readout);
+    }
+    if (noise.contains("gate")) {
+        fill_gate_noise_config(py::cast<py::dict>(noise["gate"]), cfg.gate);
+    }
+    if (noise.contains("correlated_gate")) {
+        fill_correlated_gate_config(
+            py::cast<py::dict>(noise["correlated_gate"]),
+            cfg.correlated_gate
+        );
+    }
+    if (noise.contains("idle_rate")) {
+        cfg.idle_rate = py::cast<double>(noise["idle_rate"]);
+    }
+    if (noise.contains("phase")) {
+        fill_phase_noise_config(py::cast<py::dict>(noise["phase"]), cfg.phase);
+    }
+    if (noise.contains("amplitude_damping")) {
+        fill_amplitude_damping_config(
+            py::cast<py::dict>(noise["amplitude_damping"]),
+            cfg.amplitude_damping
+        );
+    }
+    if (noise.contains("loss_runtime")) {
+        fill_loss_runtime_config(
+            py::cast<py::dict>(noise["loss_runtime"]),
+            cfg.loss_runtime
+        );
+    }
+    return cfg;
+}
+
 service::JobRequest build_job_request(const py::dict& job_obj) {
     service::JobRequest job;
 
@@ -403,8 +696,14 @@ service::JobRequest build_job_request(const py::dict& job_obj) {
         job.profile = py::cast<std::string>(job_obj["profile"]);
     }
 
-    const auto program = py::cast<py::list>(job_obj["program"]);
-    job.program = instructions_from_list(program);
+    const py::object program = job_obj["program"];
+    if (py::isinstance<py::dict>(program)) {
+        job.program = instructions_from_packed(py::cast<py::dict>(program));
+    } else if (py::isinstance<py::buffer>(program)) {
+        job.program = instructions_from_wire(py::cast<py::buffer>(program));
+    } else {
+        job.program = instructions_from_list(py::cast<py::list>(program));
+    }
 
     if (job_obj.contains("hardware")) {
         const auto hardware = py::cast<py::dict>(job_obj["hardware"]);
@@ -498,52 +797,24 @@ service::JobRequest build_job_request(const py::dict& job_obj) {
         job.stim_circuit = py::cast<std::string>(job_obj["stim_circuit"]);
     }
 
+    if (job_obj.contains("seed") && !job_obj["seed"].is_none()) {
+        job.seed = py::cast<std::uint64_t>(job_obj["seed"]);
+    }
+
     if (job_obj.contains("noise")) {
-        const auto noise = py::cast<py::dict>(job_obj["noise"]);
-        SimpleNoiseConfig cfg;
-        if (noise.contains("p_quantum_flip")) {
-            cfg.p_quantum_flip = py::cast<double>(noise["p_quantum_flip"]);
-        }
-        if (noise.contains("p_loss")) {
-            cfg.p_loss = py::cast<double>(noise["p_loss"]);
-        }
-        if (noise.contains("readout")) {
-            fill_measurement_noise_config(py::cast<py::dict>(noise["readout"]), cfg.readout);
-        }
-        if (noise.contains("gate")) {
-            fill_gate_noise_config(py::cast<py::dict>(noise["gate"]), cfg.gate);
-        }
-        if (noise.contains("correlated_gate")) {
-            fill_correlated_gate_config(
-                py::cast<py::dict>(noise["correlated_gate"]),
-                cfg.correlated_gate
-            );
-        }
-        if (noise.contains("idle_rate")) {
-            cfg.idle_rate = py::cast<double>(noise["idle_rate"]);
-        }
-        if (noise.contains("phase")) {
-            fill_phase_noise_config(py::cast<py::dict>(noise["phase"]), cfg.phase);
-        }
-        if (noise.contains("amplitude_damping")) {
-            fill_amplitude_damping_config(
-                py::cast<py::dict>(noise["amplitude_damping"]),
-                cfg.amplitude_damping
-            );
-        }
-        if (noise.contains("loss_runtime")) {
-            fill_loss_runtime_config(
-                py::cast<py::dict>(noise["loss_runtime"]),
-                cfg.loss_runtime
-            );
-        }
-        job.noise_config = cfg;
+        job.noise_config = noise_config_from_dict(py::cast<py::dict>(job_obj["noise"]));
+    }
+
+    if (job_obj.contains("parameters") && !job_obj["parameters"].is_none()) {
+        job.parameters = py::cast<service::ParameterSet>(job_obj["parameters"]);
     }
 
     return job;
 }
 
 service::JobService job_service;
+std::shared_ptr<service::ResultCache> result_cache;
+CounterScope counter_scope = CounterScope::kOff;
 
 py::dict execution_log_to_dict(const ExecutionLog& entry) {
     py::dict log;
@@ -557,18 +828,189 @@ py::dict execution_log_to_dict(const ExecutionLog& entry) {
 py::dict submit_job(const py::dict& job_obj) {
     service::JobRequest job = build_job_request(job_obj);
     service::JobRunner runner;
-    auto result = runner.run(job);
-    return job_result_to_dict(result);
+    runner.set_result_cache(result_cache);
+    runner.set_counter_scope(counter_scope);
+    service::JobResult result;
+    {
+        py::gil_scoped_release release;
+        result = runner.run(job);
+    }
+    return job_result_to_dict(result, static_cast<std::size_t>(std::max(0, job.shots)));
 }
 
 py::dict submit_job_async(const py::dict& job_obj) {
     service::JobRequest job = build_job_request(job_obj);
-    const std::string job_id = job_service.submit(job, job.max_threads);
+    std::string job_id;
+    {
+        py::gil_scoped_release release;
+        const std::size_t max_threads = job.max_threads;
+        job_id = job_service.submit(std::move(job), max_threads);
+    }
     py::dict out;
     out["job_id"] = job_id;
     return out;
 }
 
+service::JobOverride job_override_from_dict(const py::dict& item) {
+    service::JobOverride out;
+    if (item.contains("seed") && !item["seed"].is_none()) {
+        out.seed = py::cast<std::uint64_t>(item["seed"]);
+    }
+    if (item.contains("shots") && !item["shots"].is_none()) {
+        out.shots = py::cast<int>(item["shots"]);
+    }
+    if (item.contains("noise") && !item["noise"].is_none()) {
+        out.noise_config = noise_config_from_dict(py::cast<py::dict>(item["noise"]));
+    }
+    if (item.contains("gate_params")) {
+        for (const auto& [index, param] : py::cast<py::dict>(item["gate_params"])) {
+            out.gate_params.push_back(
+                service::GateParamBinding{py::cast<std::size_t>(index), py::cast<double>(param)});
+        }
+    }
+    if (item.contains("parameters")) {
+        out.parameters = py::cast<service::ParameterSet>(item["parameters"]);
+    }
+    return out;
+}
+
+py::dict submit_batch_async(const py::dict& job_obj, const py::list& overrides) {
+    service::JobRequest base = build_job_request(job_obj);
+    std::vector<service::JobOverride> items;
+    items.reserve(overrides.size());
+    for (const auto& item : overrides) {
+        items.push_back(job_override_from_dict(py::cast<py::dict>(item)));
+    }
+    const std::size_t max_threads = base.max_threads;
+    const service::BatchSubmission batch = job_service.submit_batch(std::move(base), items, max_threads);
+    py::dict out;
+    out["batch_id"] = batch.batch_id;
+    out["job_ids"] = batch.job_ids;
+    return out;
+}
+
+py::dict batch_status(const std::string& batch_id) {
+    const service::BatchStatus status = job_service.batch_status(batch_id);
+    py::dict out;
+    out["batch_id"] = batch_id;
+    out["total"] = status.total;
+    out["finished"] = status.finished;
+    out["failed"] = status.failed;
+    out["message"] = status.message;
+    return out;
+}
+
+py::list batch_results(const std::string& batch_id, std::size_t cursor) {
+    std::vector<service::JobResult> results;
+    {
+        py::gil_scoped_release release;
+        results = job_service.batch_results(batch_id, cursor);
+    }
+    py::list out;
+    for (const auto& result : results) {
+        out.append(job_result_to_dict(result));
+    }
+    return out;
+}
+
+// Same {"bits", "layout"} form as measurements_to_arrays with one row per
+// streamed shot. Shots whose records differ from the first shot's targets
+// (conditional measurements) fall back to the period detection over the
+// concatenated records.
+py::dict shot_rows_to_arrays(const std::vector<service::ShotRecord>& shots) {
+    const auto same_layout = [&](const service::ShotRecord& shot) {
+        const auto& first = shots.front().measurements;
+        if (shot.measurements.size() != first.size()) {
+            return false;
+        }
+        for (std::size_t idx = 0; idx < first.size(); ++idx) {
+            if (shot.measurements[idx].targets != first[idx].targets ||
+                shot.measurements[idx].bits.size() != first[idx].bits.size()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (shots.empty() || !std::all_of(shots.begin(), shots.end(), same_layout)) {
+        std::vector<MeasurementRecord> records;
+        for (const auto& shot : shots) {
+            records.insert(records.end(), shot.measurements.begin(), shot.measurements.end());
+        }
+        return measurements_to_arrays(records, shots.size());
+    }
+    py::list layout;
+    std::size_t width = 0;
+    for (const auto& record : shots.front().measurements) {
+        layout.append(py::cast(record.targets));
+        width += record.bits.size();
+    }
+    py::array_t<std::int8_t> bits(std::vector<py::ssize_t>{
+        static_cast<py::ssize_t>(shots.size()), static_cast<py::ssize_t>(width)});
+    std::int8_t* out = bits.mutable_data();
+    {
+        py::gil_scoped_release release;
+        for (const auto& shot : shots) {
+            for (const auto& record : shot.measurements) {
+                for (const int bit : record.bits) {
+                    *out++ = static_cast<std::int8_t>(bit);
+                }
+            }
+        }
+    }
+    py::dict result;
+    result["bits"] = bits;
+    result["layout"] = layout;
+    return result;
+}
+
+py::dict shot_batch_to_dict(const service::ShotBatch& batch) {
+    py::array_t<std::int64_t> indices(static_cast<py::ssize_t>(batch.shots.size()));
+    std::int64_t* index = indices.mutable_data();
+    for (const auto& shot : batch.shots) {
+        *index++ = shot.shot;
+    }
+    py::dict out;
+    out["shots"] = indices;
+    out["measurements"] = shot_rows_to_arrays(batch.shots);
+    out["counts"] = batch.counts;
+    out["coalesced_shots"] = batch.coalesced_shots;
+    out["completed_shots"] = batch.completed_shots;
+    out["total_shots"] = batch.total_shots;
+    return out;
+}
+
+std::unique_ptr<service::ShotSubscription> subscribe_job(
+    const std::string& job_id,
+    std::size_t capacity
+) {
+    auto subscription = job_service.subscribe(job_id, capacity);
+    if (!subscription) {
+        throw std::runtime_error("job_id not found");
+    }
+    return std::make_unique<service::ShotSubscription>(std::move(*subscription));
+}
+
+py::dict next_shot_batch(service::ShotSubscription& subscription, std::size_t max_shots) {
+    // Wait in short slices with the GIL released so other Python threads keep
+    // running and Ctrl-C is honoured while the job is producing shots.
+    while (true) {
+        std::optional<service::ShotBatch> batch;
+        {
+            py::gil_scoped_release release;
+            batch = subscription.next(std::chrono::milliseconds(100), max_shots);
+        }
+        if (!batch) {
+            throw py::stop_iteration();
+        }
+        if (!batch->shots.empty()) {
+            return shot_batch_to_dict(*batch);
+        }
+        if (PyErr_CheckSignals() != 0) {
+            throw py::error_already_set();
+        }
+    }
+}
+
 py::dict job_status(const std::string& job_id) {
     const service::JobStatusSnapshot snapshot = job_service.status(job_id);
     py::dict out;
@@ -585,13 +1027,306 @@ py::dict job_status(const std::string& job_id) {
 }
 
 py::dict job_result(const std::string& job_id) {
-    const auto result = job_service.poll_result(job_id);
+    std::optional<service::JobResult> result;
+    {
+        py::gil_scoped_release release;
+        result = job_service.poll_result(job_id);
+    }
     if (!result) {
         throw std::runtime_error("job result not available yet");
     }
+    service::ScopedTimer timer(&job_service.job_metrics()->serialize_seconds);
     return job_result_to_dict(*result);
 }
 
+using SegmentHandle = std::shared_ptr<service::SharedResultSegment>;
+
+// One bit plane of a result segment. Holding it keeps the segment mapped,
+// so buffers exported from it stay valid after the segment object is gone.
+struct ResultPlane {
+    SegmentHandle segment;
+    bool lost = false;
+
+    std::span<const std::uint64_t> words() const { return lost ? segment->lost() : segment->values(); }
+};
+
+py::buffer_info plane_buffer(const ResultPlane& plane) {
+    const auto words = plane.words();
+    return py::buffer_info(
+        const_cast<std::uint64_t*>(words.data()),
+        sizeof(std::uint64_t),
+        py::format_descriptor<std::uint64_t>::format(),
+        1,
+        {static_cast<py::ssize_t>(words.size())},
+        {static_cast<py::ssize_t>(sizeof(std::uint64_t))},
+        true
+    );
+}
+
+py::object job_result_segment(const std::string& job_id) {
+    auto segment = job_service.result_segment(job_id);
+    if (!segment) {
+        return py::none();
+    }
+    return py::cast(std::const_pointer_cast<service::SharedResultSegment>(std::move(segment)));
+}
+
+SegmentHandle open_result_segment(const std::string& name) {
+    return service::SharedResultSegment::open(name);
+}
+
+std::string metrics_text() {
+    return job_service.render_metrics();
+}
+
+void start_trace(std::size_t events_per_thread) {
+    neutral_atom_vm::trace::start(events_per_thread);
+}
+
+// Stops tracing and returns the recorded spans as Chrome trace JSON.
+std::string stop_trace() {
+    neutral_atom_vm::trace::stop();
+    py::gil_scoped_release release;
+    return neutral_atom_vm::trace::chrome_trace_json();
+}
+
+void set_tenant_policy(
+    const std::string& tenant,
+    double weight,
+    std::size_t max_threads,
+    std::size_t max_memory_bytes,
+    std::size_t max_queued_jobs
+) {
+    service::TenantPolicy policy;
+    policy.weight = weight;
+    policy.max_threads = max_threads;
+    policy.max_memory_bytes = max_memory_bytes;
+    policy.max_queued_jobs = max_queued_jobs;
+    job_service.set_tenant_policy(tenant, policy);
+}
+
+void configure_result_cache(
+    std::size_t memory_budget_bytes,
+    const std::string& disk_directory,
+    std::size_t disk_budget_bytes
+) {
+    service::ResultCacheOptions options;
+    options.memory_budget_bytes = memory_budget_bytes;
+    options.disk_directory = disk_directory;
+    options.disk_budget_bytes = disk_budget_bytes;
+    result_cache = std::make_shared<service::ResultCache>(options);
+    job_service.set_result_cache(result_cache);
+}
+
+// Returns whether this process can read the counters at all.
+bool configure_hardware_counters(const std::string& scope) {
+    counter_scope = parse_counter_scope(scope);
+    job_service.set_counter_scope(counter_scope);
+    return hardware_counters_supported();
+}
+
+py::dict result_cache_stats() {
+    py::dict out;
+    out["enabled"] = static_cast<bool>(result_cache);
+    if (!result_cache) {
+        return out;
+    }
+    const service::ResultCacheStats stats = result_cache->stats();
+    out["memory_hits"] = stats.memory_hits;
+    out["disk_hits"] = stats.disk_hits;
+    out["misses"] = stats.misses;
+    out["stores"] = stats.stores;
+    out["evictions"] = stats.evictions;
+    out["memory_entries"] = stats.memory_entries;
+    out["memory_bytes"] = stats.memory_bytes;
+    out["disk_entries"] = stats.disk_entries;
+    out["disk_bytes"] = stats.disk_bytes;
+    return out;
+}
+
+// Wakes an event loop when watched jobs finish. Completion callbacks queue
+// the job ID and write to an eventfd, which an asyncio loop watches with
+// add_reader; drain() then returns the finished IDs. One notifier serves
+// any number of in-flight jobs without polling. The queue and the eventfd
+// are shared with pending callbacks, so they outlive the notifier.
+class CompletionNotifier {
+  public:
+    CompletionNotifier() : shared_(std::make_shared<Shared>()) {}
+
+    int fileno() const { return shared_->fd; }
+
+    void watch(const std::string& job_id) {
+        bool known = false;
+        {
+            py::gil_scoped_release release;
+            known = job_service.on_completion(
+                job_id, [shared = shared_](const std::string& id, service::JobStatus) { shared->push(id); });
+        }
+        if (!known) {
+            throw std::runtime_error("job_id not found");
+        }
+    }
+
+    std::vector<std::string> drain() {
+        std::uint64_t count = 0;
+        while (::read(shared_->fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+        }
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        std::vector<std::string> ready;
+        ready.swap(shared_->ready);
+        return ready;
+    }
+
+  private:
+    struct Shared {
+        Shared() : fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+            if (fd < 0) {
+                throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+            }
+        }
+        ~Shared() { ::close(fd); }
+
+        void push(const std::string& job_id) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready.push_back(job_id);
+            }
+            const std::uint64_t one = 1;
+            while (::write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+            }
+        }
+
+        int fd;
+        std::mutex mutex;
+        std::vector<std::string> ready;
+    };
+
+    std::shared_ptr<Shared> shared_;
+};
+
+// One shot of a job on a StatevectorEngine, driven from Python. The job dict
+// is compiled like submit_job (enrich, validate, schedule); the scheduled
+// program is then stepped through or run to the end. state_vector() aliases
+// the engine's amplitudes without copying. AllocArray and reset() would
+// reallocate them, so both refuse to run while such views are alive.
+class EngineSession {
+  public:
+    explicit EngineSession(const py::dict& job_obj) {
+        const service::JobRequest job = build_job_request(job_obj);
+        {
+            py::gil_scoped_release release;
+            compiled_ = service::JobRunner().compile(job);
+        }
+        if (compiled_.profile.backend != BackendKind::kCpu) {
+            throw std::runtime_error("engine sessions need the statevector backend");
+        }
+        noise_ = job.noise_config ? std::make_shared<SimpleNoiseEngine>(*job.noise_config)
+                                  : compiled_.profile.noise_engine;
+        // Shot 0 of the seeded job, so a session reproduces submit_job.
+        seed_ = job.seed ? service::derive_shot_seeds(*job.seed, 0, 1).front() : std::random_device{}();
+        reset();
+    }
+
+    void reset() {
+        require_no_views("reset");
+        engine_ = std::make_unique<StatevectorEngine>(compiled_.profile.hardware, nullptr, seed_);
+        if (noise_) {
+            engine_->set_noise_model(noise_);
+        }
+        position_ = 0;
+    }
+
+    // Execute up to `count` instructions; returns how many ran. An
+    // instruction that throws is not counted, so position() points at it.
+    // A Repeat block runs as a whole, so a step that reaches one may run
+    // more than `count` instructions.
+    std::size_t step(std::size_t count) {
+        if (running_) {
+            throw std::runtime_error("engine session is already running");
+        }
+        const auto& program = compiled_.scheduled.program;
+        const std::size_t first = position_;
+        const std::size_t limit = first + std::min(count, program.size() - first);
+        std::size_t end = first;
+        while (end < limit) {
+            end = unit_end(end);
+        }
+        for (std::size_t idx = first; idx < end; ++idx) {
+            if (program[idx].op == Op::AllocArray) {
+                require_no_views("execute AllocArray");
+            }
+        }
+        running_ = true;
+        try {
+            py::gil_scoped_release release;
+            while (position_ < end) {
+                const std::size_t next = unit_end(position_);
+                engine_->step(ProgramView(program).subspan(position_, next - position_));
+                position_ = next;
+            }
+        } catch (...) {
+            running_ = false;
+            throw;
+        }
+        running_ = false;
+        return end - first;
+    }
+
+    std::size_t run() { return step(compiled_.scheduled.program.size() - position_); }
+
+    py::array state_vector(const py::object& self) {
+        auto& amplitudes = engine_->state_vector();
+        ++views_;
+        // The capsule keeps the session alive for as long as the view.
+        auto* owner = new py::object(self);
+        py::capsule base(owner, [](void* ptr) {
+            auto* session = static_cast<py::object*>(ptr);
+            --py::cast<EngineSession&>(*session).views_;
+            delete session;
+        });
+        return py::array_t<std::complex<double>>(
+            {static_cast<py::ssize_t>(amplitudes.size())},
+            {static_cast<py::ssize_t>(sizeof(std::complex<double>))},
+            amplitudes.data(),
+            base);
+    }
+
+    py::dict measurements() const { return measurements_to_arrays(engine_->state().measurements, 1); }
+    py::array logs() const { return logs_to_array(engine_->logs()); }
+    py::array timeline() const { return timeline_to_array(service::expand_timeline(compiled_.scheduled)); }
+    std::size_t position() const { return position_; }
+    std::size_t program_size() const { return compiled_.scheduled.program.size(); }
+    bool done() const { return position_ == compiled_.scheduled.program.size(); }
+    int n_qubits() const { return engine_->state().n_qubits; }
+    double logical_time() const { return engine_->state().logical_time; }
+
+  private:
+    // One past the last instruction of the step unit at `index`; a Repeat
+    // block is a single unit.
+    std::size_t unit_end(std::size_t index) const {
+        const auto& program = compiled_.scheduled.program;
+        if (program[index].op == Op::Repeat) {
+            return index + 1 + repeat_body(program, index).size();
+        }
+        return index + 1;
+    }
+
+    void require_no_views(const char* action) const {
+        if (views_ > 0) {
+            throw std::runtime_error(
+                std::string("cannot ") + action + " while state_vector() views are alive");
+        }
+    }
+
+    service::CompiledJob compiled_;
+    std::shared_ptr<const NoiseEngine> noise_;
+    std::uint64_t seed_ = 0;
+    std::unique_ptr<StatevectorEngine> engine_;
+    std::size_t position_ = 0;
+    std::size_t views_ = 0;
+    bool running_ = false;
+};
+
 bool has_stabilizer_backend() {
 #ifdef NA_VM_WITH_STIM
     return true;
@@ -604,6 +1339,59 @@ bool has_stabilizer_backend() {
 
 PYBIND11_MODULE(_neutral_atom_vm, m) {
     m.doc() = "Neutral Atom VM client bindings";
+    py::class_<service::ShotSubscription>(m, "ShotStream")
+        .def("__iter__", [](service::ShotSubscription& self) -> service::ShotSubscription& {
+            return self;
+        })
+        .def("__next__", [](service::ShotSubscription& self) { return next_shot_batch(self, 0); })
+        .def(
+            "next_batch",
+            &next_shot_batch,
+            py::arg("max_shots") = 0,
+            "Block until shots finish and return them with the cumulative counts."
+        )
+        .def("close", &service::ShotSubscription::close, "Stop streaming and drop any buffered shots.");
+    py::class_<ResultPlane>(m, "ResultPlane", py::buffer_protocol())
+        .def_buffer(&plane_buffer)
+        .def("__len__", [](const ResultPlane& self) { return self.words().size(); });
+    py::class_<service::SharedResultSegment, SegmentHandle>(m, "ResultSegment", py::buffer_protocol())
+        .def_buffer([](const SegmentHandle& self) { return plane_buffer(ResultPlane{self, false}); })
+        .def_property_readonly("name", &service::SharedResultSegment::name)
+        .def_property_readonly("shots", &service::SharedResultSegment::shots)
+        .def_property_readonly("bits_per_shot", &service::SharedResultSegment::bits_per_shot)
+        .def_property_readonly("layout", &service::SharedResultSegment::layout)
+        .def_property_readonly("size_bytes", &service::SharedResultSegment::size_bytes)
+        .def_property_readonly("values", [](const SegmentHandle& self) { return ResultPlane{self, false}; })
+        .def_property_readonly("lost", [](const SegmentHandle& self) -> py::object {
+            if (self->lost().empty()) {
+                return py::none();
+            }
+            return py::cast(ResultPlane{self, true});
+        })
+        .def("bit", &service::SharedResultSegment::bit, py::arg("shot"), py::arg("index"));
+    py::class_<CompletionNotifier>(m, "CompletionNotifier")
+        .def(py::init<>())
+        .def("fileno", &CompletionNotifier::fileno,
+            "eventfd that becomes readable when a watched job finishes.")
+        .def("watch", &CompletionNotifier::watch, py::arg("job_id"),
+            "Report `job_id` through drain() once it completes or fails.")
+        .def("drain", &CompletionNotifier::drain, "Return the watched jobs finished since the last call.");
+    py::class_<EngineSession>(m, "EngineSession")
+        .def(py::init<const py::dict&>(), py::arg("job"))
+        .def("step", &EngineSession::step, py::arg("count") = 1,
+            "Execute up to `count` scheduled instructions; returns how many ran.")
+        .def("run", &EngineSession::run, "Execute the rest of the program.")
+        .def("reset", &EngineSession::reset, "Start the shot over on a fresh engine.")
+        .def("state_vector", [](py::object self) { return py::cast<EngineSession&>(self).state_vector(self); },
+            "Writable complex128 view of the amplitudes (no copy).")
+        .def("measurements", &EngineSession::measurements)
+        .def("logs", &EngineSession::logs)
+        .def("timeline", &EngineSession::timeline)
+        .def_property_readonly("position", &EngineSession::position)
+        .def_property_readonly("program_size", &EngineSession::program_size)
+        .def_property_readonly("done", &EngineSession::done)
+        .def_property_readonly("n_qubits", &EngineSession::n_qubits)
+        .def_property_readonly("logical_time", &EngineSession::logical_time);
     m.def(
         "submit_job",
         &submit_job,
@@ -616,6 +1404,36 @@ PYBIND11_MODULE(_neutral_atom_vm, m) {
         py::arg("job"),
         "Submit a VM job asynchronously and receive a job_id immediately."
     );
+    m.def(
+        "submit_batch_async",
+        &submit_batch_async,
+        py::arg("job"),
+        py::arg("overrides"),
+        "Submit a sweep: the base job is compiled once and each override dict "
+        "(seed, shots, noise, gate_params, parameters) runs as its own async job."
+    );
+    m.def(
+        "batch_status",
+        &batch_status,
+        py::arg("batch_id"),
+        "Return total/finished/failed counters for a batch submission."
+    );
+    m.def(
+        "batch_results",
+        &batch_results,
+        py::arg("batch_id"),
+        py::arg("cursor") = 0,
+        "Return results of batch items finished since `cursor`, in completion order."
+    );
+    m.def(
+        "subscribe_job",
+        &subscribe_job,
+        py::arg("job_id"),
+        py::arg("capacity") = 1024,
+        "Stream finished shots of an async job. Iterating yields batches of "
+        "shots plus the cumulative histogram of the streamed shots; at most `capacity` "
+        "shots are buffered before the job waits for the consumer."
+    );
     m.def(
         "job_status",
         &job_status,
@@ -628,6 +1446,68 @@ PYBIND11_MODULE(_neutral_atom_vm, m) {
         py::arg("job_id"),
         "Fetch the final result for an async job (raises if not ready)."
     );
+    m.def(
+        "job_result_segment",
+        &job_result_segment,
+        py::arg("job_id"),
+        "Return the bit-packed measurements of a completed async job as a "
+        "shared-memory ResultSegment (None when unavailable)."
+    );
+    m.def(
+        "open_result_segment",
+        &open_result_segment,
+        py::arg("name"),
+        "Map a result segment published by another process."
+    );
+    m.def(
+        "configure_result_cache",
+        &configure_result_cache,
+        py::arg("memory_budget_bytes") = 64ull * 1024 * 1024,
+        py::arg("disk_directory") = std::string(),
+        py::arg("disk_budget_bytes") = 1024ull * 1024 * 1024,
+        "Enable the content-addressed result cache for seeded jobs."
+    );
+    m.def(
+        "configure_hardware_counters",
+        &configure_hardware_counters,
+        py::arg("scope"),
+        "Read perf_event hardware counters while simulating ('off', 'run' or "
+        "'kernels') and report them in result['profile']. Returns whether the "
+        "counters are available in this process."
+    );
+    m.def(
+        "result_cache_stats",
+        &result_cache_stats,
+        "Return hit/miss counters and tier sizes of the result cache."
+    );
+    m.def(
+        "metrics_text",
+        &metrics_text,
+        "Render service metrics in the Prometheus text exposition format."
+    );
+    m.def(
+        "start_trace",
+        &start_trace,
+        py::arg("events_per_thread") = neutral_atom_vm::trace::kDefaultEventsPerThread,
+        "Start recording execution spans (job stages, shots, instructions, "
+        "kernels, noise and measurement) into per-thread buffers."
+    );
+    m.def(
+        "stop_trace",
+        &stop_trace,
+        "Stop tracing and return the spans as Chrome trace JSON."
+    );
+    m.def(
+        "set_tenant_policy",
+        &set_tenant_policy,
+        py::arg("tenant"),
+        py::arg("weight") = 1.0,
+        py::arg("max_threads") = 0,
+        py::arg("max_memory_bytes") = 0,
+        py::arg("max_queued_jobs") = 0,
+        "Set the fair-share weight and caps (0 = unlimited) of the tenant named "
+        "by job metadata['tenant']. Submissions over the queued-job quota raise."
+    );
     m.def(
         "has_stabilizer_backend",
         &has_stabilizer_backend,
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <time.h>
+
+// CPU time consumed by the calling thread, in seconds. Cheap enough to read
+// around every pipeline stage and shot range.
+inline double thread_cpu_seconds() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+}
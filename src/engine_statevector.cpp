@@ -2,6 +2,7 @@
 
 #include "noise.hpp"
 #include "progress_reporter.hpp"
+#include "trace.hpp"
 
 #include <algorithm>
 #include <cstdlib>
@@ -9,12 +10,14 @@
 #include <cmath>
 #include <limits>
 #include <random>
+#include <span>
 #include <stdexcept>
+#include <string_view>
 #include <utility>
 
 namespace {
 
-std::string format_targets(const std::vector<int>& targets) {
+std::string format_targets(std::span<const int> targets) {
     std::ostringstream oss;
     oss << "[";
     for (std::size_t i = 0; i < targets.size(); ++i) {
@@ -34,7 +37,55 @@ double to_microseconds(double nanoseconds) {
     return nanoseconds * kMicrosecondsPerNanosecond;
 }
 
-int find_allocated_qubits(const std::vector<Instruction>& program) {
+const char* op_name(Op op) {
+    switch (op) {
+        case Op::AllocArray:
+            return "AllocArray";
+        case Op::ApplyGate:
+            return "ApplyGate";
+        case Op::Measure:
+            return "Measure";
+        case Op::MoveAtom:
+            return "MoveAtom";
+        case Op::Wait:
+            return "Wait";
+        case Op::Pulse:
+            return "Pulse";
+        case Op::Repeat:
+            return "Repeat";
+    }
+    return "Unknown";
+}
+
+// Adds the hardware counts of its scope to one kernel's entry.
+class KernelCount {
+  public:
+    KernelCount(const ThreadCounters* counters, KernelCounterMap* kernels, std::string_view name)
+        : counters_(kernels ? counters : nullptr), kernels_(kernels), name_(name) {
+        if (counters_) {
+            before_ = counters_->read();
+        }
+    }
+
+    ~KernelCount() {
+        if (counters_) {
+            KernelCounters& kernel = (*kernels_)[std::string(name_)];
+            ++kernel.calls;
+            kernel.counters += counters_between(before_, counters_->read());
+        }
+    }
+
+    KernelCount(const KernelCount&) = delete;
+    KernelCount& operator=(const KernelCount&) = delete;
+
+  private:
+    const ThreadCounters* counters_;
+    KernelCounterMap* kernels_;
+    std::string_view name_;
+    HardwareCounters before_;
+};
+
+int find_allocated_qubits(const Program& program) {
     for (const auto& instr : program) {
         if (instr.op == Op::AllocArray) {
             return std::get<int>(instr.payload);
@@ -101,43 +152,80 @@ void StatevectorEngine::set_progress_reporter(neutral_atom_vm::ProgressReporter*
     progress_reporter_ = reporter;
 }
 
+void StatevectorEngine::set_kernel_counters(const ThreadCounters* counters, KernelCounterMap* kernels) {
+    kernel_counters_ = counters;
+    kernel_counts_ = kernels;
+}
+
 void StatevectorEngine::set_random_seed(std::uint64_t seed) {
     rng_.seed(seed);
 }
 
-void StatevectorEngine::run(const std::vector<Instruction>& program) {
+void StatevectorEngine::run(const Program& program) {
     state_.logs.clear();
     execute_program(program);
 }
 
-void StatevectorEngine::execute_program(const std::vector<Instruction>& program) {
-    for (const auto& instr : program) {
-        switch (instr.op) {
-            case Op::AllocArray:
-                alloc_array(std::get<int>(instr.payload));
-                break;
-            case Op::ApplyGate:
-                apply_gate(std::get<Gate>(instr.payload));
-                break;
-            case Op::Measure:
-                measure(std::get<std::vector<int>>(instr.payload));
-                break;
-            case Op::MoveAtom:
-                move_atom(std::get<MoveAtomInstruction>(instr.payload));
-                break;
-            case Op::Wait:
-                wait_duration(std::get<WaitInstruction>(instr.payload));
-                break;
-            case Op::Pulse:
-                apply_pulse(std::get<PulseInstruction>(instr.payload));
-                break;
-        }
-        if (progress_reporter_) {
-            progress_reporter_->increment_completed_steps();
+void StatevectorEngine::step(ProgramView instructions) {
+    execute_program(instructions);
+}
+
+void StatevectorEngine::execute_program(ProgramView program) {
+    // Progress is flushed in batches so worker threads do not contend on the
+    // reporter once per instruction. A Repeat block counts as its instructions
+    // once, matching the program size callers use as the step total.
+    constexpr std::size_t kProgressBatch = 64;
+    std::size_t pending_steps = 0;
+    for (std::size_t index = 0; index < program.size();) {
+        const std::size_t next = execute_instruction(program, index);
+        pending_steps += next - index;
+        index = next;
+        if (progress_reporter_ && pending_steps >= kProgressBatch) {
+            progress_reporter_->increment_completed_steps(pending_steps);
+            pending_steps = 0;
         }
     }
+    if (progress_reporter_ && pending_steps > 0) {
+        progress_reporter_->increment_completed_steps(pending_steps);
+    }
 }
 
+std::size_t StatevectorEngine::execute_instruction(ProgramView program, std::size_t index) {
+    const Instruction& instr = program[index];
+    neutral_atom_vm::trace::Span span("instruction", op_name(instr.op), state_.shot_index);
+    switch (instr.op) {
+        case Op::AllocArray:
+            alloc_array(std::get<int>(instr.payload));
+            break;
+        case Op::ApplyGate:
+            apply_gate(std::get<Gate>(instr.payload));
+            counters_.amplitude_updates += backend_->state().size();
+            break;
+        case Op::Measure:
+            measure(program.targets(instr));
+            break;
+        case Op::MoveAtom:
+            move_atom(std::get<MoveAtomInstruction>(instr.payload));
+            break;
+        case Op::Wait:
+            wait_duration(std::get<WaitInstruction>(instr.payload));
+            break;
+        case Op::Pulse:
+            apply_pulse(std::get<PulseInstruction>(instr.payload));
+            break;
+        case Op::Repeat: {
+            const auto body = repeat_body(program, index);
+            const int count = std::get<RepeatInstruction>(instr.payload).count;
+            for (int iteration = 0; iteration < count; ++iteration) {
+                for (std::size_t pc = 0; pc < body.size();) {
+                    pc = execute_instruction(body, pc);
+                }
+            }
+            return index + 1 + body.size();
+        }
+    }
+    return index + 1;
+}
 
 void StatevectorEngine::alloc_array(int n) {
     if (n <= 0) {
@@ -145,6 +233,8 @@ void StatevectorEngine::alloc_array(int n) {
     }
     backend_->alloc_array(n);
     state_.n_qubits = backend_->num_qubits();
+    counters_.peak_state_bytes = std::max<std::uint64_t>(
+        counters_.peak_state_bytes, backend_->state().size() * sizeof(std::complex<double>));
     if (state_.hw.positions.size() < static_cast<std::size_t>(n)) {
         state_.hw.positions.resize(static_cast<std::size_t>(n), 0.0);
     }
@@ -238,41 +328,46 @@ void StatevectorEngine::apply_gate(const Gate& g) {
     }
     }
 
-    if (g.name == "X" && g.targets.size() == 1) {
-        std::array<std::complex<double>, 4> U{
-            {{0.0, 0.0}, {1.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}}};
-        backend_->apply_single_qubit_unitary(g.targets[0], U);
-    } else if (g.name == "H" && g.targets.size() == 1) {
-        const double inv_sqrt2 = 1.0 / std::sqrt(2.0);
-        std::array<std::complex<double>, 4> U{
-            {{inv_sqrt2, 0.0}, {inv_sqrt2, 0.0}, {inv_sqrt2, 0.0}, {-inv_sqrt2, 0.0}}};
-        backend_->apply_single_qubit_unitary(g.targets[0], U);
-    } else if (g.name == "Z" && g.targets.size() == 1) {
-        std::array<std::complex<double>, 4> U{
-            {{1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {-1.0, 0.0}}};
-        backend_->apply_single_qubit_unitary(g.targets[0], U);
-    } else if (g.name == "CX" && g.targets.size() == 2) {
-        enforce_blockade(g.targets[0], g.targets[1]);
-        // CX with control on g.targets[0] and target on g.targets[1].
-        // Basis ordering for the 4x4 block is |q0,q1> with q0 = control and
-        // q1 = target, laid out as [|00>, |10>, |01>, |11>].
-        std::array<std::complex<double>, 16> U{{
-            {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
-            {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0},
-            {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.0},
-            {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
-        }};
-        backend_->apply_two_qubit_unitary(g.targets[0], g.targets[1], U);
-    } else if (g.name == "CZ" && g.targets.size() == 2) {
-        enforce_blockade(g.targets[0], g.targets[1]);
-        std::array<std::complex<double>, 16> U{};
-        U[0] = {1.0, 0.0};
-        U[5] = {1.0, 0.0};
-        U[10] = {1.0, 0.0};
-        U[15] = {-1.0, 0.0};
-        backend_->apply_two_qubit_unitary(g.targets[0], g.targets[1], U);
-    } else {
-        throw std::runtime_error("Unsupported gate: " + g.name);
+    {
+        neutral_atom_vm::trace::Span kernel("kernel", g.name, state_.shot_index);
+        KernelCount count(kernel_counters_, kernel_counts_, g.name.str());
+        const GateOp op = g.name.op();
+        if (op == GateOp::X && g.targets.size() == 1) {
+            std::array<std::complex<double>, 4> U{
+                {{0.0, 0.0}, {1.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}}};
+            backend_->apply_single_qubit_unitary(g.targets[0], U);
+        } else if (op == GateOp::H && g.targets.size() == 1) {
+            const double inv_sqrt2 = 1.0 / std::sqrt(2.0);
+            std::array<std::complex<double>, 4> U{
+                {{inv_sqrt2, 0.0}, {inv_sqrt2, 0.0}, {inv_sqrt2, 0.0}, {-inv_sqrt2, 0.0}}};
+            backend_->apply_single_qubit_unitary(g.targets[0], U);
+        } else if (op == GateOp::Z && g.targets.size() == 1) {
+            std::array<std::complex<double>, 4> U{
+                {{1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {-1.0, 0.0}}};
+            backend_->apply_single_qubit_unitary(g.targets[0], U);
+        } else if (op == GateOp::CX && g.targets.size() == 2) {
+            enforce_blockade(g.targets[0], g.targets[1]);
+            // CX with control on g.targets[0] and target on g.targets[1].
+            // Basis ordering for the 4x4 block is |q0,q1> with q0 = control and
+            // q1 = target, laid out as [|00>, |10>, |01>, |11>].
+            std::array<std::complex<double>, 16> U{{
+                {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
+                {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0},
+                {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.0},
+                {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0},
+            }};
+            backend_->apply_two_qubit_unitary(g.targets[0], g.targets[1], U);
+        } else if (op == GateOp::CZ && g.targets.size() == 2) {
+            enforce_blockade(g.targets[0], g.targets[1]);
+            std::array<std::complex<double>, 16> U{};
+            U[0] = {1.0, 0.0};
+            U[5] = {1.0, 0.0};
+            U[10] = {1.0, 0.0};
+            U[15] = {-1.0, 0.0};
+            backend_->apply_two_qubit_unitary(g.targets[0], g.targets[1], U);
+        } else {
+            throw std::runtime_error("Unsupported gate: " + g.name);
+        }
     }
     const double duration = native_desc ? native_desc->duration_ns : 0.0;
     state_.logical_time = gate_start + duration;
@@ -285,6 +380,7 @@ void StatevectorEngine::apply_gate(const Gate& g) {
             backend_->sync_device_to_host();
             StdRandomStream noise_rng(rng_);
             if (g.targets.size() == 1) {
+                neutral_atom_vm::trace::Span noise_span("noise", "single_qubit_gate", state_.shot_index);
                 noise_->apply_single_qubit_gate_noise(
                     g.targets[0],
                     state_.n_qubits,
@@ -297,6 +393,7 @@ void StatevectorEngine::apply_gate(const Gate& g) {
                     log_event("Noise", oss_noise.str());
                 }
             } else if (g.targets.size() == 2) {
+                neutral_atom_vm::trace::Span noise_span("noise", "two_qubit_gate", state_.shot_index);
                 noise_->apply_two_qubit_gate_noise(
                     g.targets[0],
                     g.targets[1],
@@ -357,6 +454,7 @@ void StatevectorEngine::wait_duration(const WaitInstruction& wait_instr) {
     if (noise_) {
         backend_->sync_device_to_host();
         StdRandomStream noise_rng(rng_);
+        neutral_atom_vm::trace::Span noise_span("noise", "idle", state_.shot_index);
         noise_->apply_idle_noise(
             state_.n_qubits,
             backend_->state(),
@@ -461,7 +559,7 @@ const SiteDescriptor* StatevectorEngine::site_descriptor_for_qubit(int qubit) co
     return nullptr;
 }
 
-void StatevectorEngine::measure(const std::vector<int>& targets) {
+void StatevectorEngine::measure(std::span<const int> targets) {
     if (targets.empty()) {
         return;
     }
@@ -481,6 +579,8 @@ void StatevectorEngine::measure(const std::vector<int>& targets) {
     const double measurement_duration = state_.hw.timing_limits.measurement_duration_ns;
     const double measurement_start = state_.logical_time;
     if (!measured_on_device) {
+        neutral_atom_vm::trace::Span sample("measurement", "sample", state_.shot_index);
+        KernelCount count(kernel_counters_, kernel_counts_, "measure");
         backend_->sync_device_to_host();
         auto& amps = backend_->state();
         const std::size_t dim = amps.size();
@@ -538,7 +638,7 @@ void StatevectorEngine::measure(const std::vector<int>& targets) {
             }
         }
 
-        record.targets = targets;
+        record.targets.assign(targets.begin(), targets.end());
         record.bits.reserve(k);
         for (std::size_t idx = 0; idx < k; ++idx) {
             record.bits.push_back(static_cast<int>((selected >> idx) & 1ULL));
@@ -549,6 +649,7 @@ void StatevectorEngine::measure(const std::vector<int>& targets) {
 
     if (noise_) {
         StdRandomStream noise_rng(rng_);
+        neutral_atom_vm::trace::Span noise_span("noise", "measurement", state_.shot_index);
         noise_->apply_measurement_noise(record, noise_rng);
     }
 
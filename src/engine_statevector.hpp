@@ -6,18 +6,28 @@
 #include <limits>
 #include <memory>
 #include <random>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "cpu_state_backend.hpp"
 #include "noise.hpp"
+#include "perf_counters.hpp"
 #include "vm/isa.hpp"
 #include "vm/measurement_record.types.hpp"
 namespace neutral_atom_vm {
 class ProgressReporter;
 }
 
+// Work counters of one engine, accumulated across run() calls.
+struct EngineCounters {
+    // Amplitudes touched by gate applications (statevector size per gate).
+    std::uint64_t amplitude_updates = 0;
+    // Largest statevector allocated.
+    std::uint64_t peak_state_bytes = 0;
+};
+
 // Statevector-based execution engine for the Neutral Atom ISA.
 // This is a concrete runtime backend, not the hardware VM itself.
 
@@ -48,11 +58,21 @@ class StatevectorEngine {
 
     void set_progress_reporter(neutral_atom_vm::ProgressReporter* reporter);
 
+    // Attribute the hardware counts of gate kernels and measurement sampling
+    // to `kernels`, read from `counters`, which the calling thread opened.
+    // nullptr stops the attribution.
+    void set_kernel_counters(const ThreadCounters* counters, KernelCounterMap* kernels);
+
     // Set the random seed used for stochastic processes such as
     // measurement sampling and noise application.
     void set_random_seed(std::uint64_t seed);
 
-    void run(const std::vector<Instruction>& program);
+    void run(const Program& program);
+    // Execute `instructions` on the current state, appending to the logs
+    // instead of clearing them. Lets a caller step through a program; running
+    // a program in consecutive slices matches one run() as long as no slice
+    // splits a Repeat block.
+    void step(ProgramView instructions);
     void set_shot_index(int shot);
     const std::vector<ExecutionLog>& logs() const { return state_.logs; }
 
@@ -60,22 +80,29 @@ class StatevectorEngine {
     const std::vector<std::complex<double>>& state_vector() const;
 
     const StatevectorState& state() const { return state_; }
+    const EngineCounters& counters() const { return counters_; }
 
   private:
     StatevectorState state_;
+    EngineCounters counters_;
 
     std::shared_ptr<const NoiseEngine> noise_;
     std::mt19937_64 rng_{};
     std::unique_ptr<StateBackend> backend_;
     neutral_atom_vm::ProgressReporter* progress_reporter_ = nullptr;
+    const ThreadCounters* kernel_counters_ = nullptr;
+    KernelCounterMap* kernel_counts_ = nullptr;
 
 
     void log_event(const std::string& category, const std::string& message);
-    void execute_program(const std::vector<Instruction>& program);
+    void execute_program(ProgramView program);
+    // Executes program[index] (a whole block for a Repeat) and returns the
+    // index of the next instruction.
+    std::size_t execute_instruction(ProgramView program, std::size_t index);
     bool should_emit_logs() const;
     void alloc_array(int n);
     void apply_gate(const Gate& g);
-    void measure(const std::vector<int>& targets);
+    void measure(std::span<const int> targets);
     void move_atom(const MoveAtomInstruction& move);
     void wait_duration(const WaitInstruction& wait_instr);
     void apply_pulse(const PulseInstruction& pulse);
@@ -1,9 +1,13 @@
 #include "hardware_vm.hpp"
 
+#include "cpu_time.hpp"
+#include "trace.hpp"
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
+#include <optional>
 #include <random>
 #include <stdexcept>
 #include <thread>
@@ -32,7 +36,7 @@ void HardwareVM::set_progress_reporter(neutral_atom_vm::ProgressReporter* report
 }
 
 HardwareVM::RunResult HardwareVM::run(
-    const std::vector<Instruction>& program,
+    const Program& program,
     int shots,
     const std::vector<std::uint64_t>& shot_seeds,
     const std::vector<neutral_atom_vm::InstructionTiming>* instruction_timings,
@@ -45,6 +49,8 @@ HardwareVM::RunResult HardwareVM::run(
         );
     }
 
+    validate_repeat_blocks(program);
+
     const int num_shots = std::max(1, shots);
     if (!shot_seeds.empty() && static_cast<int>(shot_seeds.size()) != num_shots) {
         throw std::invalid_argument("shot seeds must match the requested shots");
@@ -63,7 +69,20 @@ HardwareVM::RunResult HardwareVM::run(
 
     if (profile_.backend == BackendKind::kStabilizer) {
 #ifdef NA_VM_WITH_STIM
-        return run_stabilizer(program, num_shots, seeds);
+        std::optional<ThreadCounters> counters;
+        HardwareCounters counters_start;
+        if (counter_scope_ != CounterScope::kOff) {
+            counters.emplace();
+            counters_start = counters->read();
+        }
+        const double cpu_start = thread_cpu_seconds();
+        RunResult result = run_stabilizer(program, num_shots, seeds);
+        result.stats.cpu_seconds = thread_cpu_seconds() - cpu_start;
+        result.stats.threads = 1;
+        if (counters) {
+            result.stats.counters = counters_between(counters_start, counters->read());
+        }
+        return result;
 #else
         throw std::runtime_error(
             "stabilizer backend unavailable; rebuild with NA_VM_WITH_STIM=ON"
@@ -81,6 +100,7 @@ HardwareVM::RunResult HardwareVM::run(
 
     std::vector<std::vector<MeasurementRecord>> per_shot_measurements(num_shots);
     std::vector<std::vector<ExecutionLog>> per_shot_logs(num_shots);
+    std::vector<RunStats> per_worker_stats(worker_count);
     std::vector<std::thread> workers;
     workers.reserve(worker_count);
     std::mutex failure_mutex;
@@ -103,33 +123,56 @@ HardwareVM::RunResult HardwareVM::run(
             &per_shot_measurements,
             &per_shot_logs,
             &seeds,
+            stats = &per_worker_stats[worker_idx],
             start,
             end,
             &failure_mutex,
             &failure
         ]() {
+            std::optional<ThreadCounters> counters;
+            HardwareCounters counters_start;
+            if (counter_scope_ != CounterScope::kOff) {
+                counters.emplace();
+                counters_start = counters->read();
+            }
+            const double cpu_start = thread_cpu_seconds();
             for (std::size_t shot = start; shot < end; ++shot) {
                 try {
+                    neutral_atom_vm::trace::Span span("shot", "shot", first_shot_ + static_cast<int>(shot));
                     HardwareConfig hw = profile_.hardware;
                     StatevectorEngine engine(hw, make_state_backend(profile_.backend), seeds[shot]);
                     if (progress_reporter_) {
                         engine.set_progress_reporter(progress_reporter_);
                     }
-                    engine.set_shot_index(static_cast<int>(shot));
+                    engine.set_shot_index(first_shot_ + static_cast<int>(shot));
                     if (profile_.noise_engine) {
                         engine.set_noise_model(profile_.noise_engine);
                     }
+                    if (counter_scope_ == CounterScope::kKernels) {
+                        engine.set_kernel_counters(&*counters, &stats->kernels);
+                    }
                     engine.run(program);
+                    stats->amplitude_updates += engine.counters().amplitude_updates;
+                    stats->peak_statevector_bytes =
+                        std::max(stats->peak_statevector_bytes, engine.counters().peak_state_bytes);
                     per_shot_measurements[shot] = engine.state().measurements;
                     per_shot_logs[shot] = engine.state().logs;
+                    if (progress_reporter_) {
+                        progress_reporter_->record_shot(
+                            first_shot_ + static_cast<int>(shot), per_shot_measurements[shot]);
+                    }
                 } catch (...) {
                     std::lock_guard<std::mutex> lock(failure_mutex);
                     if (!failure) {
                         failure = std::current_exception();
                     }
-                    return;
+                    break;
                 }
             }
+            stats->cpu_seconds = thread_cpu_seconds() - cpu_start;
+            if (counters) {
+                stats->counters = counters_between(counters_start, counters->read());
+            }
         });
         shot_offset = end;
     }
@@ -142,6 +185,14 @@ HardwareVM::RunResult HardwareVM::run(
     }
 
     RunResult result;
+    result.stats.threads = workers.size();
+    for (const auto& stats : per_worker_stats) {
+        result.stats.amplitude_updates += stats.amplitude_updates;
+        result.stats.peak_statevector_bytes += stats.peak_statevector_bytes;
+        result.stats.cpu_seconds += stats.cpu_seconds;
+        result.stats.counters += stats.counters;
+        merge_kernel_counters(result.stats.kernels, stats.kernels);
+    }
     std::vector<ExecutionLog>& all_logs = result.logs;
     for (const auto& shot_records : per_shot_measurements) {
         result.measurements.insert(
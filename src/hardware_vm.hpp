@@ -9,6 +9,7 @@
 
 #include "noise.hpp"
 #include "engine_statevector.hpp"
+#include "perf_counters.hpp"
 #include "progress_reporter.hpp"
 #include "vm/instruction_timing.hpp"
 
@@ -38,25 +39,53 @@ struct DeviceProfile {
     // Future extensions: noise configuration, resource limits, diagnostics.
 };
 
+#ifdef NA_VM_WITH_STIM
+// The Stim circuit the stabilizer backend samples for `program`, with each
+// Repeat block kept as a native REPEAT.
+std::string stabilizer_circuit_text(const DeviceProfile& profile, const Program& program);
+#endif
+
 class HardwareVM {
   public:
     explicit HardwareVM(DeviceProfile profile);
 
     void set_progress_reporter(neutral_atom_vm::ProgressReporter* reporter);
 
+    // Index reported for the first shot of each run(). Lets callers execute a
+    // job as several shot ranges while logs and streamed shots keep their
+    // job-wide shot numbers.
+    void set_first_shot(int first_shot) { first_shot_ = first_shot; }
+
+    // Read hardware counters on each worker thread of run() (see
+    // perf_counters.hpp); off by default.
+    void set_counter_scope(CounterScope scope) { counter_scope_ = scope; }
+
     const DeviceProfile& profile() const { return profile_; }
 
-    // Execute the given program for the requested number of shots using
-    // the configured device profile. Returns concatenated measurement
-    // records across all shots.
+    // Resources one run() used, summed over its worker threads.
+    struct RunStats {
+        std::uint64_t amplitude_updates = 0;
+        // Statevectors alive at once: the largest per worker, summed.
+        std::uint64_t peak_statevector_bytes = 0;
+        double cpu_seconds = 0.0;
+        std::size_t threads = 0;
+        // Filled according to the counter scope.
+        HardwareCounters counters;
+        KernelCounterMap kernels;
+    };
+
     struct RunResult {
         std::vector<MeasurementRecord> measurements;
         std::vector<ExecutionLog> logs;
         std::vector<BackendTimelineEvent> backend_timeline;
+        RunStats stats;
     };
 
+    // Execute the given program for the requested number of shots using
+    // the configured device profile. Returns concatenated measurement
+    // records across all shots.
     RunResult run(
-        const std::vector<Instruction>& program,
+        const Program& program,
         int shots = 1,
         const std::vector<std::uint64_t>& shot_seeds = {},
         const std::vector<neutral_atom_vm::InstructionTiming>* instruction_timings = nullptr,
@@ -66,11 +95,13 @@ class HardwareVM {
   private:
 #ifdef NA_VM_WITH_STIM
     RunResult run_stabilizer(
-        const std::vector<Instruction>& program,
+        const Program& program,
         int num_shots,
         const std::vector<std::uint64_t>& shot_seeds
     );
 #endif
     DeviceProfile profile_;
     neutral_atom_vm::ProgressReporter* progress_reporter_ = nullptr;
+    int first_shot_ = 0;
+    CounterScope counter_scope_ = CounterScope::kOff;
 };
@@ -9,7 +9,7 @@ int main() {
 
     StatevectorEngine engine(cfg);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -0,0 +1,156 @@
+#include "perf_counters.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int open_event(std::uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    return static_cast<int>(fd);
+}
+
+std::uint64_t difference(std::uint64_t before, std::uint64_t after) {
+    return after >= before ? after - before : 0;
+}
+
+}  // namespace
+
+HardwareCounters& HardwareCounters::operator+=(const HardwareCounters& other) {
+    available = available || other.available;
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cache_references += other.cache_references;
+    cache_misses += other.cache_misses;
+    return *this;
+}
+
+void merge_kernel_counters(KernelCounterMap& into, const KernelCounterMap& from) {
+    for (const auto& [name, kernel] : from) {
+        KernelCounters& total = into[name];
+        total.calls += kernel.calls;
+        total.counters += kernel.counters;
+    }
+}
+
+ThreadCounters::ThreadCounters() {
+    leader_fd_ = open_event(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (leader_fd_ < 0) {
+        return;
+    }
+    const std::uint64_t members[3] = {
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES,
+    };
+    for (int idx = 0; idx < 3; ++idx) {
+        member_fds_[idx] = open_event(members[idx], leader_fd_);
+        if (member_fds_[idx] < 0) {
+            // Report nothing rather than a partial set.
+            for (int open = 0; open < idx; ++open) {
+                ::close(member_fds_[open]);
+                member_fds_[open] = -1;
+            }
+            ::close(leader_fd_);
+            leader_fd_ = -1;
+            return;
+        }
+    }
+    ::ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+ThreadCounters::~ThreadCounters() {
+    for (int fd : member_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (leader_fd_ >= 0) {
+        ::close(leader_fd_);
+    }
+}
+
+HardwareCounters ThreadCounters::read() const {
+    HardwareCounters out;
+    if (leader_fd_ < 0) {
+        return out;
+    }
+    // {nr, time_enabled, time_running, value[nr]}
+    std::uint64_t data[3 + 4] = {};
+    if (::read(leader_fd_, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[0] != 4) {
+        return out;
+    }
+    const std::uint64_t enabled = data[1];
+    const std::uint64_t running = data[2];
+    auto scaled = [&](std::uint64_t value) {
+        if (running == 0 || running >= enabled) {
+            return value;
+        }
+        return static_cast<std::uint64_t>(
+            static_cast<double>(value) * static_cast<double>(enabled) / static_cast<double>(running));
+    };
+    out.available = true;
+    out.cycles = scaled(data[3]);
+    out.instructions = scaled(data[4]);
+    out.cache_references = scaled(data[5]);
+    out.cache_misses = scaled(data[6]);
+    return out;
+}
+
+HardwareCounters counters_between(const HardwareCounters& before, const HardwareCounters& after) {
+    HardwareCounters out;
+    out.available = before.available && after.available;
+    if (!out.available) {
+        return out;
+    }
+    out.cycles = difference(before.cycles, after.cycles);
+    out.instructions = difference(before.instructions, after.instructions);
+    out.cache_references = difference(before.cache_references, after.cache_references);
+    out.cache_misses = difference(before.cache_misses, after.cache_misses);
+    return out;
+}
+
+bool hardware_counters_supported() {
+    static const bool supported = ThreadCounters().available();
+    return supported;
+}
+
+std::string to_string(CounterScope scope) {
+    switch (scope) {
+        case CounterScope::kOff:
+            return "off";
+        case CounterScope::kRun:
+            return "run";
+        case CounterScope::kKernels:
+            return "kernels";
+    }
+    return "off";
+}
+
+CounterScope parse_counter_scope(const std::string& text) {
+    if (text == "off") {
+        return CounterScope::kOff;
+    }
+    if (text == "run") {
+        return CounterScope::kRun;
+    }
+    if (text == "kernels") {
+        return CounterScope::kKernels;
+    }
+    throw std::invalid_argument("unknown counter scope '" + text + "' (expected off, run or kernels)");
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Hardware performance counters read through Linux perf_event_open.
+// Counters are per thread and user space only, so they work at the default
+// perf_event_paranoid level; where the PMU is not exposed (many VMs and
+// containers) they simply report available = false.
+
+enum class CounterScope {
+    kOff,
+    // Count around each HardwareVM::run.
+    kRun,
+    // Also count around every gate kernel and measurement sample. Costs one
+    // read() system call per kernel on each side.
+    kKernels,
+};
+
+struct HardwareCounters {
+    bool available = false;
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    // Last-level cache references and misses.
+    std::uint64_t cache_references = 0;
+    std::uint64_t cache_misses = 0;
+
+    HardwareCounters& operator+=(const HardwareCounters& other);
+};
+
+// Counts accumulated over the calls of one kernel (a gate name, or
+// "measure" for measurement sampling).
+struct KernelCounters {
+    std::uint64_t calls = 0;
+    HardwareCounters counters;
+};
+
+using KernelCounterMap = std::map<std::string, KernelCounters>;
+
+void merge_kernel_counters(KernelCounterMap& into, const KernelCounterMap& from);
+
+// Cycles, instructions and LLC references/misses of the calling thread,
+// opened as one perf event group. Never throws: when the counters cannot be
+// opened, available() is false and read() returns zeros.
+class ThreadCounters {
+  public:
+    ThreadCounters();
+    ~ThreadCounters();
+
+    ThreadCounters(const ThreadCounters&) = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    bool available() const { return leader_fd_ >= 0; }
+    // Counts since construction, scaled up when the kernel multiplexed the
+    // group with other events. Call from the thread that opened it.
+    HardwareCounters read() const;
+
+  private:
+    int leader_fd_ = -1;
+    int member_fds_[3] = {-1, -1, -1};
+};
+
+// Difference of two readings of the same ThreadCounters.
+HardwareCounters counters_between(const HardwareCounters& before, const HardwareCounters& after);
+
+// Whether this process can open the counters; probed once.
+bool hardware_counters_supported();
+
+std::string to_string(CounterScope scope);
+// Accepts "off", "run" and "kernels"; throws std::invalid_argument otherwise.
+CounterScope parse_counter_scope(const std::string& text);
@@ -3,6 +3,7 @@
 #include "vm/measurement_record.types.hpp"
 
 #include <cstddef>
+#include <vector>
 
 namespace neutral_atom_vm {
 
@@ -13,6 +14,11 @@ class ProgressReporter {
     virtual void set_total_steps(std::size_t total_steps) = 0;
     virtual void increment_completed_steps(std::size_t delta = 1) = 0;
     virtual void record_log(const ExecutionLog& log) = 0;
+    // Called once per finished shot, possibly from several worker threads.
+    virtual void record_shot(int shot, const std::vector<MeasurementRecord>& measurements) {
+        (void)shot;
+        (void)measurements;
+    }
 };
 
 }  // namespace neutral_atom_vm
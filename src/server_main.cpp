@@ -0,0 +1,157 @@
+#include "service/http_server.hpp"
+#include "service/job_http_service.hpp"
+#include "service/job_service.hpp"
+#include "trace.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+// Native counterpart of python/scripts/vm_service.py: serves the same job
+// routes from a single epoll event loop.
+namespace {
+
+void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0
+              << " [--host ADDR] [--port N] [--job-endpoint PATH]"
+                 " [--devices-endpoint PATH] [--devices FILE] [--journal FILE]\n"
+                 "       [--shard-workers N] [--trace FILE] [--perf-counters off|run|kernels]\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    service::HttpServerOptions server_options;
+    server_options.host = "0.0.0.0";
+    server_options.port = 8080;
+    service::JobHttpOptions http_options;
+    std::string journal_path;
+    std::size_t shard_workers = 0;
+    std::string trace_path;
+    CounterScope counter_scope = CounterScope::kOff;
+
+    for (int idx = 1; idx < argc; ++idx) {
+        const std::string arg = argv[idx];
+        if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        }
+        if (idx + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        const std::string value = argv[++idx];
+        if (arg == "--host") {
+            server_options.host = value;
+        } else if (arg == "--port") {
+            server_options.port = static_cast<std::uint16_t>(std::atoi(value.c_str()));
+        } else if (arg == "--job-endpoint") {
+            http_options.job_endpoint = value;
+        } else if (arg == "--devices-endpoint") {
+            http_options.devices_endpoint = value;
+        } else if (arg == "--journal") {
+            journal_path = value;
+        } else if (arg == "--shard-workers") {
+            shard_workers = static_cast<std::size_t>(std::atoi(value.c_str()));
+        } else if (arg == "--perf-counters") {
+            try {
+                counter_scope = parse_counter_scope(value);
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << "\n";
+                return 2;
+            }
+        } else if (arg == "--trace") {
+            trace_path = value;
+        } else if (arg == "--devices") {
+            std::ifstream in(value);
+            if (!in) {
+                std::cerr << "unable to read device catalogue " << value << "\n";
+                return 1;
+            }
+            std::ostringstream contents;
+            contents << in.rdbuf();
+            http_options.devices_json = contents.str();
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Block termination signals before any thread starts so every thread
+    // inherits the mask and sigwait below receives them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    // Fork the shard workers while this is still the only thread.
+    std::shared_ptr<service::ShardCoordinator> coordinator;
+    if (shard_workers > 0) {
+        service::ShardCoordinatorOptions shard_options;
+        shard_options.workers = shard_workers;
+        shard_options.counter_scope = counter_scope;
+        try {
+            coordinator = std::make_shared<service::ShardCoordinator>(shard_options);
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << "\n";
+            return 1;
+        }
+    }
+
+    if (!trace_path.empty()) {
+        neutral_atom_vm::trace::start();
+    }
+
+    service::JobService jobs;
+    jobs.set_shard_coordinator(coordinator);
+    jobs.set_counter_scope(counter_scope);
+    if (counter_scope != CounterScope::kOff && !hardware_counters_supported()) {
+        std::cerr << "hardware counters are unavailable; profiles will report none\n";
+    }
+    if (!journal_path.empty()) {
+        try {
+            service::JobJournalOptions journal_options;
+            journal_options.path = journal_path;
+            const std::size_t requeued =
+                jobs.attach_journal(std::make_shared<service::JobJournal>(journal_options));
+            std::cout << "Recovered " << requeued << " unfinished jobs from " << journal_path << std::endl;
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << "\n";
+            return 1;
+        }
+    }
+    service::JobHttpService api(jobs, http_options);
+    service::HttpServer server(server_options, [&api](const service::HttpRequest& request) {
+        return api.handle(request);
+    });
+    try {
+        server.start();
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    std::cout << "Serving Neutral Atom VM on http://" << server_options.host << ":"
+              << server.port() << http_options.job_endpoint << std::endl;
+
+    int received = 0;
+    sigwait(&signals, &received);
+    std::cout << "Shutting down service" << std::endl;
+    server.stop();
+    if (!trace_path.empty()) {
+        neutral_atom_vm::trace::stop();
+        std::ofstream out(trace_path);
+        neutral_atom_vm::trace::write_chrome_trace(out);
+        if (!out) {
+            std::cerr << "unable to write trace " << trace_path << "\n";
+            return 1;
+        }
+        std::cout << "Wrote " << neutral_atom_vm::trace::recorded_events() << " trace events to "
+                  << trace_path << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,304 @@
+#include "service/fair_scheduler.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace service {
+
+FairShareScheduler::FairShareScheduler(FairShareOptions options) : options_(std::move(options)) {
+    if (options_.worker_threads == 0) {
+        options_.worker_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options_.shots_per_batch = std::max<std::size_t>(1, options_.shots_per_batch);
+    if (options_.prepare_threads > 0) {
+        prepare_stage_ = std::make_unique<PipelineStage>(options_.prepare_threads);
+    }
+    if (options_.finish_threads > 0) {
+        finish_stage_ = std::make_unique<PipelineStage>(options_.finish_threads);
+    }
+    workers_.reserve(options_.worker_threads);
+    for (std::size_t idx = 0; idx < options_.worker_threads; ++idx) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+FairShareScheduler::~FairShareScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    prepare_stage_.reset();
+    finish_stage_.reset();
+}
+
+void FairShareScheduler::submit(ScheduledJob job) {
+    std::vector<ScheduledJob> jobs;
+    jobs.push_back(std::move(job));
+    submit(std::move(jobs));
+}
+
+void FairShareScheduler::submit(std::vector<ScheduledJob> jobs, bool enforce_quota) {
+    std::vector<std::pair<Tenant*, std::shared_ptr<Job>>> to_plan;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, std::size_t> admitted;
+        for (const auto& job : jobs) {
+            ++admitted[job.tenant];
+        }
+        for (const auto& [name, count] : admitted) {
+            const Tenant& tenant = tenant_locked(name);
+            const std::size_t quota = tenant.policy.max_queued_jobs;
+            if (enforce_quota && quota > 0 && tenant.queued_jobs + count > quota) {
+                throw QuotaExceeded(
+                    "tenant " + name + " has " + std::to_string(tenant.queued_jobs) +
+                    " queued jobs; quota is " + std::to_string(quota));
+            }
+        }
+        for (auto& work : jobs) {
+            Tenant& tenant = tenant_locked(work.tenant);
+            if (tenant.pending.empty()) {
+                // A tenant returning from idle competes from the current
+                // virtual time instead of spending credit saved while idle.
+                tenant.virtual_time = std::max(tenant.virtual_time, virtual_clock_);
+            }
+            auto job = std::make_shared<Job>();
+            job->work = std::move(work);
+            if (prepare_stage_) {
+                // Keeps workers from planning it inline.
+                job->planning = true;
+                to_plan.emplace_back(&tenant, job);
+            }
+            tenant.pending.push_back(std::move(job));
+            ++tenant.queued_jobs;
+        }
+    }
+    for (auto& [tenant, job] : to_plan) {
+        prepare_stage_->push([this, tenant, job = std::move(job)]() { plan_job(*tenant, job); });
+    }
+    cv_.notify_all();
+}
+
+void FairShareScheduler::set_policy(const std::string& tenant, TenantPolicy policy) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy.weight = policy.weight > 0.0 ? policy.weight : 1.0;
+        tenant_locked(tenant).policy = policy;
+    }
+    cv_.notify_all();
+}
+
+TenantPolicy FairShareScheduler::policy(const std::string& tenant) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = tenants_.find(tenant);
+    return it == tenants_.end() ? options_.default_policy : it->second.policy;
+}
+
+TenantStats FairShareScheduler::stats(const std::string& tenant) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TenantStats stats;
+    const auto it = tenants_.find(tenant);
+    if (it != tenants_.end()) {
+        stats.queued_jobs = it->second.queued_jobs;
+        stats.running_tasks = it->second.running_tasks;
+        stats.memory_bytes = it->second.memory_bytes;
+        stats.virtual_time = it->second.virtual_time;
+    }
+    return stats;
+}
+
+FairShareScheduler::Tenant& FairShareScheduler::tenant_locked(const std::string& name) {
+    auto [it, inserted] = tenants_.try_emplace(name);
+    if (inserted) {
+        it->second.policy = options_.default_policy;
+        if (it->second.policy.weight <= 0.0) {
+            it->second.policy.weight = 1.0;
+        }
+    }
+    return it->second;
+}
+
+bool FairShareScheduler::next_task_locked(Task& task) {
+    Tenant* best = nullptr;
+    std::shared_ptr<Job> best_job;
+    for (auto& [name, tenant] : tenants_) {
+        const TenantPolicy& policy = tenant.policy;
+        if (tenant.pending.empty() ||
+            (policy.max_threads > 0 && tenant.running_tasks >= policy.max_threads) ||
+            (best && best->virtual_time <= tenant.virtual_time)) {
+            continue;
+        }
+        // First job in FIFO order that can take another task.
+        for (const auto& job : tenant.pending) {
+            if (!job->planned) {
+                if (!job->planning) {
+                    best = &tenant;
+                    best_job = job;
+                    break;
+                }
+                continue;
+            }
+            const std::size_t max_parallel = job->work.max_parallel;
+            const std::size_t memory_cap = policy.max_memory_bytes;
+            const bool fits_memory =
+                memory_cap == 0 || tenant.memory_bytes + job->plan.batch_memory_bytes <= memory_cap;
+            if ((max_parallel == 0 || job->running < max_parallel) && fits_memory) {
+                best = &tenant;
+                best_job = job;
+                break;
+            }
+        }
+    }
+    if (!best) {
+        return false;
+    }
+
+    task = Task{};
+    task.tenant = best;
+    task.job = best_job;
+    ++best->running_tasks;
+    if (!best_job->planned) {
+        best_job->planning = true;
+        task.plan = true;
+        return true;
+    }
+
+    Job& job = *best_job;
+    task.first = job.next_shot;
+    task.count = std::min(job.batch_shots, job.plan.shots - job.next_shot);
+    job.next_shot += task.count;
+    ++job.running;
+    best->memory_bytes += job.plan.batch_memory_bytes;
+    virtual_clock_ = std::max(virtual_clock_, best->virtual_time);
+    best->virtual_time +=
+        static_cast<double>(task.count) * job.plan.shot_cost / best->policy.weight;
+    if (job.next_shot >= job.plan.shots) {
+        auto& pending = best->pending;
+        pending.erase(std::find(pending.begin(), pending.end(), best_job));
+    }
+    return true;
+}
+
+void FairShareScheduler::worker_loop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return stopping_ || next_task_locked(task); });
+            if (stopping_) {
+                return;
+            }
+        }
+        WorkPlan plan;
+        try {
+            if (task.plan) {
+                neutral_atom_vm::trace::Span span("scheduler", "plan");
+                plan = task.job->work.plan();
+            } else {
+                neutral_atom_vm::trace::Span span("scheduler", "batch", static_cast<std::int64_t>(task.first));
+                task.job->work.run_batch(task.first, task.count);
+            }
+        } catch (...) {
+            // Callbacks report their own failures; a throwing plan runs no shots.
+            plan = WorkPlan{};
+        }
+        finish_task(task, plan);
+        cv_.notify_all();
+    }
+}
+
+void FairShareScheduler::finish_task(const Task& task, const WorkPlan& plan) {
+    Job& job = *task.job;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Tenant& tenant = *task.tenant;
+        --tenant.running_tasks;
+        if (task.plan) {
+            done = apply_plan_locked(tenant, task.job, plan);
+        } else {
+            --job.running;
+            job.finished_shots += task.count;
+            tenant.memory_bytes -= job.plan.batch_memory_bytes;
+            done = job.finished_shots >= job.plan.shots;
+            if (done) {
+                --tenant.queued_jobs;
+            }
+        }
+    }
+    if (done) {
+        complete_job(task.job);
+    }
+}
+
+void FairShareScheduler::plan_job(Tenant& tenant, const std::shared_ptr<Job>& job) {
+    WorkPlan plan;
+    try {
+        neutral_atom_vm::trace::Span span("scheduler", "plan");
+        plan = job->work.plan();
+    } catch (...) {
+        plan = WorkPlan{};
+    }
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done = apply_plan_locked(tenant, job, plan);
+    }
+    cv_.notify_all();
+    if (done) {
+        complete_job(job);
+    }
+}
+
+bool FairShareScheduler::apply_plan_locked(Tenant& tenant, const std::shared_ptr<Job>& job, const WorkPlan& plan) {
+    job->planning = false;
+    job->planned = true;
+    job->plan = plan;
+    job->plan.shot_cost = std::max(plan.shot_cost, std::numeric_limits<double>::min());
+    // A batch over the whole cap could never be dispatched. The planner
+    // reports such jobs as failed (JobService does); here they just finish.
+    const std::size_t memory_cap = tenant.policy.max_memory_bytes;
+    if (memory_cap > 0 && job->plan.batch_memory_bytes > memory_cap) {
+        job->plan.shots = 0;
+    }
+    // Workers this job may occupy at once; spread its shots over all of them.
+    std::size_t slots = options_.worker_threads;
+    if (job->work.max_parallel > 0) {
+        slots = std::min(slots, job->work.max_parallel);
+    }
+    if (tenant.policy.max_threads > 0) {
+        slots = std::min(slots, tenant.policy.max_threads);
+    }
+    job->batch_shots = std::clamp<std::size_t>(
+        (job->plan.shots + slots - 1) / slots, 1, options_.shots_per_batch);
+    if (job->plan.shots > 0) {
+        return false;
+    }
+    auto& pending = tenant.pending;
+    pending.erase(std::find(pending.begin(), pending.end(), job));
+    --tenant.queued_jobs;
+    return true;
+}
+
+void FairShareScheduler::complete_job(const std::shared_ptr<Job>& job) {
+    auto complete = [job]() {
+        neutral_atom_vm::trace::Span span("scheduler", "complete");
+        try {
+            job->work.complete();
+        } catch (...) {
+        }
+    };
+    if (finish_stage_) {
+        finish_stage_->push(std::move(complete));
+    } else {
+        complete();
+    }
+}
+
+}  // namespace service
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "service/pipeline_stage.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace service {
+
+// Share and limits of one tenant. Zero leaves a limit unbounded.
+struct TenantPolicy {
+    // Relative share of worker time while several tenants have work queued.
+    double weight = 1.0;
+    // Shot batches of the tenant running at once (one worker thread each).
+    std::size_t max_threads = 0;
+    // Statevector bytes held by the tenant's running batches, a hard ceiling:
+    // batches wait until they fit, and a job whose single batch is larger
+    // than the cap never runs (JobService fails it at planning).
+    std::size_t max_memory_bytes = 0;
+    // Jobs accepted but not yet finished; submissions beyond it are rejected.
+    std::size_t max_queued_jobs = 0;
+};
+
+struct FairShareOptions {
+    // Worker pool size; 0 uses std::thread::hardware_concurrency().
+    std::size_t worker_threads = 0;
+    // Shots per batch, the unit the scheduler interleaves and preempts at.
+    // Jobs too small to give every worker they may use a full batch are
+    // split into smaller ones, so a lone job still fills the pool.
+    std::size_t shots_per_batch = 64;
+    // Policy of tenants without an explicit set_policy().
+    TenantPolicy default_policy;
+    // Threads of the prepare stage, which plans (compiles) queued jobs while
+    // the workers simulate earlier ones, and of the finish stage, which runs
+    // `complete` (merging and storing results) off the workers. 0 runs the
+    // stage on the workers between batches.
+    std::size_t prepare_threads = 1;
+    std::size_t finish_threads = 1;
+};
+
+// Thrown when a submission would exceed the tenant's queued-job quota.
+class QuotaExceeded : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+// Result of planning a job (compiling it, usually).
+struct WorkPlan {
+    // Shots left to run; 0 finishes the job without running batches.
+    std::size_t shots = 0;
+    // Memory one running batch holds, charged against the tenant's cap.
+    std::size_t batch_memory_bytes = 0;
+    // Relative cost of one shot; virtual time advances by shots x cost.
+    double shot_cost = 1.0;
+};
+
+// A job as the scheduler sees it. `plan` runs once in the prepare stage;
+// `run_batch` then runs for consecutive shot ranges, possibly on several
+// workers at once; `complete` runs once in the finish stage after the last
+// batch. The callbacks report their own failures and must not throw.
+struct ScheduledJob {
+    std::string tenant;
+    // Batches of this job running at once; 0 leaves it to the tenant's cap.
+    std::size_t max_parallel = 0;
+    std::function<WorkPlan()> plan;
+    std::function<void(std::size_t first, std::size_t count)> run_batch;
+    std::function<void()> complete;
+};
+
+struct TenantStats {
+    std::size_t queued_jobs = 0;      // accepted and not finished
+    std::size_t running_tasks = 0;    // batches (and inline plans) on workers
+    std::size_t memory_bytes = 0;     // held by running batches
+    double virtual_time = 0.0;
+};
+
+// Weighted fair queuing over shot batches. Each tenant owns a FIFO of jobs
+// and a virtual time that advances by the cost of every batch dispatched for
+// it divided by its weight; idle workers take the next batch of the eligible
+// tenant with the smallest virtual time. A long job therefore yields its
+// worker between batches, and a small job from another tenant starts within
+// one batch time instead of waiting for the long job to end.
+//
+// Planning and completion run in their own pipeline stages, so job k+1 is
+// compiled while job k simulates and job k-1 is merged and stored.
+class FairShareScheduler {
+  public:
+    explicit FairShareScheduler(FairShareOptions options = {});
+    // Stops the workers after their current task; queued jobs are dropped.
+    ~FairShareScheduler();
+
+    FairShareScheduler(const FairShareScheduler&) = delete;
+    FairShareScheduler& operator=(const FairShareScheduler&) = delete;
+
+    // Queue jobs. Jobs of one call are admitted together or, if any tenant
+    // would exceed its queued-job quota, not at all (QuotaExceeded).
+    // `enforce_quota = false` admits them regardless, e.g. jobs recovered
+    // after a restart that were already accepted once.
+    void submit(std::vector<ScheduledJob> jobs, bool enforce_quota = true);
+    void submit(ScheduledJob job);
+
+    void set_policy(const std::string& tenant, TenantPolicy policy);
+    TenantPolicy policy(const std::string& tenant) const;
+    TenantStats stats(const std::string& tenant) const;
+
+    const FairShareOptions& options() const { return options_; }
+
+  private:
+    struct Job {
+        ScheduledJob work;
+        WorkPlan plan;
+        std::size_t batch_shots = 1;  // set from the plan
+        bool planning = false;
+        bool planned = false;
+        std::size_t next_shot = 0;
+        std::size_t running = 0;
+        std::size_t finished_shots = 0;
+    };
+
+    struct Tenant {
+        TenantPolicy policy;
+        double virtual_time = 0.0;
+        std::deque<std::shared_ptr<Job>> pending;  // jobs with work left to dispatch
+        std::size_t queued_jobs = 0;
+        std::size_t running_tasks = 0;
+        std::size_t memory_bytes = 0;
+    };
+
+    struct Task {
+        Tenant* tenant = nullptr;
+        std::shared_ptr<Job> job;
+        bool plan = false;
+        std::size_t first = 0;
+        std::size_t count = 0;
+    };
+
+    Tenant& tenant_locked(const std::string& name);
+    bool next_task_locked(Task& task);
+    void worker_loop();
+    void finish_task(const Task& task, const WorkPlan& plan);
+    void plan_job(Tenant& tenant, const std::shared_ptr<Job>& job);
+    // Returns true if the job has no shots to run.
+    bool apply_plan_locked(Tenant& tenant, const std::shared_ptr<Job>& job, const WorkPlan& plan);
+    void complete_job(const std::shared_ptr<Job>& job);
+
+    FairShareOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, Tenant> tenants_;
+    double virtual_clock_ = 0.0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+    std::unique_ptr<PipelineStage> prepare_stage_;
+    std::unique_ptr<PipelineStage> finish_stage_;
+};
+
+}  // namespace service
@@ -0,0 +1,694 @@
+#include "service/http_server.hpp"
+
+#include "service/json.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+namespace service {
+
+namespace {
+
+constexpr std::size_t kReadChunk = 16 * 1024;
+constexpr int kMaxEvents = 64;
+
+std::string lower(std::string_view text) {
+    std::string out(text);
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    return out;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool has_token(const std::string* header, std::string_view token) {
+    return header != nullptr && lower(*header).find(token) != std::string::npos;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::runtime_error("http server: " + what + ": " + std::strerror(errno));
+}
+
+// Parse the request line and headers in `head` (without the blank line).
+// Returns false on malformed input.
+bool parse_head(std::string_view head, HttpRequest& request) {
+    const std::size_t line_end = head.find("\r\n");
+    const std::string_view line = head.substr(0, line_end);
+    const std::size_t first_space = line.find(' ');
+    const std::size_t last_space = line.rfind(' ');
+    if (first_space == std::string_view::npos || first_space == last_space) {
+        return false;
+    }
+    request.method = std::string(line.substr(0, first_space));
+    std::string_view target = line.substr(first_space + 1, last_space - first_space - 1);
+    request.version = std::string(line.substr(last_space + 1));
+    if (request.method.empty() || target.empty() || request.version.rfind("HTTP/1.", 0) != 0) {
+        return false;
+    }
+    const std::size_t query_start = target.find('?');
+    if (query_start != std::string_view::npos) {
+        request.query = std::string(target.substr(query_start + 1));
+        target = target.substr(0, query_start);
+    }
+    request.path = std::string(target);
+
+    std::size_t pos = line_end == std::string_view::npos ? head.size() : line_end + 2;
+    while (pos < head.size()) {
+        std::size_t next = head.find("\r\n", pos);
+        if (next == std::string_view::npos) {
+            next = head.size();
+        }
+        const std::string_view header = head.substr(pos, next - pos);
+        const std::size_t colon = header.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return false;
+        }
+        request.headers.emplace_back(
+            lower(header.substr(0, colon)), std::string(trim(header.substr(colon + 1))));
+        pos = next + 2;
+    }
+    return true;
+}
+
+// Status line and headers. `framing` is the Content-Length or
+// Transfer-Encoding header line, or empty for a close-delimited body.
+std::string response_head(const HttpResponse& response, bool keep_alive, std::string_view framing) {
+    std::string head = "HTTP/1.1 ";
+    head += std::to_string(response.status);
+    head += ' ';
+    head += http_reason_phrase(response.status);
+    head += "\r\nContent-Type: ";
+    head += response.content_type;
+    head += "\r\n";
+    for (const auto& [name, value] : response.headers) {
+        head += name;
+        head += ": ";
+        head += value;
+        head += "\r\n";
+    }
+    if (!framing.empty()) {
+        head += framing;
+        head += "\r\n";
+    }
+    head += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    return head;
+}
+
+void append_response(std::string& out, const HttpResponse& response, bool keep_alive) {
+    out += response_head(
+        response, keep_alive, "Content-Length: " + std::to_string(response.body.size()));
+    out += response.body;
+}
+
+HttpResponse error_response(int status, const std::string& message) {
+    JsonWriter body;
+    body.begin_object().field("error", message).end_object();
+    HttpResponse response;
+    response.status = status;
+    response.body = body.take();
+    return response;
+}
+
+}  // namespace
+
+const std::string* HttpRequest::header(std::string_view name) const {
+    for (const auto& [key, value] : headers) {
+        if (key == name) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+const char* http_reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        case 415: return "Unsupported Media Type";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+// Output of one streaming response. The producer thread frames chunks into
+// `pending`; the event loop moves them to the connection once its previous
+// output has been flushed, which is what bounds the backlog.
+struct HttpServer::Stream final : ChunkWriter {
+    Stream(HttpServer& server, std::size_t limit, bool chunked)
+        : server(server), limit(limit), chunked(chunked) {}
+
+    bool write(std::string_view data) override {
+        if (data.empty()) {
+            return open();
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            space.wait(lock, [this]() { return aborted || pending.size() < limit; });
+            if (aborted) {
+                return false;
+            }
+            if (chunked) {
+                char size[2 * sizeof(std::size_t)];
+                const auto end = std::to_chars(size, size + sizeof(size), data.size(), 16).ptr;
+                pending.append(size, end);
+                pending += "\r\n";
+                pending.append(data);
+                pending += "\r\n";
+            } else {
+                pending.append(data);
+            }
+        }
+        server.wake();
+        return true;
+    }
+
+    bool open() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !aborted;
+    }
+
+    void abort() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+        }
+        space.notify_all();
+    }
+
+    // Finished, or abandoned by a deferred reply nobody will complete.
+    bool done() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return finished || (aborted && !thread.joinable());
+    }
+
+    HttpServer& server;
+    const std::size_t limit;
+    const bool chunked;
+    mutable std::mutex mutex;
+    std::condition_variable space;
+    std::string pending;
+    bool finished = false;  // producer returned
+    bool failed = false;    // producer threw; the response is truncated
+    bool aborted = false;   // connection gone
+    std::thread thread;
+};
+
+struct HttpServer::Connection {
+    explicit Connection(int fd) : fd(fd) {}
+
+    int fd;
+    std::string in;
+    std::string out;
+    std::size_t out_offset = 0;
+    bool close_after_flush = false;
+    bool read_closed = false;  // peer shut down its sending side
+    bool keep_alive_after_stream = true;
+    std::uint32_t interest = 0;
+    std::shared_ptr<Stream> stream;
+};
+
+HttpServer::HttpServer(HttpServerOptions options, HttpHandler handler)
+    : options_(std::move(options)), handler_(std::move(handler)) {}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+void HttpServer::start() {
+    if (loop_.joinable()) {
+        throw std::runtime_error("http server: already started");
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options_.port);
+    const std::string host = options_.host == "localhost" ? "127.0.0.1" : options_.host;
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        throw std::runtime_error("http server: invalid IPv4 address '" + options_.host + "'");
+    }
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw_errno("socket");
+    }
+    try {
+        const int enable = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            throw_errno("bind " + options_.host + ":" + std::to_string(options_.port));
+        }
+        if (::listen(listen_fd_, SOMAXCONN) != 0) {
+            throw_errno("listen");
+        }
+        socklen_t length = sizeof(addr);
+        if (::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+            throw_errno("getsockname");
+        }
+        port_ = ntohs(addr.sin_port);
+
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) {
+            throw_errno("epoll_create1");
+        }
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            throw_errno("eventfd");
+        }
+        for (int fd : {listen_fd_, wake_fd_}) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+                throw_errno("epoll_ctl");
+            }
+        }
+    } catch (...) {
+        for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+        throw;
+    }
+    stopping_.store(false);
+    loop_ = std::thread([this]() { run(); });
+}
+
+void HttpServer::stop() {
+    if (!loop_.joinable()) {
+        return;
+    }
+    stopping_.store(true);
+    wake();
+    loop_.join();
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void HttpServer::wake() {
+    const std::uint64_t one = 1;
+    // A full counter already guarantees a pending wakeup.
+    [[maybe_unused]] const auto written = ::write(wake_fd_, &one, sizeof(one));
+}
+
+void HttpServer::run() {
+    epoll_event events[kMaxEvents];
+    while (!stopping_.load()) {
+        const int ready = ::epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int idx = 0; idx < ready; ++idx) {
+            const int fd = events[idx].data.fd;
+            const std::uint32_t flags = events[idx].events;
+            if (fd == listen_fd_) {
+                accept_connections();
+            } else if (fd == wake_fd_) {
+                std::uint64_t count = 0;
+                [[maybe_unused]] const auto read = ::read(wake_fd_, &count, sizeof(count));
+                drain_streams();
+            } else if (static_cast<std::size_t>(fd) < connections_.size() && connections_[fd]) {
+                if (flags & EPOLLIN) {
+                    handle_readable(*connections_[fd]);
+                } else if (flags & (EPOLLERR | EPOLLHUP)) {
+                    close_connection(fd);
+                    continue;
+                }
+                if (static_cast<std::size_t>(fd) < connections_.size() && connections_[fd]
+                    && (flags & EPOLLOUT)) {
+                    handle_writable(*connections_[fd]);
+                }
+            }
+        }
+        reap_streams(false);
+    }
+    for (std::size_t fd = 0; fd < connections_.size(); ++fd) {
+        if (connections_[fd]) {
+            close_connection(static_cast<int>(fd));
+        }
+    }
+    reap_streams(true);
+}
+
+void HttpServer::accept_connections() {
+    while (true) {
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;  // EAGAIN, or out of descriptors until a connection closes
+        }
+        const int enable = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        if (static_cast<std::size_t>(fd) >= connections_.size()) {
+            connections_.resize(static_cast<std::size_t>(fd) + 1);
+        }
+        connections_[fd] = std::make_unique<Connection>(fd);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            connections_[fd].reset();
+            ::close(fd);
+            continue;
+        }
+        connections_[fd]->interest = EPOLLIN;
+    }
+}
+
+void HttpServer::handle_readable(Connection& conn) {
+    const int fd = conn.fd;
+    char buffer[kReadChunk];
+    while (true) {
+        const ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            conn.in.append(buffer, static_cast<std::size_t>(received));
+            continue;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received < 0) {
+            close_connection(fd);  // hard error
+            return;
+        }
+        // Half-close: the client sent everything it will. Answer the
+        // complete requests already buffered, then close once flushed.
+        conn.read_closed = true;
+        break;
+    }
+    process_requests(conn);
+}
+
+void HttpServer::handle_writable(Connection& conn) {
+    flush(conn);
+}
+
+void HttpServer::process_requests(Connection& conn) {
+    const auto fail = [&conn](int status, const std::string& message) {
+        append_response(conn.out, error_response(status, message), false);
+        conn.in.clear();
+        conn.close_after_flush = true;
+    };
+    while (!conn.stream && !conn.close_after_flush) {
+        const std::size_t head_end = conn.in.find("\r\n\r\n");
+        if (head_end == std::string::npos) {
+            if (conn.in.size() > options_.max_header_bytes) {
+                fail(431, "request head too large");
+            }
+            break;
+        }
+        if (head_end > options_.max_header_bytes) {
+            fail(431, "request head too large");
+            break;
+        }
+        HttpRequest request;
+        if (!parse_head(std::string_view(conn.in).substr(0, head_end), request)) {
+            fail(400, "malformed request");
+            break;
+        }
+        if (request.header("transfer-encoding") != nullptr) {
+            fail(411, "chunked request bodies are not supported; send Content-Length");
+            break;
+        }
+        std::size_t body_length = 0;
+        if (const std::string* length = request.header("content-length")) {
+            const auto [ptr, ec] = std::from_chars(
+                length->data(), length->data() + length->size(), body_length);
+            if (ec != std::errc() || ptr != length->data() + length->size()) {
+                fail(400, "invalid Content-Length");
+                break;
+            }
+        }
+        if (body_length > options_.max_body_bytes) {
+            fail(413, "request body too large");
+            break;
+        }
+        const std::size_t body_start = head_end + 4;
+        if (conn.in.size() - body_start < body_length) {
+            break;  // wait for the rest of the body
+        }
+        request.body = conn.in.substr(body_start, body_length);
+        conn.in.erase(0, body_start + body_length);
+
+        const std::string* connection = request.header("connection");
+        const bool keep_alive = !stopping_.load()
+            && (request.version == "HTTP/1.0" ? has_token(connection, "keep-alive")
+                                              : !has_token(connection, "close"));
+        dispatch(conn, std::move(request), keep_alive);
+    }
+    flush(conn);
+}
+
+void HttpServer::dispatch(Connection& conn, HttpRequest request, bool keep_alive) {
+    const bool http10 = request.version == "HTTP/1.0";
+    HttpReply reply;
+    try {
+        reply = handler_(request);
+    } catch (const std::exception& ex) {
+        reply = HttpReply{error_response(500, ex.what()), {}, {}};
+    }
+
+    if (!reply.stream && reply.deferred) {
+        // A stream without a producer thread: the completion writes the
+        // whole response into `pending` and wakes the loop to send it.
+        auto stream = std::make_shared<Stream>(*this, options_.max_stream_backlog, false);
+        conn.stream = stream;
+        conn.keep_alive_after_stream = keep_alive;
+        ReplyCompletion complete = [stream, keep_alive](HttpResponse response) {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            if (stream->aborted || stream->finished) {
+                return;
+            }
+            append_response(stream->pending, response, keep_alive);
+            stream->finished = true;
+            // Under the lock: once abort() returns, the server is not touched.
+            stream->server.wake();
+        };
+        try {
+            reply.deferred(complete);
+        } catch (const std::exception& ex) {
+            complete(error_response(500, ex.what()));
+        }
+        return;
+    }
+
+    if (!reply.stream) {
+        append_response(conn.out, reply.response, keep_alive);
+        conn.close_after_flush = !keep_alive;
+        return;
+    }
+
+    // Bound the producer threads: past the limit the client retries later.
+    std::shared_ptr<Stream> stream;
+    if (running_streams_.load() < options_.max_streams) {
+        // HTTP/1.0 has no chunked encoding: stream the raw body and close.
+        stream = std::make_shared<Stream>(*this, options_.max_stream_backlog, !http10);
+        ++running_streams_;
+        try {
+            stream->thread = std::thread([stream, producer = std::move(reply.stream)]() {
+                bool failed = false;
+                try {
+                    producer(*stream);
+                } catch (...) {
+                    failed = true;
+                }
+                // Before `finished`: a client that saw the end may stream again.
+                --stream->server.running_streams_;
+                {
+                    std::lock_guard<std::mutex> lock(stream->mutex);
+                    if (stream->chunked && !failed) {
+                        stream->pending += "0\r\n\r\n";
+                    }
+                    stream->failed = failed;
+                    stream->finished = true;
+                }
+                stream->server.wake();
+            });
+        } catch (const std::system_error&) {
+            --running_streams_;
+            stream.reset();
+        }
+    }
+    if (!stream) {
+        HttpResponse busy = error_response(503, "too many streaming responses");
+        busy.headers.emplace_back("Retry-After", "1");
+        append_response(conn.out, busy, keep_alive);
+        conn.close_after_flush = !keep_alive;
+        return;
+    }
+    // The producer only fills `pending`; nothing reaches the socket before
+    // the head below.
+    conn.out += response_head(
+        reply.response, stream->chunked && keep_alive, stream->chunked ? "Transfer-Encoding: chunked" : "");
+    conn.keep_alive_after_stream = stream->chunked && keep_alive;
+    conn.stream = std::move(stream);
+}
+
+void HttpServer::drain_streams() {
+    for (std::size_t fd = 0; fd < connections_.size(); ++fd) {
+        if (connections_[fd] && connections_[fd]->stream) {
+            flush(*connections_[fd]);
+        }
+    }
+}
+
+void HttpServer::flush(Connection& conn) {
+    const int fd = conn.fd;
+    while (true) {
+        while (conn.out_offset < conn.out.size()) {
+            const ssize_t sent = ::send(fd, conn.out.data() + conn.out_offset,
+                conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+            if (sent > 0) {
+                conn.out_offset += static_cast<std::size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                update_interest(conn);
+                return;
+            }
+            close_connection(fd);
+            return;
+        }
+        conn.out.clear();
+        conn.out_offset = 0;
+        if (conn.close_after_flush) {
+            close_connection(fd);
+            return;
+        }
+        if (!conn.stream) {
+            break;
+        }
+
+        // Previous output is on the wire: hand over the next streamed bytes.
+        Stream& stream = *conn.stream;
+        bool finished = false;
+        bool failed = false;
+        {
+            std::lock_guard<std::mutex> lock(stream.mutex);
+            conn.out.swap(stream.pending);
+            finished = stream.finished;
+            failed = stream.failed;
+        }
+        stream.space.notify_all();
+        if (!conn.out.empty()) {
+            continue;
+        }
+        if (!finished) {
+            break;  // producer still running
+        }
+        if (failed || !conn.keep_alive_after_stream) {
+            close_connection(fd);
+            return;
+        }
+        retired_streams_.push_back(std::move(conn.stream));
+        // Requests pipelined behind the stream can now be served.
+        if (!conn.in.empty()) {
+            process_requests(conn);
+            return;
+        }
+        break;
+    }
+    if (conn.read_closed && !conn.stream && conn.out.empty()) {
+        // Every response the half-closed peer can still get has been sent;
+        // a partial request left in `in` can never complete.
+        close_connection(fd);
+        return;
+    }
+    update_interest(conn);
+}
+
+void HttpServer::update_interest(Connection& conn) {
+    std::uint32_t interest = 0;
+    if (!conn.stream && !conn.close_after_flush && !conn.read_closed) {
+        interest |= EPOLLIN;
+    }
+    if (conn.out_offset < conn.out.size()) {
+        interest |= EPOLLOUT;
+    }
+    if (interest == conn.interest) {
+        return;
+    }
+    epoll_event event{};
+    event.events = interest;
+    event.data.fd = conn.fd;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &event);
+    conn.interest = interest;
+}
+
+void HttpServer::close_connection(int fd) {
+    std::unique_ptr<Connection> conn = std::move(connections_[fd]);
+    if (!conn) {
+        return;
+    }
+    if (conn->stream) {
+        conn->stream->abort();
+        retired_streams_.push_back(std::move(conn->stream));
+    }
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+}
+
+void HttpServer::reap_streams(bool wait) {
+    auto it = retired_streams_.begin();
+    while (it != retired_streams_.end()) {
+        if (wait || (*it)->done()) {
+            if ((*it)->thread.joinable()) {
+                (*it)->thread.join();
+            }
+            it = retired_streams_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace service
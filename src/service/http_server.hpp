@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace service {
+
+struct HttpRequest {
+    std::string method;
+    std::string path;   // request target without the query string
+    std::string query;  // text after '?', empty when absent
+    std::string version;  // "HTTP/1.1" or "HTTP/1.0"
+    // Header names are lower-cased; values have surrounding whitespace trimmed.
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // First header with the given (lower-case) name, or nullptr.
+    const std::string* header(std::string_view name) const;
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string content_type = "application/json";
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+};
+
+// Sink handed to streaming handlers. Each write() is sent as one HTTP chunk.
+class ChunkWriter {
+  public:
+    virtual ~ChunkWriter() = default;
+
+    // Queue a chunk. Blocks while the connection already has too much
+    // unsent output, so a slow client throttles the producer. Returns false
+    // once the client has gone away or the server is stopping.
+    virtual bool write(std::string_view data) = 0;
+    // False once writes can no longer reach the client.
+    virtual bool open() const = 0;
+};
+
+using StreamProducer = std::function<void(ChunkWriter&)>;
+
+// Completes a deferred reply. Call it once, from any thread.
+using ReplyCompletion = std::function<void(HttpResponse)>;
+// Starts work whose response is not known yet. Runs on the event-loop thread
+// and must not block.
+using DeferredReply = std::function<void(ReplyCompletion)>;
+
+// What a handler returns. When `stream` is set the response is sent with
+// chunked transfer encoding: `response.body` is ignored and `stream` runs on
+// a dedicated thread until it returns (at most
+// HttpServerOptions::max_streams at once; further streams are refused with
+// 503). Otherwise, when `deferred` is set,
+// `response` is ignored and the connection waits for the response `deferred`
+// completes; requests pipelined behind it are served afterwards.
+struct HttpReply {
+    HttpResponse response;
+    StreamProducer stream;
+    DeferredReply deferred;
+};
+
+// Handlers run on the event-loop thread and must not block; long-running
+// output belongs in a StreamProducer, waits in a DeferredReply.
+using HttpHandler = std::function<HttpReply(const HttpRequest&)>;
+
+struct HttpServerOptions {
+    std::string host = "127.0.0.1";
+    std::uint16_t port = 0;  // 0 picks an ephemeral port, see HttpServer::port()
+    std::size_t max_header_bytes = 64 * 1024;
+    std::size_t max_body_bytes = 64 * 1024 * 1024;
+    // Unsent streamed bytes per connection before producers block.
+    std::size_t max_stream_backlog = 1024 * 1024;
+    // Stream producers running at once (one thread each). Streaming requests
+    // beyond this get 503 with Retry-After instead of another thread.
+    std::size_t max_streams = 64;
+};
+
+// Minimal HTTP/1.1 server: one epoll event loop over non-blocking sockets
+// with keep-alive, pipelined requests, Content-Length request bodies, and
+// chunked streaming responses. Linux only.
+class HttpServer {
+  public:
+    HttpServer(HttpServerOptions options, HttpHandler handler);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Bind, listen, and start the event loop. Throws std::runtime_error if
+    // the socket cannot be set up.
+    void start();
+    // Close every connection, finish streaming threads, and join the loop.
+    void stop();
+
+    // Bound port; valid after start().
+    std::uint16_t port() const { return port_; }
+
+  private:
+    struct Connection;
+    struct Stream;
+
+    void run();
+    void accept_connections();
+    void handle_readable(Connection& conn);
+    void handle_writable(Connection& conn);
+    void process_requests(Connection& conn);
+    void dispatch(Connection& conn, HttpRequest request, bool keep_alive);
+    void drain_streams();
+    void flush(Connection& conn);
+    void update_interest(Connection& conn);
+    void close_connection(int fd);
+    void reap_streams(bool wait);
+    void wake();
+
+    HttpServerOptions options_;
+    HttpHandler handler_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::uint16_t port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::size_t> running_streams_{0};  // producer threads not yet returned
+    std::thread loop_;
+    std::vector<std::unique_ptr<Connection>> connections_;  // indexed by fd
+    std::vector<std::shared_ptr<Stream>> retired_streams_;
+};
+
+const char* http_reason_phrase(int status);
+
+}  // namespace service
@@ -1,15 +1,26 @@
 #include "service/job.hpp"
+
+#include "cpu_time.hpp"
 #include "hardware_vm.hpp"
 #include "service/job_validation.hpp"
+#include "service/json.hpp"
+#include "service/result_cache.hpp"
 #include "service/scheduler.hpp"
+#include "trace.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <complex>
 #include <chrono>
 #include <iomanip>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <set>
+#include <span>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
 namespace {
@@ -19,32 +30,9 @@ constexpr const char* kDisplayTimeUnit = "us";
 constexpr double kDefaultSingleQubitDurationNs = 500.0;
 constexpr double kDefaultTwoQubitDurationNs = 1000.0;
 constexpr double kDefaultMeasurementDurationNs = 50000.0;
+constexpr double kCacheLineBytes = 64.0;
 
-std::string escape_json(const std::string& str) {
-    std::ostringstream out;
-    for (const char ch : str) {
-        switch (ch) {
-            case '"':
-                out << "\\\"";
-                break;
-            case '\\':
-                out << "\\\\";
-                break;
-            case '\n':
-                out << "\\n";
-                break;
-            case '\r':
-                out << "\\r";
-                break;
-            case '\t':
-                out << "\\t";
-                break;
-            default:
-                out << ch;
-        }
-    }
-    return out.str();
-}
+using service::escape_json;
 
 std::vector<ExecutionLog> build_timeline_logs(const std::vector<service::TimelineEntry>& timeline) {
     std::vector<ExecutionLog> entries;
@@ -79,7 +67,7 @@ void convert_logs_to_microseconds(std::vector<ExecutionLog>& logs) {
     }
 }
 
-void append_int_array(const std::vector<int>& values, std::ostringstream& out) {
+void append_int_array(std::span<const int> values, std::ostringstream& out) {
     out << '[';
     for (std::size_t i = 0; i < values.size(); ++i) {
         if (i > 0) {
@@ -351,7 +339,53 @@ void ensure_coordinates_from_sites(HardwareConfig& hw) {
     }
 }
 
-void append_instruction_json(const Instruction& instr, std::ostringstream& out) {
+void append_pauli_config_json(const SingleQubitPauliConfig& cfg, std::ostringstream& out) {
+    out << "{\"px\":" << cfg.px
+        << ",\"py\":" << cfg.py
+        << ",\"pz\":" << cfg.pz << '}';
+}
+
+void append_noise_config_json(const SimpleNoiseConfig& cfg, std::ostringstream& out) {
+    out << '{'
+        << "\"p_quantum_flip\":" << cfg.p_quantum_flip
+        << ",\"p_loss\":" << cfg.p_loss
+        << ",\"readout\":{\"p_flip0_to_1\":" << cfg.readout.p_flip0_to_1
+        << ",\"p_flip1_to_0\":" << cfg.readout.p_flip1_to_0 << '}';
+    out << ",\"gate\":{\"single_qubit\":";
+    append_pauli_config_json(cfg.gate.single_qubit, out);
+    out << ",\"two_qubit_control\":";
+    append_pauli_config_json(cfg.gate.two_qubit_control, out);
+    out << ",\"two_qubit_target\":";
+    append_pauli_config_json(cfg.gate.two_qubit_target, out);
+    out << '}';
+    out << ",\"correlated_gate\":{\"matrix\":[";
+    for (std::size_t row = 0; row < 4; ++row) {
+        if (row > 0) {
+            out << ',';
+        }
+        out << '[';
+        for (std::size_t col = 0; col < 4; ++col) {
+            if (col > 0) {
+                out << ',';
+            }
+            out << cfg.correlated_gate.matrix[4 * row + col];
+        }
+        out << ']';
+    }
+    out << "]}";
+    out << ",\"idle_rate\":" << cfg.idle_rate;
+    out << ",\"phase\":{\"single_qubit\":" << cfg.phase.single_qubit
+        << ",\"two_qubit_control\":" << cfg.phase.two_qubit_control
+        << ",\"two_qubit_target\":" << cfg.phase.two_qubit_target
+        << ",\"idle\":" << cfg.phase.idle << '}';
+    out << ",\"amplitude_damping\":{\"per_gate\":" << cfg.amplitude_damping.per_gate
+        << ",\"idle_rate\":" << cfg.amplitude_damping.idle_rate << '}';
+    out << ",\"loss_runtime\":{\"per_gate\":" << cfg.loss_runtime.per_gate
+        << ",\"idle_rate\":" << cfg.loss_runtime.idle_rate << '}';
+    out << '}';
+}
+
+void append_instruction_json(const Program& program, const Instruction& instr, std::ostringstream& out) {
     out << "{\"op\":\"";
     switch (instr.op) {
         case Op::AllocArray: {
@@ -363,12 +397,16 @@ void append_instruction_json(const Instruction& instr, std::ostringstream& out)
             out << "ApplyGate\",\"gate\":{\"name\":\"" << escape_json(gate.name)
                 << "\",\"targets\":";
             append_int_array(gate.targets, out);
-            out << ",\"param\":" << gate.param << '}';
+            if (gate.symbol.empty()) {
+                out << ",\"param\":" << gate.param << '}';
+            } else {
+                out << ",\"param\":\"" << escape_json(gate.symbol) << "\"}";
+            }
             break;
         }
         case Op::Measure: {
             out << "Measure\",\"targets\":";
-            append_int_array(std::get<std::vector<int>>(instr.payload), out);
+            append_int_array(program.targets(instr), out);
             break;
         }
         case Op::MoveAtom: {
@@ -389,6 +427,12 @@ void append_instruction_json(const Instruction& instr, std::ostringstream& out)
                 << ",\"duration\":" << pulse.duration;
             break;
         }
+        case Op::Repeat: {
+            const auto& repeat = std::get<RepeatInstruction>(instr.payload);
+            out << "Repeat\",\"count\":" << repeat.count
+                << ",\"body_size\":" << repeat.body_size;
+            break;
+        }
         default:
             throw std::runtime_error("Unsupported instruction for serialization");
     }
@@ -405,6 +449,16 @@ BackendKind backend_for_device(const std::string& device_id) {
     return BackendKind::kCpu;
 }
 
+std::string backend_name(BackendKind backend) {
+    switch (backend) {
+        case BackendKind::kCpu:
+            return "cpu";
+        case BackendKind::kStabilizer:
+            return "stabilizer";
+    }
+    return "unknown";
+}
+
 namespace {
 
 void enrich_hardware_with_profile_constraints(
@@ -495,7 +549,9 @@ void enrich_hardware_with_profile_constraints(
 
 std::string to_json(const JobRequest& job) {
     std::ostringstream out;
-    out << std::setprecision(15);
+    // Round-trip precision: canonical_cache_key hashes this text, so distinct
+    // doubles must print differently.
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
     out << '{';
     out << "\"job_id\":\"" << escape_json(job.job_id) << "\",";
     out << "\"device_id\":\"" << escape_json(job.device_id) << "\",";
@@ -556,7 +612,7 @@ std::string to_json(const JobRequest& job) {
         if (i > 0) {
             out << ',';
         }
-        append_instruction_json(job.program[i], out);
+        append_instruction_json(job.program, job.program[i], out);
     }
     out << "],";
     if (job.max_threads > 0) {
@@ -575,10 +631,48 @@ std::string to_json(const JobRequest& job) {
     if (job.stim_circuit) {
         out << ",\"stim_circuit\":\"" << escape_json(*job.stim_circuit) << "\"";
     }
+    if (job.noise_config) {
+        out << ",\"noise\":";
+        append_noise_config_json(*job.noise_config, out);
+    }
+    if (job.seed) {
+        out << ",\"seed\":" << *job.seed;
+    }
+    if (!job.parameters.empty()) {
+        out << ",\"parameters\":{";
+        bool first_parameter = true;
+        for (const auto& [name, value] : job.parameters) {
+            if (!first_parameter) {
+                out << ',';
+            }
+            first_parameter = false;
+            out << "\"" << escape_json(name) << "\":" << value;
+        }
+        out << '}';
+    }
     out << '}';
     return out.str();
 }
 
+std::vector<std::uint64_t> derive_shot_seeds(
+    std::uint64_t seed,
+    std::size_t first_shot,
+    std::size_t count
+) {
+    // SplitMix64: the i-th output only depends on seed + i * gamma, which
+    // lets callers derive any shot range without replaying earlier shots.
+    constexpr std::uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+    std::vector<std::uint64_t> seeds;
+    seeds.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        std::uint64_t z = seed + kGamma * static_cast<std::uint64_t>(first_shot + idx + 1);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        seeds.push_back(z ^ (z >> 31));
+    }
+    return seeds;
+}
+
 std::string status_to_string(JobStatus status) {
     switch (status) {
         case JobStatus::Pending:
@@ -593,99 +687,750 @@ std::string status_to_string(JobStatus status) {
     return "unknown";
 }
 
+namespace {
+
+// Resolve the device profile for a request: ISA gate, hardware enrichment
+// and backend selection. Cheap enough to run before a cache lookup.
+DeviceProfile prepare_profile(const JobRequest& job) {
+    if (!is_supported_isa_version(job.isa_version)) {
+        throw std::runtime_error(
+            "Unsupported ISA version " + to_string(job.isa_version) +
+            " (supported: " + supported_versions_to_string() + ")");
+    }
+    // Hardware VM façade: select a concrete device profile and execute
+    // the ISA program on a backend engine. For now all devices share the
+    // same statevector backend, but the profile struct gives us a place
+    // to hang future differences (noise, capabilities, backend kind).
+    DeviceProfile profile;
+    profile.id = job.device_id;
+    profile.isa_version = job.isa_version;
+    profile.hardware = job.hardware;
+    HardwareConfig& hw = profile.hardware;
+    populate_sites_from_coordinates(hw);
+    enrich_hardware_with_profile_constraints(job, hw);
+    ensure_site_ids(hw);
+    ensure_positions_from_sites(hw);
+    ensure_coordinates_from_sites(hw);
+    profile.backend = backend_for_device(job.device_id);
+    if (job.stim_circuit) {
+        profile.stim_circuit_text = job.stim_circuit;
+    }
+    return profile;
+}
+
+// Adds the wall and CPU time of its scope to a JobProfile stage and traces
+// it as a "job" span.
+class StageClock {
+  public:
+    StageClock(const char* stage, StageTiming* timing)
+        : span_("job", stage),
+          timing_(timing),
+          wall_start_(std::chrono::steady_clock::now()),
+          cpu_start_(timing ? thread_cpu_seconds() : 0.0) {}
+
+    ~StageClock() {
+        if (timing_) {
+            timing_->wall_seconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start_).count();
+            timing_->cpu_seconds += thread_cpu_seconds() - cpu_start_;
+        }
+    }
+
+    StageClock(const StageClock&) = delete;
+    StageClock& operator=(const StageClock&) = delete;
+
+  private:
+    neutral_atom_vm::trace::Span span_;
+    StageTiming* timing_;
+    std::chrono::steady_clock::time_point wall_start_;
+    double cpu_start_;
+};
+
+CompiledJob compile_profile(
+    const JobRequest& job,
+    DeviceProfile profile,
+    JobMetrics* metrics,
+    JobProfile* job_profile = nullptr
+) {
+    {
+        ScopedTimer timer(metrics ? &metrics->validate_seconds : nullptr);
+        StageClock clock("validate", job_profile ? &job_profile->validate : nullptr);
+        validate_repeat_blocks(job.program);
+        auto validators = make_validator_registry_for(job, profile.hardware);
+        validators.run_all_validators(profile.hardware, job.program);
+    }
+
+    CompiledJob compiled;
+    {
+        ScopedTimer timer(metrics ? &metrics->schedule_seconds : nullptr);
+        StageClock clock("schedule", job_profile ? &job_profile->schedule : nullptr);
+        compiled.scheduled = schedule_program(job.program, profile.hardware);
+    }
+    compiled.profile = std::move(profile);
+    return compiled;
+}
+
+// Largest register allocated by a program; statevector size is 2^n.
+int allocated_qubits(const Program& program) {
+    int qubits = 0;
+    for (const auto& instr : program) {
+        if (instr.op == Op::AllocArray) {
+            qubits = std::max(qubits, std::get<int>(instr.payload));
+        }
+    }
+    return qubits;
+}
+
+// Gates executed by one shot; a Repeat body counts once per iteration.
+std::uint64_t count_gates(std::span<const Instruction> program) {
+    std::uint64_t gates = 0;
+    for (std::size_t idx = 0; idx < program.size(); ++idx) {
+        if (program[idx].op == Op::Repeat) {
+            const auto body = repeat_body(program, idx);
+            gates += static_cast<std::uint64_t>(std::get<RepeatInstruction>(program[idx].payload).count) *
+                     count_gates(body);
+            idx += body.size();
+        } else if (program[idx].op == Op::ApplyGate) {
+            ++gates;
+        }
+    }
+    return gates;
+}
+
+// Amplitudes of the dense statevector a CPU engine keeps for `program`, or 0
+// for backends without one.
+std::uint64_t statevector_amplitudes(const DeviceProfile& profile, const Program& program) {
+    const int qubits = allocated_qubits(program);
+    if (profile.backend != BackendKind::kCpu || qubits <= 0 || qubits >= 48) {
+        return 0;
+    }
+    return std::uint64_t{1} << qubits;
+}
+
+// Account simulation work and live statevector memory for one vm.run().
+class SimulationAccounting {
+  public:
+    SimulationAccounting(
+        JobMetrics* metrics,
+        const DeviceProfile& profile,
+        const Program& program,
+        int shots,
+        std::size_t threads
+    ) : metrics_(metrics) {
+        if (!metrics_) {
+            return;
+        }
+        const std::uint64_t gates = count_gates(program);
+        metrics_->shots.add(static_cast<std::uint64_t>(shots));
+        metrics_->gates.add(gates * static_cast<std::uint64_t>(shots));
+        metrics_->active_shots.add(shots);
+        shots_ = shots;
+        const std::uint64_t amplitudes = statevector_amplitudes(profile, program);
+        if (amplitudes > 0) {
+            metrics_->amplitude_updates.add(amplitudes * gates * static_cast<std::uint64_t>(shots));
+            // HardwareVM keeps one engine alive per worker thread.
+            std::size_t workers = threads > 0 ? threads : std::thread::hardware_concurrency();
+            workers = std::max<std::size_t>(1, std::min<std::size_t>(workers, shots));
+            bytes_ = static_cast<std::int64_t>(
+                amplitudes * sizeof(std::complex<double>) * workers);
+            metrics_->statevector_bytes.add(bytes_);
+        }
+    }
+
+    ~SimulationAccounting() {
+        if (metrics_) {
+            metrics_->active_shots.add(-shots_);
+            metrics_->statevector_bytes.add(-bytes_);
+        }
+    }
+
+    SimulationAccounting(const SimulationAccounting&) = delete;
+    SimulationAccounting& operator=(const SimulationAccounting&) = delete;
+
+  private:
+    JobMetrics* metrics_;
+    std::int64_t shots_ = 0;
+    std::int64_t bytes_ = 0;
+};
+
+bool has_symbolic_params(const Program& program) {
+    return std::any_of(program.begin(), program.end(), [](const Instruction& instr) {
+        return instr.op == Op::ApplyGate && !std::get<Gate>(instr.payload).symbol.empty();
+    });
+}
+
+}  // namespace
+
+std::vector<GateParamBinding> parameter_bindings(
+    const Program& program,
+    const ParameterSet& values
+) {
+    std::vector<GateParamBinding> bindings;
+    std::set<std::string> used;
+    for (std::size_t idx = 0; idx < program.size(); ++idx) {
+        if (program[idx].op != Op::ApplyGate) {
+            continue;
+        }
+        const auto& gate = std::get<Gate>(program[idx].payload);
+        if (gate.symbol.empty()) {
+            continue;
+        }
+        const auto it = values.find(gate.symbol.str());
+        if (it == values.end()) {
+            throw std::invalid_argument(
+                "Gate parameter '" + gate.symbol + "' of instruction " +
+                std::to_string(idx) + " has no value");
+        }
+        bindings.push_back(GateParamBinding{idx, it->second});
+        used.insert(it->first);
+    }
+    for (const auto& [name, value] : values) {
+        if (!used.count(name)) {
+            throw std::invalid_argument(
+                "Parameter '" + name + "' does not name a symbolic gate parameter of the program");
+        }
+    }
+    return bindings;
+}
+
+std::vector<GateParamBinding> override_bindings(const JobRequest& base, const JobOverride& item) {
+    std::vector<GateParamBinding> bindings;
+    if (item.parameters.empty()) {
+        bindings = parameter_bindings(base.program, base.parameters);
+    } else {
+        ParameterSet values = base.parameters;
+        for (const auto& [name, value] : item.parameters) {
+            values[name] = value;
+        }
+        bindings = parameter_bindings(base.program, values);
+    }
+    for (const auto& binding : item.gate_params) {
+        if (binding.instruction_index >= base.program.size() ||
+            base.program[binding.instruction_index].op != Op::ApplyGate) {
+            throw std::invalid_argument(
+                "Gate parameter binding references instruction " +
+                std::to_string(binding.instruction_index) + " which is not an ApplyGate");
+        }
+        bindings.push_back(binding);
+    }
+    return bindings;
+}
+
+JobRequest apply_override(
+    const JobRequest& base,
+    const JobOverride& item,
+    const std::vector<GateParamBinding>& bindings
+) {
+    JobRequest job = base;
+    if (item.seed) {
+        job.seed = item.seed;
+    }
+    if (item.shots) {
+        job.shots = *item.shots;
+    }
+    if (item.noise_config) {
+        job.noise_config = item.noise_config;
+    }
+    for (const auto& binding : bindings) {
+        Gate& gate = std::get<Gate>(job.program[binding.instruction_index].payload);
+        gate.param = binding.param;
+        gate.symbol = {};
+    }
+    // Every symbol is bound now, so the table has nothing left to bind.
+    job.parameters.clear();
+    return job;
+}
+
+JobRequest apply_override(const JobRequest& base, const JobOverride& item) {
+    return apply_override(base, item, override_bindings(base, item));
+}
+
+ShotRangeExecution::ShotRangeExecution(
+    const JobRunner& runner,
+    std::shared_ptr<const CompiledJob> compiled,
+    const JobRequest& job,
+    neutral_atom_vm::ProgressReporter* reporter,
+    std::chrono::steady_clock::time_point start,
+    JobResult result,
+    std::shared_ptr<const BoundProgram> bound
+) : runner_(runner),
+    compiled_(std::move(compiled)),
+    bound_(std::move(bound)),
+    profile_(compiled_->profile),
+    reporter_(reporter),
+    seed_(job.seed),
+    shots_(static_cast<std::size_t>(std::max(1, job.shots))),
+    start_(start),
+    result_(std::move(result)) {
+    if (job.noise_config) {
+        profile_.noise_config = job.noise_config;
+        profile_.noise_engine = std::make_shared<SimpleNoiseEngine>(*job.noise_config);
+    }
+    const auto& program = this->program();
+    const std::uint64_t amplitudes = statevector_amplitudes(profile_, program);
+    statevector_bytes_ = static_cast<std::size_t>(amplitudes * sizeof(std::complex<double>));
+    shot_cost_ = std::max(1.0, static_cast<double>(count_gates(program)) *
+        static_cast<double>(std::max<std::uint64_t>(1, amplitudes)));
+}
+
+void ShotRangeExecution::restore_range(std::size_t first, std::size_t count, HardwareVM::RunResult run) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count == 0 || first + count > shots_) {
+        return;
+    }
+    const auto next = ranges_.lower_bound(first);
+    if (next != ranges_.end() && next->first < first + count) {
+        return;
+    }
+    if (next != ranges_.begin() && std::prev(next)->first + std::prev(next)->second.count > first) {
+        return;
+    }
+    ranges_.emplace(first, Range{count, std::move(run)});
+    shots_done_ += count;
+}
+
+void ShotRangeExecution::run_range(std::size_t first, std::size_t count, std::size_t max_threads) {
+    const std::size_t end = first + count;
+    std::vector<std::pair<std::size_t, std::size_t>> gaps;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!failure_.empty()) {
+            return;
+        }
+        // Concurrent callers run disjoint ranges, so the gaps stay ours.
+        std::size_t cursor = first;
+        auto it = ranges_.upper_bound(first);
+        if (it != ranges_.begin()) {
+            --it;
+        }
+        for (; it != ranges_.end() && it->first < end; ++it) {
+            const std::size_t range_end = it->first + it->second.count;
+            if (range_end <= cursor) {
+                continue;
+            }
+            if (it->first > cursor) {
+                gaps.emplace_back(cursor, it->first - cursor);
+            }
+            cursor = range_end;
+        }
+        if (cursor < end) {
+            gaps.emplace_back(cursor, end - cursor);
+        }
+        if (!gaps.empty() && !first_range_start_) {
+            first_range_start_ = std::chrono::steady_clock::now();
+        }
+    }
+    for (const auto& [gap_first, gap_count] : gaps) {
+        simulate(gap_first, gap_count, max_threads);
+    }
+}
+
+void ShotRangeExecution::simulate(std::size_t first, std::size_t count, std::size_t max_threads) {
+    neutral_atom_vm::trace::Span span("job", "simulate", static_cast<std::int64_t>(first));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_active_ranges_ = std::max(max_active_ranges_, ++active_ranges_);
+    }
+    try {
+        const auto& program = this->program();
+        HardwareVM::RunResult run_result;
+        std::shared_ptr<const SharedResultSegment> segment;
+        if (executor_) {
+            RemoteRange remote;
+            {
+                // The worker process holds the statevector meanwhile.
+                SimulationAccounting accounting(
+                    runner_.metrics_.get(), profile_, program, static_cast<int>(count), max_threads);
+                remote = executor_(first, count);
+            }
+            report_remote_range(first, count, remote);
+            run_result = std::move(remote.run);
+            segment = std::move(remote.segment);
+        } else {
+            HardwareVM vm(profile_);
+            if (reporter_) {
+                vm.set_progress_reporter(reporter_);
+            }
+            vm.set_first_shot(static_cast<int>(first));
+            vm.set_counter_scope(runner_.counter_scope_);
+            std::vector<std::uint64_t> shot_seeds;
+            if (seed_) {
+                shot_seeds = derive_shot_seeds(*seed_, first, count);
+            }
+            SimulationAccounting accounting(
+                runner_.metrics_.get(), profile_, program, static_cast<int>(count), max_threads);
+            run_result = vm.run(program, static_cast<int>(count), shot_seeds, nullptr, max_threads);
+        }
+        if (observer_) {
+            // Observers (the journal) read records; only they pay for
+            // unpacking a packed range.
+            if (segment) {
+                run_result.measurements = segment->unpack();
+            }
+            observer_(first, count, run_result);
+            if (segment) {
+                std::vector<MeasurementRecord>().swap(run_result.measurements);
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const HardwareVM::RunStats& stats = run_result.stats;
+        simulate_cpu_seconds_ += stats.cpu_seconds;
+        amplitude_updates_ += stats.amplitude_updates;
+        range_peak_bytes_ = std::max(range_peak_bytes_, stats.peak_statevector_bytes);
+        range_threads_ = std::max(range_threads_, stats.threads);
+        counters_ += stats.counters;
+        merge_kernel_counters(kernels_, stats.kernels);
+        ranges_.emplace(first, Range{count, std::move(run_result), std::move(segment)});
+        shots_done_ += count;
+        last_range_end_ = std::chrono::steady_clock::now();
+        --active_ranges_;
+    } catch (const std::exception& ex) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failure_.empty()) {
+            failure_ = ex.what();
+        }
+        --active_ranges_;
+    }
+}
+
+void ShotRangeExecution::fill_profile(
+    JobProfile& profile,
+    std::chrono::steady_clock::time_point convert_start,
+    double convert_cpu_start
+) const {
+    if (first_range_start_ && last_range_end_) {
+        profile.simulate.wall_seconds =
+            std::chrono::duration<double>(*last_range_end_ - *first_range_start_).count();
+    }
+    profile.simulate.cpu_seconds = simulate_cpu_seconds_;
+    profile.amplitude_updates = amplitude_updates_;
+    profile.peak_statevector_bytes = range_peak_bytes_ * max_active_ranges_;
+    profile.threads = range_threads_ * max_active_ranges_;
+    profile.counters = counters_;
+    profile.kernels = kernels_;
+    if (profile.simulate.wall_seconds > 0.0) {
+        profile.shots_per_second = static_cast<double>(shots_done_) / profile.simulate.wall_seconds;
+        profile.memory_bandwidth_bytes_per_second =
+            static_cast<double>(counters_.cache_misses) * kCacheLineBytes / profile.simulate.wall_seconds;
+    }
+    profile.convert.wall_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - convert_start).count();
+    profile.convert.cpu_seconds = thread_cpu_seconds() - convert_cpu_start;
+}
+
+void ShotRangeExecution::report_remote_range(
+    std::size_t first,
+    std::size_t count,
+    const RemoteRange& range
+) const {
+    // The worker process had no reporter; replay what the VM would have sent.
+    if (!reporter_ || count == 0) {
+        return;
+    }
+    for (const auto& log : range.run.logs) {
+        reporter_->record_log(log);
+    }
+    if (range.segment && range.segment->shots() == count) {
+        // One shot's records at a time, read from the bit planes.
+        const SharedResultSegment& segment = *range.segment;
+        std::vector<MeasurementRecord> records(segment.layout().size());
+        for (std::size_t shot = 0; shot < count; ++shot) {
+            std::size_t index = 0;
+            for (std::size_t record = 0; record < records.size(); ++record) {
+                records[record].targets = segment.layout()[record];
+                records[record].bits.resize(segment.layout()[record].size());
+                for (int& bit : records[record].bits) {
+                    bit = segment.bit(shot, index++);
+                }
+            }
+            reporter_->record_shot(static_cast<int>(first + shot), records);
+        }
+    } else if (range.run.measurements.size() % count == 0) {
+        const auto& measurements = range.run.measurements;
+        const std::size_t per_shot = measurements.size() / count;
+        for (std::size_t shot = 0; shot < count; ++shot) {
+            const auto begin = measurements.begin() + static_cast<std::ptrdiff_t>(shot * per_shot);
+            reporter_->record_shot(
+                static_cast<int>(first + shot),
+                std::vector<MeasurementRecord>(begin, begin + static_cast<std::ptrdiff_t>(per_shot)));
+        }
+    }
+    reporter_->increment_completed_steps(program().size() * count);
+}
+
+JobResult ShotRangeExecution::finish() {
+    neutral_atom_vm::trace::Span span("job", "convert");
+    const auto convert_start = std::chrono::steady_clock::now();
+    const double convert_cpu_start = thread_cpu_seconds();
+    std::lock_guard<std::mutex> lock(mutex_);
+    JobResult result = std::move(result_);
+    JobMetrics* metrics = runner_.metrics_.get();
+    if (metrics && first_range_start_ && last_range_end_) {
+        metrics->simulate_seconds.observe(
+            std::chrono::duration<double>(*last_range_end_ - *first_range_start_).count());
+    }
+
+    std::vector<service::TimelineEntry> scheduled_timeline = bound_
+        ? expand_timeline(compiled_->scheduled, bound_->timeline_details)
+        : expand_timeline(compiled_->scheduled);
+    std::vector<service::TimelineEntry> scheduler_timeline;
+    scheduler_timeline.reserve(scheduled_timeline.size());
+    double step = 0.0;
+    for (const auto& event : scheduled_timeline) {
+        service::TimelineEntry entry;
+        entry.start_time = step;
+        entry.duration = 1.0;
+        entry.op = event.op;
+        entry.detail = event.detail;
+        scheduler_timeline.push_back(std::move(entry));
+        step += 1.0;
+    }
+    result.scheduler_timeline = std::move(scheduler_timeline);
+    result.scheduler_timeline_units = "steps";
+
+    if (failure_.empty() && shots_done_ != shots_) {
+        failure_ = "job ended after " + std::to_string(shots_done_) + " of " +
+            std::to_string(shots_) + " shots";
+    }
+    if (!failure_.empty()) {
+        result.status = JobStatus::Failed;
+        result.message = failure_;
+        fill_profile(result.profile, convert_start, convert_cpu_start);
+        runner_.finish(start_, result);
+        return result;
+    }
+
+    // Every range of a program shares one backend timeline.
+    const auto& backend_timeline = ranges_.begin()->second.run.backend_timeline;
+    std::vector<service::TimelineEntry> timeline_entries;
+    if (!backend_timeline.empty()) {
+        timeline_entries.reserve(backend_timeline.size());
+        for (const auto& event : backend_timeline) {
+            service::TimelineEntry entry;
+            entry.start_time = event.start_time;
+            entry.duration = event.duration;
+            entry.op = event.op;
+            entry.detail = event.detail;
+            timeline_entries.push_back(std::move(entry));
+        }
+    } else {
+        timeline_entries = std::move(scheduled_timeline);
+    }
+    convert_timeline_to_microseconds(timeline_entries);
+    result.timeline = timeline_entries;
+    result.timeline_units = kDisplayTimeUnit;
+    result.logs = build_timeline_logs(result.timeline);
+    result.log_time_units = kDisplayTimeUnit;
+    // Ranges that came back as bit planes are merged plane to plane into the
+    // published segment; the records are unpacked once, from the merge.
+    std::vector<std::shared_ptr<const SharedResultSegment>> segments;
+    for (const auto& [first, entry] : ranges_) {
+        if (!entry.segment) {
+            segments.clear();
+            break;
+        }
+        segments.push_back(entry.segment);
+    }
+    if (!segments.empty()) {
+        try {
+            result.segment = SharedResultSegment::merge(segments);
+        } catch (const std::runtime_error&) {
+            result.segment = nullptr;  // no shared memory left: fall back to records
+        }
+    }
+    for (auto& [first, entry] : ranges_) {
+        auto& range = entry.run;
+        convert_logs_to_microseconds(range.logs);
+        result.logs.insert(result.logs.end(), range.logs.begin(), range.logs.end());
+        if (result.segment) {
+            continue;
+        }
+        if (entry.segment) {
+            range.measurements = entry.segment->unpack();
+        }
+        if (result.measurements.empty()) {
+            result.measurements = std::move(range.measurements);
+        } else {
+            result.measurements.insert(
+                result.measurements.end(),
+                std::make_move_iterator(range.measurements.begin()),
+                std::make_move_iterator(range.measurements.end()));
+        }
+    }
+    ranges_.clear();
+    if (result.segment) {
+        result.measurements = result.segment->unpack();
+    }
+    result.status = JobStatus::Completed;
+    fill_profile(result.profile, convert_start, convert_cpu_start);
+    runner_.finish(start_, result);
+    return result;
+}
+
 JobResult JobRunner::run(
     const JobRequest& job,
     std::size_t max_threads,
     neutral_atom_vm::ProgressReporter* reporter
+) {
+    return run_prepared(prepare(job, reporter), max_threads > 0 ? max_threads : job.max_threads);
+}
+
+CompiledJob JobRunner::compile(const JobRequest& job) const {
+    return compile_profile(job, prepare_profile(job), metrics_.get());
+}
+
+JobResult JobRunner::execute(
+    const CompiledJob& compiled,
+    const JobRequest& job,
+    std::size_t max_threads,
+    neutral_atom_vm::ProgressReporter* reporter
+) {
+    // Non-owning: the execution finishes before this call returns.
+    std::shared_ptr<const CompiledJob> borrowed(std::shared_ptr<const CompiledJob>(), &compiled);
+    return run_prepared(
+        prepare(std::move(borrowed), job, reporter),
+        max_threads > 0 ? max_threads : job.max_threads);
+}
+
+PreparedJob JobRunner::prepare(
+    const JobRequest& job,
+    neutral_atom_vm::ProgressReporter* reporter
 ) {
     auto start = std::chrono::steady_clock::now();
     JobResult result;
     result.job_id = job.job_id;
     try {
-        if (!is_supported_isa_version(job.isa_version)) {
-            throw std::runtime_error(
-                "Unsupported ISA version " + to_string(job.isa_version) +
-                " (supported: " + supported_versions_to_string() + ")");
+        if (!job.parameters.empty() || has_symbolic_params(job.program)) {
+            // Bind first so the cache key and the schedule see the values.
+            return prepare(apply_override(job, JobOverride{}), reporter);
         }
-        const int shots = std::max(1, job.shots);
-
-        // Hardware VM façade: select a concrete device profile and execute
-        // the ISA program on a backend engine. For now all devices share the
-        // same statevector backend, but the profile struct gives us a place
-        // to hang future differences (noise, capabilities, backend kind).
         DeviceProfile profile;
-        profile.id = job.device_id;
-        profile.isa_version = job.isa_version;
-        HardwareConfig hw = job.hardware;
-        populate_sites_from_coordinates(hw);
-        enrich_hardware_with_profile_constraints(job, hw);
-        ensure_site_ids(hw);
-        ensure_positions_from_sites(hw);
-        ensure_coordinates_from_sites(hw);
-        auto validators = make_validator_registry_for(job, hw);
-        validators.run_all_validators(hw, job.program);
-        profile.hardware = std::move(hw);
-        profile.backend = backend_for_device(job.device_id);
-        if (job.noise_config) {
-            profile.noise_config = job.noise_config;
-            profile.noise_engine = std::make_shared<SimpleNoiseEngine>(*job.noise_config);
-        }
-        if (job.stim_circuit) {
-            profile.stim_circuit_text = job.stim_circuit;
-        }
-
-        HardwareVM vm(profile);
-        if (reporter) {
-            vm.set_progress_reporter(reporter);
-        }
-        const std::size_t threads = max_threads > 0 ? max_threads : job.max_threads;
-        const SchedulerResult scheduled = schedule_program(job.program, profile.hardware);
-
-        std::vector<service::TimelineEntry> scheduler_timeline;
-        scheduler_timeline.reserve(scheduled.timeline.size());
-        double step = 0.0;
-        for (const auto& event : scheduled.timeline) {
-            service::TimelineEntry entry;
-            entry.start_time = step;
-            entry.duration = 1.0;
-            entry.op = event.op;
-            entry.detail = event.detail;
-            scheduler_timeline.push_back(std::move(entry));
-            step += 1.0;
-        }
-        result.scheduler_timeline = std::move(scheduler_timeline);
-        result.scheduler_timeline_units = "steps";
-        auto run_result = vm.run(scheduled.program, shots, {}, nullptr, threads);
-        std::vector<service::TimelineEntry> timeline_entries;
-        if (!run_result.backend_timeline.empty()) {
-            timeline_entries.reserve(run_result.backend_timeline.size());
-            for (const auto& event : run_result.backend_timeline) {
-                service::TimelineEntry entry;
-                entry.start_time = event.start_time;
-                entry.duration = event.duration;
-                entry.op = event.op;
-                entry.detail = event.detail;
-                timeline_entries.push_back(std::move(entry));
-            }
-        } else {
-            timeline_entries = scheduled.timeline;
-        }
-        convert_timeline_to_microseconds(timeline_entries);
-        result.timeline = timeline_entries;
-        result.timeline_units = kDisplayTimeUnit;
-        result.logs = build_timeline_logs(result.timeline);
-        convert_logs_to_microseconds(run_result.logs);
-        result.log_time_units = kDisplayTimeUnit;
-        result.logs.insert(result.logs.end(), run_result.logs.begin(), run_result.logs.end());
-        result.measurements = std::move(run_result.measurements);
-        result.status = JobStatus::Completed;
+        {
+            StageClock clock("enrich", &result.profile.enrich);
+            profile = prepare_profile(job);
+        }
+        result.profile.backend = backend_name(profile.backend);
+        // Seeded jobs are deterministic, so identical resubmissions can be
+        // answered from the cache without validating or simulating again.
+        if (auto cached = lookup_cached(job, profile, start, result)) {
+            return PreparedJob{std::move(cached), nullptr};
+        }
+        auto compiled = std::make_shared<const CompiledJob>(
+            compile_profile(job, std::move(profile), metrics_.get(), &result.profile));
+        return PreparedJob{std::nullopt, std::shared_ptr<ShotRangeExecution>(new ShotRangeExecution(
+            *this, std::move(compiled), job, reporter, start, std::move(result)))};
+    } catch (const std::exception& ex) {
+        result.status = JobStatus::Failed;
+        result.message = ex.what();
+    }
+    finish(start, result);
+    return PreparedJob{std::move(result), nullptr};
+}
+
+PreparedJob JobRunner::prepare(
+    std::shared_ptr<const CompiledJob> compiled,
+    const JobRequest& job,
+    neutral_atom_vm::ProgressReporter* reporter
+) {
+    auto start = std::chrono::steady_clock::now();
+    JobResult result;
+    result.job_id = job.job_id;
+    try {
+        result.profile.backend = backend_name(compiled->profile.backend);
+        if (auto cached = lookup_cached(job, compiled->profile, start, result)) {
+            return PreparedJob{std::move(cached), nullptr};
+        }
+        return PreparedJob{std::nullopt, std::shared_ptr<ShotRangeExecution>(new ShotRangeExecution(
+            *this, std::move(compiled), job, reporter, start, std::move(result)))};
+    } catch (const std::exception& ex) {
+        result.status = JobStatus::Failed;
+        result.message = ex.what();
+    }
+    finish(start, result);
+    return PreparedJob{std::move(result), nullptr};
+}
+
+PreparedJob JobRunner::prepare(
+    std::shared_ptr<const BoundProgram> bound,
+    const JobRequest& job,
+    neutral_atom_vm::ProgressReporter* reporter
+) {
+    auto start = std::chrono::steady_clock::now();
+    JobResult result;
+    result.job_id = job.job_id;
+    try {
+        std::shared_ptr<const CompiledJob> compiled = bound->base;
+        result.profile.backend = backend_name(compiled->profile.backend);
+        if (auto cached = lookup_cached(job, compiled->profile, start, result)) {
+            return PreparedJob{std::move(cached), nullptr};
+        }
+        return PreparedJob{std::nullopt, std::shared_ptr<ShotRangeExecution>(new ShotRangeExecution(
+            *this, std::move(compiled), job, reporter, start, std::move(result), std::move(bound)))};
     } catch (const std::exception& ex) {
         result.status = JobStatus::Failed;
         result.message = ex.what();
     }
+    finish(start, result);
+    return PreparedJob{std::move(result), nullptr};
+}
+
+JobResult JobRunner::run_prepared(PreparedJob prepared, std::size_t threads) {
+    if (prepared.result) {
+        return std::move(*prepared.result);
+    }
+    auto& execution = *prepared.execution;
+    execution.run_range(0, execution.total_shots(), threads);
+    return execution.finish();
+}
+
+std::optional<JobResult> JobRunner::lookup_cached(
+    const JobRequest& job,
+    const DeviceProfile& profile,
+    std::chrono::steady_clock::time_point start,
+    JobResult& result
+) const {
+    if (!result_cache_ || !job.seed) {
+        return std::nullopt;
+    }
+    const std::string cache_key = canonical_cache_key(job, profile.hardware, profile.backend);
+    auto cached = result_cache_->lookup(cache_key);
+    if (metrics_) {
+        (cached ? metrics_->cache_hits : metrics_->cache_misses).add();
+    }
+    if (cached) {
+        cached->job_id = job.job_id;
+        cached->metadata["cache_hit"] = "true";
+        cached->metadata["cache_key"] = cache_key;
+        cached->profile = result.profile;
+        cached->profile.cache_hit = true;
+        auto end = std::chrono::steady_clock::now();
+        cached->elapsed_time = std::chrono::duration<double>(end - start).count();
+        return cached;
+    }
+    result.metadata["cache_hit"] = "false";
+    result.metadata["cache_key"] = cache_key;
+    return std::nullopt;
+}
+
+void JobRunner::finish(
+    std::chrono::steady_clock::time_point start,
+    JobResult& result
+) const {
     auto end = std::chrono::steady_clock::now();
     result.elapsed_time = std::chrono::duration<double>(end - start).count();
-    return result;
+    const auto key = result.metadata.find("cache_key");
+    if (result_cache_ && key != result.metadata.end() &&
+        result.status == JobStatus::Completed) {
+        result_cache_->store(key->second, result);
+    }
+}
+
+void JobRunner::set_result_cache(std::shared_ptr<ResultCache> cache) {
+    result_cache_ = std::move(cache);
+}
+
+void JobRunner::set_metrics(std::shared_ptr<JobMetrics> metrics) {
+    metrics_ = std::move(metrics);
 }
 
 }  // namespace service
@@ -6,15 +6,26 @@
 #include "vm/isa.hpp"
 #include "vm/measurement_record.types.hpp"
 #include "progress_reporter.hpp"
+#include "service/metrics.hpp"
+#include "service/scheduler.hpp"
+#include "service/shared_result.hpp"
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <optional>
 
 namespace service {
 
+// Values of symbolic gate parameters (Gate::symbol), keyed by name.
+using ParameterSet = std::map<std::string, double>;
+
 enum class JobStatus {
     Pending,
     Running,
@@ -27,13 +38,54 @@ struct JobRequest {
     std::string device_id;
     std::string profile;
     HardwareConfig hardware;
-    std::vector<Instruction> program;
+    Program program;
     int shots = 1;
     std::size_t max_threads = 0;
     std::map<std::string, std::string> metadata;
     ISAVersion isa_version = kCurrentISAVersion;
     std::optional<SimpleNoiseConfig> noise_config;
     std::optional<std::string> stim_circuit;
+    // Optional job-level seed. When present, per-shot seeds are derived
+    // deterministically so identical requests reproduce identical results.
+    std::optional<std::uint64_t> seed;
+    // Binds the program's symbolic gate parameters; every symbol must have a
+    // value before the job runs.
+    ParameterSet parameters;
+};
+
+// Wall-clock and CPU seconds one stage of a job took. CPU time covers the
+// threads that ran the stage, so it exceeds wall time when shots run in
+// parallel.
+struct StageTiming {
+    double wall_seconds = 0.0;
+    double cpu_seconds = 0.0;
+};
+
+// Where a job spent its time and what it used, from cheap instrumentation
+// in JobRunner, HardwareVM and the engines. Stages a job skipped (e.g.
+// compilation shared by a batch, or everything after a cache hit) stay 0.
+struct JobProfile {
+    StageTiming enrich;     // device profile and hardware enrichment
+    StageTiming validate;
+    StageTiming schedule;
+    StageTiming simulate;   // first shot range start to last range end
+    StageTiming convert;    // range merge, timeline and log conversion
+    // Statevector bytes alive at once (upper bound when ranges overlap).
+    std::uint64_t peak_statevector_bytes = 0;
+    std::uint64_t amplitude_updates = 0;
+    double shots_per_second = 0.0;
+    // Simulation threads running at once (upper bound when ranges overlap).
+    std::size_t threads = 0;
+    std::string backend;
+    bool cache_hit = false;
+    // Hardware counters of the simulate stage (JobRunner::set_counter_scope);
+    // not available when counting is off or the PMU is not exposed.
+    HardwareCounters counters;
+    // Per gate kernel and "measure", with CounterScope::kKernels.
+    KernelCounterMap kernels;
+    // LLC misses times the 64-byte line size per simulate second: a lower
+    // bound on the memory traffic.
+    double memory_bandwidth_bytes_per_second = 0.0;
 };
 
 struct JobResult {
@@ -48,13 +100,202 @@ struct JobResult {
     std::string scheduler_timeline_units = "ns";
     double elapsed_time = 0.0;
     std::string message;
+    // Free-form execution annotations (e.g. "cache_hit").
+    std::map<std::string, std::string> metadata;
+    // Describes this execution; not persisted by the codec or the cache.
+    JobProfile profile;
+    // `measurements` already packed into a shared-memory segment when the
+    // shots came back from shard workers that way; JobService publishes it
+    // instead of packing the records again. Not persisted either.
+    std::shared_ptr<const SharedResultSegment> segment;
+};
+
+// Request-independent output of compiling a job: the enriched device
+// profile plus the validated and scheduled program. Executions that only
+// vary seed, shots, noise or gate parameters reuse it.
+struct CompiledJob {
+    DeviceProfile profile;
+    SchedulerResult scheduled;
 };
 
+// A batch item's variant of a shared CompiledJob: its own program with the
+// item's gate parameters bound (see bind_gate_params). The profile, timings
+// and timeline stay in `base`; `timeline_details` holds the rebound gates'
+// timeline text.
+struct BoundProgram {
+    std::shared_ptr<const CompiledJob> base;
+    Program program;
+    TimelineDetails timeline_details;
+};
+
+// Per-item deviations from the base request of a batch submission. Only
+// fields that keep the compiled program valid may vary; gate parameter
+// bindings address instructions of the base program by index, parameter
+// values address symbolic gates by name and extend the base's table.
+struct JobOverride {
+    std::optional<std::uint64_t> seed;
+    std::optional<int> shots;
+    std::optional<SimpleNoiseConfig> noise_config;
+    std::vector<GateParamBinding> gate_params;
+    ParameterSet parameters;
+};
+
+// One binding per symbolic gate of `program`. Throws std::invalid_argument
+// when a symbol has no value or a value names no symbol of the program.
+std::vector<GateParamBinding> parameter_bindings(
+    const Program& program,
+    const ParameterSet& values
+);
+
+// The gate bindings a batch item applies to the base program: its
+// parameter values resolved against the symbolic gates, then its explicit
+// gate_params. Throws std::invalid_argument like parameter_bindings and
+// when a gate binding does not address an ApplyGate.
+std::vector<GateParamBinding> override_bindings(const JobRequest& base, const JobOverride& item);
+
+// Materialise the request a batch item describes, with every symbolic gate
+// bound. Throws like override_bindings.
+JobRequest apply_override(const JobRequest& base, const JobOverride& item);
+// Same, with the bindings override_bindings(base, item) returned.
+JobRequest apply_override(
+    const JobRequest& base,
+    const JobOverride& item,
+    const std::vector<GateParamBinding>& bindings
+);
+
+class ResultCache;
+
 BackendKind backend_for_device(const std::string& device_id);
+std::string backend_name(BackendKind backend);
 
 std::string to_json(const JobRequest& job);
 std::string status_to_string(JobStatus status);
 
+// Derive `count` per-shot seeds starting at `first_shot` from a job seed.
+// Each shot seed depends only on (seed, shot index), so any shot range can
+// be reproduced independently of how the shots are partitioned.
+std::vector<std::uint64_t> derive_shot_seeds(
+    std::uint64_t seed,
+    std::size_t first_shot,
+    std::size_t count
+);
+
+class JobRunner;
+
+// A compiled job whose shots run as independent ranges. Ranges may run
+// concurrently, in any order and on any thread; per-shot seeds depend only
+// on the shot index, so a seeded job produces the same result however its
+// shots are partitioned. Errors raised by a range are kept and reported by
+// finish() as a failed result.
+class ShotRangeExecution {
+  public:
+    std::size_t total_shots() const { return shots_; }
+    // Statevector bytes a range holds per worker thread (0 when the
+    // backend does not keep a dense state).
+    std::size_t statevector_bytes() const { return statevector_bytes_; }
+    // Relative cost of one shot: gate applications times amplitudes touched.
+    double shot_cost() const { return shot_cost_; }
+
+    using RangeObserver = std::function<void(
+        std::size_t first, std::size_t count, const HardwareVM::RunResult& run)>;
+
+    // Called after each range this execution simulates. Set it before any
+    // range runs.
+    void set_range_observer(RangeObserver observer) { observer_ = std::move(observer); }
+
+    // Output of a range simulated elsewhere. When `segment` is set it holds
+    // the range's measurements and `run.measurements` is empty.
+    struct RemoteRange {
+        HardwareVM::RunResult run;
+        std::shared_ptr<const SharedResultSegment> segment;
+    };
+    using RangeExecutor = std::function<RemoteRange(std::size_t first, std::size_t count)>;
+
+    // Run ranges through `executor` (e.g. a worker process) instead of
+    // simulating them in this process. The executor must reproduce the
+    // job's shots [first, first + count). Set it before any range runs.
+    void set_range_executor(RangeExecutor executor) { executor_ = std::move(executor); }
+
+    // Adopt shots of a seeded job finished by an earlier execution, e.g.
+    // replayed from a journal. Ranges overlapping known shots are ignored.
+    void restore_range(std::size_t first, std::size_t count, HardwareVM::RunResult run);
+
+    // Simulate shots [first, first + count) that are not already present.
+    void run_range(std::size_t first, std::size_t count, std::size_t max_threads = 1);
+
+    // Merge the ranges in shot order into the final result. Call once,
+    // after every shot has run.
+    JobResult finish();
+
+  private:
+    friend class JobRunner;
+
+    ShotRangeExecution(
+        const JobRunner& runner,
+        std::shared_ptr<const CompiledJob> compiled,
+        const JobRequest& job,
+        neutral_atom_vm::ProgressReporter* reporter,
+        std::chrono::steady_clock::time_point start,
+        JobResult result,
+        std::shared_ptr<const BoundProgram> bound = nullptr
+    );
+
+    const Program& program() const {
+        return bound_ ? bound_->program : compiled_->scheduled.program;
+    }
+
+    const JobRunner& runner_;
+    std::shared_ptr<const CompiledJob> compiled_;
+    std::shared_ptr<const BoundProgram> bound_;  // batch items with rebound parameters
+    DeviceProfile profile_;
+    neutral_atom_vm::ProgressReporter* reporter_;
+    std::optional<std::uint64_t> seed_;
+    std::size_t shots_ = 0;
+    std::size_t statevector_bytes_ = 0;
+    double shot_cost_ = 1.0;
+    std::chrono::steady_clock::time_point start_;
+    JobResult result_;
+
+    void simulate(std::size_t first, std::size_t count, std::size_t max_threads);
+    void report_remote_range(std::size_t first, std::size_t count, const RemoteRange& range) const;
+    void fill_profile(
+        JobProfile& profile,
+        std::chrono::steady_clock::time_point convert_start,
+        double convert_cpu_start
+    ) const;
+
+    struct Range {
+        std::size_t count = 0;
+        HardwareVM::RunResult run;
+        std::shared_ptr<const SharedResultSegment> segment;  // see RemoteRange
+    };
+
+    RangeObserver observer_;
+    RangeExecutor executor_;
+    std::mutex mutex_;
+    std::map<std::size_t, Range> ranges_;  // keyed by first shot
+    std::size_t shots_done_ = 0;
+    std::optional<std::chrono::steady_clock::time_point> first_range_start_;
+    std::optional<std::chrono::steady_clock::time_point> last_range_end_;
+    std::string failure_;
+    // Profile inputs, summed or maxed over simulated ranges.
+    std::size_t active_ranges_ = 0;
+    std::size_t max_active_ranges_ = 0;
+    double simulate_cpu_seconds_ = 0.0;
+    std::uint64_t amplitude_updates_ = 0;
+    std::uint64_t range_peak_bytes_ = 0;
+    std::size_t range_threads_ = 0;
+    HardwareCounters counters_;
+    KernelCounterMap kernels_;
+};
+
+// Outcome of JobRunner::prepare(): either a finished result (cache hit or a
+// request rejected while compiling) or the execution of its shots.
+struct PreparedJob {
+    std::optional<JobResult> result;
+    std::shared_ptr<ShotRangeExecution> execution;
+};
+
 class JobRunner {
   public:
     JobResult run(
@@ -62,6 +303,70 @@ class JobRunner {
         std::size_t max_threads = 0,
         neutral_atom_vm::ProgressReporter* reporter = nullptr
     );
+
+    // Enrich, validate and schedule a request. Throws on invalid jobs.
+    CompiledJob compile(const JobRequest& job) const;
+
+    // Execute a request against a program compiled from the same base
+    // request. `job` supplies the seed, shots and noise of this execution
+    // and must carry the same gate parameters as `compiled`.
+    JobResult execute(
+        const CompiledJob& compiled,
+        const JobRequest& job,
+        std::size_t max_threads = 0,
+        neutral_atom_vm::ProgressReporter* reporter = nullptr
+    );
+
+    // Compile a request (or consult the cache) without running any shots,
+    // so a scheduler can execute them in ranges. `reporter` must outlive
+    // the returned execution.
+    PreparedJob prepare(
+        const JobRequest& job,
+        neutral_atom_vm::ProgressReporter* reporter = nullptr
+    );
+    PreparedJob prepare(
+        std::shared_ptr<const CompiledJob> compiled,
+        const JobRequest& job,
+        neutral_atom_vm::ProgressReporter* reporter = nullptr
+    );
+    PreparedJob prepare(
+        std::shared_ptr<const BoundProgram> bound,
+        const JobRequest& job,
+        neutral_atom_vm::ProgressReporter* reporter = nullptr
+    );
+
+    // Attach a result cache consulted for seeded (deterministic) jobs.
+    void set_result_cache(std::shared_ptr<ResultCache> cache);
+    const std::shared_ptr<ResultCache>& result_cache() const { return result_cache_; }
+
+    // Attach the instruments that stage latencies, simulation throughput and
+    // cache lookups are recorded into.
+    void set_metrics(std::shared_ptr<JobMetrics> metrics);
+    const std::shared_ptr<JobMetrics>& metrics() const { return metrics_; }
+
+    // Read hardware counters while simulating shots and report them in
+    // JobResult::profile. Call before running jobs.
+    void set_counter_scope(CounterScope scope) { counter_scope_ = scope; }
+    CounterScope counter_scope() const { return counter_scope_; }
+
+  private:
+    friend class ShotRangeExecution;
+
+    JobResult run_prepared(PreparedJob prepared, std::size_t threads);
+    std::optional<JobResult> lookup_cached(
+        const JobRequest& job,
+        const DeviceProfile& profile,
+        std::chrono::steady_clock::time_point start,
+        JobResult& result
+    ) const;
+    void finish(
+        std::chrono::steady_clock::time_point start,
+        JobResult& result
+    ) const;
+
+    std::shared_ptr<ResultCache> result_cache_;
+    std::shared_ptr<JobMetrics> metrics_;
+    CounterScope counter_scope_ = CounterScope::kOff;
 };
 
 }  // namespace service
@@ -0,0 +1,816 @@
+#include "service/job_codec.hpp"
+
+#include "service/packed_measurements.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace service {
+
+namespace {
+
+constexpr std::uint32_t kJobResultMagic = 0x4e41524cU;  // "NARL"
+constexpr std::uint32_t kJobRequestMagic = 0x4e415251U;  // "NARQ"
+constexpr std::uint32_t kRunRangeMagic = 0x4e415252U;    // "NARR"
+constexpr std::uint32_t kCodecVersion = 2;
+
+class ByteWriter {
+  public:
+    ByteWriter() = default;
+    // Hands the output to `sink` in pieces of about `chunk_bytes`; see
+    // JsonWriter's streaming constructor.
+    ByteWriter(const ResultSink& sink, std::size_t chunk_bytes) : sink_(&sink), chunk_bytes_(chunk_bytes) {}
+
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>, "put requires POD values");
+        const auto* raw = reinterpret_cast<const char*>(&value);
+        reserve_chunk();
+        out_.append(raw, sizeof(T));
+    }
+
+    void put_string(const std::string& value) {
+        put<std::uint64_t>(value.size());
+        reserve_chunk();
+        out_.append(value);
+    }
+
+    void put_ints(std::span<const int> values) {
+        put<std::uint64_t>(values.size());
+        for (int value : values) {
+            put<std::int32_t>(value);
+        }
+    }
+
+    void put_doubles(const std::vector<double>& values) {
+        put<std::uint64_t>(values.size());
+        for (double value : values) {
+            put<double>(value);
+        }
+    }
+
+    std::string take() { return std::move(out_); }
+
+    void flush() {
+        if (sink_ != nullptr && !out_.empty()) {
+            (*sink_)(out_);
+            out_.clear();
+        }
+    }
+
+  private:
+    void reserve_chunk() {
+        if (sink_ != nullptr && out_.size() >= chunk_bytes_) {
+            flush();
+        }
+    }
+
+    const ResultSink* sink_ = nullptr;
+    std::size_t chunk_bytes_ = 0;
+    std::string out_;
+};
+
+class ByteReader {
+  public:
+    explicit ByteReader(std::string_view bytes) : bytes_(bytes) {}
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable_v<T>, "get requires POD values");
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, bytes_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    std::size_t get_size() {
+        const auto size = get<std::uint64_t>();
+        // Every element occupies at least one byte, which bounds malformed sizes.
+        if (size > bytes_.size() - offset_) {
+            throw std::runtime_error("job codec: length prefix exceeds payload");
+        }
+        return static_cast<std::size_t>(size);
+    }
+
+    std::string get_string() {
+        const std::size_t size = get_size();
+        std::string value(bytes_.substr(offset_, size));
+        offset_ += size;
+        return value;
+    }
+
+    std::vector<int> get_ints() {
+        const std::size_t size = get_size();
+        std::vector<int> values;
+        values.reserve(size);
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            values.push_back(get<std::int32_t>());
+        }
+        return values;
+    }
+
+    std::vector<double> get_doubles() {
+        const std::size_t size = reader_size_checked(sizeof(double));
+        std::vector<double> values;
+        values.reserve(size);
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            values.push_back(get<double>());
+        }
+        return values;
+    }
+
+    bool exhausted() const { return offset_ == bytes_.size(); }
+
+  private:
+    std::size_t reader_size_checked(std::size_t element_size) {
+        const std::size_t size = get_size();
+        require(size * element_size);
+        return size;
+    }
+
+    void require(std::size_t count) const {
+        if (bytes_.size() - offset_ < count) {
+            throw std::runtime_error("job codec: truncated payload");
+        }
+    }
+
+    std::string_view bytes_;
+    std::size_t offset_ = 0;
+};
+
+void put_timeline(ByteWriter& writer, const std::vector<TimelineEntry>& timeline) {
+    writer.put<std::uint64_t>(timeline.size());
+    for (const auto& entry : timeline) {
+        writer.put<double>(entry.start_time);
+        writer.put<double>(entry.duration);
+        writer.put_string(entry.op);
+        writer.put_string(entry.detail);
+    }
+}
+
+std::vector<TimelineEntry> get_timeline(ByteReader& reader) {
+    const std::size_t size = reader.get_size();
+    std::vector<TimelineEntry> timeline;
+    timeline.reserve(size);
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        TimelineEntry entry;
+        entry.start_time = reader.get<double>();
+        entry.duration = reader.get<double>();
+        entry.op = reader.get_string();
+        entry.detail = reader.get_string();
+        timeline.push_back(std::move(entry));
+    }
+    return timeline;
+}
+
+void put_words(ByteWriter& writer, const std::vector<std::uint64_t>& words) {
+    writer.put<std::uint64_t>(words.size());
+    for (const auto word : words) {
+        writer.put<std::uint64_t>(word);
+    }
+}
+
+std::vector<std::uint64_t> get_words(ByteReader& reader) {
+    const std::size_t size = reader.get_size();
+    std::vector<std::uint64_t> words;
+    words.reserve(size);
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        words.push_back(reader.get<std::uint64_t>());
+    }
+    return words;
+}
+
+void put_records(ByteWriter& writer, const std::vector<MeasurementRecord>& records) {
+    writer.put<std::uint64_t>(records.size());
+    for (const auto& record : records) {
+        writer.put_ints(record.targets);
+        writer.put_ints(record.bits);
+    }
+}
+
+std::vector<MeasurementRecord> get_records(ByteReader& reader) {
+    const std::size_t count = reader.get_size();
+    std::vector<MeasurementRecord> records;
+    records.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        MeasurementRecord record;
+        record.targets = reader.get_ints();
+        record.bits = reader.get_ints();
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+void put_logs(ByteWriter& writer, const std::vector<ExecutionLog>& logs) {
+    writer.put<std::uint64_t>(logs.size());
+    for (const auto& log : logs) {
+        writer.put<std::int32_t>(log.shot);
+        writer.put<double>(log.logical_time);
+        writer.put_string(log.category);
+        writer.put_string(log.message);
+    }
+}
+
+std::vector<ExecutionLog> get_logs(ByteReader& reader) {
+    const std::size_t count = reader.get_size();
+    std::vector<ExecutionLog> logs;
+    logs.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        ExecutionLog log;
+        log.shot = reader.get<std::int32_t>();
+        log.logical_time = reader.get<double>();
+        log.category = reader.get_string();
+        log.message = reader.get_string();
+        logs.push_back(std::move(log));
+    }
+    return logs;
+}
+
+void put_counters(ByteWriter& writer, const HardwareCounters& counters) {
+    writer.put<std::uint8_t>(counters.available ? 1 : 0);
+    writer.put<std::uint64_t>(counters.cycles);
+    writer.put<std::uint64_t>(counters.instructions);
+    writer.put<std::uint64_t>(counters.cache_references);
+    writer.put<std::uint64_t>(counters.cache_misses);
+}
+
+HardwareCounters get_counters(ByteReader& reader) {
+    HardwareCounters counters;
+    counters.available = reader.get<std::uint8_t>() != 0;
+    counters.cycles = reader.get<std::uint64_t>();
+    counters.instructions = reader.get<std::uint64_t>();
+    counters.cache_references = reader.get<std::uint64_t>();
+    counters.cache_misses = reader.get<std::uint64_t>();
+    return counters;
+}
+
+std::uint8_t status_to_byte(JobStatus status) {
+    return static_cast<std::uint8_t>(status);
+}
+
+JobStatus status_from_byte(std::uint8_t value) {
+    if (value > static_cast<std::uint8_t>(JobStatus::Failed)) {
+        throw std::runtime_error("job codec: invalid job status");
+    }
+    return static_cast<JobStatus>(value);
+}
+
+// Fixed-layout configuration structs are walked field by field so the same
+// visitor drives both encoding and decoding.
+template <typename Config, typename Fn>
+void for_each_noise_field(Config& cfg, Fn&& fn) {
+    fn(cfg.p_quantum_flip);
+    fn(cfg.p_loss);
+    fn(cfg.readout.p_flip0_to_1);
+    fn(cfg.readout.p_flip1_to_0);
+    for (auto* pauli : {&cfg.gate.single_qubit, &cfg.gate.two_qubit_control, &cfg.gate.two_qubit_target}) {
+        fn(pauli->px);
+        fn(pauli->py);
+        fn(pauli->pz);
+    }
+    for (auto& entry : cfg.correlated_gate.matrix) {
+        fn(entry);
+    }
+    fn(cfg.idle_rate);
+    fn(cfg.phase.single_qubit);
+    fn(cfg.phase.two_qubit_control);
+    fn(cfg.phase.two_qubit_target);
+    fn(cfg.phase.idle);
+    fn(cfg.amplitude_damping.per_gate);
+    fn(cfg.amplitude_damping.idle_rate);
+    fn(cfg.loss_runtime.per_gate);
+    fn(cfg.loss_runtime.idle_rate);
+}
+
+template <typename Hardware, typename Fn>
+void for_each_hardware_scalar(Hardware& hw, Fn&& fn) {
+    fn(hw.blockade_radius);
+    fn(hw.blockade_model.radius);
+    fn(hw.blockade_model.radius_x);
+    fn(hw.blockade_model.radius_y);
+    fn(hw.blockade_model.radius_z);
+    fn(hw.timing_limits.min_wait_ns);
+    fn(hw.timing_limits.max_wait_ns);
+    fn(hw.timing_limits.max_parallel_single_qubit);
+    fn(hw.timing_limits.max_parallel_two_qubit);
+    fn(hw.timing_limits.max_parallel_per_zone);
+    fn(hw.timing_limits.measurement_cooldown_ns);
+    fn(hw.timing_limits.measurement_duration_ns);
+    fn(hw.pulse_limits.detuning_min);
+    fn(hw.pulse_limits.detuning_max);
+    fn(hw.pulse_limits.duration_min_ns);
+    fn(hw.pulse_limits.duration_max_ns);
+    fn(hw.pulse_limits.max_overlapping_pulses);
+    fn(hw.move_limits.max_total_displacement_per_atom);
+    fn(hw.move_limits.max_moves_per_atom);
+    fn(hw.move_limits.max_moves_per_shot);
+    fn(hw.move_limits.max_moves_per_configuration_change);
+    fn(hw.move_limits.rearrangement_window_ns);
+}
+
+// Scalars are written with their declared type; ints travel as int32.
+struct ScalarWriter {
+    ByteWriter& writer;
+    void operator()(double value) const { writer.put<double>(value); }
+    void operator()(int value) const { writer.put<std::int32_t>(value); }
+};
+
+struct ScalarReader {
+    ByteReader& reader;
+    void operator()(double& value) const { value = reader.get<double>(); }
+    void operator()(int& value) const { value = reader.get<std::int32_t>(); }
+};
+
+void put_hardware(ByteWriter& writer, const HardwareConfig& hw) {
+    writer.put_doubles(hw.positions);
+    writer.put<std::uint64_t>(hw.coordinates.size());
+    for (const auto& row : hw.coordinates) {
+        writer.put_doubles(row);
+    }
+    writer.put_ints(hw.site_ids);
+    for_each_hardware_scalar(hw, ScalarWriter{writer});
+
+    writer.put<std::uint64_t>(hw.interaction_graphs.size());
+    for (const auto& graph : hw.interaction_graphs) {
+        writer.put_string(graph.gate_name);
+        writer.put<std::uint64_t>(graph.allowed_pairs.size());
+        for (const auto& pair : graph.allowed_pairs) {
+            writer.put<std::int32_t>(pair.site_a);
+            writer.put<std::int32_t>(pair.site_b);
+        }
+    }
+    writer.put<std::uint64_t>(hw.blockade_model.zone_overrides.size());
+    for (const auto& entry : hw.blockade_model.zone_overrides) {
+        writer.put<std::int32_t>(entry.zone_id);
+        writer.put<double>(entry.radius);
+    }
+    writer.put<std::uint64_t>(hw.sites.size());
+    for (const auto& site : hw.sites) {
+        writer.put<std::int32_t>(site.id);
+        writer.put<double>(site.x);
+        writer.put<double>(site.y);
+        writer.put<double>(site.z);
+        writer.put<std::int32_t>(site.zone_id);
+    }
+    writer.put<std::uint64_t>(hw.native_gates.size());
+    for (const auto& gate : hw.native_gates) {
+        writer.put_string(gate.name);
+        writer.put<std::int32_t>(gate.arity);
+        writer.put<double>(gate.duration_ns);
+        writer.put<double>(gate.angle_min);
+        writer.put<double>(gate.angle_max);
+        writer.put<std::uint8_t>(static_cast<std::uint8_t>(gate.connectivity));
+    }
+    writer.put<std::uint64_t>(hw.transport_edges.size());
+    for (const auto& edge : hw.transport_edges) {
+        writer.put<std::int32_t>(edge.src_site_id);
+        writer.put<std::int32_t>(edge.dst_site_id);
+        writer.put<double>(edge.distance);
+        writer.put<double>(edge.duration_ns);
+    }
+}
+
+HardwareConfig get_hardware(ByteReader& reader) {
+    HardwareConfig hw;
+    hw.positions = reader.get_doubles();
+    const std::size_t rows = reader.get_size();
+    hw.coordinates.reserve(rows);
+    for (std::size_t idx = 0; idx < rows; ++idx) {
+        hw.coordinates.push_back(reader.get_doubles());
+    }
+    hw.site_ids = reader.get_ints();
+    for_each_hardware_scalar(hw, ScalarReader{reader});
+
+    const std::size_t graph_count = reader.get_size();
+    for (std::size_t idx = 0; idx < graph_count; ++idx) {
+        InteractionGraph graph;
+        graph.gate_name = reader.get_string();
+        const std::size_t pair_count = reader.get_size();
+        for (std::size_t pair_idx = 0; pair_idx < pair_count; ++pair_idx) {
+            InteractionPair pair;
+            pair.site_a = reader.get<std::int32_t>();
+            pair.site_b = reader.get<std::int32_t>();
+            graph.allowed_pairs.push_back(pair);
+        }
+        hw.interaction_graphs.push_back(std::move(graph));
+    }
+    const std::size_t override_count = reader.get_size();
+    for (std::size_t idx = 0; idx < override_count; ++idx) {
+        BlockadeZoneOverride entry;
+        entry.zone_id = reader.get<std::int32_t>();
+        entry.radius = reader.get<double>();
+        hw.blockade_model.zone_overrides.push_back(entry);
+    }
+    const std::size_t site_count = reader.get_size();
+    for (std::size_t idx = 0; idx < site_count; ++idx) {
+        SiteDescriptor site;
+        site.id = reader.get<std::int32_t>();
+        site.x = reader.get<double>();
+        site.y = reader.get<double>();
+        site.z = reader.get<double>();
+        site.zone_id = reader.get<std::int32_t>();
+        hw.sites.push_back(site);
+    }
+    const std::size_t gate_count = reader.get_size();
+    for (std::size_t idx = 0; idx < gate_count; ++idx) {
+        NativeGate gate;
+        gate.name = reader.get_string();
+        gate.arity = reader.get<std::int32_t>();
+        gate.duration_ns = reader.get<double>();
+        gate.angle_min = reader.get<double>();
+        gate.angle_max = reader.get<double>();
+        const auto connectivity = reader.get<std::uint8_t>();
+        if (connectivity > static_cast<std::uint8_t>(ConnectivityKind::NearestNeighborGrid)) {
+            throw std::runtime_error("job codec: invalid connectivity");
+        }
+        gate.connectivity = static_cast<ConnectivityKind>(connectivity);
+        hw.native_gates.push_back(std::move(gate));
+    }
+    const std::size_t edge_count = reader.get_size();
+    for (std::size_t idx = 0; idx < edge_count; ++idx) {
+        TransportEdge edge;
+        edge.src_site_id = reader.get<std::int32_t>();
+        edge.dst_site_id = reader.get<std::int32_t>();
+        edge.distance = reader.get<double>();
+        edge.duration_ns = reader.get<double>();
+        hw.transport_edges.push_back(edge);
+    }
+    return hw;
+}
+
+void put_instruction(ByteWriter& writer, const Program& program, const Instruction& instr) {
+    writer.put<std::uint8_t>(static_cast<std::uint8_t>(instr.op));
+    switch (instr.op) {
+        case Op::AllocArray:
+            writer.put<std::int32_t>(std::get<int>(instr.payload));
+            break;
+        case Op::ApplyGate: {
+            const auto& gate = std::get<Gate>(instr.payload);
+            writer.put_string(gate.name);
+            writer.put_ints(gate.targets);
+            writer.put<double>(gate.param);
+            writer.put_string(gate.symbol);
+            break;
+        }
+        case Op::Measure:
+            writer.put_ints(program.targets(instr));
+            break;
+        case Op::MoveAtom: {
+            const auto& move = std::get<MoveAtomInstruction>(instr.payload);
+            writer.put<std::int32_t>(move.atom);
+            writer.put<double>(move.position);
+            break;
+        }
+        case Op::Wait:
+            writer.put<double>(std::get<WaitInstruction>(instr.payload).duration);
+            break;
+        case Op::Pulse: {
+            const auto& pulse = std::get<PulseInstruction>(instr.payload);
+            writer.put<std::int32_t>(pulse.target);
+            writer.put<double>(pulse.detuning);
+            writer.put<double>(pulse.duration);
+            break;
+        }
+        case Op::Repeat: {
+            const auto& repeat = std::get<RepeatInstruction>(instr.payload);
+            writer.put<std::int32_t>(repeat.count);
+            writer.put<std::int32_t>(repeat.body_size);
+            break;
+        }
+    }
+}
+
+// Appends the next instruction to `program`, whose operand table receives
+// wide Measure lists.
+void get_instruction(ByteReader& reader, Program& program) {
+    const auto op = reader.get<std::uint8_t>();
+    Instruction instr;
+    switch (static_cast<Op>(op)) {
+        case Op::AllocArray:
+            instr.op = Op::AllocArray;
+            instr.payload = static_cast<int>(reader.get<std::int32_t>());
+            program.push_back(instr);
+            return;
+        case Op::ApplyGate: {
+            instr.op = Op::ApplyGate;
+            Gate gate;
+            gate.name = reader.get_string();
+            gate.targets = reader.get_ints();
+            gate.param = reader.get<double>();
+            gate.symbol = reader.get_string();
+            instr.payload = std::move(gate);
+            program.push_back(instr);
+            return;
+        }
+        case Op::Measure:
+            program.push_measure(reader.get_ints());
+            return;
+        case Op::MoveAtom: {
+            instr.op = Op::MoveAtom;
+            MoveAtomInstruction move;
+            move.atom = reader.get<std::int32_t>();
+            move.position = reader.get<double>();
+            instr.payload = move;
+            program.push_back(instr);
+            return;
+        }
+        case Op::Wait:
+            instr.op = Op::Wait;
+            instr.payload = WaitInstruction{reader.get<double>()};
+            program.push_back(instr);
+            return;
+        case Op::Pulse: {
+            instr.op = Op::Pulse;
+            PulseInstruction pulse;
+            pulse.target = reader.get<std::int32_t>();
+            pulse.detuning = reader.get<double>();
+            pulse.duration = reader.get<double>();
+            instr.payload = pulse;
+            program.push_back(instr);
+            return;
+        }
+        case Op::Repeat: {
+            instr.op = Op::Repeat;
+            RepeatInstruction repeat;
+            repeat.count = reader.get<std::int32_t>();
+            repeat.body_size = reader.get<std::int32_t>();
+            instr.payload = repeat;
+            program.push_back(instr);
+            return;
+        }
+    }
+    throw std::runtime_error("job codec: invalid opcode " + std::to_string(op));
+}
+
+void read_header(ByteReader& reader, std::uint32_t magic, const char* what) {
+    if (reader.get<std::uint32_t>() != magic) {
+        throw std::runtime_error(std::string("job codec: not an encoded ") + what);
+    }
+    const auto version = reader.get<std::uint32_t>();
+    if (version != kCodecVersion) {
+        throw std::runtime_error(
+            "job codec: unsupported version " + std::to_string(version));
+    }
+}
+
+}  // namespace
+
+std::string encode_job_request(const JobRequest& request) {
+    ByteWriter writer;
+    writer.put<std::uint32_t>(kJobRequestMagic);
+    writer.put<std::uint32_t>(kCodecVersion);
+    writer.put_string(request.job_id);
+    writer.put_string(request.device_id);
+    writer.put_string(request.profile);
+    writer.put<std::int32_t>(request.shots);
+    writer.put<std::uint64_t>(request.max_threads);
+    writer.put<std::int32_t>(request.isa_version.major);
+    writer.put<std::int32_t>(request.isa_version.minor);
+    put_hardware(writer, request.hardware);
+
+    writer.put<std::uint64_t>(request.program.size());
+    for (const auto& instr : request.program) {
+        put_instruction(writer, request.program, instr);
+    }
+
+    writer.put<std::uint64_t>(request.metadata.size());
+    for (const auto& [key, value] : request.metadata) {
+        writer.put_string(key);
+        writer.put_string(value);
+    }
+    writer.put<std::uint8_t>(request.noise_config ? 1 : 0);
+    if (request.noise_config) {
+        for_each_noise_field(*request.noise_config, [&writer](double value) {
+            writer.put<double>(value);
+        });
+    }
+    writer.put<std::uint8_t>(request.stim_circuit ? 1 : 0);
+    if (request.stim_circuit) {
+        writer.put_string(*request.stim_circuit);
+    }
+    writer.put<std::uint8_t>(request.seed ? 1 : 0);
+    if (request.seed) {
+        writer.put<std::uint64_t>(*request.seed);
+    }
+    writer.put<std::uint64_t>(request.parameters.size());
+    for (const auto& [name, value] : request.parameters) {
+        writer.put_string(name);
+        writer.put<double>(value);
+    }
+    return writer.take();
+}
+
+JobRequest decode_job_request(std::string_view bytes) {
+    ByteReader reader(bytes);
+    read_header(reader, kJobRequestMagic, "JobRequest");
+
+    JobRequest request;
+    request.job_id = reader.get_string();
+    request.device_id = reader.get_string();
+    request.profile = reader.get_string();
+    request.shots = reader.get<std::int32_t>();
+    request.max_threads = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    request.isa_version.major = reader.get<std::int32_t>();
+    request.isa_version.minor = reader.get<std::int32_t>();
+    request.hardware = get_hardware(reader);
+
+    const std::size_t instruction_count = reader.get_size();
+    request.program.reserve(instruction_count);
+    for (std::size_t idx = 0; idx < instruction_count; ++idx) {
+        get_instruction(reader, request.program);
+    }
+
+    const std::size_t metadata_count = reader.get_size();
+    for (std::size_t idx = 0; idx < metadata_count; ++idx) {
+        std::string key = reader.get_string();
+        request.metadata[std::move(key)] = reader.get_string();
+    }
+    if (reader.get<std::uint8_t>() != 0) {
+        SimpleNoiseConfig cfg;
+        for_each_noise_field(cfg, [&reader](double& value) { value = reader.get<double>(); });
+        request.noise_config = cfg;
+    }
+    if (reader.get<std::uint8_t>() != 0) {
+        request.stim_circuit = reader.get_string();
+    }
+    if (reader.get<std::uint8_t>() != 0) {
+        request.seed = reader.get<std::uint64_t>();
+    }
+    const std::size_t parameter_count = reader.get_size();
+    for (std::size_t idx = 0; idx < parameter_count; ++idx) {
+        std::string name = reader.get_string();
+        request.parameters[std::move(name)] = reader.get<double>();
+    }
+    if (!reader.exhausted()) {
+        throw std::runtime_error("job codec: trailing bytes after JobRequest");
+    }
+    return request;
+}
+
+namespace {
+
+void put_job_result(ByteWriter& writer, const JobResult& result) {
+    writer.put<std::uint32_t>(kJobResultMagic);
+    writer.put<std::uint32_t>(kCodecVersion);
+    writer.put_string(result.job_id);
+    writer.put<std::uint8_t>(status_to_byte(result.status));
+    writer.put<double>(result.elapsed_time);
+    writer.put_string(result.message);
+
+    put_records(writer, result.measurements);
+    put_logs(writer, result.logs);
+
+    put_timeline(writer, result.timeline);
+    put_timeline(writer, result.scheduler_timeline);
+    writer.put_string(result.log_time_units);
+    writer.put_string(result.timeline_units);
+    writer.put_string(result.scheduler_timeline_units);
+
+    writer.put<std::uint64_t>(result.metadata.size());
+    for (const auto& [key, value] : result.metadata) {
+        writer.put_string(key);
+        writer.put_string(value);
+    }
+}
+
+}  // namespace
+
+std::string encode_job_result(const JobResult& result) {
+    ByteWriter writer;
+    put_job_result(writer, result);
+    return writer.take();
+}
+
+void encode_job_result(const JobResult& result, const ResultSink& sink, std::size_t chunk_bytes) {
+    ByteWriter writer(sink, chunk_bytes);
+    put_job_result(writer, result);
+    writer.flush();
+}
+
+JobResult decode_job_result(std::string_view bytes) {
+    ByteReader reader(bytes);
+    read_header(reader, kJobResultMagic, "JobResult");
+
+    JobResult result;
+    result.job_id = reader.get_string();
+    result.status = status_from_byte(reader.get<std::uint8_t>());
+    result.elapsed_time = reader.get<double>();
+    result.message = reader.get_string();
+
+    result.measurements = get_records(reader);
+    result.logs = get_logs(reader);
+
+    result.timeline = get_timeline(reader);
+    result.scheduler_timeline = get_timeline(reader);
+    result.log_time_units = reader.get_string();
+    result.timeline_units = reader.get_string();
+    result.scheduler_timeline_units = reader.get_string();
+
+    const std::size_t metadata_count = reader.get_size();
+    for (std::size_t idx = 0; idx < metadata_count; ++idx) {
+        std::string key = reader.get_string();
+        result.metadata[std::move(key)] = reader.get_string();
+    }
+    if (!reader.exhausted()) {
+        throw std::runtime_error("job codec: trailing bytes after JobResult");
+    }
+    return result;
+}
+
+std::string encode_run_range(const HardwareVM::RunResult& run, std::size_t shots) {
+    ByteWriter writer;
+    writer.put<std::uint32_t>(kRunRangeMagic);
+    writer.put<std::uint32_t>(kCodecVersion);
+    const auto packed = pack_measurements(run.measurements, shots);
+    writer.put<std::uint8_t>(packed ? 1 : 0);
+    if (packed) {
+        writer.put<std::uint64_t>(packed->shots);
+        writer.put<std::uint64_t>(packed->layout.size());
+        for (const auto& targets : packed->layout) {
+            writer.put_ints(targets);
+        }
+        put_words(writer, packed->values);
+        put_words(writer, packed->lost);
+    } else {
+        put_records(writer, run.measurements);
+    }
+    put_logs(writer, run.logs);
+    writer.put<std::uint64_t>(run.backend_timeline.size());
+    for (const auto& event : run.backend_timeline) {
+        writer.put<double>(event.start_time);
+        writer.put<double>(event.duration);
+        writer.put_string(event.op);
+        writer.put_string(event.detail);
+    }
+    writer.put<std::uint64_t>(run.stats.amplitude_updates);
+    writer.put<std::uint64_t>(run.stats.peak_statevector_bytes);
+    writer.put<double>(run.stats.cpu_seconds);
+    writer.put<std::uint64_t>(run.stats.threads);
+    put_counters(writer, run.stats.counters);
+    writer.put<std::uint64_t>(run.stats.kernels.size());
+    for (const auto& [name, kernel] : run.stats.kernels) {
+        writer.put_string(name);
+        writer.put<std::uint64_t>(kernel.calls);
+        put_counters(writer, kernel.counters);
+    }
+    return writer.take();
+}
+
+HardwareVM::RunResult decode_run_range(std::string_view bytes) {
+    ByteReader reader(bytes);
+    read_header(reader, kRunRangeMagic, "shot range");
+
+    HardwareVM::RunResult run;
+    if (reader.get<std::uint8_t>() != 0) {
+        PackedMeasurements packed;
+        packed.shots = static_cast<std::size_t>(reader.get<std::uint64_t>());
+        const std::size_t layout_size = reader.get_size();
+        for (std::size_t idx = 0; idx < layout_size; ++idx) {
+            packed.layout.push_back(reader.get_ints());
+            packed.bits_per_shot += packed.layout.back().size();
+        }
+        packed.values = get_words(reader);
+        packed.lost = get_words(reader);
+        const std::size_t words = (packed.bits_per_shot * packed.shots + 63) / 64;
+        if (packed.values.size() != words || (!packed.lost.empty() && packed.lost.size() != words)) {
+            throw std::runtime_error("job codec: bit planes do not match the shot layout");
+        }
+        run.measurements = unpack_measurements(packed);
+    } else {
+        run.measurements = get_records(reader);
+    }
+    run.logs = get_logs(reader);
+    const std::size_t events = reader.get_size();
+    run.backend_timeline.reserve(events);
+    for (std::size_t idx = 0; idx < events; ++idx) {
+        BackendTimelineEvent event;
+        event.start_time = reader.get<double>();
+        event.duration = reader.get<double>();
+        event.op = reader.get_string();
+        event.detail = reader.get_string();
+        run.backend_timeline.push_back(std::move(event));
+    }
+    run.stats.amplitude_updates = reader.get<std::uint64_t>();
+    run.stats.peak_statevector_bytes = reader.get<std::uint64_t>();
+    run.stats.cpu_seconds = reader.get<double>();
+    run.stats.threads = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    run.stats.counters = get_counters(reader);
+    const std::size_t kernels = reader.get_size();
+    for (std::size_t idx = 0; idx < kernels; ++idx) {
+        std::string name = reader.get_string();
+        KernelCounters kernel;
+        kernel.calls = reader.get<std::uint64_t>();
+        kernel.counters = get_counters(reader);
+        run.stats.kernels.emplace(std::move(name), kernel);
+    }
+    if (!reader.exhausted()) {
+        throw std::runtime_error("job codec: trailing bytes after shot range");
+    }
+    return run;
+}
+
+}  // namespace service
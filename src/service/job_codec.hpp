@@ -0,0 +1,33 @@
+#pragma once
+
+#include "hardware_vm.hpp"
+#include "service/job.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace service {
+
+// Compact binary encoding of job payloads. The format is versioned and
+// self-delimiting so encoded blobs can be stored on disk or sent between
+// processes; decoding throws std::runtime_error on malformed input.
+
+std::string encode_job_result(const JobResult& result);
+// Same bytes as encode_job_result(), handed to `sink` in pieces of about
+// `chunk_bytes` instead of being assembled into one string.
+using ResultSink = std::function<void(std::string_view)>;
+void encode_job_result(const JobResult& result, const ResultSink& sink, std::size_t chunk_bytes);
+JobResult decode_job_result(std::string_view bytes);
+
+std::string encode_job_request(const JobRequest& request);
+JobRequest decode_job_request(std::string_view bytes);
+
+// Raw output of a shot range (HardwareVM::RunResult of `shots` shots).
+// Measurements use the PackedMeasurements bit planes whenever the shots
+// share one record layout.
+std::string encode_run_range(const HardwareVM::RunResult& run, std::size_t shots);
+HardwareVM::RunResult decode_run_range(std::string_view bytes);
+
+}  // namespace service
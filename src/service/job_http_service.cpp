@@ -0,0 +1,233 @@
+#include "service/job_http_service.hpp"
+
+#include "service/job_codec.hpp"
+#include "service/job_json.hpp"
+#include "service/json.hpp"
+
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace service {
+
+namespace {
+
+HttpReply json_reply(std::string body, int status = 200) {
+    HttpReply reply;
+    reply.response.status = status;
+    reply.response.body = std::move(body);
+    return reply;
+}
+
+HttpReply error_reply(int status, const std::string& message) {
+    JsonWriter body;
+    body.begin_object().field("error", message).end_object();
+    return json_reply(body.take(), status);
+}
+
+// Strip trailing slashes; the root path stays "/".
+std::string normalize_path(std::string path) {
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+bool starts_with(const std::string* header, const char* prefix) {
+    return header != nullptr && header->rfind(prefix, 0) == 0;
+}
+
+bool contains(const std::string* header, const char* token) {
+    return header != nullptr && header->find(token) != std::string::npos;
+}
+
+HttpReply submit_reply(const std::string& job_id, std::exception_ptr error) {
+    if (error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const QuotaExceeded& ex) {
+            return error_reply(429, ex.what());
+        } catch (const std::exception& ex) {
+            return error_reply(500, ex.what());
+        }
+    }
+    JsonWriter body;
+    body.begin_object().field("job_id", job_id).field("status", "pending").end_object();
+    return json_reply(body.take());
+}
+
+std::string status_to_json(const std::string& job_id, const JobStatusSnapshot& snapshot) {
+    JsonWriter out;
+    out.begin_object();
+    out.field("job_id", job_id);
+    out.field("status", status_to_string(snapshot.status));
+    out.field("percent_complete", snapshot.percent_complete);
+    out.field("message", snapshot.message);
+    out.key("recent_logs").begin_array();
+    for (const auto& entry : snapshot.recent_logs) {
+        out.begin_object()
+            .field("shot", entry.shot)
+            .field("time", entry.logical_time)
+            .field("category", entry.category)
+            .field("message", entry.message)
+            .end_object();
+    }
+    out.end_array();
+    out.end_object();
+    return out.take();
+}
+
+}  // namespace
+
+JobHttpService::JobHttpService(JobService& jobs, JobHttpOptions options)
+    : jobs_(jobs), options_(std::move(options)) {
+    options_.job_endpoint = normalize_path(options_.job_endpoint);
+    options_.devices_endpoint = normalize_path(options_.devices_endpoint);
+}
+
+HttpReply JobHttpService::handle(const HttpRequest& request) {
+    const std::string path = normalize_path(request.path);
+    const bool is_get = request.method == "GET";
+
+    if (path == options_.job_endpoint) {
+        if (request.method != "POST") {
+            return error_reply(405, "use POST to submit jobs");
+        }
+        return submit(request);
+    }
+    if (path == "/healthz" && is_get) {
+        return json_reply("{\"status\":\"ok\"}");
+    }
+    if (path == "/metrics" && is_get) {
+        HttpReply reply;
+        reply.response.content_type = "text/plain; version=0.0.4";
+        reply.response.body = jobs_.render_metrics();
+        return reply;
+    }
+    if (path == options_.devices_endpoint && is_get) {
+        if (options_.devices_json.empty()) {
+            return error_reply(404, "no device catalogue configured");
+        }
+        return json_reply(options_.devices_json);
+    }
+
+    const std::string prefix = options_.job_endpoint == "/" ? "/" : options_.job_endpoint + "/";
+    if (path.rfind(prefix, 0) == 0) {
+        const std::string tail = path.substr(prefix.size());
+        const std::size_t slash = tail.find('/');
+        if (slash != std::string::npos && slash > 0 && tail.find('/', slash + 1) == std::string::npos) {
+            const std::string job_id = tail.substr(0, slash);
+            const std::string verb = tail.substr(slash + 1);
+            if (verb == "status" || verb == "result" || verb == "stream") {
+                if (!is_get) {
+                    return error_reply(405, "use GET for job queries");
+                }
+                if (verb == "status") {
+                    return status(job_id);
+                }
+                if (verb == "result") {
+                    return result(request, job_id);
+                }
+                return stream(job_id);
+            }
+        }
+    }
+    return error_reply(404, "not found");
+}
+
+HttpReply JobHttpService::submit(const HttpRequest& request) {
+    if (request.body.empty()) {
+        return error_reply(411, "Content-Length required");
+    }
+    JobRequest job;
+    try {
+        if (starts_with(request.header("content-type"), kJobRequestMediaType)) {
+            job = decode_job_request(request.body);
+        } else {
+            job = job_request_from_json(request.body);
+        }
+        // Cheap structural check, so oversized Repeat counts are refused
+        // here instead of failing after they were queued.
+        validate_repeat_blocks(job.program);
+    } catch (const std::exception& ex) {
+        return error_reply(400, std::string("invalid job: ") + ex.what());
+    }
+    // The reply waits for the journal's sync, which runs on the journal's
+    // writer thread instead of blocking the event loop.
+    HttpReply reply;
+    reply.deferred = [this, job = std::move(job)](ReplyCompletion complete) mutable {
+        const std::size_t max_threads = job.max_threads;
+        jobs_.submit_async(std::move(job), max_threads,
+            [complete = std::move(complete)](const std::string& job_id, std::exception_ptr error) {
+                complete(submit_reply(job_id, error).response);
+            });
+    };
+    return reply;
+}
+
+HttpReply JobHttpService::status(const std::string& job_id) const {
+    return json_reply(status_to_json(job_id, jobs_.status(job_id)));
+}
+
+HttpReply JobHttpService::result(const HttpRequest& request, const std::string& job_id) const {
+    if (!jobs_.has_result(job_id)) {
+        return error_reply(404, "job result not ready: " + job_id);
+    }
+    // Copying and encoding a large result is left to the producer thread;
+    // the event loop only sends the chunks it writes.
+    const bool binary = contains(request.header("accept"), kJobResultMediaType);
+    HttpReply reply;
+    reply.response.content_type = binary ? kJobResultMediaType : "application/json";
+    reply.stream = [&jobs = jobs_, job_id, binary, chunk_bytes = options_.result_chunk_bytes](ChunkWriter& out) {
+        const auto result = jobs.poll_result(job_id);
+        if (!result) {
+            throw std::runtime_error("job result vanished: " + job_id);
+        }
+        ScopedTimer timer(&jobs.job_metrics()->serialize_seconds);
+        const auto sink = [&out](std::string_view bytes) {
+            if (!out.write(bytes)) {
+                throw std::runtime_error("client went away");
+            }
+        };
+        if (binary) {
+            encode_job_result(*result, sink, chunk_bytes);
+            return;
+        }
+        JsonWriter writer(sink, chunk_bytes);
+        write_job_result(writer, *result);
+        writer.flush();
+    };
+    return reply;
+}
+
+HttpReply JobHttpService::stream(const std::string& job_id) const {
+    auto subscription = jobs_.subscribe(job_id, options_.stream_capacity);
+    if (!subscription) {
+        return error_reply(404, "job not found: " + job_id);
+    }
+    HttpReply reply;
+    reply.response.content_type = "application/x-ndjson";
+    reply.response.headers.emplace_back("Cache-Control", "no-cache");
+    // std::function needs a copyable callable; share the move-only handle.
+    auto shared = std::make_shared<ShotSubscription>(std::move(*subscription));
+    reply.stream = [shared](ChunkWriter& out) {
+        while (auto batch = shared->next(std::chrono::milliseconds(100))) {
+            if (batch->shots.empty()) {
+                if (!out.open()) {
+                    break;
+                }
+                continue;
+            }
+            if (!out.write(shot_batch_to_json(*batch) + "\n")) {
+                break;
+            }
+        }
+        shared->close();
+    };
+    return reply;
+}
+
+}  // namespace service
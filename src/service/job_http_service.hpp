@@ -0,0 +1,52 @@
+#pragma once
+
+#include "service/http_server.hpp"
+#include "service/job_service.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace service {
+
+// Media type of JobRequest bodies encoded with encode_job_request().
+inline constexpr const char* kJobRequestMediaType = "application/x-na-vm-job";
+// Media type of JobResult bodies encoded with encode_job_result(); sent when
+// the client lists it in Accept.
+inline constexpr const char* kJobResultMediaType = "application/x-na-vm-result";
+
+struct JobHttpOptions {
+    std::string job_endpoint = "/job";
+    std::string devices_endpoint = "/devices";
+    // Body served for GET on the devices endpoint; 404 when empty.
+    std::string devices_json;
+    // Shots buffered per stream subscription; later ones are coalesced.
+    std::size_t stream_capacity = 1024;
+    // Results are encoded off the event loop and sent as HTTP chunks of
+    // about this size.
+    std::size_t result_chunk_bytes = 64 * 1024;
+};
+
+// Routes of python/scripts/vm_service.py on top of a JobService:
+//   POST <job>               submit a JSON or binary JobRequest (429 over quota)
+//   GET  <job>/<id>/status   status snapshot
+//   GET  <job>/<id>/result   final result (404 until the job ends)
+//   GET  <job>/<id>/stream   chunked NDJSON shot batches
+//   GET  <devices>, /healthz
+//   GET  /metrics            Prometheus text exposition
+class JobHttpService {
+  public:
+    explicit JobHttpService(JobService& jobs, JobHttpOptions options = {});
+
+    HttpReply handle(const HttpRequest& request);
+
+  private:
+    HttpReply submit(const HttpRequest& request);
+    HttpReply status(const std::string& job_id) const;
+    HttpReply result(const HttpRequest& request, const std::string& job_id) const;
+    HttpReply stream(const std::string& job_id) const;
+
+    JobService& jobs_;
+    JobHttpOptions options_;
+};
+
+}  // namespace service
@@ -0,0 +1,466 @@
+#include "service/job_journal.hpp"
+
+#include "service/job_codec.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace service {
+
+namespace {
+
+enum class RecordType : std::uint8_t {
+    Submit = 1,
+    Start = 2,
+    Range = 3,
+    Finish = 4,
+    Discard = 5,
+};
+
+// Frame header: payload length and FNV-1a checksum of the payload.
+constexpr std::size_t kHeaderBytes = 8;
+
+std::uint32_t checksum(std::string_view bytes) {
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void put_string(std::string& out, const std::string& value) {
+    put<std::uint64_t>(out, value.size());
+    out.append(value);
+}
+
+std::string frame(RecordType type, const std::string& payload) {
+    std::string body;
+    body.reserve(payload.size() + 1);
+    put<std::uint8_t>(body, static_cast<std::uint8_t>(type));
+    body.append(payload);
+    std::string out;
+    out.reserve(kHeaderBytes + body.size());
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(body.size()));
+    put<std::uint32_t>(out, checksum(body));
+    out.append(body);
+    return out;
+}
+
+class PayloadReader {
+  public:
+    explicit PayloadReader(std::string_view bytes) : bytes_(bytes) {}
+
+    template <typename T>
+    T get() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, bytes_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    std::string get_string() {
+        const auto size = get<std::uint64_t>();
+        require(size);
+        std::string value(bytes_.substr(offset_, static_cast<std::size_t>(size)));
+        offset_ += static_cast<std::size_t>(size);
+        return value;
+    }
+
+  private:
+    void require(std::uint64_t count) const {
+        if (bytes_.size() - offset_ < count) {
+            throw std::runtime_error("job journal: truncated record");
+        }
+    }
+
+    std::string_view bytes_;
+    std::size_t offset_ = 0;
+};
+
+std::string submit_record(const JobRequest& request, const std::string& batch_id, std::size_t max_threads) {
+    std::string payload;
+    put_string(payload, batch_id);
+    put<std::uint64_t>(payload, max_threads);
+    put_string(payload, encode_job_request(request));
+    return frame(RecordType::Submit, payload);
+}
+
+std::string job_id_record(RecordType type, const std::string& job_id) {
+    std::string payload;
+    put_string(payload, job_id);
+    return frame(type, payload);
+}
+
+std::string range_record(
+    const std::string& job_id,
+    std::size_t first,
+    std::size_t count,
+    const HardwareVM::RunResult& run
+) {
+    std::string payload;
+    put_string(payload, job_id);
+    put<std::uint64_t>(payload, first);
+    put<std::uint64_t>(payload, count);
+    put_string(payload, encode_run_range(run, count));
+    return frame(RecordType::Range, payload);
+}
+
+JournaledRange decode_range(PayloadReader& reader) {
+    JournaledRange range;
+    range.first = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    range.count = static_cast<std::size_t>(reader.get<std::uint64_t>());
+    range.run = decode_run_range(reader.get_string());
+    return range;
+}
+
+std::string finish_record(const JobResult& result) {
+    std::string payload;
+    put_string(payload, encode_job_result(result));
+    return frame(RecordType::Finish, payload);
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return {};
+    }
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Rebuild job state from journal bytes. Stops at the first torn or corrupt
+// record: everything after it was never acknowledged as durable.
+std::vector<JournaledJob> replay(std::string_view bytes) {
+    std::vector<JournaledJob> jobs;
+    std::unordered_map<std::string, std::size_t> index;
+    std::size_t offset = 0;
+    while (bytes.size() - offset >= kHeaderBytes) {
+        std::uint32_t length = 0;
+        std::uint32_t sum = 0;
+        std::memcpy(&length, bytes.data() + offset, sizeof(length));
+        std::memcpy(&sum, bytes.data() + offset + 4, sizeof(sum));
+        if (length == 0 || bytes.size() - offset - kHeaderBytes < length) {
+            break;
+        }
+        const std::string_view body = bytes.substr(offset + kHeaderBytes, length);
+        if (checksum(body) != sum) {
+            break;
+        }
+        offset += kHeaderBytes + length;
+
+        try {
+            const auto type = static_cast<RecordType>(static_cast<std::uint8_t>(body[0]));
+            PayloadReader reader(body.substr(1));
+            switch (type) {
+                case RecordType::Submit: {
+                    JournaledJob job;
+                    job.batch_id = reader.get_string();
+                    job.max_threads = static_cast<std::size_t>(reader.get<std::uint64_t>());
+                    job.request = decode_job_request(reader.get_string());
+                    index[job.request.job_id] = jobs.size();
+                    jobs.push_back(std::move(job));
+                    break;
+                }
+                case RecordType::Range: {
+                    const std::string job_id = reader.get_string();
+                    const auto it = index.find(job_id);
+                    if (it != index.end()) {
+                        jobs[it->second].ranges.push_back(decode_range(reader));
+                    }
+                    break;
+                }
+                case RecordType::Finish: {
+                    JobResult result = decode_job_result(reader.get_string());
+                    const auto it = index.find(result.job_id);
+                    if (it != index.end()) {
+                        jobs[it->second].ranges.clear();
+                        jobs[it->second].result = std::move(result);
+                    }
+                    break;
+                }
+                case RecordType::Discard: {
+                    const auto it = index.find(reader.get_string());
+                    if (it != index.end()) {
+                        jobs[it->second].request.job_id.clear();
+                        index.erase(it);
+                    }
+                    break;
+                }
+                case RecordType::Start:
+                    break;
+                default:
+                    throw std::runtime_error("job journal: unknown record type");
+            }
+        } catch (const std::exception&) {
+            break;
+        }
+    }
+
+    std::vector<JournaledJob> live;
+    live.reserve(jobs.size());
+    for (auto& job : jobs) {
+        if (job.request.job_id.empty()) {
+            continue;
+        }
+        if (!job.request.seed) {
+            // Unseeded shots cannot be reproduced; the job restarts.
+            job.ranges.clear();
+        }
+        live.push_back(std::move(job));
+    }
+    return live;
+}
+
+[[noreturn]] void throw_errno(const std::string& what, const std::string& path) {
+    throw std::runtime_error("job journal: " + what + " " + path + ": " + std::strerror(errno));
+}
+
+void write_fd(int fd, const std::string& bytes, const std::string& path) {
+    std::size_t written = 0;
+    while (written < bytes.size()) {
+        const ssize_t count = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("cannot write", path);
+        }
+        written += static_cast<std::size_t>(count);
+    }
+}
+
+}  // namespace
+
+JobJournal::JobJournal(JobJournalOptions options) : options_(std::move(options)) {
+    if (options_.path.empty()) {
+        throw std::invalid_argument("job journal: path must not be empty");
+    }
+    recovered_ = replay(read_file(options_.path));
+    std::size_t finished = 0;
+    for (auto it = recovered_.rbegin(); it != recovered_.rend(); ++it) {
+        if (it->result && ++finished > options_.retain_finished) {
+            it->request.job_id.clear();
+        }
+    }
+    if (finished > options_.retain_finished) {
+        recovered_.erase(
+            std::remove_if(recovered_.begin(), recovered_.end(),
+                [](const JournaledJob& job) { return job.request.job_id.empty(); }),
+            recovered_.end());
+    }
+
+    // Compact: rewrite only the surviving state, then swap it in atomically.
+    std::string compacted;
+    for (const auto& job : recovered_) {
+        compacted += submit_record(job.request, job.batch_id, job.max_threads);
+        if (job.result) {
+            compacted += finish_record(*job.result);
+        }
+        for (const auto& range : job.ranges) {
+            compacted += range_record(job.request.job_id, range.first, range.count, range.run);
+        }
+    }
+    const std::string temp_path = options_.path + ".tmp";
+    const int temp_fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (temp_fd < 0) {
+        throw_errno("cannot create", temp_path);
+    }
+    try {
+        write_fd(temp_fd, compacted, temp_path);
+        if (::fsync(temp_fd) != 0) {
+            throw_errno("cannot sync", temp_path);
+        }
+    } catch (...) {
+        ::close(temp_fd);
+        throw;
+    }
+    ::close(temp_fd);
+    if (::rename(temp_path.c_str(), options_.path.c_str()) != 0) {
+        throw_errno("cannot replace", options_.path);
+    }
+    std::string directory = std::filesystem::path(options_.path).parent_path().string();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    const int dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+
+    fd_ = ::open(options_.path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw_errno("cannot open", options_.path);
+    }
+    stats_.bytes = compacted.size();
+    writer_ = std::thread([this]() { writer_loop(); });
+}
+
+JobJournal::~JobJournal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    pending_cv_.notify_all();
+    writer_.join();
+    ::close(fd_);
+}
+
+std::vector<JournaledJob> JobJournal::take_recovered() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(recovered_);
+}
+
+std::uint64_t JobJournal::record_submit(
+    const JobRequest& request,
+    const std::string& batch_id,
+    std::size_t max_threads
+) {
+    return append(submit_record(request, batch_id, max_threads));
+}
+
+std::uint64_t JobJournal::record_start(const std::string& job_id) {
+    return append(job_id_record(RecordType::Start, job_id));
+}
+
+std::uint64_t JobJournal::record_range(
+    const std::string& job_id,
+    std::size_t first,
+    std::size_t count,
+    const HardwareVM::RunResult& run
+) {
+    return append(range_record(job_id, first, count, run));
+}
+
+std::uint64_t JobJournal::record_finish(const JobResult& result) {
+    return append(finish_record(result));
+}
+
+std::uint64_t JobJournal::record_discard(const std::string& job_id) {
+    return append(job_id_record(RecordType::Discard, job_id));
+}
+
+std::uint64_t JobJournal::append(std::string record) {
+    std::uint64_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ += record;
+        sequence = ++appended_;
+        ++stats_.records;
+    }
+    pending_cv_.notify_one();
+    return sequence;
+}
+
+void JobJournal::wait_durable(std::uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_cv_.wait(lock, [&]() { return durable_ >= sequence || !failure_.empty(); });
+    if (!failure_.empty()) {
+        throw std::runtime_error(failure_);
+    }
+}
+
+void JobJournal::on_durable(std::uint64_t sequence, DurableCallback callback) {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sequence > handed_off_) {
+            callbacks_.emplace(sequence, std::move(callback));
+            return;
+        }
+        if (!failure_.empty()) {
+            error = std::make_exception_ptr(std::runtime_error(failure_));
+        }
+    }
+    callback(error);
+}
+
+void JobJournal::flush() {
+    std::uint64_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = appended_;
+    }
+    wait_durable(sequence);
+}
+
+JobJournalStats JobJournal::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void JobJournal::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        pending_cv_.wait(lock, [&]() { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;  // stopping with nothing left to write
+        }
+        if (options_.sync_interval.count() > 0 && !stopping_) {
+            pending_cv_.wait_for(lock, options_.sync_interval, [&]() {
+                return stopping_ || pending_.size() >= options_.sync_bytes;
+            });
+        }
+        std::string batch;
+        batch.swap(pending_);
+        const std::uint64_t target = appended_;
+        lock.unlock();
+
+        std::string error;
+        try {
+            write_fd(fd_, batch, options_.path);
+            if (::fdatasync(fd_) != 0) {
+                throw_errno("cannot sync", options_.path);
+            }
+        } catch (const std::exception& ex) {
+            error = ex.what();
+        }
+
+        lock.lock();
+        if (!error.empty() && failure_.empty()) {
+            failure_ = error;
+        }
+        // Run callbacks before publishing durable_, so wait_durable() and
+        // flush() return only after they have run.
+        std::vector<DurableCallback> ready;
+        const auto last = callbacks_.upper_bound(target);
+        for (auto it = callbacks_.begin(); it != last; ++it) {
+            ready.push_back(std::move(it->second));
+        }
+        callbacks_.erase(callbacks_.begin(), last);
+        handed_off_ = target;
+        if (!ready.empty()) {
+            const std::exception_ptr outcome = failure_.empty()
+                ? nullptr
+                : std::make_exception_ptr(std::runtime_error(failure_));
+            lock.unlock();
+            for (auto& callback : ready) {
+                callback(outcome);
+            }
+            lock.lock();
+        }
+        durable_ = target;
+        ++stats_.syncs;
+        stats_.bytes += batch.size();
+        durable_cv_.notify_all();
+    }
+}
+
+}  // namespace service
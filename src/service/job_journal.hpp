@@ -0,0 +1,127 @@
+#pragma once
+
+#include "hardware_vm.hpp"
+#include "service/job.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace service {
+
+struct JobJournalOptions {
+    // Journal file; created when missing.
+    std::string path;
+    // After the first pending record the writer waits up to this long for
+    // more before syncing, trading submit latency for fewer fsyncs. Records
+    // appended while a sync is in flight always share the next one.
+    std::chrono::microseconds sync_interval{0};
+    // Pending bytes that trigger a sync without waiting for sync_interval.
+    std::size_t sync_bytes = 1 << 20;
+    // Finished jobs kept when the journal is compacted on open, counting
+    // from the most recent submission; older results are dropped.
+    std::size_t retain_finished = 4096;
+};
+
+// Shots [first, first + count) of a seeded job, finished before a restart.
+struct JournaledRange {
+    std::size_t first = 0;
+    std::size_t count = 0;
+    HardwareVM::RunResult run;
+};
+
+// A job reconstructed from the journal.
+struct JournaledJob {
+    JobRequest request;          // request.job_id is the service job ID
+    std::string batch_id;        // empty for single submissions
+    std::size_t max_threads = 0;
+    std::optional<JobResult> result;    // set when the job had finished
+    std::vector<JournaledRange> ranges; // finished shot ranges of unfinished jobs
+};
+
+struct JobJournalStats {
+    std::uint64_t records = 0;
+    std::uint64_t syncs = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Append-only write-ahead log of JobService state: submissions, starts,
+// finished shot ranges and final results. Records are length-prefixed and
+// checksummed; a background writer appends them in order and group-commits
+// with fdatasync, so concurrent jobs share syncs. Opening a journal replays
+// it (a torn tail from a crash is discarded) and rewrites it compacted to
+// the surviving jobs (all unfinished ones, the last retain_finished finished
+// ones). Append methods are thread-safe and return a sequence number for
+// wait_durable() and on_durable().
+class JobJournal {
+  public:
+    // Throws std::runtime_error if the file cannot be opened or rewritten.
+    explicit JobJournal(JobJournalOptions options);
+    // Flushes pending records.
+    ~JobJournal();
+
+    JobJournal(const JobJournal&) = delete;
+    JobJournal& operator=(const JobJournal&) = delete;
+
+    // Jobs found when the journal was opened, in submission order. Ranges
+    // are only kept for seeded jobs, whose shots can be reproduced exactly.
+    std::vector<JournaledJob> take_recovered();
+
+    std::uint64_t record_submit(const JobRequest& request, const std::string& batch_id, std::size_t max_threads);
+    std::uint64_t record_start(const std::string& job_id);
+    std::uint64_t record_range(
+        const std::string& job_id,
+        std::size_t first,
+        std::size_t count,
+        const HardwareVM::RunResult& run
+    );
+    std::uint64_t record_finish(const JobResult& result);
+    // The job was never accepted (e.g. rejected by a quota); forget it.
+    std::uint64_t record_discard(const std::string& job_id);
+
+    // Block until every record up to `sequence` has been synced.
+    void wait_durable(std::uint64_t sequence);
+    // Called with nullptr once the records are synced, or with the write
+    // error. Runs on the writer thread (inline when already synced) before
+    // wait_durable() returns for the same sequence; it may append records
+    // but must not wait for them.
+    using DurableCallback = std::function<void(std::exception_ptr error)>;
+    void on_durable(std::uint64_t sequence, DurableCallback callback);
+    void flush();
+
+    JobJournalStats stats() const;
+    const JobJournalOptions& options() const { return options_; }
+
+  private:
+    std::uint64_t append(std::string record);
+    void writer_loop();
+
+    JobJournalOptions options_;
+    int fd_ = -1;
+    std::vector<JournaledJob> recovered_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::condition_variable durable_cv_;
+    std::string pending_;
+    std::uint64_t appended_ = 0;
+    std::uint64_t durable_ = 0;
+    // Sequences whose callbacks the writer has already taken.
+    std::uint64_t handed_off_ = 0;
+    std::multimap<std::uint64_t, DurableCallback> callbacks_;
+    std::string failure_;
+    bool stopping_ = false;
+    JobJournalStats stats_;
+    std::thread writer_;
+};
+
+}  // namespace service
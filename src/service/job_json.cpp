@@ -0,0 +1,518 @@
+#include "service/job_json.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace service {
+
+namespace {
+
+double number_or(const JsonValue& obj, std::string_view key, double fallback) {
+    const JsonValue* value = obj.find_non_null(key);
+    return value ? value->as_double() : fallback;
+}
+
+int int_or(const JsonValue& obj, std::string_view key, int fallback) {
+    const JsonValue* value = obj.find_non_null(key);
+    return value ? value->as_int() : fallback;
+}
+
+std::string string_or(const JsonValue& obj, std::string_view key, std::string fallback) {
+    const JsonValue* value = obj.find_non_null(key);
+    return value ? value->as_string() : std::move(fallback);
+}
+
+std::vector<int> int_list(const JsonValue& value) {
+    std::vector<int> out;
+    out.reserve(value.as_array().size());
+    for (const auto& item : value.as_array()) {
+        out.push_back(item.as_int());
+    }
+    return out;
+}
+
+std::vector<double> double_list(const JsonValue& value) {
+    std::vector<double> out;
+    out.reserve(value.as_array().size());
+    for (const auto& item : value.as_array()) {
+        out.push_back(item.as_double());
+    }
+    return out;
+}
+
+template <typename T, typename Fill>
+std::vector<T> object_list(const JsonValue& value, Fill fill) {
+    std::vector<T> out;
+    out.reserve(value.as_array().size());
+    for (const auto& item : value.as_array()) {
+        T entry;
+        fill(item, entry);
+        out.push_back(std::move(entry));
+    }
+    return out;
+}
+
+ConnectivityKind connectivity_from_json(const JsonValue& value) {
+    const std::string& text = value.as_string();
+    if (text == "AllToAll") {
+        return ConnectivityKind::AllToAll;
+    }
+    if (text == "NearestNeighborChain") {
+        return ConnectivityKind::NearestNeighborChain;
+    }
+    if (text == "NearestNeighborGrid") {
+        return ConnectivityKind::NearestNeighborGrid;
+    }
+    throw std::runtime_error("Unknown connectivity: " + text);
+}
+
+void fill_site(const JsonValue& src, SiteDescriptor& dst) {
+    dst.id = int_or(src, "id", dst.id);
+    dst.x = number_or(src, "x", dst.x);
+    dst.y = number_or(src, "y", dst.y);
+    dst.z = number_or(src, "z", dst.z);
+    dst.zone_id = int_or(src, "zone_id", dst.zone_id);
+}
+
+void fill_native_gate(const JsonValue& src, NativeGate& dst) {
+    dst.name = string_or(src, "name", dst.name);
+    dst.arity = int_or(src, "arity", dst.arity);
+    dst.duration_ns = number_or(src, "duration_ns", dst.duration_ns);
+    dst.angle_min = number_or(src, "angle_min", dst.angle_min);
+    dst.angle_max = number_or(src, "angle_max", dst.angle_max);
+    if (const JsonValue* connectivity = src.find_non_null("connectivity")) {
+        dst.connectivity = connectivity_from_json(*connectivity);
+    }
+}
+
+void fill_interaction_graph(const JsonValue& src, InteractionGraph& dst) {
+    dst.gate_name = string_or(src, "gate_name", dst.gate_name);
+    if (const JsonValue* pairs = src.find_non_null("allowed_pairs")) {
+        dst.allowed_pairs = object_list<InteractionPair>(*pairs, [](const JsonValue& item, InteractionPair& pair) {
+            pair.site_a = int_or(item, "site_a", pair.site_a);
+            pair.site_b = int_or(item, "site_b", pair.site_b);
+        });
+    }
+}
+
+void fill_blockade_model(const JsonValue& src, BlockadeModel& dst) {
+    dst.radius = number_or(src, "radius", dst.radius);
+    dst.radius_x = number_or(src, "radius_x", dst.radius_x);
+    dst.radius_y = number_or(src, "radius_y", dst.radius_y);
+    dst.radius_z = number_or(src, "radius_z", dst.radius_z);
+    if (const JsonValue* overrides = src.find_non_null("zone_overrides")) {
+        dst.zone_overrides = object_list<BlockadeZoneOverride>(
+            *overrides, [](const JsonValue& item, BlockadeZoneOverride& entry) {
+                entry.zone_id = int_or(item, "zone_id", entry.zone_id);
+                entry.radius = number_or(item, "radius", entry.radius);
+            });
+    }
+}
+
+void fill_timing_limits(const JsonValue& src, TimingLimits& dst) {
+    dst.min_wait_ns = number_or(src, "min_wait_ns", dst.min_wait_ns);
+    dst.max_wait_ns = number_or(src, "max_wait_ns", dst.max_wait_ns);
+    dst.max_parallel_single_qubit = int_or(src, "max_parallel_single_qubit", dst.max_parallel_single_qubit);
+    dst.max_parallel_two_qubit = int_or(src, "max_parallel_two_qubit", dst.max_parallel_two_qubit);
+    dst.max_parallel_per_zone = int_or(src, "max_parallel_per_zone", dst.max_parallel_per_zone);
+    dst.measurement_cooldown_ns = number_or(src, "measurement_cooldown_ns", dst.measurement_cooldown_ns);
+    dst.measurement_duration_ns = number_or(src, "measurement_duration_ns", dst.measurement_duration_ns);
+}
+
+void fill_pulse_limits(const JsonValue& src, PulseLimits& dst) {
+    dst.detuning_min = number_or(src, "detuning_min", dst.detuning_min);
+    dst.detuning_max = number_or(src, "detuning_max", dst.detuning_max);
+    dst.duration_min_ns = number_or(src, "duration_min_ns", dst.duration_min_ns);
+    dst.duration_max_ns = number_or(src, "duration_max_ns", dst.duration_max_ns);
+    dst.max_overlapping_pulses = int_or(src, "max_overlapping_pulses", dst.max_overlapping_pulses);
+}
+
+void fill_move_limits(const JsonValue& src, MoveLimits& dst) {
+    dst.max_total_displacement_per_atom =
+        number_or(src, "max_total_displacement_per_atom", dst.max_total_displacement_per_atom);
+    dst.max_moves_per_atom = int_or(src, "max_moves_per_atom", dst.max_moves_per_atom);
+    dst.max_moves_per_shot = int_or(src, "max_moves_per_shot", dst.max_moves_per_shot);
+    dst.max_moves_per_configuration_change =
+        int_or(src, "max_moves_per_configuration_change", dst.max_moves_per_configuration_change);
+    dst.rearrangement_window_ns = number_or(src, "rearrangement_window_ns", dst.rearrangement_window_ns);
+}
+
+void fill_hardware(const JsonValue& src, HardwareConfig& hw) {
+    if (const JsonValue* value = src.find_non_null("positions")) {
+        hw.positions = double_list(*value);
+    }
+    if (const JsonValue* value = src.find_non_null("coordinates")) {
+        hw.coordinates.clear();
+        for (const auto& row : value->as_array()) {
+            hw.coordinates.push_back(double_list(row));
+        }
+    }
+    hw.blockade_radius = number_or(src, "blockade_radius", hw.blockade_radius);
+    if (const JsonValue* value = src.find_non_null("sites")) {
+        hw.sites = object_list<SiteDescriptor>(*value, fill_site);
+    }
+    if (const JsonValue* value = src.find_non_null("site_ids")) {
+        hw.site_ids = int_list(*value);
+    }
+    if (const JsonValue* value = src.find_non_null("native_gates")) {
+        hw.native_gates = object_list<NativeGate>(*value, fill_native_gate);
+    }
+    if (const JsonValue* value = src.find_non_null("interaction_graphs")) {
+        hw.interaction_graphs = object_list<InteractionGraph>(*value, fill_interaction_graph);
+    }
+    if (const JsonValue* value = src.find_non_null("blockade_model")) {
+        fill_blockade_model(*value, hw.blockade_model);
+    }
+    if (const JsonValue* value = src.find_non_null("timing_limits")) {
+        fill_timing_limits(*value, hw.timing_limits);
+    }
+    if (const JsonValue* value = src.find_non_null("pulse_limits")) {
+        fill_pulse_limits(*value, hw.pulse_limits);
+    }
+    if (const JsonValue* value = src.find_non_null("transport_edges")) {
+        hw.transport_edges = object_list<TransportEdge>(*value, [](const JsonValue& item, TransportEdge& edge) {
+            edge.src_site_id = int_or(item, "src_site_id", edge.src_site_id);
+            edge.dst_site_id = int_or(item, "dst_site_id", edge.dst_site_id);
+            edge.distance = number_or(item, "distance", edge.distance);
+            edge.duration_ns = number_or(item, "duration_ns", edge.duration_ns);
+        });
+    }
+    if (const JsonValue* value = src.find_non_null("move_limits")) {
+        fill_move_limits(*value, hw.move_limits);
+    }
+}
+
+const JsonValue& required(const JsonValue& obj, std::string_view key) {
+    const JsonValue* value = obj.find_non_null(key);
+    if (!value) {
+        throw std::runtime_error("Instruction is missing '" + std::string(key) + "'");
+    }
+    return *value;
+}
+
+// Appends the instruction `obj` describes. A Repeat either nests its body
+// under "body" (the Python client) or gives "body_size" and is followed by
+// the body in the same list (to_json(JobRequest)).
+void append_instruction_from_json(const JsonValue& obj, Program& out) {
+    const std::string& op = required(obj, "op").as_string();
+    Instruction instr;
+    if (op == "Repeat") {
+        instr.op = Op::Repeat;
+        RepeatInstruction repeat{required(obj, "count").as_int(), 0};
+        const JsonValue* body = obj.find_non_null("body");
+        if (!body) {
+            repeat.body_size = required(obj, "body_size").as_int();
+            out.push_back({Op::Repeat, repeat});
+            return;
+        }
+        const std::size_t header = out.size();
+        out.push_back({Op::Repeat, repeat});
+        for (const auto& item : body->as_array()) {
+            append_instruction_from_json(item, out);
+        }
+        std::get<RepeatInstruction>(out[header].payload).body_size = static_cast<int>(out.size() - header - 1);
+        return;
+    }
+    if (op == "AllocArray") {
+        instr.op = Op::AllocArray;
+        instr.payload = required(obj, "n_qubits").as_int();
+    } else if (op == "ApplyGate") {
+        // The Python client flattens the gate into the instruction while
+        // to_json(JobRequest) nests it under "gate"; accept both.
+        const JsonValue* nested = obj.find_non_null("gate");
+        const JsonValue& gate_obj = nested ? *nested : obj;
+        instr.op = Op::ApplyGate;
+        Gate gate;
+        gate.name = required(gate_obj, "name").as_string();
+        gate.targets = int_list(required(gate_obj, "targets"));
+        // A string parameter names a symbol bound from "parameters".
+        const JsonValue* param = gate_obj.find_non_null("param");
+        if (param && param->is_string()) {
+            gate.symbol = param->as_string();
+        } else if (param) {
+            gate.param = param->as_double();
+        }
+        instr.payload = std::move(gate);
+    } else if (op == "Measure") {
+        out.push_measure(int_list(required(obj, "targets")));
+        return;
+    } else if (op == "MoveAtom") {
+        instr.op = Op::MoveAtom;
+        instr.payload = MoveAtomInstruction{
+            required(obj, "atom").as_int(), required(obj, "position").as_double()};
+    } else if (op == "Wait") {
+        instr.op = Op::Wait;
+        instr.payload = WaitInstruction{required(obj, "duration").as_double()};
+    } else if (op == "Pulse") {
+        instr.op = Op::Pulse;
+        instr.payload = PulseInstruction{
+            required(obj, "target").as_int(),
+            required(obj, "detuning").as_double(),
+            required(obj, "duration").as_double()};
+    } else {
+        throw std::runtime_error("Unsupported op: " + op);
+    }
+    out.push_back(std::move(instr));
+}
+
+void fill_pauli(const JsonValue& src, SingleQubitPauliConfig& dst) {
+    dst.px = number_or(src, "px", dst.px);
+    dst.py = number_or(src, "py", dst.py);
+    dst.pz = number_or(src, "pz", dst.pz);
+}
+
+void write_timeline(JsonWriter& out, const std::vector<TimelineEntry>& timeline) {
+    out.begin_array();
+    for (const auto& entry : timeline) {
+        out.begin_object()
+            .field("start_time", entry.start_time)
+            .field("duration", entry.duration)
+            .field("op", entry.op)
+            .field("detail", entry.detail)
+            .end_object();
+    }
+    out.end_array();
+}
+
+}  // namespace
+
+SimpleNoiseConfig noise_config_from_json(const JsonValue& noise) {
+    SimpleNoiseConfig cfg;
+    cfg.p_quantum_flip = number_or(noise, "p_quantum_flip", cfg.p_quantum_flip);
+    cfg.p_loss = number_or(noise, "p_loss", cfg.p_loss);
+    if (const JsonValue* readout = noise.find_non_null("readout")) {
+        cfg.readout.p_flip0_to_1 = number_or(*readout, "p_flip0_to_1", cfg.readout.p_flip0_to_1);
+        cfg.readout.p_flip1_to_0 = number_or(*readout, "p_flip1_to_0", cfg.readout.p_flip1_to_0);
+    }
+    if (const JsonValue* gate = noise.find_non_null("gate")) {
+        if (const JsonValue* value = gate->find_non_null("single_qubit")) {
+            fill_pauli(*value, cfg.gate.single_qubit);
+        }
+        if (const JsonValue* value = gate->find_non_null("two_qubit_control")) {
+            fill_pauli(*value, cfg.gate.two_qubit_control);
+        }
+        if (const JsonValue* value = gate->find_non_null("two_qubit_target")) {
+            fill_pauli(*value, cfg.gate.two_qubit_target);
+        }
+    }
+    if (const JsonValue* correlated = noise.find_non_null("correlated_gate")) {
+        if (const JsonValue* matrix = correlated->find_non_null("matrix")) {
+            const auto& rows = matrix->as_array();
+            for (std::size_t row = 0; row < 4 && row < rows.size(); ++row) {
+                const auto& cols = rows[row].as_array();
+                for (std::size_t col = 0; col < 4 && col < cols.size(); ++col) {
+                    cfg.correlated_gate.matrix[4 * row + col] = cols[col].as_double();
+                }
+            }
+        }
+    }
+    cfg.idle_rate = number_or(noise, "idle_rate", cfg.idle_rate);
+    if (const JsonValue* phase = noise.find_non_null("phase")) {
+        cfg.phase.single_qubit = number_or(*phase, "single_qubit", cfg.phase.single_qubit);
+        cfg.phase.two_qubit_control = number_or(*phase, "two_qubit_control", cfg.phase.two_qubit_control);
+        cfg.phase.two_qubit_target = number_or(*phase, "two_qubit_target", cfg.phase.two_qubit_target);
+        cfg.phase.idle = number_or(*phase, "idle", cfg.phase.idle);
+    }
+    if (const JsonValue* damping = noise.find_non_null("amplitude_damping")) {
+        cfg.amplitude_damping.per_gate = number_or(*damping, "per_gate", cfg.amplitude_damping.per_gate);
+        cfg.amplitude_damping.idle_rate = number_or(*damping, "idle_rate", cfg.amplitude_damping.idle_rate);
+    }
+    if (const JsonValue* loss = noise.find_non_null("loss_runtime")) {
+        cfg.loss_runtime.per_gate = number_or(*loss, "per_gate", cfg.loss_runtime.per_gate);
+        cfg.loss_runtime.idle_rate = number_or(*loss, "idle_rate", cfg.loss_runtime.idle_rate);
+    }
+    return cfg;
+}
+
+JobRequest job_request_from_json(const JsonValue& obj) {
+    if (!obj.is_object()) {
+        throw std::runtime_error("job payload must be a JSON object");
+    }
+    JobRequest job;
+    job.job_id = string_or(obj, "job_id", "");
+    job.device_id = string_or(obj, "device_id", "state-vector");
+    job.profile = string_or(obj, "profile", "");
+
+    const JsonValue* program = obj.find_non_null("program");
+    if (!program) {
+        throw std::runtime_error("job payload is missing 'program'");
+    }
+    job.program.reserve(program->as_array().size());
+    for (const auto& item : program->as_array()) {
+        append_instruction_from_json(item, job.program);
+    }
+
+    if (const JsonValue* hardware = obj.find_non_null("hardware")) {
+        fill_hardware(*hardware, job.hardware);
+    } else {
+        // Legacy flat layout: geometry at the top level of the job.
+        fill_hardware(obj, job.hardware);
+    }
+
+    job.shots = int_or(obj, "shots", job.shots);
+    if (const JsonValue* threads = obj.find_non_null("max_threads")) {
+        job.max_threads = static_cast<std::size_t>(threads->as_uint64());
+    }
+    if (const JsonValue* version = obj.find_non_null("isa_version")) {
+        job.isa_version.major = int_or(*version, "major", job.isa_version.major);
+        job.isa_version.minor = int_or(*version, "minor", job.isa_version.minor);
+    }
+    if (const JsonValue* metadata = obj.find_non_null("metadata")) {
+        for (const auto& [key, value] : metadata->as_object()) {
+            job.metadata[key] = value.as_string();
+        }
+    }
+    if (const JsonValue* stim = obj.find_non_null("stim_circuit")) {
+        job.stim_circuit = stim->as_string();
+    }
+    if (const JsonValue* seed = obj.find_non_null("seed")) {
+        job.seed = seed->as_uint64();
+    }
+    if (const JsonValue* noise = obj.find_non_null("noise")) {
+        job.noise_config = noise_config_from_json(*noise);
+    }
+    if (const JsonValue* parameters = obj.find_non_null("parameters")) {
+        for (const auto& [name, value] : parameters->as_object()) {
+            job.parameters[name] = value.as_double();
+        }
+    }
+    return job;
+}
+
+JobRequest job_request_from_json(std::string_view text) {
+    return job_request_from_json(parse_json(text));
+}
+
+void write_stage(JsonWriter& out, std::string_view name, const StageTiming& timing) {
+    out.key(name).begin_object()
+        .field("wall_seconds", timing.wall_seconds)
+        .field("cpu_seconds", timing.cpu_seconds)
+        .end_object();
+}
+
+void write_counter_fields(JsonWriter& out, const HardwareCounters& counters) {
+    out.field("cycles", counters.cycles)
+        .field("instructions", counters.instructions)
+        .field("cache_references", counters.cache_references)
+        .field("cache_misses", counters.cache_misses);
+}
+
+void write_counters(JsonWriter& out, const JobProfile& profile) {
+    out.key("hardware_counters").begin_object();
+    out.field("available", profile.counters.available);
+    write_counter_fields(out, profile.counters);
+    out.field("memory_bandwidth_bytes_per_second", profile.memory_bandwidth_bytes_per_second);
+    out.key("kernels").begin_object();
+    for (const auto& [name, kernel] : profile.kernels) {
+        out.key(name).begin_object();
+        out.field("calls", kernel.calls);
+        write_counter_fields(out, kernel.counters);
+        out.end_object();
+    }
+    out.end_object();
+    out.end_object();
+}
+
+void write_profile(JsonWriter& out, const JobProfile& profile) {
+    out.begin_object();
+    out.key("stages").begin_object();
+    write_stage(out, "enrich", profile.enrich);
+    write_stage(out, "validate", profile.validate);
+    write_stage(out, "schedule", profile.schedule);
+    write_stage(out, "simulate", profile.simulate);
+    write_stage(out, "convert", profile.convert);
+    out.end_object();
+    out.field("peak_statevector_bytes", profile.peak_statevector_bytes);
+    out.field("amplitude_updates", profile.amplitude_updates);
+    out.field("shots_per_second", profile.shots_per_second);
+    out.field("threads", profile.threads);
+    out.field("backend", profile.backend);
+    out.field("cache_hit", profile.cache_hit);
+    write_counters(out, profile);
+    out.end_object();
+}
+
+void write_job_result(JsonWriter& out, const JobResult& result) {
+    out.begin_object();
+    out.field("job_id", result.job_id);
+    out.field("status", status_to_string(result.status));
+    out.field("elapsed_time", result.elapsed_time);
+    out.key("measurements").begin_array();
+    for (const auto& record : result.measurements) {
+        out.begin_object();
+        out.key("targets").array(record.targets);
+        out.key("bits").array(record.bits);
+        out.end_object();
+    }
+    out.end_array();
+    out.field("message", result.message);
+    if (!result.log_time_units.empty()) {
+        out.field("log_time_units", result.log_time_units);
+    }
+    out.key("logs").begin_array();
+    for (const auto& entry : result.logs) {
+        out.begin_object()
+            .field("shot", entry.shot)
+            .field("time", entry.logical_time)
+            .field("category", entry.category)
+            .field("message", entry.message)
+            .end_object();
+    }
+    out.end_array();
+    if (!result.timeline_units.empty()) {
+        out.field("timeline_units", result.timeline_units);
+    }
+    out.key("timeline");
+    write_timeline(out, result.timeline);
+    if (!result.scheduler_timeline_units.empty()) {
+        out.field("scheduler_timeline_units", result.scheduler_timeline_units);
+    }
+    out.key("scheduler_timeline");
+    write_timeline(out, result.scheduler_timeline);
+    if (!result.metadata.empty()) {
+        out.key("metadata").begin_object();
+        for (const auto& [key, value] : result.metadata) {
+            out.field(key, value);
+        }
+        out.end_object();
+    }
+    out.key("profile");
+    write_profile(out, result.profile);
+    out.end_object();
+}
+
+std::string job_result_to_json(const JobResult& result) {
+    JsonWriter out;
+    write_job_result(out, result);
+    return out.take();
+}
+
+std::string shot_batch_to_json(const ShotBatch& batch) {
+    JsonWriter out;
+    out.begin_object();
+    out.key("shots").begin_array();
+    for (const auto& shot : batch.shots) {
+        out.begin_object().field("shot", shot.shot);
+        out.key("measurements").begin_array();
+        for (const auto& record : shot.measurements) {
+            out.begin_object();
+            out.key("targets").array(record.targets);
+            out.key("bits").array(record.bits);
+            out.end_object();
+        }
+        out.end_array().end_object();
+    }
+    out.end_array();
+    out.key("counts").begin_object();
+    for (const auto& [outcome, count] : batch.counts) {
+        out.field(outcome, count);
+    }
+    out.end_object();
+    out.field("coalesced_shots", batch.coalesced_shots);
+    out.field("completed_shots", batch.completed_shots);
+    out.field("total_shots", batch.total_shots);
+    out.end_object();
+    return out.take();
+}
+
+}  // namespace service
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "service/job.hpp"
+#include "service/json.hpp"
+#include "service/shot_stream.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace service {
+
+// Build a JobRequest from the JSON job schema shared with the Python client
+// (`neutral_atom_vm.JobRequest.to_dict`) and emitted by to_json(JobRequest).
+// Throws std::runtime_error on malformed input.
+JobRequest job_request_from_json(const JsonValue& job);
+JobRequest job_request_from_json(std::string_view text);
+
+SimpleNoiseConfig noise_config_from_json(const JsonValue& noise);
+
+// JSON form of a result; keys mirror the Python binding's result dict.
+std::string job_result_to_json(const JobResult& result);
+void write_job_result(JsonWriter& out, const JobResult& result);
+
+// JSON form of a streamed shot batch, one object per shot with its records.
+// The Python binding returns the same batch as a bit matrix plus layout.
+std::string shot_batch_to_json(const ShotBatch& batch);
+
+}  // namespace service
@@ -1,14 +1,21 @@
 #include "service/job_service.hpp"
 
 #include "progress_reporter.hpp"
+#include "service/job_codec.hpp"
+#include "service/packed_measurements.hpp"
 
 #include <algorithm>
 #include <atomic>
-#include <chrono>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <future>
 #include <limits>
 #include <memory>
 #include <mutex>
-#include <thread>
+#include <optional>
+#include <string>
+#include <utility>
 #include <unordered_map>
 
 namespace service {
@@ -32,57 +39,490 @@ std::size_t compute_total_steps(const JobRequest& job) {
     return clamp_product(program_steps, shot_count);
 }
 
+// Keep generated IDs ahead of "<prefix><n>" IDs recovered from a journal.
+void advance_past(std::atomic<std::uint64_t>& counter, const std::string& id, const char* prefix) {
+    const std::size_t prefix_size = std::strlen(prefix);
+    if (id.compare(0, prefix_size, prefix) != 0) {
+        return;
+    }
+    std::uint64_t value = 0;
+    const char* begin = id.data() + prefix_size;
+    const char* end = id.data() + id.size();
+    const auto parsed = std::from_chars(begin, end, value);
+    if (parsed.ec != std::errc() || parsed.ptr != end) {
+        return;
+    }
+    std::uint64_t current = counter.load(std::memory_order_relaxed);
+    while (current <= value && !counter.compare_exchange_weak(current, value + 1)) {
+    }
+}
+
 }  // namespace
 
-JobService::JobService()
-    : id_counter_(0) {}
+std::string tenant_of(const JobRequest& job) {
+    const auto it = job.metadata.find("tenant");
+    return it == job.metadata.end() || it->second.empty() ? "default" : it->second;
+}
 
-JobService::~JobService() = default;
-std::string JobService::submit(JobRequest job, std::size_t max_threads) {
-    const std::size_t seq = id_counter_.fetch_add(1, std::memory_order_relaxed);
-    const std::string job_id = "job-" + std::to_string(seq);
-    job.job_id = job_id;
+JobService::JobService(FairShareOptions options)
+    : id_counter_(0),
+      metrics_(std::make_shared<JobMetrics>(std::make_shared<MetricsRegistry>())),
+      scheduler_(std::move(options)) {
+    runner_.set_metrics(metrics_);
+}
+
+JobService::~JobService() {
+    // Pending durability callbacks reference this service.
+    if (journal_) {
+        try {
+            journal_->flush();
+        } catch (const std::exception&) {
+        }
+    }
+}
+
+std::shared_ptr<JobService::JobEntry> JobService::make_entry(JobRequest job, std::string job_id) {
+    if (job_id.empty()) {
+        const std::size_t seq = id_counter_.fetch_add(1, std::memory_order_relaxed);
+        job_id = "job-" + std::to_string(seq);
+    }
+    job.job_id = std::move(job_id);
 
     auto entry = std::make_shared<JobEntry>();
+    entry->result.job_id = job.job_id;
     entry->request = std::move(job);
     entry->reporter = std::make_shared<JobProgressReporter>();
-    entry->result.job_id = job_id;
+    entry->reporter->set_total_steps(compute_total_steps(entry->request));
+    metrics_->queued_jobs.add(1);
+    return entry;
+}
 
+void JobService::start_entry(JobEntry& entry) {
+    if (journal_) {
+        journal_->record_start(entry.request.job_id);
+    }
+    entry.status.store(JobStatus::Running, std::memory_order_relaxed);
+    metrics_->queued_jobs.add(-1);
+    metrics_->running_jobs.add(1);
+}
+
+void JobService::store_result(JobEntry& entry, JobResult result) {
+    metrics_->running_jobs.add(-1);
+    (result.status == JobStatus::Completed ? metrics_->completed_jobs : metrics_->failed_jobs).add();
+    metrics_->job_seconds.observe(result.elapsed_time);
+    if (journal_) {
+        journal_->record_finish(result);
+    }
+    publish_result(entry, std::move(result));
+}
+
+void JobService::publish_result(JobEntry& entry, JobResult result) {
+    std::vector<CompletionCallback> callbacks;
+    JobStatus status;
+    {
+        std::lock_guard<std::mutex> guard(entry.result_mutex);
+        entry.result = std::move(result);
+        status = entry.result.status;
+        entry.status.store(status, std::memory_order_relaxed);
+        callbacks.swap(entry.callbacks);
+    }
+    entry.reporter->finish_streams();
+    for (const auto& callback : callbacks) {
+        callback(entry.request.job_id, status);
+    }
+}
+
+void JobService::reject_entries(const std::vector<std::shared_ptr<JobEntry>>& entries) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        jobs_.emplace(job_id, entry);
+        for (const auto& entry : entries) {
+            jobs_.erase(entry->request.job_id);
+        }
+    }
+    metrics_->queued_jobs.add(-static_cast<std::int64_t>(entries.size()));
+    metrics_->rejected_jobs.add(entries.size());
+    if (journal_) {
+        for (const auto& entry : entries) {
+            journal_->record_discard(entry->request.job_id);
+        }
     }
+}
 
-    std::thread worker([this, entry, max_threads]() {
-        entry->status.store(JobStatus::Running, std::memory_order_relaxed);
-        const std::size_t total_steps = compute_total_steps(entry->request);
-        entry->reporter->set_total_steps(total_steps);
-        const auto start = std::chrono::steady_clock::now();
-        try {
-            const std::size_t threads =
-                max_threads > 0 ? max_threads : entry->request.max_threads;
-            auto result = runner_.run(entry->request, threads, entry->reporter.get());
-            auto end_result = std::chrono::steady_clock::now();
-            result.elapsed_time =
-                std::chrono::duration<double>(end_result - start).count();
-            std::lock_guard<std::mutex> guard(entry->result_mutex);
-            entry->result = std::move(result);
-            entry->status.store(entry->result.status, std::memory_order_relaxed);
-        } catch (const std::exception& ex) {
-            const auto end = std::chrono::steady_clock::now();
-            std::lock_guard<std::mutex> guard(entry->result_mutex);
-            entry->result.status = JobStatus::Failed;
-            entry->result.message = ex.what();
-            entry->result.elapsed_time =
-                std::chrono::duration<double>(end - start).count();
-            entry->status.store(JobStatus::Failed, std::memory_order_relaxed);
-        }
-    });
-    worker.detach();
+ScheduledJob JobService::schedule_entry(
+    std::shared_ptr<JobEntry> entry,
+    std::size_t max_threads,
+    std::function<PreparedJob(JobEntry&)> prepare,
+    std::function<void(const std::shared_ptr<JobEntry>&)> on_finished
+) {
+    // Handed from plan to run_batch/complete; the scheduler orders the calls.
+    auto prepared = std::make_shared<PreparedJob>();
+    ScheduledJob work;
+    work.tenant = tenant_of(entry->request);
+    work.max_parallel = max_threads > 0 ? max_threads : entry->request.max_threads;
+    work.plan = [this, entry, prepared, prepare = std::move(prepare), tenant = work.tenant]() {
+        start_entry(*entry);
+        *prepared = prepare(*entry);
+        WorkPlan plan;
+        if (!prepared->execution) {
+            return plan;
+        }
+        ShotRangeExecution& execution = *prepared->execution;
+        const std::size_t memory_cap = scheduler_.policy(tenant).max_memory_bytes;
+        if (memory_cap > 0 && execution.statevector_bytes() > memory_cap) {
+            JobResult failed;
+            failed.job_id = entry->request.job_id;
+            failed.status = JobStatus::Failed;
+            failed.message = "tenant " + tenant + " memory quota of " + std::to_string(memory_cap) +
+                " bytes is below the " + std::to_string(execution.statevector_bytes()) +
+                " bytes one shot needs";
+            *prepared = PreparedJob{std::move(failed), nullptr};
+            return plan;
+        }
+        if (journal_ && entry->request.seed) {
+            // Seeded shots are reproducible, so finished ranges survive a restart.
+            execution.set_range_observer([this, job_id = entry->request.job_id](
+                std::size_t first, std::size_t count, const HardwareVM::RunResult& run) {
+                journal_->record_range(job_id, first, count, run);
+            });
+        }
+        if (coordinator_) {
+            execution.set_range_executor([coordinator = coordinator_,
+                                          request = encode_job_request(entry->request)](
+                std::size_t first, std::size_t count) {
+                return coordinator->run_range(request, first, count);
+            });
+        }
+        plan.shots = execution.total_shots();
+        plan.batch_memory_bytes = execution.statevector_bytes();
+        plan.shot_cost = execution.shot_cost();
+        return plan;
+    };
+    work.run_batch = [prepared](std::size_t first, std::size_t count) {
+        // One thread per batch: parallelism comes from running batches of
+        // the job on several workers, and the scheduler sizes batches so
+        // even a small job gets one per worker (up to max_threads).
+        prepared->execution->run_range(first, count, 1);
+    };
+    work.complete = [this, entry, prepared, on_finished = std::move(on_finished)]() {
+        JobResult result;
+        if (prepared->execution) {
+            result = prepared->execution->finish();
+        } else if (prepared->result) {
+            result = std::move(*prepared->result);
+        } else {
+            result.job_id = entry->request.job_id;
+            result.status = JobStatus::Failed;
+            result.message = "job could not be prepared";
+        }
+        prepared->execution.reset();
+        store_result(*entry, std::move(result));
+        if (on_finished) {
+            on_finished(entry);
+        }
+    };
+    return work;
+}
+
+void JobService::enqueue_when_durable(
+    std::uint64_t journaled,
+    std::vector<std::shared_ptr<JobEntry>> entries,
+    std::vector<ScheduledJob> work,
+    std::function<void(std::exception_ptr)> done
+) {
+    // Jobs are queued only once their submission is durable, so a failed
+    // journal write rejects them instead of leaving them running unlogged.
+    auto accept = [this, entries = std::move(entries), work = std::move(work), done = std::move(done)](
+        std::exception_ptr error
+    ) mutable {
+        if (!error) {
+            try {
+                scheduler_.submit(std::move(work));
+            } catch (const QuotaExceeded&) {
+                error = std::current_exception();
+            }
+        }
+        if (error) {
+            reject_entries(entries);
+        }
+        done(error);
+    };
+    if (journal_) {
+        journal_->on_durable(journaled, std::move(accept));
+    } else {
+        accept(nullptr);
+    }
+}
 
+std::string JobService::submit(JobRequest job, std::size_t max_threads) {
+    std::promise<std::exception_ptr> accepted;
+    auto outcome = accepted.get_future();
+    std::string job_id = submit_async(std::move(job), max_threads,
+        [&accepted](const std::string&, std::exception_ptr error) { accepted.set_value(error); });
+    if (const std::exception_ptr error = outcome.get()) {
+        std::rethrow_exception(error);
+    }
     return job_id;
 }
 
+std::string JobService::submit_async(JobRequest job, std::size_t max_threads, SubmitCallback on_accepted) {
+    auto entry = make_entry(std::move(job));
+    const std::string job_id = entry->request.job_id;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.emplace(job_id, entry);
+    }
+
+    const std::uint64_t journaled = journal_ ? journal_->record_submit(entry->request, {}, max_threads) : 0;
+    std::vector<ScheduledJob> work;
+    work.push_back(schedule_entry(entry, max_threads, [this](JobEntry& item) {
+        return runner_.prepare(item.request, item.reporter.get());
+    }));
+    enqueue_when_durable(journaled, {entry}, std::move(work),
+        [job_id, on_accepted = std::move(on_accepted)](std::exception_ptr error) {
+            on_accepted(job_id, error);
+        });
+    return job_id;
+}
+
+BatchSubmission JobService::submit_batch(
+    JobRequest base,
+    const std::vector<JobOverride>& items,
+    std::size_t max_threads
+) {
+    // Materialise every item up front so malformed overrides are reported to
+    // the caller instead of surfacing as failed jobs.
+    std::vector<JobRequest> requests;
+    std::vector<std::vector<GateParamBinding>> bindings;
+    requests.reserve(items.size());
+    bindings.reserve(items.size());
+    for (const auto& item : items) {
+        bindings.push_back(override_bindings(base, item));
+        requests.push_back(apply_override(base, item, bindings.back()));
+    }
+
+    auto batch = std::make_shared<BatchEntry>();
+    BatchSubmission submission;
+    submission.batch_id =
+        "batch-" + std::to_string(batch_counter_.fetch_add(1, std::memory_order_relaxed));
+    for (auto& request : requests) {
+        auto entry = make_entry(std::move(request));
+        submission.job_ids.push_back(entry->request.job_id);
+        batch->items.push_back(std::move(entry));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : batch->items) {
+            jobs_.emplace(entry->request.job_id, entry);
+        }
+        batches_.emplace(submission.batch_id, batch);
+    }
+
+    // The first item to reach a worker compiles the base and indexes its
+    // parameter slots; the others wait for it and share both.
+    struct Compilation {
+        std::once_flag once;
+        std::shared_ptr<const CompiledJob> compiled;
+        std::shared_ptr<const GateParamIndex> index;
+        std::string error;
+    };
+    auto compilation = std::make_shared<Compilation>();
+    auto shared_base = std::make_shared<const JobRequest>(std::move(base));
+    const auto finish_item = [batch](const std::shared_ptr<JobEntry>& entry) {
+        std::lock_guard<std::mutex> guard(batch->mutex);
+        batch->finished.push_back(entry);
+    };
+
+    std::vector<ScheduledJob> work;
+    work.reserve(batch->items.size());
+    for (std::size_t idx = 0; idx < batch->items.size(); ++idx) {
+        auto prepare = [this, batch, compilation, shared_base, gate_params = std::move(bindings[idx])](
+            JobEntry& entry
+        ) {
+            std::call_once(compilation->once, [&]() {
+                try {
+                    compilation->compiled = std::make_shared<const CompiledJob>(runner_.compile(*shared_base));
+                    compilation->index = std::make_shared<const GateParamIndex>(
+                        index_gate_params(compilation->compiled->scheduled));
+                } catch (const std::exception& ex) {
+                    compilation->error = ex.what();
+                    std::lock_guard<std::mutex> guard(batch->mutex);
+                    batch->message = ex.what();
+                }
+            });
+            if (!compilation->compiled) {
+                JobResult failed;
+                failed.job_id = entry.request.job_id;
+                failed.status = JobStatus::Failed;
+                failed.message = compilation->error;
+                return PreparedJob{std::move(failed), nullptr};
+            }
+            if (gate_params.empty()) {
+                return runner_.prepare(compilation->compiled, entry.request, entry.reporter.get());
+            }
+            // Parameters never change timing or validity, so only the
+            // program is copied and patched; the schedule stays shared.
+            auto bound = std::make_shared<BoundProgram>();
+            bound->base = compilation->compiled;
+            bound->program = compilation->compiled->scheduled.program;
+            bound->timeline_details = bind_gate_params(bound->program, *compilation->index, gate_params);
+            return runner_.prepare(
+                std::shared_ptr<const BoundProgram>(std::move(bound)), entry.request, entry.reporter.get());
+        };
+        work.push_back(schedule_entry(batch->items[idx], max_threads, std::move(prepare), finish_item));
+    }
+
+    std::uint64_t journaled = 0;
+    if (journal_) {
+        for (const auto& entry : batch->items) {
+            journaled = journal_->record_submit(entry->request, submission.batch_id, max_threads);
+        }
+    }
+    std::promise<std::exception_ptr> accepted;
+    auto outcome = accepted.get_future();
+    enqueue_when_durable(journaled, batch->items, std::move(work),
+        [&accepted](std::exception_ptr error) { accepted.set_value(error); });
+    if (const std::exception_ptr error = outcome.get()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batches_.erase(submission.batch_id);
+        }
+        std::rethrow_exception(error);
+    }
+    return submission;
+}
+
+BatchSubmission JobService::submit_sweep(
+    JobRequest base,
+    const std::vector<ParameterSet>& parameter_sets,
+    std::size_t max_threads
+) {
+    std::vector<JobOverride> items(parameter_sets.size());
+    for (std::size_t idx = 0; idx < parameter_sets.size(); ++idx) {
+        items[idx].parameters = parameter_sets[idx];
+    }
+    return submit_batch(std::move(base), items, max_threads);
+}
+
+std::size_t JobService::attach_journal(std::shared_ptr<JobJournal> journal) {
+    journal_ = std::move(journal);
+    std::vector<JournaledJob> recovered = journal_->take_recovered();
+
+    std::size_t requeued = 0;
+    std::vector<ScheduledJob> work;
+    for (auto& job : recovered) {
+        advance_past(id_counter_, job.request.job_id, "job-");
+        advance_past(batch_counter_, job.batch_id, "batch-");
+        std::string job_id = job.request.job_id;
+        auto entry = make_entry(std::move(job.request), std::move(job_id));
+
+        std::shared_ptr<BatchEntry> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.emplace(entry->request.job_id, entry);
+            if (!job.batch_id.empty()) {
+                auto& slot = batches_[job.batch_id];
+                if (!slot) {
+                    slot = std::make_shared<BatchEntry>();
+                }
+                batch = slot;
+                batch->items.push_back(entry);
+            }
+        }
+
+        if (job.result) {
+            metrics_->queued_jobs.add(-1);
+            publish_result(*entry, std::move(*job.result));
+            if (batch) {
+                std::lock_guard<std::mutex> guard(batch->mutex);
+                batch->finished.push_back(entry);
+            }
+            continue;
+        }
+
+        // Batch items were materialised before journaling, so each resumes
+        // as a standalone request compiled on its own.
+        auto ranges = std::make_shared<std::vector<JournaledRange>>(std::move(job.ranges));
+        auto prepare = [this, ranges](JobEntry& item) {
+            PreparedJob prepared = runner_.prepare(item.request, item.reporter.get());
+            if (prepared.execution) {
+                for (auto& range : *ranges) {
+                    item.reporter->increment_completed_steps(item.request.program.size() * range.count);
+                    prepared.execution->restore_range(range.first, range.count, std::move(range.run));
+                }
+            }
+            ranges->clear();
+            return prepared;
+        };
+        std::function<void(const std::shared_ptr<JobEntry>&)> on_finished;
+        if (batch) {
+            on_finished = [batch](const std::shared_ptr<JobEntry>& finished) {
+                std::lock_guard<std::mutex> guard(batch->mutex);
+                batch->finished.push_back(finished);
+            };
+        }
+        work.push_back(schedule_entry(entry, job.max_threads, std::move(prepare), std::move(on_finished)));
+        ++requeued;
+    }
+    // These jobs were accepted before the restart; quotas do not apply again.
+    scheduler_.submit(std::move(work), false);
+    return requeued;
+}
+
+BatchStatus JobService::batch_status(const std::string& batch_id) const {
+    BatchStatus snapshot;
+    std::shared_ptr<BatchEntry> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = batches_.find(batch_id);
+        if (it == batches_.end()) {
+            snapshot.message = std::string("batch_id not found");
+            return snapshot;
+        }
+        batch = it->second;
+    }
+    snapshot.total = batch->items.size();
+    std::lock_guard<std::mutex> guard(batch->mutex);
+    snapshot.finished = batch->finished.size();
+    for (const auto& entry : batch->finished) {
+        if (entry->status.load(std::memory_order_relaxed) == JobStatus::Failed) {
+            ++snapshot.failed;
+        }
+    }
+    snapshot.message = batch->message;
+    return snapshot;
+}
+
+std::vector<JobResult> JobService::batch_results(
+    const std::string& batch_id,
+    std::size_t cursor
+) const {
+    std::shared_ptr<BatchEntry> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = batches_.find(batch_id);
+        if (it == batches_.end()) {
+            return {};
+        }
+        batch = it->second;
+    }
+    std::vector<std::shared_ptr<JobEntry>> finished;
+    {
+        std::lock_guard<std::mutex> guard(batch->mutex);
+        if (cursor < batch->finished.size()) {
+            finished.assign(batch->finished.begin() + static_cast<std::ptrdiff_t>(cursor),
+                            batch->finished.end());
+        }
+    }
+    std::vector<JobResult> results;
+    results.reserve(finished.size());
+    for (const auto& entry : finished) {
+        std::lock_guard<std::mutex> guard(entry->result_mutex);
+        results.push_back(entry->result);
+    }
+    return results;
+}
+
 std::optional<JobResult> JobService::poll_result(const std::string& job_id) const {
     std::shared_ptr<JobEntry> entry;
     {
@@ -101,6 +541,85 @@ std::optional<JobResult> JobService::poll_result(const std::string& job_id) cons
     return entry->result;
 }
 
+bool JobService::has_result(const std::string& job_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = jobs_.find(job_id);
+    if (it == jobs_.end()) {
+        return false;
+    }
+    const JobStatus status = it->second->status.load(std::memory_order_relaxed);
+    return status == JobStatus::Completed || status == JobStatus::Failed;
+}
+
+std::shared_ptr<const SharedResultSegment> JobService::result_segment(const std::string& job_id) const {
+    std::shared_ptr<JobEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = jobs_.find(job_id);
+        if (it == jobs_.end()) {
+            return nullptr;
+        }
+        entry = it->second;
+    }
+    if (entry->status.load(std::memory_order_relaxed) != JobStatus::Completed) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(entry->result_mutex);
+    if (!entry->segment && entry->result.segment) {
+        // Merged from the shard workers' planes; publish it as is.
+        entry->segment = entry->result.segment;
+    }
+    if (!entry->segment) {
+        const auto packed = pack_measurements(
+            entry->result.measurements, static_cast<std::size_t>(std::max(0, entry->request.shots)));
+        if (!packed) {
+            return nullptr;
+        }
+        entry->segment = SharedResultSegment::create(*packed);
+    }
+    return entry->segment;
+}
+
+std::optional<ShotSubscription> JobService::subscribe(
+    const std::string& job_id,
+    std::size_t capacity
+) const {
+    std::shared_ptr<JobEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = jobs_.find(job_id);
+        if (it == jobs_.end()) {
+            return std::nullopt;
+        }
+        entry = it->second;
+    }
+    const auto total_shots = static_cast<std::size_t>(std::max(1, entry->request.shots));
+    return ShotSubscription(entry->reporter->subscribe(capacity, total_shots));
+}
+
+bool JobService::on_completion(const std::string& job_id, CompletionCallback callback) {
+    std::shared_ptr<JobEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = jobs_.find(job_id);
+        if (it == jobs_.end()) {
+            return false;
+        }
+        entry = it->second;
+    }
+    JobStatus status;
+    {
+        std::lock_guard<std::mutex> guard(entry->result_mutex);
+        status = entry->status.load(std::memory_order_relaxed);
+        if (status != JobStatus::Completed && status != JobStatus::Failed) {
+            entry->callbacks.push_back(std::move(callback));
+            return true;
+        }
+    }
+    callback(job_id, status);
+    return true;
+}
+
 JobStatusSnapshot JobService::status(const std::string& job_id) const {
     JobStatusSnapshot snapshot;
     std::shared_ptr<JobEntry> entry;
@@ -127,4 +646,32 @@ JobStatusSnapshot JobService::status(const std::string& job_id) const {
     return snapshot;
 }
 
+void JobService::set_shard_coordinator(std::shared_ptr<ShardCoordinator> coordinator) {
+    coordinator_ = std::move(coordinator);
+}
+
+void JobService::set_tenant_policy(const std::string& tenant, TenantPolicy policy) {
+    scheduler_.set_policy(tenant, policy);
+}
+
+TenantStats JobService::tenant_stats(const std::string& tenant) const {
+    return scheduler_.stats(tenant);
+}
+
+void JobService::set_result_cache(std::shared_ptr<ResultCache> cache) {
+    runner_.set_result_cache(std::move(cache));
+}
+
+void JobService::set_counter_scope(CounterScope scope) {
+    runner_.set_counter_scope(scope);
+}
+
+MetricsRegistry& JobService::metrics() const {
+    return *metrics_->registry;
+}
+
+std::string JobService::render_metrics() const {
+    return metrics_->registry->render_prometheus();
+}
+
 }  // namespace service
@@ -1,10 +1,21 @@
 #pragma once
 
+#include "service/fair_scheduler.hpp"
 #include "service/job.hpp"
+#include "service/job_journal.hpp"
+#include "service/mpsc_ring_buffer.hpp"
+#include "service/shard_coordinator.hpp"
+#include "service/shared_result.hpp"
+#include "service/sharded_counter.hpp"
+#include "service/shot_stream.hpp"
 
 #include "progress_reporter.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -17,43 +28,135 @@ class JobProgressReporter final : public neutral_atom_vm::ProgressReporter {
     JobProgressReporter() = default;
 
     void set_total_steps(std::size_t total_steps) override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        total_steps_ = total_steps;
+        total_steps_.store(total_steps, std::memory_order_relaxed);
     }
 
     void increment_completed_steps(std::size_t delta = 1) override {
-        completed_steps_.fetch_add(delta, std::memory_order_relaxed);
+        completed_steps_.add(delta);
     }
 
     void record_log(const ExecutionLog& log) override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        logs_.push_back(log);
-        if (logs_.size() > kMaxLogs) {
-            logs_.erase(logs_.begin());
-        }
+        logs_.push(pack_log(log));
     }
 
     std::size_t total_steps() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return total_steps_;
+        return total_steps_.load(std::memory_order_relaxed);
     }
 
     std::size_t completed_steps() const {
-        return completed_steps_.load(std::memory_order_relaxed);
+        return completed_steps_.load();
+    }
+
+    void record_shot(int shot, const std::vector<MeasurementRecord>& measurements) override {
+        // Unobserved jobs only bump a counter; histograms live in the streams.
+        completed_shots_.fetch_add(1);
+        if (!streaming_.load()) {
+            return;
+        }
+        std::vector<std::shared_ptr<service::ShotStream>> streams;
+        {
+            std::lock_guard<std::mutex> lock(stream_mutex_);
+            streams = streams_;
+        }
+        // Push outside the lock. push() never waits: a full stream coalesces
+        // the shot into its histogram, so a slow subscriber cannot stall
+        // this worker.
+        bool any_cancelled = false;
+        for (const auto& stream : streams) {
+            any_cancelled |= !stream->push(service::ShotRecord{shot, measurements});
+        }
+        if (any_cancelled) {
+            std::lock_guard<std::mutex> lock(stream_mutex_);
+            streams_.erase(
+                std::remove_if(streams_.begin(), streams_.end(),
+                    [](const auto& stream) { return stream->cancelled(); }),
+                streams_.end());
+            streaming_.store(!streams_.empty());
+        }
     }
 
     std::vector<ExecutionLog> recent_logs() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return logs_;
+        std::vector<ExecutionLog> logs;
+        for (const auto& packed : logs_.snapshot(kMaxLogs)) {
+            logs.push_back(ExecutionLog{
+                packed.shot, packed.logical_time, packed.category, packed.message});
+        }
+        return logs;
+    }
+
+    // Open a stream of shots finished from now on. The stream's histogram
+    // covers those shots; its completed count includes earlier ones too.
+    std::shared_ptr<service::ShotStream> subscribe(std::size_t capacity, std::size_t total_shots) {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
+        if (!streams_finished_) {
+            // Publish the stream before sampling the counter, so a shot is
+            // either counted in the snapshot or pushed (possibly both, which
+            // the stream clamps at total_shots).
+            streaming_.store(true);
+        }
+        auto stream = std::make_shared<service::ShotStream>(
+            capacity, total_shots, completed_shots_.load());
+        if (streams_finished_) {
+            stream->finish();
+        } else {
+            streams_.push_back(stream);
+        }
+        return stream;
+    }
+
+    // Called once the job has ended; open streams drain and then finish.
+    void finish_streams() {
+        std::vector<std::shared_ptr<service::ShotStream>> streams;
+        {
+            std::lock_guard<std::mutex> lock(stream_mutex_);
+            streams_finished_ = true;
+            streams.swap(streams_);
+            streaming_.store(false);
+        }
+        for (const auto& stream : streams) {
+            stream->finish();
+        }
     }
 
   private:
     static constexpr std::size_t kMaxLogs = 8;
+    // Ring slots beyond kMaxLogs leave room for slots skipped mid-write.
+    static constexpr std::size_t kLogRingCapacity = 16;
 
-    mutable std::mutex mutex_;
-    std::vector<ExecutionLog> logs_;
-    std::size_t total_steps_ = 0;
-    std::atomic<std::size_t> completed_steps_{0};
+    // Fixed-size copy of an ExecutionLog; long text is truncated in status
+    // snapshots only, JobResult keeps the full logs.
+    struct PackedLog {
+        int shot = 0;
+        double logical_time = 0.0;
+        char category[24] = {};
+        char message[152] = {};
+    };
+
+    template <std::size_t N>
+    static void copy_truncated(const std::string& text, char (&out)[N]) {
+        const std::size_t length = std::min(text.size(), N - 1);
+        std::memcpy(out, text.data(), length);
+        out[length] = '\0';
+    }
+
+    static PackedLog pack_log(const ExecutionLog& log) {
+        PackedLog packed;
+        packed.shot = log.shot;
+        packed.logical_time = log.logical_time;
+        copy_truncated(log.category, packed.category);
+        copy_truncated(log.message, packed.message);
+        return packed;
+    }
+
+    service::MpscRingBuffer<PackedLog, kLogRingCapacity> logs_;
+    std::atomic<std::size_t> total_steps_{0};
+    service::ShardedCounter completed_steps_;
+
+    std::mutex stream_mutex_;
+    std::vector<std::shared_ptr<service::ShotStream>> streams_;
+    std::atomic<std::size_t> completed_shots_{0};
+    std::atomic<bool> streaming_{false};
+    bool streams_finished_ = false;
 };
 
 namespace service {
@@ -65,20 +168,141 @@ struct JobStatusSnapshot {
     std::vector<ExecutionLog> recent_logs;
 };
 
+struct BatchSubmission {
+    std::string batch_id;
+    std::vector<std::string> job_ids;  // one per override, in submission order
+};
+
+struct BatchStatus {
+    std::size_t total = 0;
+    std::size_t finished = 0;
+    std::size_t failed = 0;
+    std::string message;
+};
+
+// Tenant a request is scheduled under: metadata["tenant"], or "default".
+std::string tenant_of(const JobRequest& job);
+
+// Jobs run on a FairShareScheduler worker pool: each tenant gets a weighted
+// share of the workers, and jobs are executed in shot batches so a large job
+// yields between batches. `max_threads` bounds how many batches of one job
+// run at once.
 class JobService {
   public:
-    JobService();
+    explicit JobService(FairShareOptions options = {});
     ~JobService();
 
-    // Submit a job for asynchronous execution. Returns the generated job ID.
+    // Submit a job for asynchronous execution. Returns the generated job ID
+    // once the submission is durable in the journal (if any). Throws
+    // QuotaExceeded when the tenant's queued-job quota is full, and the
+    // journal's error when the submission could not be written.
     std::string submit(JobRequest job, std::size_t max_threads = 0);
 
+    // Outcome of submit_async(): `error` is null once the job is durable and
+    // queued, else QuotaExceeded or the journal's write error, in which case
+    // the job ID is unknown again.
+    using SubmitCallback = std::function<void(const std::string& job_id, std::exception_ptr error)>;
+
+    // Like submit(), but returns the job ID without waiting for the journal.
+    // `on_accepted` runs once, on the journal's writer thread or before
+    // submit_async returns; it must be quick and must not throw.
+    std::string submit_async(JobRequest job, std::size_t max_threads, SubmitCallback on_accepted);
+
+    // Submit a sweep over one base request. The base program is validated and
+    // scheduled once; each override then runs as its own job (queryable via
+    // status/poll_result) against the shared compiled program. Throws
+    // std::invalid_argument for overrides that do not fit the base program
+    // and QuotaExceeded when the items do not fit the tenant's quota.
+    BatchSubmission submit_batch(
+        JobRequest base,
+        const std::vector<JobOverride>& items,
+        std::size_t max_threads = 0
+    );
+
+    // Submit one parametric program with one job per parameter set; each
+    // set binds the base's symbolic gate parameters (Gate::symbol) on top of
+    // base.parameters. Throws like submit_batch, e.g. for unbound symbols.
+    BatchSubmission submit_sweep(
+        JobRequest base,
+        const std::vector<ParameterSet>& parameter_sets,
+        std::size_t max_threads = 0
+    );
+
+    // Progress counters for a batch submission.
+    BatchStatus batch_status(const std::string& batch_id) const;
+
+    // Results of batch items in completion order, starting at `cursor`
+    // (the number of results the caller has already consumed).
+    std::vector<JobResult> batch_results(
+        const std::string& batch_id,
+        std::size_t cursor = 0
+    ) const;
+
     // Poll for the final result if the job is complete.
     std::optional<JobResult> poll_result(const std::string& job_id) const;
+    // True when poll_result() would return a result, without copying it.
+    bool has_result(const std::string& job_id) const;
+
+    // Subscribe to shots of a job as they finish. At most `capacity` shots
+    // are buffered; beyond that shots only reach the batch histogram (see
+    // ShotBatch::coalesced_shots) and the job never waits for the consumer.
+    // Returns std::nullopt for unknown job IDs.
+    std::optional<ShotSubscription> subscribe(
+        const std::string& job_id,
+        std::size_t capacity = 1024
+    ) const;
+
+    // Measurements of a completed job in a shared-memory segment, created on
+    // first use and kept while the service holds the job. Readers in other
+    // processes map it with SharedResultSegment::open(segment->name()).
+    // Returns nullptr for unknown or unfinished jobs and for results whose
+    // shots do not share one record layout.
+    std::shared_ptr<const SharedResultSegment> result_segment(const std::string& job_id) const;
 
     // Query the current status snapshot for the given job.
     JobStatusSnapshot status(const std::string& job_id) const;
 
+    // Invoked once when the job reaches Completed or Failed, on the thread
+    // that finished it, after poll_result() can see the result; invoked
+    // before on_completion returns when the job has already finished.
+    // Callbacks must be quick and must not throw (e.g. signal an eventfd).
+    using CompletionCallback = std::function<void(const std::string& job_id, JobStatus status)>;
+
+    // Returns false for unknown job IDs.
+    bool on_completion(const std::string& job_id, CompletionCallback callback);
+
+    // Write submissions, starts, finished shot ranges of seeded jobs and
+    // results to `journal`, after restoring the jobs it recovered: finished
+    // jobs become pollable again and unfinished ones are re-queued under
+    // their old IDs, skipping shot ranges already journaled. Call once,
+    // before submitting jobs. Returns the number of re-queued jobs.
+    std::size_t attach_journal(std::shared_ptr<JobJournal> journal);
+
+    // Run shot batches in the coordinator's worker processes instead of on
+    // the scheduler threads, which then only dispatch and merge. Call
+    // before submitting jobs.
+    void set_shard_coordinator(std::shared_ptr<ShardCoordinator> coordinator);
+
+    // Weight and caps of a tenant; applies to batches dispatched from now on.
+    void set_tenant_policy(const std::string& tenant, TenantPolicy policy);
+    TenantStats tenant_stats(const std::string& tenant) const;
+
+    // Share a result cache across all jobs executed by this service. Call
+    // before submitting jobs; the cache itself is thread-safe.
+    void set_result_cache(std::shared_ptr<ResultCache> cache);
+
+    // Hardware counters read while simulating (see perf_counters.hpp). Call
+    // before submitting jobs.
+    void set_counter_scope(CounterScope scope);
+
+    // Service metrics: stage latencies, queue depth, active shots, simulation
+    // throughput, statevector memory and cache lookups. Callers may register
+    // their own instruments in the same registry.
+    MetricsRegistry& metrics() const;
+    const std::shared_ptr<JobMetrics>& job_metrics() const { return metrics_; }
+    // Current metrics in the Prometheus text exposition format.
+    std::string render_metrics() const;
+
   private:
     struct JobEntry {
         JobRequest request;
@@ -86,12 +310,51 @@ class JobService {
         std::shared_ptr<JobProgressReporter> reporter;
         std::atomic<JobStatus> status{JobStatus::Pending};
         mutable std::mutex result_mutex;
+        std::shared_ptr<const SharedResultSegment> segment;  // guarded by result_mutex
+        std::vector<CompletionCallback> callbacks;     // guarded by result_mutex
     };
 
+    struct BatchEntry {
+        std::vector<std::shared_ptr<JobEntry>> items;
+        mutable std::mutex mutex;
+        std::vector<std::shared_ptr<JobEntry>> finished;  // completion order
+        std::string message;
+    };
+
+    // Assigns the next job ID unless `job_id` is given (journal recovery).
+    std::shared_ptr<JobEntry> make_entry(JobRequest job, std::string job_id = {});
+    void start_entry(JobEntry& entry);
+    void store_result(JobEntry& entry, JobResult result);
+    // Make `result` visible, end the shot streams and run the callbacks.
+    void publish_result(JobEntry& entry, JobResult result);
+    void reject_entries(const std::vector<std::shared_ptr<JobEntry>>& entries);
+    // Queue `work` once journal record `journaled` is durable; `done` gets
+    // the rejection, if any, after `entries` were dropped for it.
+    void enqueue_when_durable(
+        std::uint64_t journaled,
+        std::vector<std::shared_ptr<JobEntry>> entries,
+        std::vector<ScheduledJob> work,
+        std::function<void(std::exception_ptr)> done
+    );
+    ScheduledJob schedule_entry(
+        std::shared_ptr<JobEntry> entry,
+        std::size_t max_threads,
+        std::function<PreparedJob(JobEntry&)> prepare,
+        std::function<void(const std::shared_ptr<JobEntry>&)> on_finished = {}
+    );
+
     mutable std::mutex mutex_;
     std::unordered_map<std::string, std::shared_ptr<JobEntry>> jobs_;
+    std::unordered_map<std::string, std::shared_ptr<BatchEntry>> batches_;
     std::atomic<std::uint64_t> id_counter_{0};
+    std::atomic<std::uint64_t> batch_counter_{0};
+    std::shared_ptr<JobMetrics> metrics_;
     JobRunner runner_;
+    std::shared_ptr<JobJournal> journal_;
+    std::shared_ptr<ShardCoordinator> coordinator_;
+    // Last member: its destructor joins the workers before the state they
+    // use goes away.
+    FairShareScheduler scheduler_;
 };
 
 }  // namespace service
@@ -1,6 +1,7 @@
 #include "service/job.hpp"
 #include "service/job_validation.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <optional>
@@ -147,7 +148,7 @@ class ActiveQubitsValidator final : public Validator {
 public:
     void validate(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     ) const override {
         const std::size_t limit = hardware.site_ids.size();
         if (limit == 0) {
@@ -178,7 +179,7 @@ class BlockadeValidator final : public Validator {
 public:
     void validate(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     ) const override {
         const SiteIndexMap index = build_site_index(hardware);
         const std::size_t limit = configuration_limit(hardware);
@@ -238,7 +239,7 @@ class TransportValidator final : public Validator {
 public:
     void validate(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     ) const override {
         if (hardware.transport_edges.empty() && !move_limits_has_data(hardware.move_limits)) {
             return;
@@ -274,8 +275,21 @@ public:
         std::vector<MoveStats> stats(slot_count);
         int total_moves = 0;
 
-        for (const auto& instr : program) {
+        // Other validators check a Repeat body once, which covers every
+        // iteration. Moves accumulate across iterations, so they are only
+        // accepted outside Repeat blocks.
+        std::size_t repeat_end = 0;
+        for (std::size_t idx = 0; idx < program.size(); ++idx) {
+            const Instruction& instr = program[idx];
+            if (instr.op == Op::Repeat) {
+                const auto body_size = std::get<RepeatInstruction>(instr.payload).body_size;
+                repeat_end = std::max(repeat_end, idx + 1 + static_cast<std::size_t>(std::max(0, body_size)));
+                continue;
+            }
             if (instr.op == Op::MoveAtom) {
+                if (idx < repeat_end) {
+                    throw std::invalid_argument("MoveAtom inside a Repeat block is not supported by transport limits");
+                }
                 if (limits.rearrangement_window_ns > 0.0 && seen_main_program) {
                     throw std::invalid_argument("MoveAtom violates rearrangement window constraints");
                 }
@@ -359,7 +373,7 @@ LambdaValidator::LambdaValidator(std::string name, ValidateFn fn)
 
 void LambdaValidator::validate(
     const HardwareConfig& hardware,
-    const std::vector<Instruction>& program
+    const Program& program
 ) const {
     if (fn_) {
         fn_(hardware, program);
@@ -378,7 +392,7 @@ void ValidatorRegistry::register_validator(std::unique_ptr<Validator> validator)
 
 void ValidatorRegistry::run_all_validators(
     const HardwareConfig& hardware,
-    const std::vector<Instruction>& program
+    const Program& program
 ) const {
     for (const auto& validator : validators_) {
         validator->validate(hardware, program);
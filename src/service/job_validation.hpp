@@ -16,7 +16,7 @@ public:
     virtual ~Validator() = default;
     virtual void validate(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     ) const = 0;
     virtual std::string name() const;
 };
@@ -25,13 +25,13 @@ class LambdaValidator final : public Validator {
 public:
     using ValidateFn = std::function<void(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     )>;
 
     LambdaValidator(std::string name, ValidateFn fn);
     void validate(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     ) const override;
     std::string name() const override;
 
@@ -45,7 +45,7 @@ public:
     void register_validator(std::unique_ptr<Validator> validator);
     void run_all_validators(
         const HardwareConfig& hardware,
-        const std::vector<Instruction>& program
+        const Program& program
     ) const;
     std::vector<std::string> validator_names() const;
 
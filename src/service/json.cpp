@@ -0,0 +1,483 @@
+#include "service/json.hpp"
+
+#include <charconv>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace service {
+
+namespace {
+
+constexpr std::size_t kMaxDepth = 128;
+
+class JsonParser {
+  public:
+    explicit JsonParser(std::string_view text) : text_(text) {}
+
+    JsonValue parse_document() {
+        JsonValue value = parse_value(0);
+        skip_whitespace();
+        if (pos_ != text_.size()) {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+  private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("json: " + what + " at offset " + std::to_string(pos_));
+    }
+
+    void skip_whitespace() {
+        while (pos_ < text_.size()) {
+            const char ch = text_[pos_];
+            if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r') {
+                break;
+            }
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) {
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == expected) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char expected) {
+        if (!consume(expected)) {
+            fail(std::string("expected '") + expected + "'");
+        }
+    }
+
+    void expect_literal(std::string_view literal) {
+        if (text_.substr(pos_, literal.size()) != literal) {
+            fail("invalid literal");
+        }
+        pos_ += literal.size();
+    }
+
+    JsonValue parse_value(std::size_t depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        skip_whitespace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+        switch (text_[pos_]) {
+            case '{':
+                return parse_object(depth);
+            case '[':
+                return parse_array(depth);
+            case '"':
+                return JsonValue(parse_string());
+            case 't':
+                expect_literal("true");
+                return JsonValue(true);
+            case 'f':
+                expect_literal("false");
+                return JsonValue(false);
+            case 'n':
+                expect_literal("null");
+                return JsonValue();
+            default:
+                return parse_number();
+        }
+    }
+
+    JsonValue parse_object(std::size_t depth) {
+        ++pos_;
+        JsonValue::Object members;
+        if (consume('}')) {
+            return JsonValue(std::move(members));
+        }
+        do {
+            skip_whitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                fail("expected object key");
+            }
+            std::string key = parse_string();
+            expect(':');
+            members.emplace_back(std::move(key), parse_value(depth + 1));
+        } while (consume(','));
+        expect('}');
+        return JsonValue(std::move(members));
+    }
+
+    JsonValue parse_array(std::size_t depth) {
+        ++pos_;
+        JsonValue::Array items;
+        if (consume(']')) {
+            return JsonValue(std::move(items));
+        }
+        do {
+            items.push_back(parse_value(depth + 1));
+        } while (consume(','));
+        expect(']');
+        return JsonValue(std::move(items));
+    }
+
+    unsigned parse_hex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("truncated unicode escape");
+        }
+        unsigned code = 0;
+        for (int idx = 0; idx < 4; ++idx) {
+            const char ch = text_[pos_++];
+            code <<= 4;
+            if (ch >= '0' && ch <= '9') {
+                code |= static_cast<unsigned>(ch - '0');
+            } else if (ch >= 'a' && ch <= 'f') {
+                code |= static_cast<unsigned>(ch - 'a' + 10);
+            } else if (ch >= 'A' && ch <= 'F') {
+                code |= static_cast<unsigned>(ch - 'A' + 10);
+            } else {
+                fail("invalid unicode escape");
+            }
+        }
+        return code;
+    }
+
+    static void append_utf8(unsigned code, std::string& out) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    std::string parse_string() {
+        ++pos_;  // opening quote
+        std::string out;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            const char ch = text_[pos_++];
+            if (ch == '"') {
+                return out;
+            }
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                fail("control character in string");
+            }
+            if (ch != '\\') {
+                out.push_back(ch);
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                fail("unterminated escape");
+            }
+            const char escape = text_[pos_++];
+            switch (escape) {
+                case '"':
+                case '\\':
+                case '/':
+                    out.push_back(escape);
+                    break;
+                case 'b':
+                    out.push_back('\b');
+                    break;
+                case 'f':
+                    out.push_back('\f');
+                    break;
+                case 'n':
+                    out.push_back('\n');
+                    break;
+                case 'r':
+                    out.push_back('\r');
+                    break;
+                case 't':
+                    out.push_back('\t');
+                    break;
+                case 'u': {
+                    unsigned code = parse_hex4();
+                    if (code >= 0xD800 && code < 0xDC00 &&
+                        text_.substr(pos_, 2) == "\\u") {
+                        pos_ += 2;
+                        const unsigned low = parse_hex4();
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    append_utf8(code, out);
+                    break;
+                }
+                default:
+                    fail("invalid escape");
+            }
+        }
+    }
+
+    JsonValue parse_number() {
+        const std::size_t start = pos_;
+        if (pos_ < text_.size() && text_[pos_] == '-') {
+            ++pos_;
+        }
+        bool digits = false;
+        while (pos_ < text_.size()) {
+            const char ch = text_[pos_];
+            if ((ch >= '0' && ch <= '9') || ch == '.' || ch == 'e' || ch == 'E' ||
+                ch == '+' || ch == '-') {
+                digits = digits || (ch >= '0' && ch <= '9');
+                ++pos_;
+            } else {
+                break;
+            }
+        }
+        if (!digits) {
+            pos_ = start;
+            fail("unexpected character");
+        }
+        JsonValue::Number number;
+        number.text = std::string(text_.substr(start, pos_ - start));
+        char* end = nullptr;
+        number.value = std::strtod(number.text.c_str(), &end);
+        if (end != number.text.c_str() + number.text.size()) {
+            pos_ = start;
+            fail("invalid number");
+        }
+        return JsonValue(std::move(number));
+    }
+
+    std::string_view text_;
+    std::size_t pos_ = 0;
+};
+
+[[noreturn]] void type_error(const char* expected) {
+    throw std::runtime_error(std::string("json: expected ") + expected);
+}
+
+}  // namespace
+
+bool JsonValue::as_bool() const {
+    if (const auto* value = std::get_if<bool>(&value_)) {
+        return *value;
+    }
+    type_error("boolean");
+}
+
+double JsonValue::as_double() const {
+    if (const auto* value = std::get_if<Number>(&value_)) {
+        return value->value;
+    }
+    type_error("number");
+}
+
+int JsonValue::as_int() const {
+    const double value = as_double();
+    if (value != std::floor(value) || value < std::numeric_limits<int>::min() ||
+        value > std::numeric_limits<int>::max()) {
+        type_error("integer");
+    }
+    return static_cast<int>(value);
+}
+
+std::uint64_t JsonValue::as_uint64() const {
+    const auto* value = std::get_if<Number>(&value_);
+    if (!value) {
+        type_error("number");
+    }
+    errno = 0;
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(value->text.c_str(), &end, 10);
+    if (errno != 0 || value->text.empty() || value->text[0] == '-' ||
+        end != value->text.c_str() + value->text.size()) {
+        type_error("unsigned 64-bit integer");
+    }
+    return static_cast<std::uint64_t>(parsed);
+}
+
+const std::string& JsonValue::as_string() const {
+    if (const auto* value = std::get_if<std::string>(&value_)) {
+        return *value;
+    }
+    type_error("string");
+}
+
+const JsonValue::Array& JsonValue::as_array() const {
+    if (const auto* value = std::get_if<Array>(&value_)) {
+        return *value;
+    }
+    type_error("array");
+}
+
+const JsonValue::Object& JsonValue::as_object() const {
+    if (const auto* value = std::get_if<Object>(&value_)) {
+        return *value;
+    }
+    type_error("object");
+}
+
+const JsonValue* JsonValue::find(std::string_view key) const {
+    const auto* members = std::get_if<Object>(&value_);
+    if (!members) {
+        return nullptr;
+    }
+    for (const auto& [name, value] : *members) {
+        if (name == key) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+const JsonValue* JsonValue::find_non_null(std::string_view key) const {
+    const JsonValue* value = find(key);
+    return (value && !value->is_null()) ? value : nullptr;
+}
+
+JsonValue parse_json(std::string_view text) {
+    return JsonParser(text).parse_document();
+}
+
+std::string escape_json(const std::string& str) {
+    std::string out;
+    out.reserve(str.size() + 2);
+    for (const char ch : str) {
+        switch (ch) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(ch));
+                    out += buffer;
+                } else {
+                    out.push_back(ch);
+                }
+        }
+    }
+    return out;
+}
+
+void JsonWriter::flush() {
+    if (sink_ && !out_.empty()) {
+        sink_(out_);
+        out_.clear();
+    }
+}
+
+void JsonWriter::separator() {
+    if (sink_ && out_.size() >= chunk_bytes_) {
+        flush();
+    }
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!first_.empty()) {
+        if (!first_.back()) {
+            out_.push_back(',');
+        }
+        first_.back() = false;
+    }
+}
+
+JsonWriter& JsonWriter::begin_object() {
+    separator();
+    out_.push_back('{');
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::end_object() {
+    out_.push_back('}');
+    first_.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::begin_array() {
+    separator();
+    out_.push_back('[');
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::end_array() {
+    out_.push_back(']');
+    first_.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separator();
+    out_.push_back('"');
+    out_ += escape_json(std::string(name));
+    out_ += "\":";
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separator();
+    out_.push_back('"');
+    out_ += escape_json(std::string(text));
+    out_.push_back('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    separator();
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out_.append(buffer, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long number) {
+    separator();
+    out_ += std::to_string(number);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long long number) {
+    separator();
+    out_ += std::to_string(number);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separator();
+    out_ += flag ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separator();
+    out_ += "null";
+    return *this;
+}
+
+}  // namespace service
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace service {
+
+// Minimal JSON document model used by the native job server to read
+// request bodies. Numbers keep their source text so 64-bit seeds survive
+// parsing without a round trip through double.
+class JsonValue {
+  public:
+    struct Number {
+        double value = 0.0;
+        std::string text;
+    };
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+    explicit JsonValue(bool value) : value_(value) {}
+    explicit JsonValue(Number value) : value_(std::move(value)) {}
+    explicit JsonValue(std::string value) : value_(std::move(value)) {}
+    explicit JsonValue(Array value) : value_(std::move(value)) {}
+    explicit JsonValue(Object value) : value_(std::move(value)) {}
+
+    bool is_null() const { return std::holds_alternative<std::monostate>(value_); }
+    bool is_bool() const { return std::holds_alternative<bool>(value_); }
+    bool is_number() const { return std::holds_alternative<Number>(value_); }
+    bool is_string() const { return std::holds_alternative<std::string>(value_); }
+    bool is_array() const { return std::holds_alternative<Array>(value_); }
+    bool is_object() const { return std::holds_alternative<Object>(value_); }
+
+    // Typed accessors throw std::runtime_error on a type mismatch.
+    bool as_bool() const;
+    double as_double() const;
+    int as_int() const;
+    std::uint64_t as_uint64() const;
+    const std::string& as_string() const;
+    const Array& as_array() const;
+    const Object& as_object() const;
+
+    // Object member lookup; nullptr when absent or when this is not an object.
+    const JsonValue* find(std::string_view key) const;
+    // Like find() but treats an explicit null as absent.
+    const JsonValue* find_non_null(std::string_view key) const;
+
+  private:
+    std::variant<std::monostate, bool, Number, std::string, Array, Object> value_;
+};
+
+// Parse a complete JSON document. Throws std::runtime_error with the byte
+// offset of the first syntax error.
+JsonValue parse_json(std::string_view text);
+
+// Escape a string for embedding between double quotes in JSON output.
+std::string escape_json(const std::string& str);
+
+// Streaming JSON builder that tracks separators. Doubles are written in
+// shortest round-trip form; non-finite values become null.
+class JsonWriter {
+  public:
+    using Sink = std::function<void(std::string_view)>;
+
+    JsonWriter() = default;
+    // Hand the output to `sink` in pieces of about `chunk_bytes` as it is
+    // built; call flush() after the last value. str()/take() then only hold
+    // output that has not been flushed yet.
+    JsonWriter(Sink sink, std::size_t chunk_bytes) : sink_(std::move(sink)), chunk_bytes_(chunk_bytes) {}
+
+    JsonWriter& begin_object();
+    JsonWriter& end_object();
+    JsonWriter& begin_array();
+    JsonWriter& end_array();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(double number);
+    JsonWriter& value(int number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(long long number);
+    JsonWriter& value(unsigned long long number);
+    JsonWriter& value(unsigned long number) { return value(static_cast<unsigned long long>(number)); }
+    JsonWriter& value(long number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(unsigned number) { return value(static_cast<unsigned long long>(number)); }
+    JsonWriter& value(bool flag);
+    JsonWriter& null();
+
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& content) {
+        key(name);
+        return value(content);
+    }
+
+    template <typename T>
+    JsonWriter& array(const std::vector<T>& items) {
+        begin_array();
+        for (const auto& item : items) {
+            value(item);
+        }
+        return end_array();
+    }
+
+    const std::string& str() const { return out_; }
+    std::string take() { return std::move(out_); }
+    void flush();
+
+  private:
+    void separator();
+
+    Sink sink_;
+    std::size_t chunk_bytes_ = 0;
+    std::string out_;
+    std::vector<bool> first_;
+    bool after_key_ = false;
+};
+
+}  // namespace service
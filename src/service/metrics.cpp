@@ -0,0 +1,228 @@
+#include "service/metrics.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace service {
+
+namespace {
+
+std::string format_double(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    char buffer[32];
+    const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    return std::string(buffer, end);
+}
+
+// Label values escape backslash, double quote and newline.
+std::string render_labels(const MetricLabels& labels) {
+    std::string out;
+    for (const auto& [name, value] : labels) {
+        if (!out.empty()) {
+            out += ',';
+        }
+        out += name;
+        out += "=\"";
+        for (char ch : value) {
+            if (ch == '\\' || ch == '"') {
+                out += '\\';
+                out += ch;
+            } else if (ch == '\n') {
+                out += "\\n";
+            } else {
+                out += ch;
+            }
+        }
+        out += '"';
+    }
+    return out;
+}
+
+void append_sample(
+    std::string& out,
+    const std::string& name,
+    const std::string& labels,
+    const std::string& value
+) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+constexpr const char* kStageHelp = "Latency of job pipeline stages in seconds.";
+
+}  // namespace
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+    std::sort(bounds_.begin(), bounds_.end());
+    bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+    for (auto& shard : shards_) {
+        shard.buckets = std::make_unique<std::atomic<std::uint64_t>[]>(bounds_.size() + 1);
+    }
+}
+
+void Histogram::observe(double value) {
+    const std::size_t bucket = static_cast<std::size_t>(
+        std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin());
+    Shard& shard = shards_[ShardedCounter::shard_index() % kShards];
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot out;
+    out.bounds = bounds_;
+    out.buckets.assign(bounds_.size() + 1, 0);
+    for (const auto& shard : shards_) {
+        for (std::size_t idx = 0; idx <= bounds_.size(); ++idx) {
+            out.buckets[idx] += shard.buckets[idx].load(std::memory_order_relaxed);
+        }
+        out.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    for (const auto count : out.buckets) {
+        out.count += count;
+    }
+    return out;
+}
+
+std::vector<double> Histogram::latency_bounds() {
+    return {5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2,
+            0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0};
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(
+    const std::string& name,
+    const std::string& help,
+    Kind kind,
+    const MetricLabels& labels
+) {
+    const std::string rendered = render_labels(labels);
+    auto [it, inserted] = families_.try_emplace(name, Family{kind, help, {}});
+    Family& family = it->second;
+    if (!inserted && family.kind != kind) {
+        throw std::invalid_argument("metric " + name + " is already registered with another type");
+    }
+    for (auto& entry : family.series) {
+        if (entry.labels == rendered) {
+            return entry;
+        }
+    }
+    family.series.push_back(Series{rendered, nullptr, nullptr, nullptr});
+    return family.series.back();
+}
+
+Counter& MetricsRegistry::counter(
+    const std::string& name,
+    const std::string& help,
+    const MetricLabels& labels
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Kind::Counter, labels);
+    if (!entry.counter) {
+        entry.counter = std::make_unique<Counter>();
+    }
+    return *entry.counter;
+}
+
+Gauge& MetricsRegistry::gauge(
+    const std::string& name,
+    const std::string& help,
+    const MetricLabels& labels
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Kind::Gauge, labels);
+    if (!entry.gauge) {
+        entry.gauge = std::make_unique<Gauge>();
+    }
+    return *entry.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(
+    const std::string& name,
+    const std::string& help,
+    const MetricLabels& labels,
+    std::vector<double> bounds
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Kind::Histogram, labels);
+    if (!entry.histogram) {
+        entry.histogram = std::make_unique<Histogram>(std::move(bounds));
+    }
+    return *entry.histogram;
+}
+
+std::string MetricsRegistry::render_prometheus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    for (const auto& [name, family] : families_) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        const char* type = family.kind == Kind::Counter ? "counter"
+            : family.kind == Kind::Gauge ? "gauge" : "histogram";
+        out += "# TYPE " + name + " " + type + "\n";
+        for (const auto& entry : family.series) {
+            switch (family.kind) {
+                case Kind::Counter:
+                    append_sample(out, name, entry.labels, std::to_string(entry.counter->value()));
+                    break;
+                case Kind::Gauge:
+                    append_sample(out, name, entry.labels, std::to_string(entry.gauge->value()));
+                    break;
+                case Kind::Histogram: {
+                    const auto snap = entry.histogram->snapshot();
+                    const std::string prefix = entry.labels.empty() ? "" : entry.labels + ",";
+                    std::uint64_t cumulative = 0;
+                    for (std::size_t idx = 0; idx <= snap.bounds.size(); ++idx) {
+                        cumulative += snap.buckets[idx];
+                        const std::string le = idx < snap.bounds.size()
+                            ? format_double(snap.bounds[idx]) : "+Inf";
+                        append_sample(out, name + "_bucket", prefix + "le=\"" + le + "\"",
+                            std::to_string(cumulative));
+                    }
+                    append_sample(out, name + "_sum", entry.labels, format_double(snap.sum));
+                    append_sample(out, name + "_count", entry.labels, std::to_string(snap.count));
+                    break;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+JobMetrics::JobMetrics(std::shared_ptr<MetricsRegistry> registry_in)
+    : registry(std::move(registry_in)),
+      validate_seconds(registry->histogram("na_vm_job_stage_seconds", kStageHelp, {{"stage", "validate"}})),
+      schedule_seconds(registry->histogram("na_vm_job_stage_seconds", kStageHelp, {{"stage", "schedule"}})),
+      simulate_seconds(registry->histogram("na_vm_job_stage_seconds", kStageHelp, {{"stage", "simulate"}})),
+      serialize_seconds(registry->histogram("na_vm_job_stage_seconds", kStageHelp, {{"stage", "serialize"}})),
+      job_seconds(registry->histogram("na_vm_job_seconds", "End-to-end job latency in seconds.")),
+      queued_jobs(registry->gauge("na_vm_jobs_queued", "Jobs submitted but not yet started.")),
+      running_jobs(registry->gauge("na_vm_jobs_running", "Jobs currently executing.")),
+      active_shots(registry->gauge("na_vm_active_shots", "Shots of jobs currently simulating.")),
+      statevector_bytes(registry->gauge(
+          "na_vm_statevector_bytes", "Bytes of statevector storage held by running simulations.")),
+      completed_jobs(registry->counter("na_vm_jobs_total", "Finished jobs by outcome.", {{"status", "completed"}})),
+      failed_jobs(registry->counter("na_vm_jobs_total", "Finished jobs by outcome.", {{"status", "failed"}})),
+      rejected_jobs(registry->counter("na_vm_jobs_total", "Finished jobs by outcome.", {{"status", "rejected"}})),
+      shots(registry->counter("na_vm_shots_total", "Shots simulated.")),
+      gates(registry->counter("na_vm_gates_total", "Gate applications across all shots.")),
+      amplitude_updates(registry->counter(
+          "na_vm_amplitude_updates_total", "Statevector amplitudes updated by gate applications.")),
+      cache_hits(registry->counter(
+          "na_vm_result_cache_lookups_total", "Result cache lookups by outcome.", {{"result", "hit"}})),
+      cache_misses(registry->counter(
+          "na_vm_result_cache_lookups_total", "Result cache lookups by outcome.", {{"result", "miss"}})) {}
+
+}  // namespace service
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "service/sharded_counter.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace service {
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Monotonic count. Updates go to the calling thread's shard.
+class Counter {
+  public:
+    void add(std::uint64_t delta = 1) { value_.add(static_cast<std::size_t>(delta)); }
+    std::uint64_t value() const { return value_.load(); }
+
+  private:
+    ShardedCounter value_;
+};
+
+// Instantaneous level such as a queue depth.
+class Gauge {
+  public:
+    void add(std::int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    void set(std::int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    std::int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+// Fixed-bucket distribution. Each thread records into its own padded shard;
+// snapshots merge the shards and are eventually consistent with in-flight
+// observations.
+class Histogram {
+  public:
+    struct Snapshot {
+        std::vector<double> bounds;           // upper bounds, ascending
+        std::vector<std::uint64_t> buckets;   // per bucket, last is +Inf
+        std::uint64_t count = 0;
+        double sum = 0.0;
+    };
+
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+    Snapshot snapshot() const;
+
+    // Default bounds for latencies in seconds: 50us .. 60s.
+    static std::vector<double> latency_bounds();
+
+  private:
+    static constexpr std::size_t kShards = 16;
+
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<std::uint64_t>[]> buckets;
+        std::atomic<double> sum{0.0};
+    };
+
+    std::vector<double> bounds_;
+    std::array<Shard, kShards> shards_;
+};
+
+// Records the time from construction to destruction into a histogram.
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(Histogram* histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        if (histogram_) {
+            histogram_->observe(std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start_).count());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    Histogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Named metric families rendered in the Prometheus text exposition format.
+// Registration takes a lock and returns a reference that stays valid for the
+// registry's lifetime, so hot paths look metrics up once and then update
+// them without locking.
+class MetricsRegistry {
+  public:
+    // Return the metric with this name and label set, creating it on first
+    // use. Throws std::invalid_argument if `name` is already registered with
+    // a different type.
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Histogram& histogram(
+        const std::string& name,
+        const std::string& help,
+        const MetricLabels& labels = {},
+        std::vector<double> bounds = Histogram::latency_bounds()
+    );
+
+    std::string render_prometheus() const;
+
+  private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Series {
+        std::string labels;  // rendered `a="x",b="y"`, empty when unlabelled
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        Kind kind;
+        std::string help;
+        std::vector<Series> series;
+    };
+
+    Series& series(const std::string& name, const std::string& help, Kind kind, const MetricLabels& labels);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+// The service's standard instruments, registered once per registry.
+struct JobMetrics {
+    explicit JobMetrics(std::shared_ptr<MetricsRegistry> registry);
+
+    std::shared_ptr<MetricsRegistry> registry;
+
+    // Per-stage latency: validate, schedule, simulate, serialize.
+    Histogram& validate_seconds;
+    Histogram& schedule_seconds;
+    Histogram& simulate_seconds;
+    Histogram& serialize_seconds;
+    Histogram& job_seconds;
+
+    Gauge& queued_jobs;
+    Gauge& running_jobs;
+    Gauge& active_shots;
+    Gauge& statevector_bytes;
+
+    Counter& completed_jobs;
+    Counter& failed_jobs;
+    Counter& rejected_jobs;
+    Counter& shots;
+    Counter& gates;
+    Counter& amplitude_updates;
+    Counter& cache_hits;
+    Counter& cache_misses;
+};
+
+}  // namespace service
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace service {
+
+// Fixed-capacity multi-producer ring that keeps the most recent `Capacity`
+// entries. Producers never take a lock: each claims a position with one
+// fetch_add and publishes the slot with a per-slot turn counter. Readers
+// copy slots optimistically and drop any slot a producer touched meanwhile,
+// so reads never stall writers. T must be trivially copyable.
+template <typename T, std::size_t Capacity>
+class MpscRingBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "ring entries are copied optimistically");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "capacity must be a power of two");
+
+  public:
+    void push(const T& value) {
+        const std::uint64_t pos = head_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots_[pos & (Capacity - 1)];
+        const std::uint64_t lap = pos / Capacity;
+        // Only waits if the writer one full lap behind is still copying into
+        // this slot, which needs Capacity writes to overtake a stalled one.
+        while (slot.turn.load(std::memory_order_acquire) != 2 * lap) {
+            std::this_thread::yield();
+        }
+        slot.turn.store(2 * lap + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value = value;
+        slot.turn.store(2 * lap + 2, std::memory_order_release);
+    }
+
+    // Up to `max_entries` of the newest published entries, oldest first.
+    std::vector<T> snapshot(std::size_t max_entries = Capacity) const {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        const std::uint64_t span = std::min<std::uint64_t>(
+            head, std::min<std::uint64_t>(max_entries, Capacity));
+        std::vector<T> out;
+        out.reserve(static_cast<std::size_t>(span));
+        for (std::uint64_t pos = head - span; pos < head; ++pos) {
+            const Slot& slot = slots_[pos & (Capacity - 1)];
+            const std::uint64_t published = 2 * (pos / Capacity) + 2;
+            if (slot.turn.load(std::memory_order_acquire) != published) {
+                continue;
+            }
+            T copy = slot.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.turn.load(std::memory_order_relaxed) == published) {
+                out.push_back(copy);
+            }
+        }
+        return out;
+    }
+
+    std::uint64_t total_pushed() const {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> turn{0};
+        T value{};
+    };
+
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    std::array<Slot, Capacity> slots_{};
+};
+
+}  // namespace service
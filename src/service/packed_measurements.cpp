@@ -0,0 +1,101 @@
+#include "service/packed_measurements.hpp"
+
+#include <utility>
+
+namespace service {
+
+namespace {
+
+constexpr std::size_t kWordBits = 64;
+
+std::size_t words_for(std::size_t bits) {
+    return (bits + kWordBits - 1) / kWordBits;
+}
+
+void set_bit(std::vector<std::uint64_t>& plane, std::size_t index) {
+    plane[index / kWordBits] |= std::uint64_t{1} << (index % kWordBits);
+}
+
+bool test_bit(std::span<const std::uint64_t> plane, std::size_t index) {
+    return (plane[index / kWordBits] >> (index % kWordBits)) & 1u;
+}
+
+}  // namespace
+
+std::optional<PackedMeasurements> pack_measurements(
+    const std::vector<MeasurementRecord>& records,
+    std::size_t shots
+) {
+    if (shots == 0 || records.size() % shots != 0) {
+        return std::nullopt;
+    }
+    PackedMeasurements packed;
+    packed.shots = shots;
+    const std::size_t per_shot = records.size() / shots;
+    packed.layout.reserve(per_shot);
+    for (std::size_t idx = 0; idx < per_shot; ++idx) {
+        if (records[idx].bits.size() != records[idx].targets.size()) {
+            return std::nullopt;
+        }
+        packed.layout.push_back(records[idx].targets);
+        packed.bits_per_shot += records[idx].targets.size();
+    }
+
+    const std::size_t total_bits = packed.bits_per_shot * shots;
+    packed.values.assign(words_for(total_bits), 0);
+    std::size_t bit = 0;
+    for (std::size_t idx = 0; idx < records.size(); ++idx) {
+        const MeasurementRecord& record = records[idx];
+        if (record.targets != packed.layout[idx % per_shot] ||
+            record.bits.size() != record.targets.size()) {
+            return std::nullopt;
+        }
+        for (int value : record.bits) {
+            if (value == 1) {
+                set_bit(packed.values, bit);
+            } else if (value == -1) {
+                if (packed.lost.empty()) {
+                    packed.lost.assign(packed.values.size(), 0);
+                }
+                set_bit(packed.lost, bit);
+            } else if (value != 0) {
+                return std::nullopt;
+            }
+            ++bit;
+        }
+    }
+    return packed;
+}
+
+std::vector<MeasurementRecord> unpack_measurements(const PackedMeasurements& packed) {
+    return unpack_measurements(packed.shots, packed.layout, packed.values, packed.lost);
+}
+
+std::vector<MeasurementRecord> unpack_measurements(
+    std::size_t shots,
+    const std::vector<std::vector<int>>& layout,
+    std::span<const std::uint64_t> values,
+    std::span<const std::uint64_t> lost
+) {
+    std::vector<MeasurementRecord> records;
+    records.reserve(shots * layout.size());
+    std::size_t bit = 0;
+    for (std::size_t shot = 0; shot < shots; ++shot) {
+        for (const auto& targets : layout) {
+            MeasurementRecord record;
+            record.targets = targets;
+            record.bits.reserve(targets.size());
+            for (std::size_t idx = 0; idx < targets.size(); ++idx, ++bit) {
+                if (!lost.empty() && test_bit(lost, bit)) {
+                    record.bits.push_back(-1);
+                } else {
+                    record.bits.push_back(test_bit(values, bit) ? 1 : 0);
+                }
+            }
+            records.push_back(std::move(record));
+        }
+    }
+    return records;
+}
+
+}  // namespace service
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vm/measurement_record.types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace service {
+
+// Measurements of consecutive shots that share one record layout, stored as
+// bit planes: bit `shot * bits_per_shot + k` holds the k-th measured bit of
+// the shot, in record order. A lost atom (bit -1) sets the same bit in
+// `lost`, which stays empty when no atom was lost. Compared with
+// MeasurementRecord vectors this is about 64x smaller and has no per-shot
+// allocations, so ranges can be shipped between processes cheaply.
+struct PackedMeasurements {
+    std::size_t shots = 0;
+    // Targets of each record of one shot.
+    std::vector<std::vector<int>> layout;
+    std::size_t bits_per_shot = 0;
+    std::vector<std::uint64_t> values;
+    std::vector<std::uint64_t> lost;
+
+    // Records produced by one shot.
+    std::size_t records_per_shot() const { return layout.size(); }
+};
+
+// Pack the concatenated records of `shots` shots. Returns std::nullopt when
+// the shots do not share one layout (e.g. records of different lengths).
+std::optional<PackedMeasurements> pack_measurements(
+    const std::vector<MeasurementRecord>& records,
+    std::size_t shots
+);
+
+std::vector<MeasurementRecord> unpack_measurements(const PackedMeasurements& packed);
+// Same, reading bit planes that live elsewhere (e.g. a shared-memory
+// segment). `lost` may be empty.
+std::vector<MeasurementRecord> unpack_measurements(
+    std::size_t shots,
+    const std::vector<std::vector<int>>& layout,
+    std::span<const std::uint64_t> values,
+    std::span<const std::uint64_t> lost
+);
+
+}  // namespace service
@@ -0,0 +1,242 @@
+#include "service/packed_program.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace service {
+
+namespace {
+
+constexpr std::uint32_t kPackedProgramMagic = 0x4e415250U;  // "NARP"
+constexpr std::uint32_t kPackedProgramVersion = 1;
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error("packed program: " + what);
+}
+
+template <typename T>
+void append(std::string& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "append requires POD values");
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+class Reader {
+  public:
+    explicit Reader(std::string_view bytes) : bytes_(bytes) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    // Element count of an array of `element_size` byte entries that follows.
+    std::size_t get_count(std::size_t element_size) {
+        const auto count = get<std::uint64_t>();
+        if (count > (bytes_.size() - offset_) / element_size) {
+            fail("truncated input");
+        }
+        return static_cast<std::size_t>(count);
+    }
+
+    template <typename T>
+    void get_array(std::vector<T>& out) {
+        out.resize(get_count(sizeof(T)));
+        if (!out.empty()) {
+            std::memcpy(out.data(), take(out.size() * sizeof(T)), out.size() * sizeof(T));
+        }
+    }
+
+    std::string get_string() {
+        const std::size_t size = get_count(1);
+        return std::string(take(size), size);
+    }
+
+    bool exhausted() const { return offset_ == bytes_.size(); }
+
+  private:
+    const char* take(std::size_t size) {
+        if (size > bytes_.size() - offset_) {
+            fail("truncated input");
+        }
+        const char* out = bytes_.data() + offset_;
+        offset_ += size;
+        return out;
+    }
+
+    std::string_view bytes_;
+    std::size_t offset_ = 0;
+};
+
+}  // namespace
+
+PackedProgram pack_program(const Program& program) {
+    PackedProgram packed;
+    packed.instructions.reserve(program.size());
+    std::unordered_map<std::uint16_t, std::uint16_t> gate_index;  // GateName id -> table index
+    auto push_targets = [&packed](PackedInstruction& row, std::span<const int> targets) {
+        row.target_count = static_cast<std::uint32_t>(targets.size());
+        packed.targets.insert(packed.targets.end(), targets.begin(), targets.end());
+    };
+    for (const auto& instr : program) {
+        PackedInstruction row;
+        row.op = static_cast<std::uint8_t>(instr.op);
+        switch (instr.op) {
+            case Op::AllocArray:
+                push_targets(row, {&std::get<int>(instr.payload), 1});
+                break;
+            case Op::ApplyGate: {
+                const auto& gate = std::get<Gate>(instr.payload);
+                if (!gate.symbol.empty()) {
+                    fail("gate parameter '" + gate.symbol + "' is symbolic; bind it before packing");
+                }
+                auto [it, inserted] = gate_index.try_emplace(gate.name.id(), static_cast<std::uint16_t>(packed.gates.size()));
+                if (inserted) {
+                    if (packed.gates.size() > std::numeric_limits<std::uint16_t>::max()) {
+                        fail("more than 65536 distinct gate names");
+                    }
+                    packed.gates.push_back(gate.name.str());
+                }
+                row.gate = it->second;
+                row.value0 = gate.param;
+                push_targets(row, gate.targets);
+                break;
+            }
+            case Op::Measure:
+                push_targets(row, program.targets(instr));
+                break;
+            case Op::MoveAtom: {
+                const auto& move = std::get<MoveAtomInstruction>(instr.payload);
+                row.value0 = move.position;
+                push_targets(row, {&move.atom, 1});
+                break;
+            }
+            case Op::Wait:
+                row.value0 = std::get<WaitInstruction>(instr.payload).duration;
+                break;
+            case Op::Pulse: {
+                const auto& pulse = std::get<PulseInstruction>(instr.payload);
+                row.value0 = pulse.detuning;
+                row.value1 = pulse.duration;
+                push_targets(row, {&pulse.target, 1});
+                break;
+            }
+            case Op::Repeat: {
+                const auto& repeat = std::get<RepeatInstruction>(instr.payload);
+                const int operands[] = {repeat.count, repeat.body_size};
+                push_targets(row, operands);
+                break;
+            }
+        }
+        packed.instructions.push_back(row);
+    }
+    return packed;
+}
+
+Program unpack_program(const PackedProgramView& packed) {
+    Program program;
+    program.reserve(packed.instructions.size());
+    std::size_t cursor = 0;
+    for (std::size_t idx = 0; idx < packed.instructions.size(); ++idx) {
+        const PackedInstruction& row = packed.instructions[idx];
+        if (row.target_count > packed.targets.size() - cursor) {
+            fail("instruction " + std::to_string(idx) + " reads past the targets buffer");
+        }
+        const auto operands = packed.targets.subspan(cursor, row.target_count);
+        cursor += row.target_count;
+        auto expect_operands = [&](std::size_t count) {
+            if (operands.size() != count) {
+                fail("instruction " + std::to_string(idx) + " expects " + std::to_string(count) +
+                     " operand(s), got " + std::to_string(operands.size()));
+            }
+        };
+        switch (static_cast<Op>(row.op)) {
+            case Op::AllocArray:
+                expect_operands(1);
+                program.push_back({Op::AllocArray, static_cast<int>(operands[0])});
+                break;
+            case Op::ApplyGate:
+                if (row.gate >= packed.gates.size()) {
+                    fail("instruction " + std::to_string(idx) + " uses unknown gate index " +
+                         std::to_string(row.gate));
+                }
+                if (operands.size() > TargetList::kCapacity) {
+                    fail("instruction " + std::to_string(idx) + " applies a gate to " +
+                         std::to_string(operands.size()) + " targets");
+                }
+                program.push_back({Op::ApplyGate,
+                    Gate{packed.gates[row.gate], TargetList(operands.begin(), operands.end()), row.value0}});
+                break;
+            case Op::Measure:
+                program.push_measure(operands);
+                break;
+            case Op::MoveAtom:
+                expect_operands(1);
+                program.push_back({Op::MoveAtom, MoveAtomInstruction{operands[0], row.value0}});
+                break;
+            case Op::Wait:
+                expect_operands(0);
+                program.push_back({Op::Wait, WaitInstruction{row.value0}});
+                break;
+            case Op::Pulse:
+                expect_operands(1);
+                program.push_back({Op::Pulse, PulseInstruction{operands[0], row.value0, row.value1}});
+                break;
+            case Op::Repeat:
+                expect_operands(2);
+                program.push_back({Op::Repeat, RepeatInstruction{operands[0], operands[1]}});
+                break;
+            default:
+                fail("instruction " + std::to_string(idx) + " has invalid opcode " + std::to_string(row.op));
+        }
+    }
+    if (cursor != packed.targets.size()) {
+        fail("targets buffer has " + std::to_string(packed.targets.size() - cursor) + " unused entries");
+    }
+    return program;
+}
+
+std::string encode_packed_program(const PackedProgramView& packed) {
+    std::string out;
+    out.reserve(32 + packed.instructions.size_bytes() + packed.targets.size_bytes());
+    append(out, kPackedProgramMagic);
+    append(out, kPackedProgramVersion);
+    append<std::uint64_t>(out, packed.gates.size());
+    for (const auto& name : packed.gates) {
+        append<std::uint64_t>(out, name.size());
+        out.append(name);
+    }
+    append<std::uint64_t>(out, packed.instructions.size());
+    out.append(reinterpret_cast<const char*>(packed.instructions.data()), packed.instructions.size_bytes());
+    append<std::uint64_t>(out, packed.targets.size());
+    out.append(reinterpret_cast<const char*>(packed.targets.data()), packed.targets.size_bytes());
+    return out;
+}
+
+PackedProgram decode_packed_program(std::string_view bytes) {
+    Reader reader(bytes);
+    if (reader.get<std::uint32_t>() != kPackedProgramMagic) {
+        fail("not an encoded packed program");
+    }
+    const auto version = reader.get<std::uint32_t>();
+    if (version != kPackedProgramVersion) {
+        fail("unsupported version " + std::to_string(version));
+    }
+    PackedProgram packed;
+    packed.gates.resize(reader.get_count(sizeof(std::uint64_t)));
+    for (auto& name : packed.gates) {
+        name = reader.get_string();
+    }
+    reader.get_array(packed.instructions);
+    reader.get_array(packed.targets);
+    if (!reader.exhausted()) {
+        fail("trailing bytes after packed program");
+    }
+    return packed;
+}
+
+}  // namespace service
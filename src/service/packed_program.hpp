@@ -0,0 +1,59 @@
+#pragma once
+
+#include "vm/isa.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace service {
+
+// Columnar program layout for bulk ingestion. Every instruction is one
+// fixed-size PackedInstruction. Its integer operands are the next
+// `target_count` entries of a flat targets buffer: gate and Measure targets,
+// the AllocArray qubit count, the MoveAtom atom, the Pulse target and the
+// Repeat count and body size.
+// ApplyGate names come from a gate table indexed by `gate`. Producers such as
+// NumPy fill the three buffers directly, so a large program crosses the
+// Python binding without one Python object per instruction.
+struct PackedInstruction {
+    std::uint8_t op = 0;  // Op
+    std::uint8_t reserved = 0;
+    std::uint16_t gate = 0;  // gate table index (ApplyGate)
+    std::uint32_t target_count = 0;
+    double value0 = 0.0;  // gate param, MoveAtom position, Wait duration, Pulse detuning
+    double value1 = 0.0;  // Pulse duration
+};
+static_assert(sizeof(PackedInstruction) == 24, "PackedInstruction is a wire layout");
+
+struct PackedProgramView {
+    std::span<const std::string> gates;
+    std::span<const PackedInstruction> instructions;
+    std::span<const std::int32_t> targets;
+};
+
+struct PackedProgram {
+    std::vector<std::string> gates;
+    std::vector<PackedInstruction> instructions;
+    std::vector<std::int32_t> targets;
+
+    PackedProgramView view() const { return {gates, instructions, targets}; }
+};
+
+// Packed rows carry fixed parameters only: throws std::runtime_error for a
+// gate with a symbolic parameter.
+PackedProgram pack_program(const Program& program);
+
+// Throws std::runtime_error on an unknown opcode or gate index, a wrong
+// operand count, or a targets buffer that the instructions do not consume
+// exactly.
+Program unpack_program(const PackedProgramView& packed);
+
+// Binary wire form: header, gate table, instruction array, targets buffer.
+// Decoding throws std::runtime_error on malformed input.
+std::string encode_packed_program(const PackedProgramView& packed);
+PackedProgram decode_packed_program(std::string_view bytes);
+
+}  // namespace service
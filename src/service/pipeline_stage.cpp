@@ -0,0 +1,57 @@
+#include "service/pipeline_stage.hpp"
+
+#include <utility>
+
+namespace service {
+
+PipelineStage::PipelineStage(std::size_t threads) {
+    threads_.reserve(threads);
+    for (std::size_t idx = 0; idx < threads; ++idx) {
+        threads_.emplace_back([this]() { loop(); });
+    }
+}
+
+PipelineStage::~PipelineStage() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void PipelineStage::push(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+std::size_t PipelineStage::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + running_;
+}
+
+void PipelineStage::loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            ++running_;
+        }
+        task();
+        std::lock_guard<std::mutex> lock(mutex_);
+        --running_;
+    }
+}
+
+}  // namespace service
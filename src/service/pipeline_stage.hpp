@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace service {
+
+// One stage of a processing pipeline: a FIFO of tasks served by its own
+// threads, so the stage overlaps with the work of the other stages instead
+// of taking turns with it on a shared pool.
+class PipelineStage {
+  public:
+    explicit PipelineStage(std::size_t threads);
+    // Stops the threads after their current task; queued tasks are dropped.
+    ~PipelineStage();
+
+    PipelineStage(const PipelineStage&) = delete;
+    PipelineStage& operator=(const PipelineStage&) = delete;
+
+    // Tasks must not throw.
+    void push(std::function<void()> task);
+    // Tasks queued or running.
+    std::size_t depth() const;
+
+  private:
+    void loop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    std::size_t running_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace service
@@ -0,0 +1,266 @@
+#include "service/result_cache.hpp"
+
+#include "service/job_codec.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace service {
+
+namespace {
+
+constexpr const char* kCacheFileSuffix = ".naresult";
+
+std::uint64_t fnv1a64(const std::string& text, std::uint64_t basis) {
+    constexpr std::uint64_t kPrime = 0x100000001b3ULL;
+    std::uint64_t hash = basis;
+    for (const char ch : text) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= kPrime;
+    }
+    return hash;
+}
+
+bool influences_execution(const std::string& metadata_key) {
+    // Validator toggles change which constraints are enforced.
+    const std::string suffix = "_validator";
+    return metadata_key.size() >= suffix.size() &&
+        metadata_key.compare(metadata_key.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+std::string canonical_cache_key(
+    const JobRequest& job,
+    const HardwareConfig& compiled_hardware,
+    BackendKind backend
+) {
+    JobRequest normalized;
+    normalized.device_id = job.device_id;
+    normalized.profile = job.profile;
+    normalized.hardware = compiled_hardware;
+    normalized.program = job.program;
+    normalized.shots = std::max(1, job.shots);
+    normalized.isa_version = job.isa_version;
+    normalized.noise_config = job.noise_config;
+    normalized.stim_circuit = job.stim_circuit;
+    normalized.seed = job.seed;
+    normalized.parameters = job.parameters;
+    for (const auto& [key, value] : job.metadata) {
+        if (influences_execution(key)) {
+            normalized.metadata.emplace(key, value);
+        }
+    }
+    const std::string canonical = to_json(normalized) + "|backend=" + backend_name(backend);
+
+    // Two independent 64-bit FNV-1a passes give a 128-bit content address.
+    std::ostringstream digest;
+    digest << std::hex << std::setfill('0')
+           << std::setw(16) << fnv1a64(canonical, 0xcbf29ce484222325ULL)
+           << std::setw(16) << fnv1a64(canonical, 0x84222325cbf29ce4ULL);
+    return digest.str();
+}
+
+ResultCache::ResultCache(ResultCacheOptions options)
+    : options_(std::move(options)) {
+    if (!options_.disk_directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(options_.disk_directory, ec);
+        if (ec) {
+            throw std::runtime_error(
+                "result cache: cannot create directory " + options_.disk_directory +
+                ": " + ec.message());
+        }
+        load_disk_index();
+    }
+}
+
+std::optional<JobResult> ResultCache::lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto mem_it = memory_.find(key);
+    if (mem_it != memory_.end()) {
+        memory_lru_.splice(memory_lru_.begin(), memory_lru_, mem_it->second.lru);
+        ++counters_.memory_hits;
+        return mem_it->second.result;
+    }
+
+    const auto disk_it = disk_.find(key);
+    if (disk_it != disk_.end()) {
+        std::ifstream in(disk_path(key), std::ios::binary);
+        std::string encoded((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        try {
+            if (!in.good() && !in.eof()) {
+                throw std::runtime_error("unreadable cache file");
+            }
+            JobResult result = decode_job_result(encoded);
+            disk_lru_.splice(disk_lru_.begin(), disk_lru_, disk_it->second.lru);
+            ++counters_.disk_hits;
+            insert_memory(key, result, encoded.size());
+            return result;
+        } catch (const std::exception&) {
+            // Corrupt or concurrently removed entry: drop it and treat as a miss.
+            disk_bytes_ -= disk_it->second.bytes;
+            disk_lru_.erase(disk_it->second.lru);
+            disk_.erase(disk_it);
+            std::error_code ec;
+            std::filesystem::remove(disk_path(key), ec);
+        }
+    }
+
+    ++counters_.misses;
+    return std::nullopt;
+}
+
+void ResultCache::store(const std::string& key, const JobResult& result) {
+    const std::string encoded = encode_job_result(result);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++counters_.stores;
+    insert_memory(key, result, encoded.size());
+    if (!options_.disk_directory.empty()) {
+        insert_disk(key, encoded);
+    }
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memory_.clear();
+    memory_lru_.clear();
+    memory_bytes_ = 0;
+    for (const auto& [key, entry] : disk_) {
+        std::error_code ec;
+        std::filesystem::remove(disk_path(key), ec);
+    }
+    disk_.clear();
+    disk_lru_.clear();
+    disk_bytes_ = 0;
+}
+
+ResultCacheStats ResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ResultCacheStats out = counters_;
+    out.memory_entries = memory_.size();
+    out.memory_bytes = memory_bytes_;
+    out.disk_entries = disk_.size();
+    out.disk_bytes = disk_bytes_;
+    return out;
+}
+
+void ResultCache::insert_memory(const std::string& key, JobResult result, std::size_t bytes) {
+    if (bytes > options_.memory_budget_bytes) {
+        return;
+    }
+    const auto existing = memory_.find(key);
+    if (existing != memory_.end()) {
+        memory_bytes_ -= existing->second.bytes;
+        memory_lru_.erase(existing->second.lru);
+        memory_.erase(existing);
+    }
+    memory_lru_.push_front(key);
+    MemoryEntry entry;
+    entry.result = std::move(result);
+    entry.bytes = bytes;
+    entry.lru = memory_lru_.begin();
+    memory_.emplace(key, std::move(entry));
+    memory_bytes_ += bytes;
+    evict_memory();
+}
+
+void ResultCache::insert_disk(const std::string& key, const std::string& encoded) {
+    if (encoded.size() > options_.disk_budget_bytes) {
+        return;
+    }
+    const std::string path = disk_path(key);
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+        if (!out) {
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return;
+    }
+    const auto existing = disk_.find(key);
+    if (existing != disk_.end()) {
+        disk_bytes_ -= existing->second.bytes;
+        disk_lru_.erase(existing->second.lru);
+        disk_.erase(existing);
+    }
+    disk_lru_.push_front(key);
+    disk_.emplace(key, DiskEntry{encoded.size(), disk_lru_.begin()});
+    disk_bytes_ += encoded.size();
+    evict_disk();
+}
+
+void ResultCache::evict_memory() {
+    while (memory_bytes_ > options_.memory_budget_bytes && !memory_lru_.empty()) {
+        const std::string victim = memory_lru_.back();
+        const auto it = memory_.find(victim);
+        memory_bytes_ -= it->second.bytes;
+        memory_.erase(it);
+        memory_lru_.pop_back();
+        ++counters_.evictions;
+    }
+}
+
+void ResultCache::evict_disk() {
+    while (disk_bytes_ > options_.disk_budget_bytes && !disk_lru_.empty()) {
+        const std::string victim = disk_lru_.back();
+        const auto it = disk_.find(victim);
+        disk_bytes_ -= it->second.bytes;
+        disk_.erase(it);
+        disk_lru_.pop_back();
+        std::error_code ec;
+        std::filesystem::remove(disk_path(victim), ec);
+        ++counters_.evictions;
+    }
+}
+
+void ResultCache::load_disk_index() {
+    struct Found {
+        std::string key;
+        std::size_t bytes = 0;
+        std::filesystem::file_time_type mtime;
+    };
+    std::vector<Found> found;
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(options_.disk_directory, ec)) {
+        if (!item.is_regular_file() || item.path().extension() != kCacheFileSuffix) {
+            continue;
+        }
+        Found entry;
+        entry.key = item.path().stem().string();
+        entry.bytes = static_cast<std::size_t>(item.file_size(ec));
+        entry.mtime = item.last_write_time(ec);
+        found.push_back(std::move(entry));
+    }
+    // Oldest files end up at the back of the LRU list.
+    std::sort(found.begin(), found.end(), [](const Found& lhs, const Found& rhs) {
+        return lhs.mtime > rhs.mtime;
+    });
+    for (auto& entry : found) {
+        disk_lru_.push_back(entry.key);
+        disk_.emplace(entry.key, DiskEntry{entry.bytes, std::prev(disk_lru_.end())});
+        disk_bytes_ += entry.bytes;
+    }
+    evict_disk();
+}
+
+std::string ResultCache::disk_path(const std::string& key) const {
+    return (std::filesystem::path(options_.disk_directory) / (key + kCacheFileSuffix)).string();
+}
+
+}  // namespace service
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "hardware_vm.hpp"
+#include "service/job.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace service {
+
+struct ResultCacheOptions {
+    // Byte budget for decoded results kept in memory (0 disables the tier).
+    std::size_t memory_budget_bytes = 64ull * 1024 * 1024;
+    // Directory for the persistent tier; empty keeps the cache memory-only.
+    std::string disk_directory;
+    std::size_t disk_budget_bytes = 1024ull * 1024 * 1024;
+};
+
+struct ResultCacheStats {
+    std::uint64_t memory_hits = 0;
+    std::uint64_t disk_hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t stores = 0;
+    std::uint64_t evictions = 0;
+    std::size_t memory_entries = 0;
+    std::size_t memory_bytes = 0;
+    std::size_t disk_entries = 0;
+    std::size_t disk_bytes = 0;
+};
+
+// Canonical content hash of a normalized request: program, compiled hardware,
+// noise, shots, seed, ISA version and backend. Job IDs, thread counts and
+// metadata that does not influence execution are excluded.
+std::string canonical_cache_key(
+    const JobRequest& job,
+    const HardwareConfig& compiled_hardware,
+    BackendKind backend
+);
+
+// Two-tier (memory + disk) LRU cache of completed JobResults keyed by
+// canonical_cache_key(). All methods are thread-safe.
+class ResultCache {
+  public:
+    explicit ResultCache(ResultCacheOptions options = {});
+
+    std::optional<JobResult> lookup(const std::string& key);
+    void store(const std::string& key, const JobResult& result);
+    void clear();
+
+    ResultCacheStats stats() const;
+    const ResultCacheOptions& options() const { return options_; }
+
+  private:
+    struct MemoryEntry {
+        JobResult result;
+        std::size_t bytes = 0;
+        std::list<std::string>::iterator lru;
+    };
+
+    struct DiskEntry {
+        std::size_t bytes = 0;
+        std::list<std::string>::iterator lru;
+    };
+
+    void insert_memory(const std::string& key, JobResult result, std::size_t bytes);
+    void insert_disk(const std::string& key, const std::string& encoded);
+    void evict_memory();
+    void evict_disk();
+    void load_disk_index();
+    std::string disk_path(const std::string& key) const;
+
+    ResultCacheOptions options_;
+    mutable std::mutex mutex_;
+    std::list<std::string> memory_lru_;
+    std::unordered_map<std::string, MemoryEntry> memory_;
+    std::size_t memory_bytes_ = 0;
+    std::list<std::string> disk_lru_;
+    std::unordered_map<std::string, DiskEntry> disk_;
+    std::size_t disk_bytes_ = 0;
+    ResultCacheStats counters_;
+};
+
+}  // namespace service
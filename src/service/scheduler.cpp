@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <span>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
@@ -20,7 +22,7 @@ const NativeGate* find_native_gate(const HardwareConfig& hw, const Gate& gate) {
     return nullptr;
 }
 
-std::string format_targets(const std::vector<int>& targets) {
+std::string format_targets(std::span<const int> targets) {
     std::ostringstream oss;
     oss << "[";
     for (std::size_t idx = 0; idx < targets.size(); ++idx) {
@@ -36,11 +38,15 @@ std::string format_targets(const std::vector<int>& targets) {
 std::string describe_gate(const Gate& gate) {
     std::ostringstream oss;
     oss << gate.name << " targets=" << format_targets(gate.targets);
-    oss << " param=" << gate.param;
+    if (gate.symbol.empty()) {
+        oss << " param=" << gate.param;
+    } else {
+        oss << " param=" << gate.symbol;
+    }
     return oss.str();
 }
 
-std::string describe_measure(const std::vector<int>& targets) {
+std::string describe_measure(std::span<const int> targets) {
     std::ostringstream oss;
     oss << "targets=" << format_targets(targets);
     return oss.str();
@@ -66,6 +72,10 @@ struct SchedulingState {
     std::vector<double> qubit_ready_time;
     std::vector<int> qubit_zones;
     std::vector<TimelineEntry>* timeline = nullptr;
+    std::vector<std::size_t>* source_indices = nullptr;
+    std::vector<std::size_t>* timeline_source_indices = nullptr;
+    std::vector<TimelineRepeat>* timeline_repeats = nullptr;
+    std::size_t current_source = kInsertedInstruction;
     struct ActiveOp {
         double end_time = 0.0;
         int arity = 1;
@@ -88,6 +98,21 @@ void record_timeline(
         return;
     }
     state.timeline->push_back(TimelineEntry{start_time, duration, op, detail});
+    if (state.timeline_source_indices) {
+        state.timeline_source_indices->push_back(state.current_source);
+    }
+}
+
+void emit_instruction(
+    Program& out,
+    SchedulingState& state,
+    const Instruction& instr,
+    std::size_t source
+) {
+    out.push_back(instr);
+    if (state.source_indices) {
+        state.source_indices->push_back(source);
+    }
 }
 
 void sync_all_qubits_to_time(SchedulingState& state) {
@@ -129,7 +154,7 @@ double next_active_completion(const SchedulingState& state) {
     return next_time;
 }
 
-std::vector<int> zones_for_targets(const SchedulingState& state, const std::vector<int>& targets) {
+std::vector<int> zones_for_targets(const SchedulingState& state, std::span<const int> targets) {
     std::vector<int> zones;
     zones.reserve(targets.size());
     for (int target : targets) {
@@ -242,7 +267,7 @@ double align_with_idle_window(SchedulingState& state, double candidate_start) {
 }
 
 void append_wait_instruction(
-    std::vector<Instruction>& out,
+    Program& out,
     SchedulingState& state,
     double duration,
     const TimingLimits& limits,
@@ -254,6 +279,8 @@ void append_wait_instruction(
     double remaining = duration;
     const double min_wait = limits.min_wait_ns;
     const double max_wait = limits.max_wait_ns;
+    const std::size_t resume_source = state.current_source;
+    state.current_source = kInsertedInstruction;
 
     while (remaining > 0.0) {
         double chunk = remaining;
@@ -272,7 +299,7 @@ void append_wait_instruction(
         payload.duration = chunk;
         wait_instr.payload = payload;
         const double start_time = state.logical_time;
-        out.push_back(wait_instr);
+        emit_instruction(out, state, wait_instr, kInsertedInstruction);
         state.logical_time += chunk;
         sync_all_qubits_to_time(state);
         const std::string detail_with_duration =
@@ -283,10 +310,11 @@ void append_wait_instruction(
             break;
         }
     }
+    state.current_source = resume_source;
 }
 
 void enforce_measurement_cooldown(
-    std::vector<Instruction>& out,
+    Program& out,
     SchedulingState& state,
     const HardwareConfig& hw,
     const Gate& gate
@@ -314,154 +342,435 @@ void enforce_measurement_cooldown(
     }
 }
 
-}  // namespace
-
-SchedulerResult schedule_program(
-    const std::vector<Instruction>& program,
-    const HardwareConfig& hardware_config
+void schedule_instruction(
+    Program& scheduled,
+    SchedulingState& state,
+    const HardwareConfig& hardware_config,
+    const SiteIndexMap& site_lookup,
+    const Instruction& instr,
+    std::size_t source
 ) {
-    SchedulerResult result;
-    std::vector<Instruction>& scheduled = result.program;
-    scheduled.reserve(program.size());
-
-    SchedulingState state;
-    state.timeline = &result.timeline;
-    const SiteIndexMap site_lookup = build_site_index(hardware_config);
-
-    for (const auto& instr : program) {
-        switch (instr.op) {
-            case Op::AllocArray: {
-                scheduled.push_back(instr);
-                const int n = std::get<int>(instr.payload);
-                state.logical_time = 0.0;
-                state.last_measurement_time.assign(
-                    static_cast<std::size_t>(std::max(0, n)),
-                    -std::numeric_limits<double>::infinity()
-                );
-                state.qubit_ready_time.assign(
-                    static_cast<std::size_t>(std::max(0, n)),
-                    0.0
+    state.current_source = source;
+    switch (instr.op) {
+        case Op::AllocArray: {
+            emit_instruction(scheduled, state, instr, source);
+            const int n = std::get<int>(instr.payload);
+            state.logical_time = 0.0;
+            state.last_measurement_time.assign(
+                static_cast<std::size_t>(std::max(0, n)),
+                -std::numeric_limits<double>::infinity()
+            );
+            state.qubit_ready_time.assign(
+                static_cast<std::size_t>(std::max(0, n)),
+                0.0
+            );
+            state.qubit_zones.assign(static_cast<std::size_t>(std::max(0, n)), 0);
+            for (std::size_t idx = 0; idx < state.qubit_zones.size(); ++idx) {
+                state.qubit_zones[idx] = zone_for_slot(
+                    hardware_config, site_lookup, static_cast<int>(idx)
                 );
-                state.qubit_zones.assign(static_cast<std::size_t>(std::max(0, n)), 0);
-                for (std::size_t idx = 0; idx < state.qubit_zones.size(); ++idx) {
-                    state.qubit_zones[idx] = zone_for_slot(
-                        hardware_config, site_lookup, static_cast<int>(idx)
-                    );
-                }
-                state.active_ops.clear();
-                state.active_single_qubit = 0;
-                state.active_multi_qubit = 0;
-                state.active_zone_counts.clear();
-                break;
             }
-            case Op::ApplyGate: {
-                const Gate& gate = std::get<Gate>(instr.payload);
-                enforce_measurement_cooldown(scheduled, state, hardware_config, gate);
-                double duration = 0.0;
-                if (const NativeGate* native = find_native_gate(hardware_config, gate)) {
-                    duration = native->duration_ns;
-                }
-                double start_time = 0.0;
-                for (int target : gate.targets) {
-                    if (target < 0 || target >= static_cast<int>(state.qubit_ready_time.size())) {
-                        continue;
-                    }
-                    start_time = std::max(start_time, state.qubit_ready_time[static_cast<std::size_t>(target)]);
+            state.active_ops.clear();
+            state.active_single_qubit = 0;
+            state.active_multi_qubit = 0;
+            state.active_zone_counts.clear();
+            break;
+        }
+        case Op::ApplyGate: {
+            const Gate& gate = std::get<Gate>(instr.payload);
+            enforce_measurement_cooldown(scheduled, state, hardware_config, gate);
+            double duration = 0.0;
+            if (const NativeGate* native = find_native_gate(hardware_config, gate)) {
+                duration = native->duration_ns;
+            }
+            double start_time = 0.0;
+            for (int target : gate.targets) {
+                if (target < 0 || target >= static_cast<int>(state.qubit_ready_time.size())) {
+                    continue;
                 }
-                const std::vector<int> zones = zones_for_targets(state, gate.targets);
-                start_time = enforce_parallel_limits(
+                start_time = std::max(start_time, state.qubit_ready_time[static_cast<std::size_t>(target)]);
+            }
+            const std::vector<int> zones = zones_for_targets(state, gate.targets);
+            start_time = enforce_parallel_limits(
+                state,
+                hardware_config.timing_limits,
+                static_cast<int>(gate.targets.size()),
+                zones,
+                start_time
+            );
+            if (start_time > state.logical_time) {
+                append_wait_instruction(
+                    scheduled,
                     state,
+                    start_time - state.logical_time,
                     hardware_config.timing_limits,
-                    static_cast<int>(gate.targets.size()),
-                    zones,
-                    start_time
+                    "Inserted for scheduling gap"
                 );
-                if (start_time > state.logical_time) {
-                    append_wait_instruction(
-                        scheduled,
-                        state,
-                        start_time - state.logical_time,
-                        hardware_config.timing_limits,
-                        "Inserted for scheduling gap"
-                    );
-                }
-                scheduled.push_back(instr);
-                const double end_time = start_time + duration;
-                record_timeline(state, start_time, duration, "ApplyGate", describe_gate(gate));
-                if (duration > 0.0) {
-                    track_active_gate(state, static_cast<int>(gate.targets.size()), zones, end_time);
-                }
-                for (int target : gate.targets) {
-                    if (target < 0 || target >= static_cast<int>(state.qubit_ready_time.size())) {
-                        continue;
-                    }
-                    state.qubit_ready_time[static_cast<std::size_t>(target)] = end_time;
+            }
+            emit_instruction(scheduled, state, instr, source);
+            const double end_time = start_time + duration;
+            record_timeline(state, start_time, duration, "ApplyGate", describe_gate(gate));
+            if (duration > 0.0) {
+                track_active_gate(state, static_cast<int>(gate.targets.size()), zones, end_time);
+            }
+            for (int target : gate.targets) {
+                if (target < 0 || target >= static_cast<int>(state.qubit_ready_time.size())) {
+                    continue;
                 }
-                state.logical_time = std::max(state.logical_time, start_time) + duration;
-                break;
+                state.qubit_ready_time[static_cast<std::size_t>(target)] = end_time;
             }
-            case Op::Measure: {
-                const auto& targets = std::get<std::vector<int>>(instr.payload);
-                double start_time = state.logical_time;
-                for (int target : targets) {
-                    if (target < 0 || target >= static_cast<int>(state.qubit_ready_time.size())) {
-                        continue;
-                    }
-                    start_time = std::max(start_time, state.qubit_ready_time[static_cast<std::size_t>(target)]);
+            state.logical_time = std::max(state.logical_time, start_time) + duration;
+            break;
+        }
+        case Op::Measure: {
+            // `scheduled` carries the source program's operand table.
+            const auto targets = scheduled.targets(instr);
+            double start_time = state.logical_time;
+            for (int target : targets) {
+                if (target < 0 || target >= static_cast<int>(state.qubit_ready_time.size())) {
+                    continue;
                 }
-                start_time = align_with_idle_window(state, start_time);
-                if (start_time > state.logical_time) {
-                    append_wait_instruction(
-                        scheduled,
-                        state,
-                        start_time - state.logical_time,
-                        hardware_config.timing_limits,
-                        "Inserted before measurement"
-                    );
+                start_time = std::max(start_time, state.qubit_ready_time[static_cast<std::size_t>(target)]);
+            }
+            start_time = align_with_idle_window(state, start_time);
+            if (start_time > state.logical_time) {
+                append_wait_instruction(
+                    scheduled,
+                    state,
+                    start_time - state.logical_time,
+                    hardware_config.timing_limits,
+                    "Inserted before measurement"
+                );
+            }
+            emit_instruction(scheduled, state, instr, source);
+            const double duration = hardware_config.timing_limits.measurement_duration_ns;
+            state.logical_time = std::max(state.logical_time, start_time) + duration;
+            for (int target : targets) {
+                if (target < 0 || target >= static_cast<int>(state.last_measurement_time.size())) {
+                    continue;
                 }
-                scheduled.push_back(instr);
-                const double duration = hardware_config.timing_limits.measurement_duration_ns;
-                state.logical_time = std::max(state.logical_time, start_time) + duration;
-                for (int target : targets) {
-                    if (target < 0 || target >= static_cast<int>(state.last_measurement_time.size())) {
-                        continue;
-                    }
-                    const std::size_t idx = static_cast<std::size_t>(target);
-                    state.last_measurement_time[idx] = state.logical_time;
-                    if (idx < state.qubit_ready_time.size()) {
-                        state.qubit_ready_time[idx] = state.logical_time;
-                    }
+                const std::size_t idx = static_cast<std::size_t>(target);
+                state.last_measurement_time[idx] = state.logical_time;
+                if (idx < state.qubit_ready_time.size()) {
+                    state.qubit_ready_time[idx] = state.logical_time;
                 }
-                sync_all_qubits_to_time(state);
-                record_timeline(state, start_time, duration, "Measure", describe_measure(targets));
-                break;
-            }
-            case Op::Wait: {
-                scheduled.push_back(instr);
-                const double start_time = state.logical_time;
-                const double duration = std::get<WaitInstruction>(instr.payload).duration;
-                state.logical_time += duration;
-                sync_all_qubits_to_time(state);
-                record_timeline(state, start_time, duration, "Wait", describe_wait(duration));
-                break;
             }
-            case Op::Pulse: {
-                scheduled.push_back(instr);
-                const double start_time = state.logical_time;
-                const auto& pulse = std::get<PulseInstruction>(instr.payload);
-                const double duration = pulse.duration;
-                state.logical_time += duration;
-                sync_all_qubits_to_time(state);
-                record_timeline(state, start_time, duration, "Pulse", describe_pulse(pulse));
-                break;
+            sync_all_qubits_to_time(state);
+            record_timeline(state, start_time, duration, "Measure", describe_measure(targets));
+            break;
+        }
+        case Op::Wait: {
+            emit_instruction(scheduled, state, instr, source);
+            const double start_time = state.logical_time;
+            const double duration = std::get<WaitInstruction>(instr.payload).duration;
+            state.logical_time += duration;
+            sync_all_qubits_to_time(state);
+            record_timeline(state, start_time, duration, "Wait", describe_wait(duration));
+            break;
+        }
+        case Op::Pulse: {
+            emit_instruction(scheduled, state, instr, source);
+            const double start_time = state.logical_time;
+            const auto& pulse = std::get<PulseInstruction>(instr.payload);
+            const double duration = pulse.duration;
+            state.logical_time += duration;
+            sync_all_qubits_to_time(state);
+            record_timeline(state, start_time, duration, "Pulse", describe_pulse(pulse));
+            break;
+        }
+        default:
+            emit_instruction(scheduled, state, instr, source);
+            break;
+    }
+}
+
+void schedule_block(
+    Program& scheduled,
+    SchedulingState& state,
+    const HardwareConfig& hardware_config,
+    const SiteIndexMap& site_lookup,
+    std::span<const Instruction> block,
+    std::size_t offset
+);
+
+// Lines every qubit up with the logical clock before a Repeat iteration
+// starts, so each iteration is scheduled from the same relative state.
+void align_repeat_boundary(
+    Program& scheduled,
+    SchedulingState& state,
+    const HardwareConfig& hardware_config
+) {
+    double start_time = state.logical_time;
+    for (double ready : state.qubit_ready_time) {
+        start_time = std::max(start_time, ready);
+    }
+    start_time = align_with_idle_window(state, start_time);
+    if (start_time > state.logical_time) {
+        append_wait_instruction(
+            scheduled,
+            state,
+            start_time - state.logical_time,
+            hardware_config.timing_limits,
+            "Inserted at repeat boundary"
+        );
+    }
+    sync_all_qubits_to_time(state);
+}
+
+// After align_repeat_boundary() the only state that can make one iteration
+// schedule differently from the next is the measurement cooldown still
+// pending on each qubit.
+std::vector<double> pending_cooldowns(const SchedulingState& state, const HardwareConfig& hardware_config) {
+    const double cooldown = hardware_config.timing_limits.measurement_cooldown_ns;
+    std::vector<double> pending(state.last_measurement_time.size(), 0.0);
+    if (cooldown <= 0.0) {
+        return pending;
+    }
+    for (std::size_t idx = 0; idx < pending.size(); ++idx) {
+        pending[idx] = std::max(0.0, state.last_measurement_time[idx] + cooldown - state.logical_time);
+    }
+    return pending;
+}
+
+bool same_pending_cooldowns(const std::vector<double>& lhs, const std::vector<double>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (std::size_t idx = 0; idx < lhs.size(); ++idx) {
+        if (std::abs(lhs[idx] - rhs[idx]) > 1e-9 * std::max({1.0, std::abs(lhs[idx]), std::abs(rhs[idx])})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Schedules the Repeat at block[index]. Iterations are scheduled one at a
+// time until one ends in the relative state it started from; every later
+// iteration would schedule identically, so that iteration becomes the body
+// of a Repeat covering the remaining count and its timeline entries are kept
+// once, described by a TimelineRepeat. Earlier iterations (usually none)
+// stay inline.
+void schedule_repeat(
+    Program& scheduled,
+    SchedulingState& state,
+    const HardwareConfig& hardware_config,
+    const SiteIndexMap& site_lookup,
+    std::span<const Instruction> block,
+    std::size_t index,
+    std::size_t offset
+) {
+    const auto& repeat = std::get<RepeatInstruction>(block[index].payload);
+    const auto body = repeat_body(block, index);
+    const std::size_t source = offset + index;
+    state.current_source = source;
+    align_repeat_boundary(scheduled, state, hardware_config);
+    std::vector<double> before = pending_cooldowns(state, hardware_config);
+    for (int iteration = 0; iteration < repeat.count; ++iteration) {
+        const std::size_t program_mark = scheduled.size();
+        const std::size_t timeline_mark = state.timeline ? state.timeline->size() : 0;
+        const std::size_t repeat_mark = state.timeline_repeats ? state.timeline_repeats->size() : 0;
+        const double iteration_start = state.logical_time;
+        schedule_block(scheduled, state, hardware_config, site_lookup, body, source + 1);
+        state.current_source = source;
+        align_repeat_boundary(scheduled, state, hardware_config);
+        std::vector<double> after = pending_cooldowns(state, hardware_config);
+        if (!same_pending_cooldowns(before, after)) {
+            before = std::move(after);
+            continue;
+        }
+
+        const int remaining = repeat.count - iteration;
+        const auto body_size = static_cast<int>(scheduled.size() - program_mark);
+        scheduled.insert(
+            scheduled.begin() + static_cast<std::ptrdiff_t>(program_mark),
+            Instruction{Op::Repeat, RepeatInstruction{remaining, body_size}});
+        if (state.source_indices) {
+            state.source_indices->insert(
+                state.source_indices->begin() + static_cast<std::ptrdiff_t>(program_mark), source);
+        }
+        const double period = state.logical_time - iteration_start;
+        const std::size_t timeline_end = state.timeline ? state.timeline->size() : 0;
+        if (state.timeline_repeats && remaining > 1 && timeline_end > timeline_mark) {
+            // Inserted ahead of the descriptors of Repeats nested in this body.
+            state.timeline_repeats->insert(
+                state.timeline_repeats->begin() + static_cast<std::ptrdiff_t>(repeat_mark),
+                TimelineRepeat{timeline_mark, timeline_end - timeline_mark, remaining, period});
+        }
+        const double skipped = period * (remaining - 1);
+        for (double& measured : state.last_measurement_time) {
+            if (measured >= iteration_start) {
+                measured += skipped;
             }
-            default:
-                scheduled.push_back(instr);
-                break;
         }
+        state.logical_time += skipped;
+        sync_all_qubits_to_time(state);
+        return;
+    }
+}
+
+void schedule_block(
+    Program& scheduled,
+    SchedulingState& state,
+    const HardwareConfig& hardware_config,
+    const SiteIndexMap& site_lookup,
+    std::span<const Instruction> block,
+    std::size_t offset
+) {
+    for (std::size_t idx = 0; idx < block.size(); ++idx) {
+        if (block[idx].op == Op::Repeat) {
+            schedule_repeat(scheduled, state, hardware_config, site_lookup, block, idx, offset);
+            idx += static_cast<std::size_t>(std::get<RepeatInstruction>(block[idx].payload).body_size);
+            continue;
+        }
+        schedule_instruction(scheduled, state, hardware_config, site_lookup, block[idx], offset + idx);
     }
+}
+
+}  // namespace
+
+SchedulerResult schedule_program(
+    const Program& program,
+    const HardwareConfig& hardware_config
+) {
+    SchedulerResult result;
+    result.program.reserve(program.size());
+    // Instructions are copied as they are, so wide Measures keep pointing
+    // into the same operand table.
+    result.program.adopt_operands(program);
 
+    SchedulingState state;
+    state.timeline = &result.timeline;
+    state.source_indices = &result.source_indices;
+    state.timeline_source_indices = &result.timeline_source_indices;
+    state.timeline_repeats = &result.timeline_repeats;
+    result.source_indices.reserve(program.size());
+    const SiteIndexMap site_lookup = build_site_index(hardware_config);
+    schedule_block(result.program, state, hardware_config, site_lookup, program, 0);
     return result;
 }
 
+namespace {
+
+// Appends timeline entries [begin, end), shifted by `shift`, expanding the
+// Repeats described from timeline_repeats[repeat] on.
+void expand_timeline_range(
+    const SchedulerResult& scheduled,
+    std::size_t begin,
+    std::size_t end,
+    std::size_t repeat,
+    double shift,
+    const std::vector<const std::string*>& details,
+    std::vector<TimelineEntry>& out
+) {
+    const auto& repeats = scheduled.timeline_repeats;
+    std::size_t idx = begin;
+    while (idx < end) {
+        if (repeat < repeats.size() && repeats[repeat].first == idx) {
+            const TimelineRepeat& block = repeats[repeat];
+            const std::size_t block_end = block.first + block.size;
+            std::size_t next = repeat + 1;
+            while (next < repeats.size() && repeats[next].first < block_end) {
+                ++next;
+            }
+            for (int iteration = 0; iteration < block.count; ++iteration) {
+                expand_timeline_range(scheduled, block.first, block_end, repeat + 1,
+                    shift + block.period * iteration, details, out);
+            }
+            idx = block_end;
+            repeat = next;
+            continue;
+        }
+        TimelineEntry entry = scheduled.timeline[idx];
+        entry.start_time += shift;
+        if (!details.empty() && details[idx] != nullptr) {
+            entry.detail = *details[idx];
+        }
+        out.push_back(std::move(entry));
+        ++idx;
+    }
+}
+
+}  // namespace
+
+std::vector<TimelineEntry> expand_timeline(
+    const SchedulerResult& scheduled,
+    const TimelineDetails& details
+) {
+    if (scheduled.timeline_repeats.empty() && details.empty()) {
+        return scheduled.timeline;
+    }
+    std::vector<const std::string*> slot_details;
+    if (!details.empty()) {
+        slot_details.assign(scheduled.timeline.size(), nullptr);
+        for (const auto& [slot, text] : details) {
+            slot_details.at(slot) = &text;
+        }
+    }
+    std::vector<TimelineEntry> expanded;
+    expanded.reserve(scheduled.timeline.size());
+    expand_timeline_range(scheduled, 0, scheduled.timeline.size(), 0, 0.0, slot_details, expanded);
+    return expanded;
+}
+
+GateParamIndex index_gate_params(const SchedulerResult& scheduled) {
+    // Instructions inside a Repeat block can appear more than once (peeled
+    // iterations) and so can their timeline entries.
+    GateParamIndex index;
+    for (std::size_t idx = 0; idx < scheduled.source_indices.size(); ++idx) {
+        if (scheduled.source_indices[idx] != kInsertedInstruction) {
+            index.program_slots[scheduled.source_indices[idx]].push_back(idx);
+        }
+    }
+    for (std::size_t idx = 0; idx < scheduled.timeline_source_indices.size(); ++idx) {
+        if (scheduled.timeline_source_indices[idx] != kInsertedInstruction) {
+            index.timeline_slots[scheduled.timeline_source_indices[idx]].push_back(idx);
+        }
+    }
+    return index;
+}
+
+TimelineDetails bind_gate_params(
+    Program& program,
+    const GateParamIndex& index,
+    const std::vector<GateParamBinding>& bindings
+) {
+    TimelineDetails details;
+    for (const auto& binding : bindings) {
+        const auto it = index.program_slots.find(binding.instruction_index);
+        if (it == index.program_slots.end() ||
+            program[it->second.front()].op != Op::ApplyGate) {
+            throw std::invalid_argument(
+                "Gate parameter binding references instruction " +
+                std::to_string(binding.instruction_index) + " which is not an ApplyGate");
+        }
+        std::string detail;
+        for (std::size_t slot : it->second) {
+            Gate& gate = std::get<Gate>(program[slot].payload);
+            gate.param = binding.param;
+            gate.symbol = {};
+            detail = describe_gate(gate);
+        }
+        const auto timeline_it = index.timeline_slots.find(binding.instruction_index);
+        if (timeline_it != index.timeline_slots.end()) {
+            for (std::size_t slot : timeline_it->second) {
+                details.emplace_back(slot, detail);
+            }
+        }
+    }
+    return details;
+}
+
+void rebind_gate_params(
+    SchedulerResult& scheduled,
+    const std::vector<GateParamBinding>& bindings
+) {
+    if (bindings.empty()) {
+        return;
+    }
+    const GateParamIndex index = index_gate_params(scheduled);
+    for (auto& [slot, detail] : bind_gate_params(scheduled.program, index, bindings)) {
+        scheduled.timeline[slot].detail = std::move(detail);
+    }
+}
+
 }  // namespace service
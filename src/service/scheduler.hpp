@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 
@@ -9,15 +13,81 @@
 
 namespace service {
 
+inline constexpr std::size_t kInsertedInstruction = std::numeric_limits<std::size_t>::max();
+
+// One scheduled Repeat in SchedulerResult::timeline: entries
+// [first, first + size) are a single iteration, which runs `count` times
+// with iteration k shifted by k * period.
+struct TimelineRepeat {
+    std::size_t first = 0;
+    std::size_t size = 0;
+    int count = 1;
+    double period = 0.0;
+};
+
 struct SchedulerResult {
-    std::vector<Instruction> program;
+    Program program;
+    // Compact: a Repeat keeps one iteration here plus a timeline_repeats
+    // descriptor. expand_timeline() yields one entry per executed event.
     std::vector<TimelineEntry> timeline;
+    // Ordered by `first`, an enclosing Repeat before the ones nested in it.
+    std::vector<TimelineRepeat> timeline_repeats;
     std::vector<neutral_atom_vm::InstructionTiming> instruction_timings;
+    // Index of the source instruction behind each scheduled instruction and
+    // timeline entry (kInsertedInstruction for scheduler-inserted waits).
+    std::vector<std::size_t> source_indices;
+    std::vector<std::size_t> timeline_source_indices;
+};
+
+struct GateParamBinding {
+    std::size_t instruction_index = 0;  // index into the source program
+    double param = 0.0;
 };
 
 SchedulerResult schedule_program(
-    const std::vector<Instruction>& program,
+    const Program& program,
     const HardwareConfig& hardware_config
 );
 
+// New detail text of timeline entries, keyed by index into
+// SchedulerResult::timeline.
+using TimelineDetails = std::vector<std::pair<std::size_t, std::string>>;
+
+// The timeline with every Repeat iteration spelled out. `details` replaces
+// the text of the entries it names, e.g. the gates a batch item rebound.
+std::vector<TimelineEntry> expand_timeline(
+    const SchedulerResult& scheduled,
+    const TimelineDetails& details = {}
+);
+
+// Scheduled instructions and timeline entries behind each source
+// instruction (several once a Repeat iteration is peeled). Build it once to
+// rebind many parameter sets against one schedule.
+struct GateParamIndex {
+    std::unordered_map<std::size_t, std::vector<std::size_t>> program_slots;
+    std::unordered_map<std::size_t, std::vector<std::size_t>> timeline_slots;
+};
+
+GateParamIndex index_gate_params(const SchedulerResult& scheduled);
+
+// Bind parameters into `program`, a copy of the program `index` was built
+// from, and return the timeline details of the rebound gates instead of
+// writing them, so the timeline itself can stay shared. Throws like
+// rebind_gate_params.
+TimelineDetails bind_gate_params(
+    Program& program,
+    const GateParamIndex& index,
+    const std::vector<GateParamBinding>& bindings
+);
+
+// Rebind gate parameters on an already scheduled program. Parameters do not
+// influence timing, so the schedule stays valid and only the affected
+// instructions and timeline details are rewritten; a bound symbolic gate
+// becomes a fixed one. Throws std::invalid_argument when a binding does not
+// address an ApplyGate.
+void rebind_gate_params(
+    SchedulerResult& scheduled,
+    const std::vector<GateParamBinding>& bindings
+);
+
 }  // namespace service
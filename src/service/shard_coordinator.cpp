@@ -0,0 +1,549 @@
+#include "service/shard_coordinator.hpp"
+
+#include "service/job_codec.hpp"
+#include "service/shared_result.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace service {
+
+namespace {
+
+// Messages are a u64 body length followed by the body. Requests carry
+// {u64 first, u64 count, encoded JobRequest}; replies a ReplyKind byte
+// followed by the error message, the encoded shot range, or the segment
+// name (u64 length + bytes) and the encoded range without measurements.
+constexpr std::size_t kRangeHeaderBytes = 2 * sizeof(std::uint64_t);
+
+enum class ReplyKind : char {
+    Error = 0,
+    Range = 1,
+    SharedRange = 2,
+};
+
+bool write_all(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t count = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+// False once `deadline` passes with nothing to read.
+bool wait_readable(int fd, const Deadline& deadline) {
+    if (!deadline) {
+        return true;
+    }
+    while (true) {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            *deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            return false;
+        }
+        pollfd entry{fd, POLLIN, 0};
+        const int ready = ::poll(&entry, 1, static_cast<int>(std::min<std::int64_t>(left.count(), 60'000)));
+        if (ready > 0) {
+            return true;
+        }
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+bool read_all(int fd, char* data, std::size_t size, const Deadline& deadline = std::nullopt) {
+    while (size > 0) {
+        if (!wait_readable(fd, deadline)) {
+            return false;
+        }
+        const ssize_t count = ::read(fd, data, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+bool write_message(int fd, std::string_view body) {
+    const std::uint64_t size = body.size();
+    return write_all(fd, reinterpret_cast<const char*>(&size), sizeof(size)) &&
+        write_all(fd, body.data(), body.size());
+}
+
+// False on EOF, a broken connection, or once `deadline` has passed.
+bool read_message(int fd, std::string& body, const Deadline& deadline = std::nullopt) {
+    std::uint64_t size = 0;
+    if (!read_all(fd, reinterpret_cast<char*>(&size), sizeof(size), deadline)) {
+        return false;
+    }
+    body.resize(static_cast<std::size_t>(size));
+    return read_all(fd, body.data(), body.size(), deadline);
+}
+
+// Zygote requests are one ZygoteRequest byte, followed for Stop by the
+// worker's pid (i64). Spawn is answered by the new pid (i64, negative errno
+// on failure) with the coordinator's socket end attached as SCM_RIGHTS;
+// Stop by an empty message once the worker is reaped.
+enum class ZygoteRequest : char {
+    Spawn = 0,
+    Stop = 1,
+};
+
+bool send_handle(int fd, std::int64_t pid, int handle) {
+    iovec payload{&pid, sizeof(pid)};
+    msghdr message{};
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    if (handle >= 0) {
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &handle, sizeof(int));
+    }
+    while (true) {
+        const ssize_t sent = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+        if (sent == static_cast<ssize_t>(sizeof(pid))) {
+            return true;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+}
+
+// The handle is -1 when none was attached.
+bool receive_handle(int fd, std::int64_t& pid, int& handle) {
+    iovec payload{&pid, sizeof(pid)};
+    msghdr message{};
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    handle = -1;
+    ssize_t received;
+    while ((received = ::recvmsg(fd, &message, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR) {
+    }
+    if (received != static_cast<ssize_t>(sizeof(pid))) {
+        return false;
+    }
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            std::memcpy(&handle, CMSG_DATA(header), sizeof(int));
+        }
+    }
+    return true;
+}
+
+template <typename T>
+T load(std::string_view bytes, std::size_t offset) {
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+class RangeWorker {
+  public:
+    explicit RangeWorker(const ShardCoordinatorOptions& options)
+        : threads_(options.threads_per_worker), shared_memory_min_bytes_(options.shared_memory_min_bytes) {
+        runner_.set_counter_scope(options.counter_scope);
+    }
+
+    std::string serve(std::string_view message) {
+        if (message.size() < kRangeHeaderBytes) {
+            throw std::runtime_error("shard worker: truncated range request");
+        }
+        const auto first = static_cast<std::size_t>(load<std::uint64_t>(message, 0));
+        const auto count = static_cast<std::size_t>(load<std::uint64_t>(message, sizeof(std::uint64_t)));
+        const std::string_view request = message.substr(kRangeHeaderBytes);
+        if (!compiled_ || request != request_bytes_) {
+            compiled_.reset();
+            job_ = decode_job_request(request);
+            compiled_ = std::make_shared<const CompiledJob>(runner_.compile(job_));
+            request_bytes_.assign(request);
+        }
+
+        PreparedJob prepared = runner_.prepare(compiled_, job_);
+        if (!prepared.execution) {
+            throw std::runtime_error(prepared.result ? prepared.result->message : "job could not be prepared");
+        }
+        std::optional<HardwareVM::RunResult> run;
+        prepared.execution->set_range_observer(
+            [&run](std::size_t, std::size_t, const HardwareVM::RunResult& result) { run = result; });
+        prepared.execution->run_range(first, count, threads_);
+        if (!run) {
+            // The execution kept the error; finish() reports it.
+            throw std::runtime_error(prepared.execution->finish().message);
+        }
+        return reply(*run, count);
+    }
+
+  private:
+    std::string reply(HardwareVM::RunResult& run, std::size_t count) const {
+        const auto packed = pack_measurements(run.measurements, count);
+        if (!packed || packed->values.size() * sizeof(std::uint64_t) < shared_memory_min_bytes_) {
+            return static_cast<char>(ReplyKind::Range) + encode_run_range(run, count);
+        }
+        // The coordinator adopts the name; this mapping goes away on return.
+        const auto segment = SharedResultSegment::create(*packed);
+        segment->release_name();
+        run.measurements.clear();
+        std::string out(1, static_cast<char>(ReplyKind::SharedRange));
+        const std::uint64_t size = segment->name().size();
+        out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.append(segment->name());
+        out.append(encode_run_range(run, count));
+        return out;
+    }
+
+    std::size_t threads_;
+    std::size_t shared_memory_min_bytes_;
+    JobRunner runner_;
+    std::string request_bytes_;
+    JobRequest job_;
+    std::shared_ptr<const CompiledJob> compiled_;
+};
+
+[[noreturn]] void worker_main(int fd, const ShardCoordinatorOptions& options) {
+    RangeWorker worker(options);
+    std::string message;
+    while (read_message(fd, message)) {
+        std::string reply;
+        try {
+            reply = worker.serve(message);
+        } catch (const std::exception& ex) {
+            reply = static_cast<char>(ReplyKind::Error) + std::string(ex.what());
+        }
+        if (!write_message(fd, reply)) {
+            break;
+        }
+    }
+    // Skip static destructors and atexit handlers inherited from the parent.
+    ::_exit(0);
+}
+
+void kill_and_reap(pid_t pid) {
+    ::kill(pid, SIGKILL);
+    while (::waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+    }
+}
+
+// Loop of the zygote process: forks workers on request and reaps them.
+// Runs single-threaded, so the forks never inherit another thread's locks.
+[[noreturn]] void zygote_main(int control, const ShardCoordinatorOptions& options) {
+    std::vector<pid_t> workers;
+    std::string message;
+    while (read_message(control, message) && !message.empty()) {
+        if (static_cast<ZygoteRequest>(message[0]) == ZygoteRequest::Stop &&
+            message.size() == 1 + sizeof(std::int64_t)) {
+            const auto pid = static_cast<pid_t>(load<std::int64_t>(message, 1));
+            const auto it = std::find(workers.begin(), workers.end(), pid);
+            if (it != workers.end()) {
+                kill_and_reap(pid);
+                workers.erase(it);
+            }
+            if (!write_message(control, {})) {
+                break;
+            }
+            continue;
+        }
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            if (!send_handle(control, -errno, -1)) {
+                break;
+            }
+            continue;
+        }
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(control);
+            ::close(fds[0]);
+            worker_main(fds[1], options);
+        }
+        const int error = errno;
+        ::close(fds[1]);
+        if (pid > 0) {
+            workers.push_back(pid);
+        }
+        const bool sent = send_handle(control, pid > 0 ? pid : -error, pid > 0 ? fds[0] : -1);
+        ::close(fds[0]);
+        if (!sent) {
+            break;
+        }
+    }
+    // The coordinator is gone: take the workers down with it.
+    for (const pid_t pid : workers) {
+        kill_and_reap(pid);
+    }
+    ::_exit(0);
+}
+
+}  // namespace
+
+ShardCoordinator::ShardCoordinator(ShardCoordinatorOptions options) : options_(std::move(options)) {
+    options_.workers = std::max<std::size_t>(1, options_.workers);
+    options_.max_attempts = std::max<std::size_t>(1, options_.max_attempts);
+    options_.threads_per_worker = std::max<std::size_t>(1, options_.threads_per_worker);
+
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        throw std::runtime_error(std::string("shard coordinator: cannot create socket pair: ") + std::strerror(errno));
+    }
+    zygote_pid_ = ::fork();
+    if (zygote_pid_ < 0) {
+        const int error = errno;
+        ::close(fds[0]);
+        ::close(fds[1]);
+        throw std::runtime_error(std::string("shard coordinator: cannot fork zygote: ") + std::strerror(error));
+    }
+    if (zygote_pid_ == 0) {
+        ::close(fds[0]);
+        zygote_main(fds[1], options_);
+    }
+    ::close(fds[1]);
+    zygote_fd_ = fds[0];
+
+    workers_.resize(options_.workers);
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        for (auto& worker : workers_) {
+            spawn_locked(worker);
+        }
+    } catch (...) {
+        ::close(zygote_fd_);
+        kill_and_reap(zygote_pid_);
+        for (auto& worker : workers_) {
+            if (worker.fd >= 0) {
+                ::close(worker.fd);
+            }
+        }
+        throw;
+    }
+}
+
+ShardCoordinator::~ShardCoordinator() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& worker : workers_) {
+        stop_locked(worker);
+    }
+    // On EOF the zygote stops any worker left and exits.
+    ::close(zygote_fd_);
+    while (::waitpid(zygote_pid_, nullptr, 0) < 0 && errno == EINTR) {
+    }
+}
+
+void ShardCoordinator::spawn_locked(Worker& worker) {
+    std::int64_t pid = 0;
+    int fd = -1;
+    const char request = static_cast<char>(ZygoteRequest::Spawn);
+    if (!write_message(zygote_fd_, std::string_view(&request, 1)) || !receive_handle(zygote_fd_, pid, fd)) {
+        throw std::runtime_error("shard coordinator: the zygote process is gone");
+    }
+    if (pid <= 0 || fd < 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw std::runtime_error(
+            std::string("shard coordinator: cannot fork worker: ") + std::strerror(static_cast<int>(-pid)));
+    }
+    worker.pid = static_cast<pid_t>(pid);
+    worker.fd = fd;
+}
+
+void ShardCoordinator::stop_locked(Worker& worker) {
+    if (worker.fd >= 0) {
+        ::close(worker.fd);
+    }
+    if (worker.pid > 0) {
+        std::string request(1, static_cast<char>(ZygoteRequest::Stop));
+        const std::int64_t pid = worker.pid;
+        request.append(reinterpret_cast<const char*>(&pid), sizeof(pid));
+        std::string ack;
+        if (!write_message(zygote_fd_, request) || !read_message(zygote_fd_, ack)) {
+            // Without the zygote nobody reaps it; at least stop it.
+            ::kill(worker.pid, SIGKILL);
+        }
+    }
+    worker.pid = -1;
+    worker.fd = -1;
+}
+
+void ShardCoordinator::replace(Worker& worker) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_locked(worker);
+    ++restarts_;
+    spawn_locked(worker);
+}
+
+ShardCoordinator::Worker& ShardCoordinator::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Worker* idle = nullptr;
+    idle_cv_.wait(lock, [&]() {
+        for (auto& worker : workers_) {
+            if (!worker.busy) {
+                idle = &worker;
+                return true;
+            }
+        }
+        return false;
+    });
+    idle->busy = true;
+    return *idle;
+}
+
+void ShardCoordinator::release(Worker& worker) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker.busy = false;
+    }
+    idle_cv_.notify_one();
+}
+
+ShotRangeExecution::RemoteRange ShardCoordinator::run_range(
+    const std::string& encoded_request,
+    std::size_t first,
+    std::size_t count
+) {
+    std::string request;
+    request.reserve(kRangeHeaderBytes + encoded_request.size());
+    const std::uint64_t header[2] = {first, count};
+    request.append(reinterpret_cast<const char*>(header), sizeof(header));
+    request.append(encoded_request);
+
+    std::string reply;
+    for (std::size_t attempt = 1;; ++attempt) {
+        Worker& worker = acquire();
+        Deadline deadline;
+        if (options_.range_timeout.count() > 0) {
+            deadline = std::chrono::steady_clock::now() + options_.range_timeout;
+        }
+        // The socket only changes while the worker is marked busy by us. A
+        // worker that misses the deadline is killed like one that died.
+        const bool delivered = write_message(worker.fd, request) && read_message(worker.fd, reply, deadline);
+        if (delivered && !reply.empty()) {
+            release(worker);
+            break;
+        }
+        try {
+            replace(worker);
+        } catch (...) {
+            release(worker);
+            throw;
+        }
+        release(worker);
+        if (attempt >= options_.max_attempts) {
+            throw std::runtime_error(
+                "shard coordinator: shots [" + std::to_string(first) + ", " + std::to_string(first + count) +
+                ") lost " + std::to_string(attempt) + " workers (died or missed the range deadline)");
+        }
+    }
+    const std::string_view body = std::string_view(reply).substr(1);
+    switch (static_cast<ReplyKind>(reply[0])) {
+        case ReplyKind::Range:
+            return {decode_run_range(body), nullptr};
+        case ReplyKind::SharedRange: {
+            if (body.size() < sizeof(std::uint64_t)) {
+                break;
+            }
+            const auto size = static_cast<std::size_t>(load<std::uint64_t>(body, 0));
+            if (body.size() - sizeof(std::uint64_t) < size) {
+                break;
+            }
+            // The planes stay in the segment; ShotRangeExecution::finish()
+            // merges them without unpacking.
+            auto segment = SharedResultSegment::open(
+                std::string(body.substr(sizeof(std::uint64_t), size)), true);
+            return {decode_run_range(body.substr(sizeof(std::uint64_t) + size)), std::move(segment)};
+        }
+        case ReplyKind::Error:
+            throw std::runtime_error(std::string(body));
+    }
+    throw std::runtime_error("shard coordinator: malformed worker reply");
+}
+
+JobResult ShardCoordinator::run(const JobRequest& job, std::size_t shots_per_range) {
+    JobRunner runner;
+    PreparedJob prepared = runner.prepare(job);
+    if (!prepared.execution) {
+        return std::move(*prepared.result);
+    }
+    ShotRangeExecution& execution = *prepared.execution;
+    const std::string request = encode_job_request(job);
+    execution.set_range_executor([this, &request](std::size_t first, std::size_t count) {
+        return run_range(request, first, count);
+    });
+
+    const std::size_t shots = execution.total_shots();
+    const std::size_t workers = options_.workers;
+    const std::size_t range = shots_per_range > 0
+        ? shots_per_range
+        : std::max<std::size_t>(1, (shots + workers - 1) / workers);
+    std::atomic<std::size_t> next{0};
+    auto dispatch = [&]() {
+        for (std::size_t first; (first = next.fetch_add(range)) < shots;) {
+            execution.run_range(first, std::min(range, shots - first), options_.threads_per_worker);
+        }
+    };
+    std::vector<std::thread> threads;
+    const std::size_t ranges = (shots + range - 1) / range;
+    for (std::size_t idx = 1; idx < std::min(workers, ranges); ++idx) {
+        threads.emplace_back(dispatch);
+    }
+    dispatch();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return execution.finish();
+}
+
+std::vector<pid_t> ShardCoordinator::worker_pids() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<pid_t> pids;
+    pids.reserve(workers_.size());
+    for (const auto& worker : workers_) {
+        pids.push_back(worker.pid);
+    }
+    return pids;
+}
+
+std::uint64_t ShardCoordinator::restarts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return restarts_;
+}
+
+}  // namespace service
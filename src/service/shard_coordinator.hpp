@@ -0,0 +1,109 @@
+#pragma once
+
+#include "hardware_vm.hpp"
+#include "service/job.hpp"
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace service {
+
+struct ShardCoordinatorOptions {
+    // Worker processes forked up front.
+    std::size_t workers = 2;
+    // Dispatches of one range before it is reported as failed; each worker
+    // that dies on the range, or misses its deadline, is replaced by a fresh
+    // process.
+    std::size_t max_attempts = 3;
+    // Time a worker gets to reply to one range before it is killed and the
+    // range is dispatched again; zero waits forever.
+    std::chrono::milliseconds range_timeout{0};
+    // Simulation threads each worker uses for a range.
+    std::size_t threads_per_worker = 1;
+    // Ranges whose bit planes take at least this many bytes come back in a
+    // SharedResultSegment instead of through the socket.
+    std::size_t shared_memory_min_bytes = 64 * 1024;
+    // Hardware counters the workers read; they come back with each range.
+    CounterScope counter_scope = CounterScope::kOff;
+};
+
+// Runs shot ranges of jobs in forked worker processes, so a crash in a
+// simulation (or a simulation that has to be killed) takes down one worker
+// instead of the service. Each worker owns one end of a Unix domain socket
+// pair and serves one range at a time: the request carries the encoded
+// JobRequest and the shot range, the reply the range's packed measurements
+// (see encode_run_range). Large ranges are written to a POSIX shared-memory
+// segment whose name the reply carries; the coordinator adopts it, merges
+// the planes of all ranges into the job's published segment and unlinks
+// it. Workers cache the program compiled for the last request, so
+// consecutive ranges of a job compile it once per worker.
+//
+// Seeded jobs produce the same shots as an in-process run however their
+// ranges are spread over workers. fork() only duplicates the calling
+// thread, so create the coordinator early, before the process holds locks
+// in other threads: the constructor forks a single-threaded zygote, and
+// every worker, including replacements for workers that died or missed
+// their deadline, is forked by the zygote rather than by the dispatching
+// thread. The zygote also reaps the workers, so a worker's pid stays
+// valid until the coordinator asks the zygote to stop it.
+class ShardCoordinator {
+  public:
+    // Throws std::runtime_error if a worker cannot be started.
+    explicit ShardCoordinator(ShardCoordinatorOptions options = {});
+    // Closes the sockets and reaps the workers.
+    ~ShardCoordinator();
+
+    ShardCoordinator(const ShardCoordinator&) = delete;
+    ShardCoordinator& operator=(const ShardCoordinator&) = delete;
+
+    // Simulate shots [first, first + count) of `encoded_request` (from
+    // encode_job_request) on the next idle worker. Thread-safe; blocks while
+    // every worker is busy. Ranges handed over in shared memory come back
+    // as the adopted segment, not unpacked. Throws std::runtime_error with
+    // the worker's message when the job fails, or when max_attempts workers
+    // died on it.
+    ShotRangeExecution::RemoteRange run_range(
+        const std::string& encoded_request,
+        std::size_t first,
+        std::size_t count
+    );
+
+    // Split the shots of `job` into ranges of `shots_per_range` (0: one
+    // range per worker), run them on the workers and merge the result.
+    JobResult run(const JobRequest& job, std::size_t shots_per_range = 0);
+
+    std::vector<pid_t> worker_pids() const;
+    // Workers replaced after dying.
+    std::uint64_t restarts() const;
+    const ShardCoordinatorOptions& options() const { return options_; }
+
+  private:
+    struct Worker {
+        pid_t pid = -1;
+        int fd = -1;
+        bool busy = false;
+    };
+
+    void spawn_locked(Worker& worker);
+    void stop_locked(Worker& worker);
+    void replace(Worker& worker);
+    Worker& acquire();
+    void release(Worker& worker);
+
+    ShardCoordinatorOptions options_;
+    pid_t zygote_pid_ = -1;
+    int zygote_fd_ = -1;  // requests to the zygote; guarded by mutex_
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    std::vector<Worker> workers_;
+    std::uint64_t restarts_ = 0;
+};
+
+}  // namespace service
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace service {
+
+// Counter split into cache-line-padded shards so concurrent writers on
+// different threads do not bounce one cache line. Each thread sticks to a
+// shard chosen on first use; reads sum every shard and are therefore only
+// eventually consistent with in-flight adds.
+class ShardedCounter {
+  public:
+    static constexpr std::size_t kShards = 64;
+
+    void add(std::size_t delta) {
+        shards_[shard_index()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    std::size_t load() const {
+        std::size_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset() {
+        for (auto& shard : shards_) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Shard owned by the calling thread, in [0, kShards). Other sharded
+    // accumulators reuse it so a thread touches the same slot everywhere.
+    static std::size_t shard_index() {
+        static std::atomic<std::size_t> next_index{0};
+        thread_local const std::size_t index =
+            next_index.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return index;
+    }
+
+  private:
+    struct alignas(64) Shard {
+        std::atomic<std::size_t> value{0};
+    };
+
+    std::array<Shard, kShards> shards_{};
+};
+
+}  // namespace service
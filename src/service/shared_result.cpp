@@ -0,0 +1,281 @@
+#include "service/shared_result.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace service {
+
+namespace {
+
+constexpr std::uint32_t kSegmentMagic = 0x4e415352U;  // "NASR"
+constexpr std::uint32_t kSegmentVersion = 1;
+
+// Followed by the layout (per record: i32 target count, then the targets)
+// and, 8-byte aligned, the value plane and the optional lost plane.
+struct SegmentHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t shots;
+    std::uint64_t bits_per_shot;
+    std::uint64_t records_per_shot;
+    std::uint64_t layout_bytes;
+    std::uint64_t words;
+    std::uint64_t has_lost;
+};
+
+std::size_t align_words(std::size_t offset) {
+    return (offset + alignof(std::uint64_t) - 1) & ~(alignof(std::uint64_t) - 1);
+}
+
+[[noreturn]] void throw_errno(const char* what, const std::string& name) {
+    throw std::runtime_error(std::string("shared result: ") + what + " " + name + ": " + std::strerror(errno));
+}
+
+// OR the first `bits` bits of `source` into `target` (`words` long) starting
+// at bit `offset`. Target bits from `offset` on are still zero, and source
+// bits past `bits` are zero padding.
+void append_bits(
+    std::uint64_t* target,
+    std::size_t words,
+    std::size_t offset,
+    std::span<const std::uint64_t> source,
+    std::size_t bits
+) {
+    const std::size_t count = (bits + 63) / 64;
+    std::uint64_t* out = target + offset / 64;
+    const std::size_t shift = offset % 64;
+    if (shift == 0) {
+        std::memcpy(out, source.data(), count * sizeof(std::uint64_t));
+        return;
+    }
+    const std::size_t available = words - offset / 64;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        out[idx] |= source[idx] << shift;
+        if (idx + 1 < available) {
+            out[idx + 1] |= source[idx] >> (64 - shift);
+        }
+    }
+}
+
+std::string next_segment_name() {
+    static std::atomic<std::uint64_t> counter{0};
+    return "/na_vm_result_" + std::to_string(::getpid()) + "_" +
+        std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+}  // namespace
+
+std::shared_ptr<SharedResultSegment> SharedResultSegment::allocate(
+    std::size_t shots,
+    const std::vector<std::vector<int>>& layout,
+    std::size_t bits_per_shot,
+    bool has_lost
+) {
+    std::size_t layout_bytes = 0;
+    for (const auto& targets : layout) {
+        layout_bytes += sizeof(std::int32_t) * (1 + targets.size());
+    }
+    const std::size_t words = (shots * bits_per_shot + 63) / 64;
+    const std::size_t values_offset = align_words(sizeof(SegmentHeader) + layout_bytes);
+    const std::size_t plane_bytes = words * sizeof(std::uint64_t);
+    const std::size_t size = values_offset + plane_bytes * (has_lost ? 2 : 1);
+
+    const std::string name = next_segment_name();
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw_errno("cannot create", name);
+    }
+    void* data = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    const int error = errno;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        errno = error;
+        throw_errno("cannot map", name);
+    }
+    // Owns the mapping from here on, so a failure below unlinks the name.
+    std::shared_ptr<SharedResultSegment> segment(new SharedResultSegment(name, data, size, true));
+
+    auto* bytes = static_cast<unsigned char*>(data);
+    SegmentHeader header{};
+    header.magic = kSegmentMagic;
+    header.version = kSegmentVersion;
+    header.shots = shots;
+    header.bits_per_shot = bits_per_shot;
+    header.records_per_shot = layout.size();
+    header.layout_bytes = layout_bytes;
+    header.words = words;
+    header.has_lost = has_lost ? 1 : 0;
+    std::memcpy(bytes, &header, sizeof(header));
+    std::size_t offset = sizeof(header);
+    for (const auto& targets : layout) {
+        const auto count = static_cast<std::int32_t>(targets.size());
+        std::memcpy(bytes + offset, &count, sizeof(count));
+        offset += sizeof(count);
+        for (const int target : targets) {
+            const auto value = static_cast<std::int32_t>(target);
+            std::memcpy(bytes + offset, &value, sizeof(value));
+            offset += sizeof(value);
+        }
+    }
+    // ftruncate zero-filled the planes.
+    segment->parse();
+    return segment;
+}
+
+std::shared_ptr<SharedResultSegment> SharedResultSegment::create(const PackedMeasurements& packed) {
+    auto segment = allocate(packed.shots, packed.layout, packed.bits_per_shot, !packed.lost.empty());
+    const std::size_t plane_bytes = packed.values.size() * sizeof(std::uint64_t);
+    if (plane_bytes > 0) {
+        std::memcpy(segment->mutable_values(), packed.values.data(), plane_bytes);
+        if (!packed.lost.empty()) {
+            std::memcpy(segment->mutable_lost(), packed.lost.data(), plane_bytes);
+        }
+    }
+    return segment;
+}
+
+std::shared_ptr<SharedResultSegment> SharedResultSegment::merge(
+    std::span<const std::shared_ptr<const SharedResultSegment>> parts
+) {
+    if (parts.empty()) {
+        return nullptr;
+    }
+    const SharedResultSegment& first = *parts.front();
+    std::size_t shots = 0;
+    bool has_lost = false;
+    for (const auto& part : parts) {
+        if (part->layout() != first.layout()) {
+            return nullptr;
+        }
+        shots += part->shots();
+        has_lost |= !part->lost().empty();
+    }
+    auto merged = allocate(shots, first.layout(), first.bits_per_shot(), has_lost);
+    const std::size_t words = merged->values().size();
+    std::size_t offset = 0;
+    for (const auto& part : parts) {
+        const std::size_t bits = part->shots() * part->bits_per_shot();
+        append_bits(merged->mutable_values(), words, offset, part->values(), bits);
+        if (!part->lost().empty()) {
+            append_bits(merged->mutable_lost(), words, offset, part->lost(), bits);
+        }
+        offset += bits;
+    }
+    return merged;
+}
+
+std::shared_ptr<SharedResultSegment> SharedResultSegment::open(const std::string& name, bool adopt) {
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw_errno("cannot open", name);
+    }
+    struct stat info {};
+    void* data = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(SegmentHeader))) {
+        data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    } else {
+        errno = EINVAL;
+    }
+    const int error = errno;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        errno = error;
+        throw_errno("cannot map", name);
+    }
+    std::shared_ptr<SharedResultSegment> segment(
+        new SharedResultSegment(name, data, static_cast<std::size_t>(info.st_size), adopt));
+    segment->parse();
+    return segment;
+}
+
+SharedResultSegment::SharedResultSegment(std::string name, void* data, std::size_t size, bool owner)
+    : name_(std::move(name)), data_(data), size_(size), owner_(owner) {}
+
+SharedResultSegment::~SharedResultSegment() {
+    ::munmap(data_, size_);
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+void SharedResultSegment::parse() {
+    const auto* bytes = static_cast<const unsigned char*>(data_);
+    SegmentHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != kSegmentMagic || header.version != kSegmentVersion) {
+        throw std::runtime_error("shared result: " + name_ + " is not a result segment");
+    }
+    const std::size_t values_offset = align_words(sizeof(header) + header.layout_bytes);
+    const std::size_t plane_bytes = header.words * sizeof(std::uint64_t);
+    if (header.layout_bytes > size_ ||
+        values_offset + plane_bytes * (header.has_lost ? 2 : 1) > size_ ||
+        header.words != (header.shots * header.bits_per_shot + 63) / 64) {
+        throw std::runtime_error("shared result: " + name_ + " is truncated");
+    }
+
+    shots_ = static_cast<std::size_t>(header.shots);
+    bits_per_shot_ = static_cast<std::size_t>(header.bits_per_shot);
+    layout_.clear();
+    std::size_t offset = sizeof(header);
+    const std::size_t layout_end = sizeof(header) + header.layout_bytes;
+    std::size_t bits = 0;
+    for (std::uint64_t record = 0; record < header.records_per_shot; ++record) {
+        std::int32_t count = 0;
+        if (offset + sizeof(count) > layout_end) {
+            throw std::runtime_error("shared result: " + name_ + " has a malformed layout");
+        }
+        std::memcpy(&count, bytes + offset, sizeof(count));
+        offset += sizeof(count);
+        if (count < 0 || offset + sizeof(std::int32_t) * static_cast<std::size_t>(count) > layout_end) {
+            throw std::runtime_error("shared result: " + name_ + " has a malformed layout");
+        }
+        std::vector<int> targets(static_cast<std::size_t>(count));
+        for (auto& target : targets) {
+            std::int32_t value = 0;
+            std::memcpy(&value, bytes + offset, sizeof(value));
+            offset += sizeof(value);
+            target = value;
+        }
+        bits += targets.size();
+        layout_.push_back(std::move(targets));
+    }
+    if (bits != bits_per_shot_) {
+        throw std::runtime_error("shared result: " + name_ + " has a malformed layout");
+    }
+
+    const auto* words = reinterpret_cast<const std::uint64_t*>(bytes + values_offset);
+    const auto count = static_cast<std::size_t>(header.words);
+    values_ = std::span<const std::uint64_t>(words, count);
+    lost_ = header.has_lost ? std::span<const std::uint64_t>(words + count, count)
+                            : std::span<const std::uint64_t>();
+}
+
+int SharedResultSegment::bit(std::size_t shot, std::size_t index) const {
+    if (shot >= shots_ || index >= bits_per_shot_) {
+        throw std::out_of_range("shared result: bit index out of range");
+    }
+    const std::size_t position = shot * bits_per_shot_ + index;
+    const std::uint64_t mask = std::uint64_t{1} << (position % 64);
+    if (!lost_.empty() && (lost_[position / 64] & mask)) {
+        return -1;
+    }
+    return (values_[position / 64] & mask) ? 1 : 0;
+}
+
+std::vector<MeasurementRecord> SharedResultSegment::unpack() const {
+    return unpack_measurements(shots_, layout_, values_, lost_);
+}
+
+}  // namespace service
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "service/packed_measurements.hpp"
+#include "vm/measurement_record.types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace service {
+
+// Packed measurements in a POSIX shared-memory segment, so results can be
+// handed between processes without copying them through a socket or pipe.
+// The segment holds a fixed header, the record layout and the bit planes of
+// PackedMeasurements; planes are 8-byte aligned and can be exposed directly
+// (e.g. through the Python buffer protocol).
+//
+// Handles are reference counted through std::shared_ptr. The handle that
+// owns the name unlinks it when the last reference goes away; mappings in
+// other processes stay valid until they are dropped as well.
+class SharedResultSegment {
+  public:
+    // Create a new segment holding `packed`. The returned handle owns the
+    // name. Throws std::runtime_error if the segment cannot be created.
+    static std::shared_ptr<SharedResultSegment> create(const PackedMeasurements& packed);
+    // Map the segment called `name`. With `adopt` the handle takes over the
+    // name from its creator (see release_name()). Throws std::runtime_error
+    // if the segment is missing or malformed.
+    static std::shared_ptr<SharedResultSegment> open(const std::string& name, bool adopt = false);
+    // Create a segment holding the shots of `parts` in order, copying their
+    // bit planes straight into the new mapping. Returns nullptr when `parts`
+    // is empty or the parts do not share one record layout.
+    static std::shared_ptr<SharedResultSegment> merge(
+        std::span<const std::shared_ptr<const SharedResultSegment>> parts);
+
+    ~SharedResultSegment();
+
+    SharedResultSegment(const SharedResultSegment&) = delete;
+    SharedResultSegment& operator=(const SharedResultSegment&) = delete;
+
+    // Name to pass to open(), valid while the owning handle lives.
+    const std::string& name() const { return name_; }
+    // Stop owning the name, leaving it for a handle that adopts it.
+    void release_name() { owner_ = false; }
+
+    std::size_t shots() const { return shots_; }
+    std::size_t bits_per_shot() const { return bits_per_shot_; }
+    const std::vector<std::vector<int>>& layout() const { return layout_; }
+    std::span<const std::uint64_t> values() const { return values_; }
+    // Empty when no atom was lost.
+    std::span<const std::uint64_t> lost() const { return lost_; }
+    std::size_t size_bytes() const { return size_; }
+
+    // Bit `index` of `shot` in record order: 0, 1 or -1 for a lost atom.
+    int bit(std::size_t shot, std::size_t index) const;
+    std::vector<MeasurementRecord> unpack() const;
+
+  private:
+    SharedResultSegment(std::string name, void* data, std::size_t size, bool owner);
+    // New owned segment with the header and layout written and zeroed planes.
+    static std::shared_ptr<SharedResultSegment> allocate(
+        std::size_t shots,
+        const std::vector<std::vector<int>>& layout,
+        std::size_t bits_per_shot,
+        bool has_lost);
+    void parse();
+    // Planes of a segment made by allocate(); the mapping is writable.
+    std::uint64_t* mutable_values() { return const_cast<std::uint64_t*>(values_.data()); }
+    std::uint64_t* mutable_lost() { return const_cast<std::uint64_t*>(lost_.data()); }
+
+    std::string name_;
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool owner_ = false;
+    std::size_t shots_ = 0;
+    std::size_t bits_per_shot_ = 0;
+    std::vector<std::vector<int>> layout_;
+    std::span<const std::uint64_t> values_;
+    std::span<const std::uint64_t> lost_;
+};
+
+}  // namespace service
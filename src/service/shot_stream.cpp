@@ -0,0 +1,142 @@
+#include "service/shot_stream.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace service {
+
+std::string shot_outcome_key(const std::vector<MeasurementRecord>& measurements) {
+    std::string key;
+    for (const auto& record : measurements) {
+        for (int bit : record.bits) {
+            key.push_back(bit < 0 ? 'x' : (bit != 0 ? '1' : '0'));
+        }
+    }
+    return key;
+}
+
+ShotStream::ShotStream(
+    std::size_t capacity,
+    std::size_t total_shots,
+    std::size_t completed_shots
+)
+    : capacity_(capacity > 0 ? capacity : 1),
+      total_shots_(total_shots),
+      completed_shots_(completed_shots) {}
+
+bool ShotStream::push(ShotRecord record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) {
+            return false;
+        }
+        if (pending_.size() >= capacity_) {
+            // The consumer lags: keep the outcome, drop the records.
+            tally_locked(record.measurements);
+            ++coalesced_shots_;
+            return true;
+        }
+        pending_.push_back(std::move(record));
+    }
+    not_empty_.notify_one();
+    return true;
+}
+
+void ShotStream::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    not_empty_.notify_all();
+}
+
+std::optional<ShotBatch> ShotStream::next(
+    std::chrono::milliseconds timeout,
+    std::size_t max_shots
+) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait_for(lock, timeout, [this]() {
+        return cancelled_ || finished_ || !pending_.empty();
+    });
+    if (pending_.empty() && (finished_ || cancelled_)) {
+        return std::nullopt;
+    }
+    ShotBatch batch;
+    const std::size_t take =
+        max_shots == 0 ? pending_.size() : std::min(max_shots, pending_.size());
+    batch.shots.reserve(take);
+    for (std::size_t idx = 0; idx < take; ++idx) {
+        ShotRecord& record = pending_.front();
+        tally_locked(record.measurements);
+        batch.shots.push_back(std::move(record));
+        pending_.pop_front();
+    }
+    batch.counts = counts_;
+    batch.coalesced_shots = coalesced_shots_;
+    // A shot racing the subscription can be both in the starting count and
+    // pushed; clamp so the count never overshoots the job.
+    batch.completed_shots =
+        total_shots_ > 0 ? std::min(completed_shots_, total_shots_) : completed_shots_;
+    batch.total_shots = total_shots_;
+    return batch;
+}
+
+void ShotStream::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        pending_.clear();
+    }
+    not_empty_.notify_all();
+}
+
+bool ShotStream::cancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+void ShotStream::tally_locked(const std::vector<MeasurementRecord>& measurements) {
+    std::string key = shot_outcome_key(measurements);
+    auto it = counts_.find(key);
+    if (it == counts_.end() && counts_.size() >= kMaxHistogramOutcomes) {
+        it = counts_.try_emplace(kOverflowOutcome, 0).first;
+    } else if (it == counts_.end()) {
+        it = counts_.emplace(std::move(key), 0).first;
+    }
+    ++it->second;
+    ++completed_shots_;
+}
+
+ShotSubscription::ShotSubscription(std::shared_ptr<ShotStream> stream)
+    : stream_(std::move(stream)) {}
+
+ShotSubscription::~ShotSubscription() {
+    close();
+}
+
+ShotSubscription& ShotSubscription::operator=(ShotSubscription&& other) noexcept {
+    if (this != &other) {
+        close();
+        stream_ = std::move(other.stream_);
+    }
+    return *this;
+}
+
+std::optional<ShotBatch> ShotSubscription::next(
+    std::chrono::milliseconds timeout,
+    std::size_t max_shots
+) {
+    if (!stream_) {
+        return std::nullopt;
+    }
+    return stream_->next(timeout, max_shots);
+}
+
+void ShotSubscription::close() {
+    if (stream_) {
+        stream_->cancel();
+        stream_.reset();
+    }
+}
+
+}  // namespace service
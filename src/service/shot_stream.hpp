@@ -0,0 +1,116 @@
+#pragma once
+
+#include "vm/measurement_record.types.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace service {
+
+// Measurements produced by one finished shot.
+struct ShotRecord {
+    int shot = 0;
+    std::vector<MeasurementRecord> measurements;
+};
+
+// Shots drained from a stream by one ShotStream::next() call.
+struct ShotBatch {
+    std::vector<ShotRecord> shots;
+    // Cumulative outcome histogram over the shots this subscription has
+    // seen, delivered or coalesced. At most kMaxHistogramOutcomes distinct
+    // outcomes are kept; later new outcomes are tallied under
+    // kOverflowOutcome.
+    std::map<std::string, std::size_t> counts;
+    // Shots so far that only reached `counts` because the queue was full
+    // when they finished; their records are not delivered.
+    std::size_t coalesced_shots = 0;
+    // Shots the job has finished so far, including those that completed
+    // before the subscription was opened.
+    std::size_t completed_shots = 0;
+    std::size_t total_shots = 0;
+};
+
+inline constexpr std::size_t kMaxHistogramOutcomes = 4096;
+inline constexpr const char* kOverflowOutcome = "other";
+
+// Histogram key for a shot: the bits of all its measurement records in
+// order, with lost atoms (-1) rendered as 'x'.
+std::string shot_outcome_key(const std::vector<MeasurementRecord>& measurements);
+
+// Bounded single-consumer queue of finished shots. push() never blocks the
+// simulation worker calling it: while `capacity` shots are pending, a new
+// shot is only tallied into the histogram (coalesced) and its records are
+// dropped, so a slow consumer loses detail instead of stalling the job or
+// growing memory without bound.
+class ShotStream {
+  public:
+    ShotStream(
+        std::size_t capacity,
+        std::size_t total_shots,
+        std::size_t completed_shots
+    );
+
+    // Producer side; does not wait. Returns false once the consumer has
+    // cancelled.
+    bool push(ShotRecord record);
+    // Mark the end of the stream; pending shots can still be drained.
+    void finish();
+
+    // Wait up to `timeout` for finished shots and drain at most `max_shots`
+    // of them (0 drains everything pending). Returns an empty batch on
+    // timeout and std::nullopt once the stream is finished and drained.
+    std::optional<ShotBatch> next(
+        std::chrono::milliseconds timeout,
+        std::size_t max_shots = 0
+    );
+    // Stop consuming: pending and later shots are dropped.
+    void cancel();
+    bool cancelled() const;
+
+  private:
+    void tally_locked(const std::vector<MeasurementRecord>& measurements);
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::deque<ShotRecord> pending_;
+    std::size_t capacity_;
+    std::size_t total_shots_;
+    std::map<std::string, std::size_t> counts_;
+    std::size_t completed_shots_;
+    std::size_t coalesced_shots_ = 0;
+    bool finished_ = false;
+    bool cancelled_ = false;
+};
+
+// Consumer handle for a ShotStream. Dropping the handle cancels the stream
+// so an abandoned subscription never stalls the job it observes.
+class ShotSubscription {
+  public:
+    ShotSubscription() = default;
+    explicit ShotSubscription(std::shared_ptr<ShotStream> stream);
+    ~ShotSubscription();
+
+    ShotSubscription(ShotSubscription&&) noexcept = default;
+    ShotSubscription& operator=(ShotSubscription&& other) noexcept;
+    ShotSubscription(const ShotSubscription&) = delete;
+    ShotSubscription& operator=(const ShotSubscription&) = delete;
+
+    std::optional<ShotBatch> next(
+        std::chrono::milliseconds timeout,
+        std::size_t max_shots = 0
+    );
+    void close();
+
+  private:
+    std::shared_ptr<ShotStream> stream_;
+};
+
+}  // namespace service
@@ -9,6 +9,7 @@
 #include <map>
 #include <optional>
 #include <random>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -71,8 +72,9 @@ class StimCircuitBuilder {
         }
     }
 
-    void translate(const std::vector<Instruction>& program) {
-        for (const auto& instr : program) {
+    void translate(ProgramView program) {
+        for (std::size_t idx = 0; idx < program.size(); ++idx) {
+            const Instruction& instr = program[idx];
             switch (instr.op) {
                 case Op::AllocArray:
                     {
@@ -94,7 +96,7 @@ class StimCircuitBuilder {
                     apply_gate(std::get<Gate>(instr.payload));
                     break;
                 case Op::Measure:
-                    append_measure(std::get<std::vector<int>>(instr.payload));
+                    append_measure(program.targets(instr));
                     break;
                 case Op::Wait:
                     append_wait(std::get<WaitInstruction>(instr.payload).duration);
@@ -102,6 +104,12 @@ class StimCircuitBuilder {
                 case Op::MoveAtom:
                 case Op::Pulse:
                     throw std::runtime_error("Stim backend does not support move/pulse instructions");
+                case Op::Repeat: {
+                    const auto body = repeat_body(program, idx);
+                    append_repeat(std::get<RepeatInstruction>(instr.payload).count, body);
+                    idx += body.size();
+                    break;
+                }
             }
         }
         if (allocated_qubits_ < 0) {
@@ -205,6 +213,44 @@ class StimCircuitBuilder {
         throw std::runtime_error("Stim backend only supports 1Q/2Q gates");
     }
 
+    // Every Stim instruction goes through here so that replayed Repeat
+    // iterations (see append_repeat) keep their bookkeeping but emit nothing.
+    void append_op(
+        const std::string& name,
+        const std::vector<uint32_t>& targets,
+        const std::vector<double>& args = {}
+    ) {
+        if (!replaying_) {
+            circuit_.safe_append_u(name, targets, args);
+        }
+    }
+
+    // Emits the body once as a native REPEAT block. The Stim instructions of
+    // a body do not depend on when it runs, but measurement record indices,
+    // timeline events and qubit timing do, so the remaining iterations are
+    // translated again with emission switched off. That keeps each
+    // iteration's measurement groups at their own record offsets and the
+    // timeline identical to the unrolled program.
+    void append_repeat(int count, ProgramView body) {
+        if (replaying_) {
+            for (int iteration = 0; iteration < count; ++iteration) {
+                translate(body);
+            }
+            return;
+        }
+        stim::Circuit outer = std::move(circuit_);
+        circuit_ = stim::Circuit();
+        translate(body);
+        stim::Circuit block = std::move(circuit_);
+        circuit_ = std::move(outer);
+        replaying_ = true;
+        for (int iteration = 1; iteration < count; ++iteration) {
+            translate(body);
+        }
+        replaying_ = false;
+        circuit_ += block * static_cast<uint64_t>(count);
+    }
+
     static std::string format_targets(const std::vector<uint32_t>& targets) {
         std::ostringstream oss;
         oss << "[";
@@ -262,7 +308,7 @@ class StimCircuitBuilder {
         int target
     ) {
         std::vector<uint32_t> targets{static_cast<uint32_t>(target)};
-        circuit_.safe_append_u(gate, targets);
+        append_op(gate, targets);
         const double duration = gate_duration_ns(gate, 1);
         std::vector<int> logical_targets{target};
         const double start_time = earliest_start_for_targets(logical_targets);
@@ -287,7 +333,7 @@ class StimCircuitBuilder {
             static_cast<uint32_t>(q0),
             static_cast<uint32_t>(q1)
         };
-        circuit_.safe_append_u(gate, targets);
+        append_op(gate, targets);
         const double duration = gate_duration_ns(gate, 2);
         std::vector<int> logical_targets{q0, q1};
         const double start_time = earliest_start_for_targets(logical_targets);
@@ -316,7 +362,7 @@ class StimCircuitBuilder {
         }
         std::vector<uint32_t> targets{static_cast<uint32_t>(target)};
         std::vector<double> args{cfg.px, cfg.py, cfg.pz};
-        circuit_.safe_append_u("PAULI_CHANNEL_1", targets, args);
+        append_op("PAULI_CHANNEL_1", targets, args);
         const double start_time = earliest_start_for_targets(std::vector<int>{target});
         record_timeline_event(
             "PAULI_CHANNEL_1",
@@ -336,7 +382,7 @@ class StimCircuitBuilder {
         if (has_single_qubit_noise(ctrl_cfg)) {
             std::vector<uint32_t> targets{static_cast<uint32_t>(control)};
             std::vector<double> args{ctrl_cfg.px, ctrl_cfg.py, ctrl_cfg.pz};
-            circuit_.safe_append_u("PAULI_CHANNEL_1", targets, args);
+            append_op("PAULI_CHANNEL_1", targets, args);
             record_timeline_event(
                 "PAULI_CHANNEL_1",
                 "targets=" + format_targets(targets) +
@@ -350,7 +396,7 @@ class StimCircuitBuilder {
         if (has_single_qubit_noise(tgt_cfg)) {
             std::vector<uint32_t> targets{static_cast<uint32_t>(target)};
             std::vector<double> args{tgt_cfg.px, tgt_cfg.py, tgt_cfg.pz};
-            circuit_.safe_append_u("PAULI_CHANNEL_1", targets, args);
+            append_op("PAULI_CHANNEL_1", targets, args);
             record_timeline_event(
                 "PAULI_CHANNEL_1",
                 "targets=" + format_targets(targets) +
@@ -363,24 +409,24 @@ class StimCircuitBuilder {
     }
 
     void append_measure(
-        const std::vector<int>& targets
+        std::span<const int> targets
     ) {
         if (targets.empty()) {
             return;
         }
         require_allocation();
         StimMeasurementGroup group;
-        group.targets = targets;
+        group.targets.assign(targets.begin(), targets.end());
         group.indices.reserve(targets.size());
         for (int target : targets) {
             ensure_target_range(target);
             group.indices.push_back(measurement_cursor_);
             std::vector<uint32_t> stim_targets{static_cast<uint32_t>(target)};
-            circuit_.safe_append_u("M", stim_targets);
+            append_op("M", stim_targets);
             ++measurement_cursor_;
         }
         measurement_groups_.push_back(std::move(group));
-        std::vector<int> logical_targets = targets;
+        std::vector<int> logical_targets(targets.begin(), targets.end());
         const double start_time = earliest_start_for_targets(logical_targets);
         record_timeline_event(
             "M",
@@ -406,7 +452,7 @@ class StimCircuitBuilder {
     void append_wait(
         double duration
     ) {
-        circuit_.safe_append_u("TICK", std::vector<uint32_t>{});
+        append_op("TICK", std::vector<uint32_t>{});
         const double safe_duration = std::max(0.0, duration);
         const double start_time = logical_time_;
         record_timeline_event(
@@ -428,6 +474,7 @@ class StimCircuitBuilder {
     }
 
     stim::Circuit circuit_;
+    bool replaying_ = false;
     int allocated_qubits_ = 0;
     std::optional<SimpleNoiseConfig> noise_holder_;
     const SimpleNoiseConfig* noise_ = nullptr;
@@ -527,8 +574,14 @@ void apply_measurement_noise(
 
 }  // namespace
 
+std::string stabilizer_circuit_text(const DeviceProfile& profile, const Program& program) {
+    StimCircuitBuilder builder(profile);
+    builder.translate(program);
+    return builder.finish().str();
+}
+
 HardwareVM::RunResult HardwareVM::run_stabilizer(
-    const std::vector<Instruction>& program,
+    const Program& program,
     int shots,
     const std::vector<std::uint64_t>& shot_seeds
 ) {
@@ -578,17 +631,18 @@ HardwareVM::RunResult HardwareVM::run_stabilizer(
         shot_logs.clear();
         if (const auto* noise_cfg = builder.noise()) {
             std::mt19937_64 noise_rng(shot_seeds[shot] ^ 0x9e3779b97f4a7c15ULL);
-            apply_measurement_noise(shot_records, *noise_cfg, shot, noise_rng, shot_logs);
+            apply_measurement_noise(shot_records, *noise_cfg, first_shot_ + shot, noise_rng, shot_logs);
         }
 
+        if (has_progress) {
+            progress_reporter_->record_shot(first_shot_ + shot, shot_records);
+        }
         for (auto& record : shot_records) {
             result.measurements.push_back(std::move(record));
         }
         result.logs.insert(result.logs.end(), shot_logs.begin(), shot_logs.end());
         if (has_progress) {
-            for (std::size_t step = 0; step < program_steps; ++step) {
-                progress_reporter_->increment_completed_steps();
-            }
+            progress_reporter_->increment_completed_steps(program_steps);
         }
     }
 
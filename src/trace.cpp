@@ -0,0 +1,230 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
+
+namespace neutral_atom_vm::trace {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+}  // namespace detail
+
+namespace {
+
+constexpr std::size_t kNameBytes = 48;
+
+struct Event {
+    const char* category;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+    std::int64_t arg;
+    char name[kNameBytes];
+};
+
+constexpr std::size_t kChunkEvents = 1024;
+
+// Appended to by its thread only; readers see the first `size` events,
+// which are never rewritten. Events live in chunks allocated as the buffer
+// fills, so short-lived threads only pay for what they record.
+struct ThreadBuffer {
+    ThreadBuffer(std::size_t capacity, std::int64_t epoch_ns, std::uint64_t session, std::uint32_t tid)
+        : chunks((capacity + kChunkEvents - 1) / kChunkEvents),
+          capacity(capacity),
+          epoch_ns(epoch_ns),
+          session(session),
+          tid(tid) {}
+
+    const Event& at(std::size_t idx) const { return chunks[idx / kChunkEvents][idx % kChunkEvents]; }
+
+    std::vector<std::unique_ptr<Event[]>> chunks;
+    const std::size_t capacity;
+    const std::int64_t epoch_ns;
+    const std::uint64_t session;
+    const std::uint32_t tid;
+    std::atomic<std::size_t> size{0};
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::size_t events_per_thread = kDefaultEventsPerThread;
+    std::int64_t epoch_ns = 0;
+    std::atomic<std::uint64_t> session{0};
+    std::atomic<std::uint32_t> next_tid{1};
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+thread_local std::shared_ptr<ThreadBuffer> current_buffer;
+
+ThreadBuffer* thread_buffer() {
+    Registry& reg = registry();
+    const std::uint64_t session = reg.session.load(std::memory_order_acquire);
+    if (!current_buffer || current_buffer->session != session) {
+        static thread_local const std::uint32_t tid = reg.next_tid.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        current_buffer = std::make_shared<ThreadBuffer>(reg.events_per_thread, reg.epoch_ns, session, tid);
+        reg.buffers.push_back(current_buffer);
+    }
+    return current_buffer.get();
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> snapshot_buffers() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.buffers;
+}
+
+void write_json_string(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* ch = text; *ch != '\0'; ++ch) {
+        const auto c = static_cast<unsigned char>(*ch);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *ch;
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << *ch;
+        }
+    }
+    out << '"';
+}
+
+void write_microseconds(std::ostream& out, std::int64_t ns) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(ns) / 1000.0);
+    out << text;
+}
+
+}  // namespace
+
+void start(std::size_t events_per_thread) {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.clear();
+        reg.events_per_thread = std::max<std::size_t>(1, events_per_thread);
+        reg.epoch_ns = now_ns();
+        reg.session.fetch_add(1, std::memory_order_release);
+    }
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+std::uint64_t recorded_events() {
+    std::uint64_t total = 0;
+    for (const auto& buffer : snapshot_buffers()) {
+        total += buffer->size.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+std::uint64_t dropped_events() {
+    std::uint64_t total = 0;
+    for (const auto& buffer : snapshot_buffers()) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void write_chrome_trace(std::ostream& out) {
+    const auto buffers = snapshot_buffers();
+    const long pid = static_cast<long>(::getpid());
+    std::uint64_t dropped = 0;
+    bool first = true;
+    out << "{\"traceEvents\":[";
+    for (const auto& buffer : buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        const std::size_t size = buffer->size.load(std::memory_order_acquire);
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            const Event& event = buffer->at(idx);
+            out << (first ? "" : ",") << "{\"name\":";
+            first = false;
+            write_json_string(out, event.name);
+            out << ",\"cat\":";
+            write_json_string(out, event.category);
+            out << ",\"ph\":\"X\",\"ts\":";
+            write_microseconds(out, event.start_ns - buffer->epoch_ns);
+            out << ",\"dur\":";
+            write_microseconds(out, event.duration_ns);
+            out << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+            if (event.arg >= 0) {
+                out << ",\"args\":{\"index\":" << event.arg << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << dropped << "}}";
+}
+
+std::string chrome_trace_json() {
+    std::ostringstream out;
+    write_chrome_trace(out);
+    return out.str();
+}
+
+void Span::begin() noexcept {
+    start_ns_ = now_ns();
+}
+
+void Span::end() noexcept {
+    const std::int64_t end_ns = now_ns();
+    ThreadBuffer* buffer = nullptr;
+    try {
+        buffer = thread_buffer();
+    } catch (...) {
+        return;
+    }
+    if (start_ns_ < buffer->epoch_ns) {
+        // Began before the session did.
+        return;
+    }
+    const std::size_t size = buffer->size.load(std::memory_order_relaxed);
+    if (size >= buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto& chunk = buffer->chunks[size / kChunkEvents];
+    if (!chunk) {
+        chunk.reset(new (std::nothrow) Event[kChunkEvents]);
+        if (!chunk) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    Event& event = chunk[size % kChunkEvents];
+    event.category = category_;
+    event.start_ns = start_ns_;
+    event.duration_ns = end_ns - start_ns_;
+    event.arg = arg_;
+    const std::size_t length = std::min(std::strlen(name_), kNameBytes - 1);
+    std::memcpy(event.name, name_, length);
+    event.name[length] = '\0';
+    buffer->size.store(size + 1, std::memory_order_release);
+}
+
+}  // namespace neutral_atom_vm::trace
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Execution tracing in the Chrome trace event format (chrome://tracing,
+// https://ui.perfetto.dev). Spans are recorded into per-thread buffers that
+// only their own thread appends to, so recording takes no locks; the
+// buffers are registered once per thread and trace session. While tracing
+// is stopped a span costs one relaxed atomic load.
+namespace neutral_atom_vm::trace {
+
+constexpr std::size_t kDefaultEventsPerThread = 1 << 16;
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}  // namespace detail
+
+inline bool enabled() noexcept {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Drop the spans of the previous session and start recording. Each thread
+// keeps its first `events_per_thread` spans; later ones are counted in
+// dropped_events().
+void start(std::size_t events_per_thread = kDefaultEventsPerThread);
+// Stop recording; the spans stay available until the next start().
+void stop();
+
+std::uint64_t recorded_events();
+std::uint64_t dropped_events();
+
+// The spans of the current session as a Chrome trace JSON object. Safe to
+// call while other threads record; spans that end meanwhile may be missing.
+void write_chrome_trace(std::ostream& out);
+std::string chrome_trace_json();
+
+// Records the scope it lives in as a complete ("X") event. `category` must
+// be a string literal; `name` must outlive the span and is copied
+// (truncated to 47 bytes) when the span ends. `arg`, when non-negative, is reported as args.index (the shot
+// or the first shot of a range).
+class Span {
+  public:
+    Span(const char* category, const char* name, std::int64_t arg = -1) noexcept
+        : category_(enabled() ? category : nullptr), name_(name), arg_(arg) {
+        if (category_) {
+            begin();
+        }
+    }
+    Span(const char* category, const std::string& name, std::int64_t arg = -1) noexcept
+        : Span(category, name.c_str(), arg) {}
+
+    ~Span() {
+        if (category_) {
+            end();
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+  private:
+    void begin() noexcept;
+    void end() noexcept;
+
+    const char* category_;
+    const char* name_;
+    std::int64_t arg_;
+    std::int64_t start_ns_ = 0;
+};
+
+}  // namespace neutral_atom_vm::trace
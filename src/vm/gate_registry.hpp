@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Gates the engines implement natively; their ids are fixed so kernels can
+// switch on them. Any other name is interned with an id >= kFirstCustom.
+enum class GateOp : std::uint16_t {
+    None,  // default-constructed (empty) name
+    X,
+    H,
+    Z,
+    CX,
+    CZ,
+    kFirstCustom,
+};
+
+// Process-wide table of the gate names the VM knows: the built-in ops, the
+// other gates a backend executes (Stim's Y, S, ...) and names trusted code
+// declares. Names are interned once and never removed, so a 16-bit id stands
+// for a name everywhere and the returned strings stay valid for the life of
+// the process. Untrusted input only looks names up, so requests cannot grow
+// the table: an undeclared name is a validation error.
+class GateRegistry {
+  public:
+    static constexpr std::size_t kMaxGates = 1024;
+
+    static GateRegistry& instance() {
+        static GateRegistry registry;
+        return registry;
+    }
+
+    // Intern a trusted name (e.g. a custom gate a backend implements).
+    // Throws std::length_error once kMaxGates names exist.
+    std::uint16_t declare(std::string_view name) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        return intern_locked(name);
+    }
+
+    // Id of a declared name; throws std::invalid_argument for any other.
+    std::uint16_t find(std::string_view name) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const auto it = ids_.find(name);
+        if (it == ids_.end()) {
+            throw std::invalid_argument("unknown gate '" + std::string(name) + "'");
+        }
+        return it->second;
+    }
+
+    // Lock-free: ids only come from declare() and find().
+    const std::string& name(std::uint16_t id) const {
+        return *names_[id].load(std::memory_order_acquire);
+    }
+
+  private:
+    GateRegistry() {
+        for (const char* name : {"", "X", "H", "Z", "CX", "CZ"}) {
+            intern_locked(name);
+        }
+        // Further gates the Stim backend executes; it matches names
+        // case-insensitively.
+        for (const char* name : {"Y", "S", "SDG", "S_DAG", "CNOT", "x", "y", "z", "h", "s", "sdg",
+                                 "s_dag", "cx", "cnot", "cz"}) {
+            intern_locked(name);
+        }
+    }
+
+    std::uint16_t intern_locked(std::string_view name) {
+        const auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        if (storage_.size() == kMaxGates) {
+            throw std::length_error("gate registry is full (" + std::to_string(kMaxGates) +
+                " distinct gate names)");
+        }
+        const auto id = static_cast<std::uint16_t>(storage_.size());
+        storage_.push_back(std::make_unique<const std::string>(name));
+        names_[id].store(storage_.back().get(), std::memory_order_release);
+        ids_.emplace(*storage_.back(), id);
+        return id;
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::vector<std::unique_ptr<const std::string>> storage_;
+    std::unordered_map<std::string_view, std::uint16_t> ids_;  // views into storage_
+    std::array<std::atomic<const std::string*>, kMaxGates> names_{};
+};
+
+// Interned gate name: a 16-bit registry id that reads like a std::string
+// (comparison, concatenation, streaming) but copies as a plain integer.
+// Constructing one from a string throws std::invalid_argument unless the
+// name is declared in the GateRegistry.
+class GateName {
+  public:
+    constexpr GateName() = default;
+    constexpr GateName(GateOp op) : id_(static_cast<std::uint16_t>(op)) {}
+    GateName(std::string_view name) : id_(GateRegistry::instance().find(name)) {}
+    GateName(const std::string& name) : GateName(std::string_view(name)) {}
+    GateName(const char* name) : GateName(std::string_view(name)) {}
+
+    std::uint16_t id() const { return id_; }
+    // The built-in op, or GateOp::kFirstCustom for any other gate.
+    GateOp op() const {
+        return id_ < static_cast<std::uint16_t>(GateOp::kFirstCustom) ? static_cast<GateOp>(id_)
+                                                                       : GateOp::kFirstCustom;
+    }
+    const std::string& str() const { return GateRegistry::instance().name(id_); }
+    operator const std::string&() const { return str(); }
+    bool empty() const { return id_ == 0; }
+
+    friend bool operator==(GateName lhs, GateName rhs) { return lhs.id_ == rhs.id_; }
+    friend bool operator==(GateName lhs, const std::string& rhs) { return lhs.str() == rhs; }
+    friend bool operator==(GateName lhs, const char* rhs) { return lhs.str() == rhs; }
+
+  private:
+    std::uint16_t id_ = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& out, GateName name) {
+    return out << name.str();
+}
+
+inline std::string operator+(const std::string& lhs, GateName rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const char* lhs, GateName rhs) { return lhs + rhs.str(); }
+inline std::string operator+(GateName lhs, const std::string& rhs) { return lhs.str() + rhs; }
+inline std::string operator+(GateName lhs, const char* rhs) { return lhs.str() + rhs; }
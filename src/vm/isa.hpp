@@ -1,16 +1,28 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
+#include <initializer_list>
+#include <iterator>
 #include <limits>
 #include <optional>
+#include <ostream>
+#include <span>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "vm/gate_registry.hpp"
+
 // Core instruction set and hardware configuration for the Neutral Atom VM.
 // This header intentionally contains no simulation state or engine-specific
 // logic; it is the "ISA" view shared by compilers, services, and backends.
@@ -74,6 +86,14 @@ struct PulseInstruction {
     double duration = 0.0;
 };
 
+// Runs the `body_size` instructions that follow it `count` times. The body
+// stays inline in the flat program, so a block costs one instruction however
+// many rounds it covers; blocks may nest.
+struct RepeatInstruction {
+    int count = 1;
+    int body_size = 0;
+};
+
 enum class Op {
     AllocArray,
     ApplyGate,
@@ -81,12 +101,158 @@ enum class Op {
     MoveAtom,
     Wait,
     Pulse,
+    Repeat,
+};
+
+// Gate operands stored inline. Native gates act on at most a few qubits, so
+// a fixed array keeps Gate trivially copyable and free of heap allocations;
+// Measure operands are stored by MeasureTargets.
+class TargetList {
+  public:
+    static constexpr std::size_t kCapacity = 4;
+
+    TargetList() = default;
+    TargetList(std::initializer_list<int> targets) : TargetList(targets.begin(), targets.end()) {}
+    TargetList(std::span<const int> targets) : TargetList(targets.begin(), targets.end()) {}
+    TargetList(const std::vector<int>& targets) : TargetList(targets.begin(), targets.end()) {}
+
+    template <typename It>
+    TargetList(It first, It last) {
+        const auto count = static_cast<std::size_t>(std::distance(first, last));
+        if (count > kCapacity) {
+            throw std::invalid_argument(
+                "gate acts on " + std::to_string(count) + " targets; at most " +
+                std::to_string(kCapacity) + " are supported");
+        }
+        std::copy(first, last, targets_.begin());
+        size_ = static_cast<std::uint8_t>(count);
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    int operator[](std::size_t idx) const { return targets_[idx]; }
+    int& operator[](std::size_t idx) { return targets_[idx]; }
+    const int* data() const { return targets_.data(); }
+    const int* begin() const { return targets_.data(); }
+    const int* end() const { return targets_.data() + size_; }
+    int* begin() { return targets_.data(); }
+    int* end() { return targets_.data() + size_; }
+    std::vector<int> to_vector() const { return std::vector<int>(begin(), end()); }
+
+    friend bool operator==(const TargetList& lhs, const TargetList& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+  private:
+    std::array<int, kCapacity> targets_{};
+    std::uint8_t size_ = 0;
+};
+
+// Name of a late-bound gate parameter, stored inline like TargetList so Gate
+// stays trivially copyable. Symbols are request data, so they are kept out
+// of the GateRegistry; longer names are rejected.
+class ParamSymbol {
+  public:
+    static constexpr std::size_t kCapacity = 23;
+
+    ParamSymbol() = default;
+    ParamSymbol(std::string_view name) {
+        if (name.size() > kCapacity) {
+            throw std::invalid_argument(
+                "gate parameter '" + std::string(name) + "' is longer than " +
+                std::to_string(kCapacity) + " characters");
+        }
+        std::copy(name.begin(), name.end(), chars_.begin());
+        size_ = static_cast<std::uint8_t>(name.size());
+    }
+    ParamSymbol(const std::string& name) : ParamSymbol(std::string_view(name)) {}
+    ParamSymbol(const char* name) : ParamSymbol(std::string_view(name)) {}
+
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return std::string_view(chars_.data(), size_); }
+    std::string str() const { return std::string(view()); }
+    operator std::string() const { return str(); }
+
+    friend bool operator==(const ParamSymbol& lhs, const ParamSymbol& rhs) {
+        return lhs.view() == rhs.view();
+    }
+    friend bool operator==(const ParamSymbol& lhs, std::string_view rhs) { return lhs.view() == rhs; }
+    friend bool operator==(const ParamSymbol& lhs, const char* rhs) { return lhs.view() == rhs; }
+
+  private:
+    std::array<char, kCapacity> chars_{};
+    std::uint8_t size_ = 0;
 };
 
+inline std::ostream& operator<<(std::ostream& out, const ParamSymbol& symbol) {
+    return out << symbol.view();
+}
+
+inline std::string operator+(const std::string& lhs, const ParamSymbol& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const char* lhs, const ParamSymbol& rhs) { return lhs + rhs.str(); }
+
 struct Gate {
-    std::string name;          // "X", "H", "CX", "CZ", ...
-    std::vector<int> targets;  // qubit indices
-    double param = 0.0;        // angle or other parameter
+    GateName name;       // "X", "H", "CX", "CZ", ... declared in GateRegistry
+    TargetList targets;  // qubit indices
+    double param = 0.0;  // angle or other parameter
+    // Symbolic parameter name (e.g. "theta"); when set, `param` is late-bound
+    // from the job's parameter table instead of fixed in the program.
+    ParamSymbol symbol{};
+};
+
+static_assert(std::is_trivially_copyable_v<Gate>, "Gate must stay a POD-like value");
+
+// Measure operands. Up to kInlineCapacity targets are stored in the
+// instruction itself; wider lists are rare and live in the owning Program's
+// operand table (see Program::push_measure), referenced by offset and count.
+class MeasureTargets {
+  public:
+    static constexpr std::size_t kInlineCapacity = 8;
+
+    MeasureTargets() = default;
+    MeasureTargets(std::initializer_list<int> targets)
+        : MeasureTargets(std::span<const int>(targets.begin(), targets.size())) {}
+    MeasureTargets(const std::vector<int>& targets) : MeasureTargets(std::span<const int>(targets)) {}
+    MeasureTargets(std::span<const int> targets) {
+        if (targets.size() > kInlineCapacity) {
+            throw std::invalid_argument(
+                "Measure on " + std::to_string(targets.size()) + " targets needs Program::push_measure; at most " +
+                std::to_string(kInlineCapacity) + " fit in an instruction");
+        }
+        std::copy(targets.begin(), targets.end(), inline_.begin());
+        count_ = static_cast<std::uint32_t>(targets.size());
+    }
+
+    // A list stored at operands[offset, offset + count) of the program.
+    static MeasureTargets spilled(std::uint32_t offset, std::uint32_t count) {
+        MeasureTargets out;
+        out.offset_ = offset;
+        out.count_ = count;
+        return out;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool is_spilled() const { return count_ > kInlineCapacity; }
+    std::uint32_t offset() const { return offset_; }
+
+    // The targets, looking wide lists up in `operands`, the operand table of
+    // the program this instruction belongs to. Inline targets are returned
+    // in place, so call this on the stored instruction, not a temporary.
+    std::span<const int> resolve(std::span<const int> operands) const {
+        if (!is_spilled()) {
+            return std::span<const int>(inline_.data(), count_);
+        }
+        if (offset_ > operands.size() || count_ > operands.size() - offset_) {
+            throw std::out_of_range("Measure operands run past the end of the program's operand table");
+        }
+        return operands.subspan(offset_, count_);
+    }
+
+  private:
+    std::array<int, kInlineCapacity> inline_{};
+    std::uint32_t offset_ = 0;
+    std::uint32_t count_ = 0;
 };
 
 struct Instruction {
@@ -94,18 +260,200 @@ struct Instruction {
     std::variant<
         int,
         Gate,
-        std::vector<int>,
+        MeasureTargets,
         MoveAtomInstruction,
         WaitInstruction,
-        PulseInstruction> payload;
+        PulseInstruction,
+        RepeatInstruction> payload;
     // AllocArray: payload = int (n_qubits)
-    // ApplyGate:  payload = Gate
-    // Measure:    payload = std::vector<int> (targets)
+    // ApplyGate:  payload = Gate (inline, no heap storage)
+    // Measure:    payload = MeasureTargets (inline, or in the program's operand table)
     // MoveAtom:   payload = MoveAtomInstruction
     // Wait:       payload = WaitInstruction
     // Pulse:      payload = PulseInstruction
+    // Repeat:     payload = RepeatInstruction (body = next body_size instructions)
 };
 
+static_assert(std::is_trivially_copyable_v<Instruction>, "Instruction must stay a POD-like value");
+
+// Non-owning view of a Program, or a slice of one, together with the
+// operand table its Measure instructions refer to.
+class ProgramView {
+  public:
+    ProgramView() = default;
+    ProgramView(std::span<const Instruction> instructions, std::span<const int> operands = {})
+        : instructions_(instructions), operands_(operands) {}
+
+    std::size_t size() const { return instructions_.size(); }
+    bool empty() const { return instructions_.empty(); }
+    const Instruction& operator[](std::size_t idx) const { return instructions_[idx]; }
+    const Instruction* begin() const { return instructions_.data(); }
+    const Instruction* end() const { return instructions_.data() + instructions_.size(); }
+    std::span<const Instruction> instructions() const { return instructions_; }
+    std::span<const int> operands() const { return operands_; }
+
+    ProgramView subspan(std::size_t offset, std::size_t count) const {
+        return ProgramView(instructions_.subspan(offset, count), operands_);
+    }
+    ProgramView first(std::size_t count) const { return subspan(0, count); }
+
+    // Targets of a Measure in this view.
+    std::span<const int> targets(const Instruction& instr) const {
+        return std::get<MeasureTargets>(instr.payload).resolve(operands_);
+    }
+
+  private:
+    std::span<const Instruction> instructions_;
+    std::span<const int> operands_;
+};
+
+// A program: contiguous, trivially copyable instructions plus the side table
+// of wide Measure operand lists. It keeps the Program
+// interface its users were written against; Instruction values remain the
+// way to build and read single instructions.
+class Program {
+  public:
+    Program() = default;
+    Program(std::initializer_list<Instruction> instructions) : instructions_(instructions) {}
+    Program(std::vector<Instruction> instructions) : instructions_(std::move(instructions)) {}
+
+    std::size_t size() const { return instructions_.size(); }
+    bool empty() const { return instructions_.empty(); }
+    void reserve(std::size_t count) { instructions_.reserve(count); }
+    void clear() {
+        instructions_.clear();
+        operands_.clear();
+    }
+
+    const Instruction& operator[](std::size_t idx) const { return instructions_[idx]; }
+    Instruction& operator[](std::size_t idx) { return instructions_[idx]; }
+    const Instruction& front() const { return instructions_.front(); }
+    const Instruction& back() const { return instructions_.back(); }
+    Instruction& back() { return instructions_.back(); }
+    const Instruction* data() const { return instructions_.data(); }
+    const Instruction* begin() const { return instructions_.data(); }
+    const Instruction* end() const { return instructions_.data() + instructions_.size(); }
+    Instruction* begin() { return instructions_.data(); }
+    Instruction* end() { return instructions_.data() + instructions_.size(); }
+
+    void push_back(const Instruction& instr) { instructions_.push_back(instr); }
+    template <typename... Args>
+    Instruction& emplace_back(Args&&... args) {
+        return instructions_.emplace_back(std::forward<Args>(args)...);
+    }
+    void insert(const Instruction* pos, const Instruction& instr) {
+        instructions_.insert(instructions_.begin() + (pos - data()), instr);
+    }
+    void insert(const Instruction* pos, std::size_t count, const Instruction& instr) {
+        instructions_.insert(instructions_.begin() + (pos - data()), count, instr);
+    }
+    template <typename It>
+    void insert(const Instruction* pos, It first, It last) {
+        instructions_.insert(instructions_.begin() + (pos - data()), first, last);
+    }
+
+    // Appends a Measure, moving lists wider than an instruction holds into
+    // the operand table.
+    void push_measure(std::span<const int> targets) {
+        if (targets.size() <= MeasureTargets::kInlineCapacity) {
+            instructions_.push_back(Instruction{Op::Measure, MeasureTargets(targets)});
+            return;
+        }
+        if (operands_.size() + targets.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("program operand table is full");
+        }
+        const auto offset = static_cast<std::uint32_t>(operands_.size());
+        operands_.insert(operands_.end(), targets.begin(), targets.end());
+        instructions_.push_back(Instruction{
+            Op::Measure, MeasureTargets::spilled(offset, static_cast<std::uint32_t>(targets.size()))});
+    }
+
+    // Targets of a Measure stored in this program.
+    std::span<const int> targets(const Instruction& instr) const {
+        return std::get<MeasureTargets>(instr.payload).resolve(operands_);
+    }
+    std::span<const int> operands() const { return operands_; }
+
+    // Takes over `source`'s operand table, so instructions copied from
+    // `source` (wide Measures included) can be appended as they are.
+    void adopt_operands(const Program& source) { operands_ = source.operands_; }
+
+    operator ProgramView() const { return ProgramView(instructions_, operands_); }
+    operator std::span<const Instruction>() const { return instructions_; }
+
+  private:
+    std::vector<Instruction> instructions_;
+    std::vector<int> operands_;
+};
+
+// Body of the Repeat at `index`. Throws std::invalid_argument when the
+// count is not positive or the body runs past the end of `program`.
+inline std::span<const Instruction> repeat_body(std::span<const Instruction> program, std::size_t index) {
+    const auto& repeat = std::get<RepeatInstruction>(program[index].payload);
+    if (repeat.count < 1) {
+        throw std::invalid_argument(
+            "Repeat at instruction " + std::to_string(index) + " needs a positive count");
+    }
+    if (repeat.body_size < 0 ||
+        static_cast<std::size_t>(repeat.body_size) > program.size() - index - 1) {
+        throw std::invalid_argument(
+            "Repeat at instruction " + std::to_string(index) + " has a body of " +
+            std::to_string(repeat.body_size) + " instructions past the end of its block");
+    }
+    return program.subspan(index + 1, static_cast<std::size_t>(repeat.body_size));
+}
+
+inline ProgramView repeat_body(ProgramView program, std::size_t index) {
+    const auto body = repeat_body(program.instructions(), index);
+    return program.subspan(index + 1, body.size());
+}
+
+inline ProgramView repeat_body(const Program& program, std::size_t index) {
+    return repeat_body(ProgramView(program), index);
+}
+
+// Upper bound on the iterations of a Repeat times those of every Repeat
+// enclosing it. Executing and timing a program costs one pass over a body
+// per iteration, so counts are bounded like any other program size.
+inline constexpr std::int64_t kMaxRepeatIterations = 100000;
+
+// Checks that every Repeat block, including nested ones, is well formed and
+// within kMaxRepeatIterations. `offset` is the index of program[0] in the
+// enclosing program and only shows up in error messages; `enclosing` is the
+// iteration count of the blocks program[] is nested in.
+inline void validate_repeat_blocks(
+    std::span<const Instruction> program,
+    std::size_t offset = 0,
+    std::int64_t enclosing = 1
+) {
+    for (std::size_t idx = 0; idx < program.size(); ++idx) {
+        if (program[idx].op != Op::Repeat) {
+            continue;
+        }
+        const auto& repeat = std::get<RepeatInstruction>(program[idx].payload);
+        if (repeat.count < 1) {
+            throw std::invalid_argument(
+                "Repeat at instruction " + std::to_string(offset + idx) + " needs a positive count");
+        }
+        if (repeat.body_size < 0 ||
+            static_cast<std::size_t>(repeat.body_size) > program.size() - idx - 1) {
+            throw std::invalid_argument(
+                "Repeat at instruction " + std::to_string(offset + idx) +
+                " has a body that runs past the end of its block");
+        }
+        const std::int64_t iterations = enclosing * repeat.count;
+        if (iterations > kMaxRepeatIterations) {
+            throw std::invalid_argument(
+                "Repeat at instruction " + std::to_string(offset + idx) + " runs its body " +
+                std::to_string(iterations) + " times including enclosing repeats; at most " +
+                std::to_string(kMaxRepeatIterations) + " are supported");
+        }
+        validate_repeat_blocks(
+            program.subspan(idx + 1, static_cast<std::size_t>(repeat.body_size)), offset + idx + 1, iterations);
+        idx += static_cast<std::size_t>(repeat.body_size);
+    }
+}
+
 // ISA v1.1 hardware description extends the original v1.0 view
 // with richer, hardware-oriented metadata. Existing fields remain
 // valid and are treated as a legacy 1D geometry when the newer
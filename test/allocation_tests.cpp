@@ -0,0 +1,206 @@
+#include "allocation_tracker.hpp"
+
+#include "cpu_state_backend.hpp"
+#include "engine_statevector.hpp"
+#include "hardware_vm.hpp"
+#include "noise.hpp"
+#include "service/packed_measurements.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using allocation_tracker::AllocationCounts;
+using allocation_tracker::AllocationScope;
+
+// Golden workloads with allocation budgets. A budget is the number of heap
+// allocations one unit of work (a gate, an instruction, a shot) may make;
+// the per-unit figure is the difference between a run with `units` units
+// and an otherwise identical run with none, so setup costs cancel out.
+// Lower a budget when a hot path loses allocations; never raise one to
+// make a test pass without understanding the new allocation.
+namespace {
+
+struct PerUnit {
+    double allocations = 0.0;
+    double bytes = 0.0;
+};
+
+AllocationCounts measure(const std::function<void()>& work) {
+    AllocationScope scope;
+    work();
+    return scope.counts();
+}
+
+PerUnit per_unit(const std::function<void(int)>& run, int units) {
+    run(0);  // warm up lazily initialized statics
+    const AllocationCounts base = measure([&]() { run(0); });
+    const AllocationCounts loaded = measure([&]() { run(units); });
+    PerUnit out;
+    out.allocations = (static_cast<double>(loaded.allocations) - static_cast<double>(base.allocations)) / units;
+    out.bytes = (static_cast<double>(loaded.bytes) - static_cast<double>(base.bytes)) / units;
+    return out;
+}
+
+// Reports the cost (also as a test property, so it lands in --gtest_output
+// XML) and checks it against the budget.
+void expect_within_budget(const char* workload, const PerUnit& cost, double budget) {
+    ::testing::Test::RecordProperty(std::string(workload) + "_allocations", std::to_string(cost.allocations));
+    ::testing::Test::RecordProperty(std::string(workload) + "_bytes", std::to_string(cost.bytes));
+    std::printf("[ ALLOCS   ] %-28s %8.2f allocations %10.1f bytes (budget %.2f)\n",
+        workload, cost.allocations, cost.bytes, budget);
+    EXPECT_LE(cost.allocations, budget) << workload << " allocates more per unit than its budget";
+}
+
+HardwareConfig make_hardware(int qubits) {
+    HardwareConfig hw;
+    for (int idx = 0; idx < qubits; ++idx) {
+        hw.positions.push_back(static_cast<double>(idx));
+    }
+    hw.blockade_radius = 1.5;
+    return hw;
+}
+
+Program repeated(const Instruction& instr, int count, int qubits) {
+    Program program{{Op::AllocArray, qubits}};
+    program.insert(program.end(), static_cast<std::size_t>(count), instr);
+    return program;
+}
+
+PerUnit engine_cost(const Instruction& instr, int count) {
+    return per_unit([&](int units) {
+        StatevectorEngine engine(make_hardware(4), nullptr, 7);
+        engine.run(repeated(instr, units, 4));
+    }, count);
+}
+
+SimpleNoiseConfig make_noise() {
+    SimpleNoiseConfig noise;
+    noise.p_quantum_flip = 0.01;
+    noise.p_loss = 0.01;
+    noise.readout.p_flip0_to_1 = 0.01;
+    noise.readout.p_flip1_to_0 = 0.01;
+    noise.gate.single_qubit = {0.01, 0.01, 0.01};
+    noise.gate.two_qubit_control = {0.01, 0.01, 0.01};
+    noise.gate.two_qubit_target = {0.01, 0.01, 0.01};
+    noise.correlated_gate.matrix[5] = 0.01;
+    noise.idle_rate = 100.0;
+    noise.phase = {0.01, 0.01, 0.01, 0.01};
+    noise.amplitude_damping = {0.01, 100.0};
+    noise.loss_runtime = {0.001, 10.0};
+    return noise;
+}
+
+}  // namespace
+
+TEST(AllocationTests, StateBackendGatesDoNotAllocate) {
+    CpuStateBackend backend;
+    backend.alloc_array(10);
+    const std::array<std::complex<double>, 4> h{{{1.0, 0.0}, {1.0, 0.0}, {1.0, 0.0}, {-1.0, 0.0}}};
+    std::array<std::complex<double>, 16> cz{};
+    cz[0] = cz[5] = cz[10] = 1.0;
+    cz[15] = -1.0;
+    const PerUnit cost = per_unit([&](int units) {
+        for (int idx = 0; idx < units; ++idx) {
+            backend.apply_single_qubit_unitary(idx % 10, h);
+            backend.apply_two_qubit_unitary(idx % 10, (idx + 1) % 10, cz);
+        }
+    }, 100);
+    expect_within_budget("backend_gate_pair", cost, 0.0);
+}
+
+TEST(AllocationTests, NoiseHooksStayWithinBudget) {
+    const auto noise = std::make_shared<SimpleNoiseEngine>(make_noise())->clone();
+    std::vector<std::complex<double>> amplitudes(16);
+    amplitudes[0] = 1.0;
+    std::mt19937_64 rng(3);
+    StdRandomStream stream(rng);
+    // Only the rare events that fire (and format a log message) allocate.
+    constexpr double kNoiseEventBudget = 0.05;
+
+    const PerUnit single = per_unit([&](int units) {
+        for (int idx = 0; idx < units; ++idx) {
+            noise->apply_single_qubit_gate_noise(idx % 4, 4, amplitudes, stream);
+        }
+    }, 200);
+    expect_within_budget("noise_single_qubit_gate", single, kNoiseEventBudget);
+    const PerUnit two = per_unit([&](int units) {
+        for (int idx = 0; idx < units; ++idx) {
+            noise->apply_two_qubit_gate_noise(0, 1, 4, amplitudes, stream);
+        }
+    }, 200);
+    expect_within_budget("noise_two_qubit_gate", two, kNoiseEventBudget);
+    const PerUnit idle = per_unit([&](int units) {
+        for (int idx = 0; idx < units; ++idx) {
+            noise->apply_idle_noise(4, amplitudes, 1e-6, stream);
+        }
+    }, 200);
+    expect_within_budget("noise_idle", idle, kNoiseEventBudget);
+    MeasurementRecord record{{0, 1}, {0, 1}};
+    const PerUnit measurement = per_unit([&](int units) {
+        for (int idx = 0; idx < units; ++idx) {
+            record.bits = {0, 1};
+            noise->apply_measurement_noise(record, stream);
+        }
+    }, 200);
+    expect_within_budget("noise_measurement", measurement, kNoiseEventBudget);
+
+}
+
+TEST(AllocationTests, EngineInstructionsStayWithinBudget) {
+    // Every instruction currently formats and stores an ExecutionLog entry.
+    const PerUnit gate = engine_cost({Op::ApplyGate, Gate{"H", {0}, 0.0}}, 64);
+    expect_within_budget("engine_apply_gate", gate, 3.5);
+    const PerUnit measure = engine_cost({Op::Measure, std::vector<int>{0, 1}}, 64);
+    expect_within_budget("engine_measure", measure, 9.5);
+    const PerUnit wait = engine_cost({Op::Wait, WaitInstruction{100.0}}, 64);
+    expect_within_budget("engine_wait", wait, 3.5);
+    const PerUnit move = engine_cost({Op::MoveAtom, MoveAtomInstruction{0, 0.5}}, 64);
+    expect_within_budget("engine_move_atom", move, 3.5);
+    const PerUnit pulse = engine_cost({Op::Pulse, PulseInstruction{0, 0.0, 100.0}}, 64);
+    expect_within_budget("engine_pulse", pulse, 3.5);
+
+}
+
+TEST(AllocationTests, ShotsStayWithinBudget) {
+    DeviceProfile profile;
+    profile.id = "allocation-bell";
+    profile.hardware = make_hardware(2);
+    const Program program{
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    const PerUnit shot = per_unit([&](int units) {
+        HardwareVM vm(profile);
+        vm.run(program, units + 1, std::vector<std::uint64_t>(static_cast<std::size_t>(units + 1), 5), nullptr, 1);
+    }, 64);
+    expect_within_budget("hardware_vm_shot", shot, 42.0);
+
+    profile.noise_engine = std::make_shared<SimpleNoiseEngine>(make_noise());
+    const PerUnit noisy = per_unit([&](int units) {
+        HardwareVM vm(profile);
+        vm.run(program, units + 1, std::vector<std::uint64_t>(static_cast<std::size_t>(units + 1), 5), nullptr, 1);
+    }, 64);
+    expect_within_budget("hardware_vm_noisy_shot", noisy, 66.0);
+
+}
+
+TEST(AllocationTests, PackingMeasurementsAllocatesPerJobNotPerShot) {
+    std::vector<MeasurementRecord> records;
+    for (int shot = 0; shot < 4096; ++shot) {
+        records.push_back(MeasurementRecord{{0, 1}, {shot % 2, 1}});
+    }
+    const std::vector<MeasurementRecord> none;
+    const PerUnit pack = per_unit([&](int units) {
+        const auto& input = units > 0 ? records : none;
+        (void)service::pack_measurements(input, static_cast<std::size_t>(units));
+    }, 4096);
+    expect_within_budget("pack_measurements_shot", pack, 0.01);
+}
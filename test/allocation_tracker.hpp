@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Heap allocation counters fed by the replacement global operator new and
+// delete in allocation_tracker.cpp. Only binaries that link that file are
+// instrumented; counts cover every thread of the process.
+namespace allocation_tracker {
+
+struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t frees = 0;
+};
+
+AllocationCounts current();
+
+// Counts between construction and counts(). Nest freely; scopes only read
+// the global counters.
+class AllocationScope {
+  public:
+    AllocationScope() : start_(current()) {}
+
+    AllocationCounts counts() const {
+        const AllocationCounts now = current();
+        return {now.allocations - start_.allocations, now.bytes - start_.bytes, now.frees - start_.frees};
+    }
+
+  private:
+    AllocationCounts start_;
+};
+
+}  // namespace allocation_tracker
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include <memory>
@@ -20,7 +22,7 @@ TEST(HardwareVMTests, AppliesNoiseEngine) {
 
     HardwareVM vm(profile);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::Measure,
@@ -41,7 +43,7 @@ TEST(HardwareVMTests, RunsMultipleShots) {
 
     HardwareVM vm(profile);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -68,7 +70,7 @@ TEST(HardwareVMTests, IdleNoiseInducesPhaseFlip) {
 
     HardwareVM vm(profile);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -106,7 +108,7 @@ TEST(HardwareVMTests, LossStateResetsEachShot) {
 
     HardwareVM vm(profile);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -134,7 +136,7 @@ TEST(HardwareVMTests, StabilizerBackendGeneratesBellPair) {
 
     HardwareVM vm(profile);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -168,7 +170,7 @@ TEST(HardwareVMTests, StabilizerBackendHandlesMultipleQallocs) {
 
     HardwareVM vm(profile);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 4});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -192,6 +194,58 @@ TEST(HardwareVMTests, StabilizerBackendHandlesMultipleQallocs) {
     ASSERT_EQ(result.measurements.size(), 1u);
     ASSERT_EQ(result.measurements[0].bits.size(), 2u);
 }
+
+TEST(HardwareVMTests, StabilizerRepeatMatchesUnrolledProgram) {
+    DeviceProfile profile;
+    profile.id = "stim-repeat";
+    profile.hardware.positions = {0.0, 1.0};
+    profile.hardware.blockade_radius = 1.0;
+    profile.backend = BackendKind::kStabilizer;
+    SimpleNoiseConfig noise;
+    noise.gate.single_qubit.px = 0.2;
+    profile.noise_config = noise;
+
+    const Program round = {
+        Instruction{Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        Instruction{Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        Instruction{Op::Measure, std::vector<int>{0, 1}},
+        Instruction{Op::Wait, WaitInstruction{100.0}},
+    };
+    constexpr int kRounds = 1000;
+    Program repeated{
+        Instruction{Op::AllocArray, 2},
+        Instruction{Op::Repeat, RepeatInstruction{kRounds, static_cast<int>(round.size())}},
+    };
+    repeated.insert(repeated.end(), round.begin(), round.end());
+    repeated.push_back(Instruction{Op::Measure, std::vector<int>{1}});
+    Program unrolled{Instruction{Op::AllocArray, 2}};
+    for (int iteration = 0; iteration < kRounds; ++iteration) {
+        unrolled.insert(unrolled.end(), round.begin(), round.end());
+    }
+    unrolled.push_back(Instruction{Op::Measure, std::vector<int>{1}});
+
+    const std::string compact = stabilizer_circuit_text(profile, repeated);
+    EXPECT_NE(compact.find("REPEAT 1000 {"), std::string::npos);
+    EXPECT_LT(compact.size() * 100, stabilizer_circuit_text(profile, unrolled).size());
+
+    const std::vector<std::uint64_t> seeds = {3, 5, 7};
+    HardwareVM repeat_vm(profile);
+    HardwareVM unrolled_vm(profile);
+    const auto lhs = repeat_vm.run(repeated, 3, seeds);
+    const auto rhs = unrolled_vm.run(unrolled, 3, seeds);
+    ASSERT_EQ(lhs.measurements.size(), 3u * (kRounds + 1));
+    ASSERT_EQ(lhs.measurements.size(), rhs.measurements.size());
+    for (std::size_t idx = 0; idx < lhs.measurements.size(); ++idx) {
+        EXPECT_EQ(lhs.measurements[idx].targets, rhs.measurements[idx].targets);
+        EXPECT_EQ(lhs.measurements[idx].bits, rhs.measurements[idx].bits);
+    }
+    ASSERT_EQ(lhs.backend_timeline.size(), rhs.backend_timeline.size());
+    for (std::size_t idx = 0; idx < lhs.backend_timeline.size(); ++idx) {
+        EXPECT_EQ(lhs.backend_timeline[idx].op, rhs.backend_timeline[idx].op);
+        EXPECT_EQ(lhs.backend_timeline[idx].detail, rhs.backend_timeline[idx].detail);
+        EXPECT_DOUBLE_EQ(lhs.backend_timeline[idx].start_time, rhs.backend_timeline[idx].start_time);
+    }
+}
 #endif
 
 }  // namespace
@@ -110,7 +110,7 @@ TEST(PhaseNoiseSourceTests, SingleQubitPhaseKickMatchesRandomStream) {
     engine.set_noise_model(noise);
     engine.set_random_seed(4242);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -157,7 +157,7 @@ TEST(PhaseNoiseSourceTests, IdlePhaseNoiseScalesWithDuration) {
     engine.set_noise_model(noise);
     engine.set_random_seed(2025);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -208,7 +208,7 @@ TEST(CorrelatedPauliSourceTests, AppliesConfiguredPair) {
     StatevectorEngine engine(hw);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -237,7 +237,7 @@ TEST(LossTrackingSourceTests, GateLossSetsMeasurementToErasure) {
     StatevectorEngine engine(hw);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -266,7 +266,7 @@ TEST(AmplitudeDampingSourceTests, GateDampingRelaxesExcitedState) {
     StatevectorEngine engine(hw);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -295,7 +295,7 @@ TEST(AmplitudeDampingSourceTests, IdleDampingDrivesStateToGround) {
     StatevectorEngine engine(hw);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -0,0 +1,105 @@
+#include "perf_counters.hpp"
+
+#include "service/job.hpp"
+#include "service/job_codec.hpp"
+#include "service/job_json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+service::JobRequest make_bell_job(int shots) {
+    service::JobRequest job;
+    job.device_id = "state-vector";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.seed = 9;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+}  // namespace
+
+TEST(PerfCountersTests, ThreadCountersReadZerosWhenUnavailable) {
+    ThreadCounters counters;
+    EXPECT_EQ(counters.available(), hardware_counters_supported());
+    const HardwareCounters before = counters.read();
+    volatile double sink = 0.0;
+    for (int idx = 0; idx < 100000; ++idx) {
+        sink = sink + idx;
+    }
+    const HardwareCounters delta = counters_between(before, counters.read());
+    EXPECT_EQ(delta.available, counters.available());
+    if (delta.available) {
+        EXPECT_GT(delta.cycles, 0u);
+        EXPECT_GT(delta.instructions, 100000u);
+    } else {
+        EXPECT_EQ(delta.cycles, 0u);
+        EXPECT_EQ(delta.instructions, 0u);
+    }
+}
+
+TEST(PerfCountersTests, ParsesCounterScopes) {
+    EXPECT_EQ(parse_counter_scope("off"), CounterScope::kOff);
+    EXPECT_EQ(parse_counter_scope("run"), CounterScope::kRun);
+    EXPECT_EQ(parse_counter_scope("kernels"), CounterScope::kKernels);
+    EXPECT_EQ(to_string(CounterScope::kKernels), "kernels");
+    EXPECT_THROW(parse_counter_scope("cycles"), std::invalid_argument);
+}
+
+TEST(PerfCountersTests, JobProfileReportsKernelCounters) {
+    service::JobRunner runner;
+    runner.set_counter_scope(CounterScope::kKernels);
+    const auto result = runner.run(make_bell_job(4), 2);
+    ASSERT_EQ(result.status, service::JobStatus::Completed) << result.message;
+
+    const service::JobProfile& profile = result.profile;
+    EXPECT_EQ(profile.counters.available, hardware_counters_supported());
+    // Kernels are attributed whether or not the PMU is exposed.
+    ASSERT_EQ(profile.kernels.count("H"), 1u);
+    EXPECT_EQ(profile.kernels.at("H").calls, 4u);
+    EXPECT_EQ(profile.kernels.at("CX").calls, 4u);
+    EXPECT_EQ(profile.kernels.at("measure").calls, 4u);
+    if (profile.counters.available) {
+        EXPECT_GT(profile.counters.cycles, 0u);
+        EXPECT_GT(profile.kernels.at("CX").counters.instructions, 0u);
+        EXPECT_LE(profile.kernels.at("CX").counters.cycles, profile.counters.cycles);
+    } else {
+        EXPECT_EQ(profile.counters.cycles, 0u);
+        EXPECT_EQ(profile.memory_bandwidth_bytes_per_second, 0.0);
+    }
+    const std::string json = service::job_result_to_json(result);
+    EXPECT_NE(json.find("\"hardware_counters\":{\"available\":"), std::string::npos);
+    EXPECT_NE(json.find("\"measure\":{\"calls\":4"), std::string::npos);
+}
+
+TEST(PerfCountersTests, CountingIsOffByDefault) {
+    service::JobRunner runner;
+    const auto result = runner.run(make_bell_job(2), 1);
+    ASSERT_EQ(result.status, service::JobStatus::Completed) << result.message;
+    EXPECT_FALSE(result.profile.counters.available);
+    EXPECT_TRUE(result.profile.kernels.empty());
+}
+
+TEST(PerfCountersTests, ShotRangesCarryTheirCounters) {
+    HardwareVM::RunResult run;
+    run.measurements = {MeasurementRecord{{0}, {1}}};
+    run.stats.counters = HardwareCounters{true, 10, 20, 3, 1};
+    run.stats.kernels["H"] = KernelCounters{2, HardwareCounters{true, 4, 8, 1, 0}};
+    const auto decoded = service::decode_run_range(service::encode_run_range(run, 1));
+    EXPECT_TRUE(decoded.stats.counters.available);
+    EXPECT_EQ(decoded.stats.counters.instructions, 20u);
+    ASSERT_EQ(decoded.stats.kernels.count("H"), 1u);
+    EXPECT_EQ(decoded.stats.kernels.at("H").calls, 2u);
+    EXPECT_EQ(decoded.stats.kernels.at("H").counters.cycles, 4u);
+}
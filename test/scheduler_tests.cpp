@@ -4,6 +4,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
 TEST(SchedulerTests, InsertsWaitAfterMeasurementCooldown) {
     HardwareConfig hw;
     hw.positions = {0.0};
@@ -15,7 +19,7 @@ TEST(SchedulerTests, InsertsWaitAfterMeasurementCooldown) {
     x.duration_ns = 10.0;
     hw.native_gates.push_back(x);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{Op::Measure, std::vector<int>{0}});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
@@ -32,6 +36,25 @@ TEST(SchedulerTests, InsertsWaitAfterMeasurementCooldown) {
     EXPECT_GE(wait_instr.duration, hw.timing_limits.measurement_cooldown_ns);
 }
 
+TEST(SchedulerTests, KeepsWideMeasureOperands) {
+    HardwareConfig hw;
+    hw.positions.assign(10, 0.0);
+    hw.timing_limits.measurement_cooldown_ns = 5.0;
+    const std::vector<int> wide{9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    Program program{{Op::AllocArray, 10}};
+    program.push_measure(wide);
+    program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
+    program.push_measure(wide);
+
+    const service::SchedulerResult scheduled = service::schedule_program(program, hw);
+    const auto& program_out = scheduled.program;
+    ASSERT_EQ(program_out.size(), 5u);
+    EXPECT_EQ(program_out[2].op, Op::Wait);
+    EXPECT_TRUE(std::ranges::equal(program_out.targets(program_out[1]), wide));
+    EXPECT_TRUE(std::ranges::equal(program_out.targets(program_out[4]), wide));
+    EXPECT_EQ(scheduled.timeline.back().detail, "targets=[9,8,7,6,5,4,3,2,1,0]");
+}
+
 TEST(SchedulerTests, AllowsParallelSingleQubitGates) {
     HardwareConfig hw;
     hw.positions = {0.0, 1.0};
@@ -40,7 +63,7 @@ TEST(SchedulerTests, AllowsParallelSingleQubitGates) {
     x.arity = 1;
     x.duration_ns = 500.0;
     hw.native_gates = {x};
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}, 0.0}});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {1}, 0.0}});
@@ -75,7 +98,7 @@ TEST(SchedulerTests, RespectsSingleQubitParallelLimit) {
     x.duration_ns = 500.0;
     hw.native_gates = {x};
     hw.timing_limits.max_parallel_single_qubit = 1;
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}, 0.0}});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {1}, 0.0}});
@@ -103,7 +126,7 @@ TEST(SchedulerTests, RespectsTwoQubitParallelLimit) {
     cx.connectivity = ConnectivityKind::AllToAll;
     hw.native_gates = {cx};
     hw.timing_limits.max_parallel_two_qubit = 1;
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 4});
     program.push_back(Instruction{Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}});
     program.push_back(Instruction{Op::ApplyGate, Gate{"CX", {2, 3}, 0.0}});
@@ -137,7 +160,7 @@ TEST(SchedulerTests, RespectsZoneLimitWithSiteIdMapping) {
     x.duration_ns = 500.0;
     hw.native_gates = {x};
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}, 0.0}});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {1}, 0.0}});
@@ -152,3 +175,128 @@ TEST(SchedulerTests, RespectsZoneLimitWithSiteIdMapping) {
     ASSERT_EQ(starts.size(), 2u);
     EXPECT_GE(starts[1], starts[0] + 500.0);
 }
+
+TEST(SchedulerTests, RepeatBlocksKeepOneBodyAndExpandTheTimeline) {
+    HardwareConfig hw;
+    hw.positions = {0.0};
+    hw.timing_limits.measurement_cooldown_ns = 5.0;
+    NativeGate x;
+    x.name = "X";
+    x.arity = 1;
+    x.duration_ns = 10.0;
+    hw.native_gates = {x};
+
+    Program program;
+    program.push_back(Instruction{Op::AllocArray, 1});
+    program.push_back(Instruction{Op::Repeat, RepeatInstruction{1000, 2}});
+    program.push_back(Instruction{Op::Measure, std::vector<int>{0}});
+    program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
+
+    const service::SchedulerResult scheduled = service::schedule_program(program, hw);
+    ASSERT_EQ(scheduled.program.size(), 5u);
+    ASSERT_EQ(scheduled.program[1].op, Op::Repeat);
+    const auto& repeat = std::get<RepeatInstruction>(scheduled.program[1].payload);
+    EXPECT_EQ(repeat.count, 1000);
+    EXPECT_EQ(repeat.body_size, 3);
+    EXPECT_EQ(scheduled.program[3].op, Op::Wait);
+    EXPECT_EQ(scheduled.source_indices, (std::vector<std::size_t>{0, 1, 2, service::kInsertedInstruction, 3}));
+
+    // One iteration is kept: Measure, cooldown wait and gate, 15 ns long.
+    ASSERT_EQ(scheduled.timeline.size(), 3u);
+    EXPECT_EQ(scheduled.timeline_source_indices[2], 3u);
+    ASSERT_EQ(scheduled.timeline_repeats.size(), 1u);
+    EXPECT_EQ(scheduled.timeline_repeats[0].first, 0u);
+    EXPECT_EQ(scheduled.timeline_repeats[0].size, 3u);
+    EXPECT_EQ(scheduled.timeline_repeats[0].count, 1000);
+    EXPECT_DOUBLE_EQ(scheduled.timeline_repeats[0].period, 15.0);
+
+    const auto expanded = service::expand_timeline(scheduled);
+    ASSERT_EQ(expanded.size(), 3000u);
+    EXPECT_EQ(expanded[2997].op, "Measure");
+    EXPECT_DOUBLE_EQ(expanded[2997].start_time, 999 * 15.0);
+}
+
+TEST(SchedulerTests, NestedRepeatTimelinesExpandInProgramOrder) {
+    HardwareConfig hw;
+    hw.positions = {0.0};
+    NativeGate x;
+    x.name = "X";
+    x.arity = 1;
+    x.duration_ns = 10.0;
+    hw.native_gates = {x};
+
+    // Repeat 3 { Repeat 2 { X } Wait 5 }, then X.
+    Program program;
+    program.push_back(Instruction{Op::AllocArray, 1});
+    program.push_back(Instruction{Op::Repeat, RepeatInstruction{3, 3}});
+    program.push_back(Instruction{Op::Repeat, RepeatInstruction{2, 1}});
+    program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
+    program.push_back(Instruction{Op::Wait, WaitInstruction{5.0}});
+    program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
+
+    const service::SchedulerResult scheduled = service::schedule_program(program, hw);
+    EXPECT_EQ(scheduled.timeline.size(), 3u);
+    ASSERT_EQ(scheduled.timeline_repeats.size(), 2u);
+    EXPECT_EQ(scheduled.timeline_repeats[0].count, 3);
+    EXPECT_EQ(scheduled.timeline_repeats[0].size, 2u);
+    EXPECT_EQ(scheduled.timeline_repeats[1].count, 2);
+
+    const auto expanded = service::expand_timeline(scheduled);
+    ASSERT_EQ(expanded.size(), 3u * 3u + 1u);
+    const std::vector<double> starts = {0, 10, 20, 25, 35, 45, 50, 60, 70, 75};
+    for (std::size_t idx = 0; idx < starts.size(); ++idx) {
+        EXPECT_DOUBLE_EQ(expanded[idx].start_time, starts[idx]) << "entry " << idx;
+    }
+    EXPECT_EQ(expanded[2].op, "Wait");
+    EXPECT_EQ(expanded[9].op, "ApplyGate");
+}
+
+TEST(SchedulerTests, RepeatCountsAreBounded) {
+    Program program;
+    program.push_back(Instruction{Op::AllocArray, 1});
+    program.push_back(Instruction{Op::Repeat, RepeatInstruction{1000, 2}});
+    program.push_back(Instruction{Op::Repeat, RepeatInstruction{100, 1}});
+    program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
+    EXPECT_NO_THROW(validate_repeat_blocks(program));
+
+    // The product of nested counts is what is bounded.
+    std::get<RepeatInstruction>(program[2].payload).count = 101;
+    EXPECT_THROW(validate_repeat_blocks(program), std::invalid_argument);
+    program[1].payload = RepeatInstruction{std::numeric_limits<int>::max(), 2};
+    EXPECT_THROW(validate_repeat_blocks(program), std::invalid_argument);
+}
+
+TEST(SchedulerTests, RepeatPeelsIterationsUntilTheScheduleSettles) {
+    HardwareConfig hw;
+    hw.positions = {0.0};
+    hw.timing_limits.measurement_cooldown_ns = 5.0;
+    NativeGate x;
+    x.name = "X";
+    x.arity = 1;
+    x.duration_ns = 10.0;
+    hw.native_gates = {x};
+
+    Program program;
+    program.push_back(Instruction{Op::AllocArray, 1});
+    program.push_back(Instruction{Op::Measure, std::vector<int>{0}});
+    program.push_back(Instruction{Op::Repeat, RepeatInstruction{3, 1}});
+    program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}, 0.5}});
+
+    service::SchedulerResult scheduled = service::schedule_program(program, hw);
+    // Only the first iteration waits out the cooldown of the earlier Measure.
+    ASSERT_EQ(scheduled.program.size(), 6u);
+    EXPECT_EQ(scheduled.program[2].op, Op::Wait);
+    EXPECT_EQ(scheduled.program[3].op, Op::ApplyGate);
+    ASSERT_EQ(scheduled.program[4].op, Op::Repeat);
+    EXPECT_EQ(std::get<RepeatInstruction>(scheduled.program[4].payload).count, 2);
+    EXPECT_EQ(scheduled.program[5].op, Op::ApplyGate);
+
+    service::rebind_gate_params(scheduled, {{3, 1.25}});
+    EXPECT_DOUBLE_EQ(std::get<Gate>(scheduled.program[3].payload).param, 1.25);
+    EXPECT_DOUBLE_EQ(std::get<Gate>(scheduled.program[5].payload).param, 1.25);
+    for (std::size_t idx = 0; idx < scheduled.timeline.size(); ++idx) {
+        if (scheduled.timeline_source_indices[idx] == 3u) {
+            EXPECT_NE(scheduled.timeline[idx].detail.find("param=1.25"), std::string::npos);
+        }
+    }
+}
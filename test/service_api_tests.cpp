@@ -1,8 +1,11 @@
 #include "hardware_vm.hpp"
 #include "service/job.hpp"
+#include "service/job_json.hpp"
+#include "service/result_cache.hpp"
 
 #include <gtest/gtest.h>
 
+#include <memory>
 #include <string>
 
 namespace {
@@ -17,7 +20,7 @@ TEST(ServiceApiTests, JobRequestJson) {
     cfg.positions = {0.0, 1.0};
     cfg.blockade_radius = 1.5;
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -74,6 +77,46 @@ TEST(ServiceApiTests, JobRunnerExecutesProgram) {
     EXPECT_EQ(result.measurements[0].bits, std::vector<int>({0, 1}));
 }
 
+TEST(ServiceApiTests, JobRunnerReportsStageProfile) {
+    service::JobRequest job;
+    job.job_id = "job-profile";
+    job.device_id = "state-vector";
+    job.hardware.positions = {0.0, 1.0, 2.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = 12;
+    job.seed = 5;
+    job.program = {
+        {Op::AllocArray, 3},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::Measure, std::vector<int>{0, 1, 2}},
+    };
+
+    service::JobRunner runner;
+    runner.set_result_cache(std::make_shared<service::ResultCache>(service::ResultCacheOptions{}));
+    const auto result = runner.run(job, 2);
+    ASSERT_EQ(result.status, service::JobStatus::Completed) << result.message;
+    const service::JobProfile& profile = result.profile;
+    EXPECT_EQ(profile.backend, "cpu");
+    EXPECT_FALSE(profile.cache_hit);
+    EXPECT_GT(profile.validate.wall_seconds, 0.0);
+    EXPECT_GT(profile.schedule.wall_seconds, 0.0);
+    EXPECT_GT(profile.simulate.wall_seconds, 0.0);
+    EXPECT_GT(profile.convert.wall_seconds, 0.0);
+    EXPECT_GT(profile.simulate.cpu_seconds, 0.0);
+    EXPECT_GT(profile.shots_per_second, 0.0);
+    // Two gates over 8 amplitudes per shot, one 3-qubit state per thread.
+    EXPECT_EQ(profile.amplitude_updates, 2u * 8u * 12u);
+    EXPECT_EQ(profile.threads, 2u);
+    EXPECT_EQ(profile.peak_statevector_bytes, 2u * 8u * sizeof(std::complex<double>));
+    EXPECT_NE(service::job_result_to_json(result).find("\"amplitude_updates\":192"), std::string::npos);
+
+    const auto cached = runner.run(job, 2);
+    EXPECT_TRUE(cached.profile.cache_hit);
+    EXPECT_EQ(cached.profile.amplitude_updates, 0u);
+    EXPECT_EQ(cached.profile.simulate.wall_seconds, 0.0);
+}
+
 TEST(ServiceApiTests, JobRunnerRejectsUnsupportedISAVersion) {
     service::JobRequest job;
     job.job_id = "job-unsupported-isa";
@@ -0,0 +1,251 @@
+#include "service/job_service.hpp"
+#include "service/scheduler.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+using service::BatchSubmission;
+using service::JobOverride;
+using service::JobRequest;
+using service::JobResult;
+using service::JobRunner;
+using service::JobService;
+using service::JobStatus;
+using service::ParameterSet;
+
+namespace {
+
+JobRequest make_sweep_base() {
+    JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.shots = 8;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+JobRequest make_parametric_base() {
+    JobRequest job = make_sweep_base();
+    std::get<Gate>(job.program[1].payload).symbol = "theta";
+    return job;
+}
+
+bool timeline_mentions(const JobResult& result, const std::string& text) {
+    for (const auto& entry : result.scheduler_timeline) {
+        if (entry.detail.find(text) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<JobResult> drain_batch(JobService& service, const std::string& batch_id) {
+    std::vector<JobResult> results;
+    for (int attempt = 0; attempt < 400; ++attempt) {
+        auto fresh = service.batch_results(batch_id, results.size());
+        results.insert(results.end(), fresh.begin(), fresh.end());
+        if (results.size() == service.batch_status(batch_id).total) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return results;
+}
+
+}  // namespace
+
+TEST(ServiceBatchTests, RebindGateParamsPatchesProgramAndTimeline) {
+    const JobRequest base = make_sweep_base();
+    auto scheduled = service::schedule_program(base.program, base.hardware);
+    ASSERT_EQ(scheduled.source_indices.size(), scheduled.program.size());
+    ASSERT_EQ(scheduled.timeline_source_indices.size(), scheduled.timeline.size());
+
+    service::rebind_gate_params(scheduled, {{1, 0.25}});
+    for (std::size_t idx = 0; idx < scheduled.program.size(); ++idx) {
+        if (scheduled.source_indices[idx] == 1) {
+            EXPECT_DOUBLE_EQ(std::get<Gate>(scheduled.program[idx].payload).param, 0.25);
+        }
+    }
+    bool found = false;
+    for (std::size_t idx = 0; idx < scheduled.timeline.size(); ++idx) {
+        if (scheduled.timeline_source_indices[idx] == 1) {
+            EXPECT_NE(scheduled.timeline[idx].detail.find("param=0.25"), std::string::npos);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+    EXPECT_THROW(service::rebind_gate_params(scheduled, {{3, 1.0}}), std::invalid_argument);
+}
+
+TEST(ServiceBatchTests, BindGateParamsLeavesSharedScheduleUntouched) {
+    const JobRequest base = make_sweep_base();
+    const auto scheduled = service::schedule_program(base.program, base.hardware);
+    const auto index = service::index_gate_params(scheduled);
+
+    auto program = scheduled.program;
+    const auto details = service::bind_gate_params(program, index, {{1, 0.25}});
+    ASSERT_FALSE(details.empty());
+    for (std::size_t idx = 0; idx < program.size(); ++idx) {
+        if (scheduled.source_indices[idx] == 1) {
+            EXPECT_DOUBLE_EQ(std::get<Gate>(program[idx].payload).param, 0.25);
+            EXPECT_NE(std::get<Gate>(scheduled.program[idx].payload).param, 0.25);
+        }
+    }
+    const auto timeline = service::expand_timeline(scheduled, details);
+    ASSERT_EQ(timeline.size(), scheduled.timeline.size());
+    for (const auto& [slot, detail] : details) {
+        EXPECT_EQ(timeline[slot].detail, detail);
+        EXPECT_NE(detail.find("param=0.25"), std::string::npos);
+        EXPECT_EQ(scheduled.timeline[slot].detail.find("param=0.25"), std::string::npos);
+    }
+}
+
+TEST(ServiceBatchTests, CompiledJobMatchesDirectRun) {
+    JobRequest job = make_sweep_base();
+    job.seed = 11;
+    JobRunner runner;
+    const auto compiled = runner.compile(job);
+    const auto executed = runner.execute(compiled, job);
+    const auto direct = runner.run(job);
+    ASSERT_EQ(executed.status, JobStatus::Completed);
+    ASSERT_EQ(executed.measurements.size(), direct.measurements.size());
+    for (std::size_t idx = 0; idx < direct.measurements.size(); ++idx) {
+        EXPECT_EQ(executed.measurements[idx].bits, direct.measurements[idx].bits);
+    }
+    EXPECT_EQ(executed.scheduler_timeline, direct.scheduler_timeline);
+}
+
+TEST(ServiceBatchTests, SweepRunsEachOverrideAsItsOwnJob) {
+    JobService service;
+    std::vector<JobOverride> items(3);
+    items[0].seed = 1;
+    items[1].seed = 2;
+    items[1].shots = 4;
+    items[2].seed = 1;
+    items[2].gate_params = {{1, 0.5}};
+
+    const BatchSubmission batch = service.submit_batch(make_sweep_base(), items, 1);
+    ASSERT_EQ(batch.job_ids.size(), 3u);
+
+    const auto results = drain_batch(service, batch.batch_id);
+    ASSERT_EQ(results.size(), 3u);
+    const auto status = service.batch_status(batch.batch_id);
+    EXPECT_EQ(status.finished, 3u);
+    EXPECT_EQ(status.failed, 0u);
+
+    std::map<std::string, JobResult> by_id;
+    for (const auto& result : results) {
+        EXPECT_EQ(result.status, JobStatus::Completed);
+        by_id[result.job_id] = result;
+    }
+    EXPECT_EQ(by_id.at(batch.job_ids[0]).measurements.size(), 8u);
+    EXPECT_EQ(by_id.at(batch.job_ids[1]).measurements.size(), 4u);
+    // Seed 1 twice: identical shots regardless of the rebound parameter.
+    const auto& first = by_id.at(batch.job_ids[0]).measurements;
+    const auto& third = by_id.at(batch.job_ids[2]).measurements;
+    ASSERT_EQ(first.size(), third.size());
+    for (std::size_t idx = 0; idx < first.size(); ++idx) {
+        EXPECT_EQ(first[idx].bits, third[idx].bits);
+    }
+    bool rebound = false;
+    for (const auto& entry : by_id.at(batch.job_ids[2]).scheduler_timeline) {
+        rebound = rebound || entry.detail.find("param=0.5") != std::string::npos;
+    }
+    EXPECT_TRUE(rebound);
+
+    auto single = service.poll_result(batch.job_ids[1]);
+    ASSERT_TRUE(single.has_value());
+    EXPECT_EQ(single->measurements.size(), 4u);
+}
+
+TEST(ServiceBatchTests, InvalidBaseFailsEveryItem) {
+    JobService service;
+    JobRequest base = make_sweep_base();
+    base.program.push_back({Op::ApplyGate, Gate{"X", {7}}});
+    const BatchSubmission batch = service.submit_batch(base, std::vector<JobOverride>(2), 1);
+
+    const auto results = drain_batch(service, batch.batch_id);
+    ASSERT_EQ(results.size(), 2u);
+    for (const auto& result : results) {
+        EXPECT_EQ(result.status, JobStatus::Failed);
+        EXPECT_FALSE(result.message.empty());
+    }
+    EXPECT_EQ(service.batch_status(batch.batch_id).failed, 2u);
+}
+
+TEST(ServiceBatchTests, RejectsOverridesThatDoNotFitTheProgram) {
+    JobService service;
+    std::vector<JobOverride> items(1);
+    items[0].gate_params = {{0, 1.0}};
+    EXPECT_THROW(service.submit_batch(make_sweep_base(), items), std::invalid_argument);
+}
+
+TEST(ServiceBatchTests, ParameterBindingsResolveSymbolsByName) {
+    const JobRequest base = make_parametric_base();
+    const auto bindings = service::parameter_bindings(base.program, {{"theta", 0.5}});
+    ASSERT_EQ(bindings.size(), 1u);
+    EXPECT_EQ(bindings[0].instruction_index, 1u);
+    EXPECT_DOUBLE_EQ(bindings[0].param, 0.5);
+    EXPECT_THROW(service::parameter_bindings(base.program, {}), std::invalid_argument);
+    EXPECT_THROW(
+        service::parameter_bindings(base.program, {{"theta", 0.5}, {"phi", 1.0}}),
+        std::invalid_argument);
+
+    JobOverride item;
+    item.parameters = {{"theta", 0.125}};
+    const JobRequest bound = service::apply_override(base, item);
+    const auto& gate = std::get<Gate>(bound.program[1].payload);
+    EXPECT_TRUE(gate.symbol.empty());
+    EXPECT_DOUBLE_EQ(gate.param, 0.125);
+    EXPECT_TRUE(bound.parameters.empty());
+}
+
+TEST(ServiceBatchTests, RunnerBindsTheRequestParameterTable) {
+    JobRunner runner;
+    JobRequest job = make_parametric_base();
+    job.parameters = {{"theta", 0.375}};
+    const JobResult result = runner.run(job);
+    ASSERT_EQ(result.status, JobStatus::Completed);
+    EXPECT_TRUE(timeline_mentions(result, "param=0.375"));
+
+    job.parameters.clear();
+    const JobResult unbound = runner.run(job);
+    EXPECT_EQ(unbound.status, JobStatus::Failed);
+    EXPECT_NE(unbound.message.find("theta"), std::string::npos);
+}
+
+TEST(ServiceBatchTests, SweepCompilesOnceAndBindsEachParameterSet) {
+    JobService service;
+    JobRequest base = make_parametric_base();
+    base.seed = 5;
+    const std::vector<ParameterSet> sets = {{{"theta", 0.1}}, {{"theta", 0.2}}, {{"theta", 0.3}}};
+    const BatchSubmission batch = service.submit_sweep(base, sets, 1);
+    ASSERT_EQ(batch.job_ids.size(), 3u);
+
+    const auto results = drain_batch(service, batch.batch_id);
+    ASSERT_EQ(results.size(), 3u);
+    std::map<std::string, JobResult> by_id;
+    for (const auto& result : results) {
+        EXPECT_EQ(result.status, JobStatus::Completed);
+        by_id[result.job_id] = result;
+    }
+    EXPECT_TRUE(timeline_mentions(by_id.at(batch.job_ids[0]), "param=0.1"));
+    EXPECT_TRUE(timeline_mentions(by_id.at(batch.job_ids[1]), "param=0.2"));
+    EXPECT_TRUE(timeline_mentions(by_id.at(batch.job_ids[2]), "param=0.3"));
+    EXPECT_FALSE(timeline_mentions(by_id.at(batch.job_ids[2]), "param=theta"));
+
+    EXPECT_THROW(service.submit_sweep(base, {ParameterSet{}}), std::invalid_argument);
+    EXPECT_THROW(service.submit_sweep(make_sweep_base(), {{{"theta", 0.1}}}), std::invalid_argument);
+}
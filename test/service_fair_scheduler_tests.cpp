@@ -0,0 +1,360 @@
+#include "service/fair_scheduler.hpp"
+#include "service/job_service.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using service::FairShareOptions;
+using service::FairShareScheduler;
+using service::JobRequest;
+using service::JobService;
+using service::QuotaExceeded;
+using service::ScheduledJob;
+using service::TenantPolicy;
+using service::WorkPlan;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Records the tenant of every batch in dispatch order.
+class BatchLog {
+  public:
+    void add(const std::string& tenant) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        order_.push_back(tenant);
+    }
+    std::vector<std::string> order() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order_;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> order_;
+};
+
+ScheduledJob make_work(
+    const std::string& tenant,
+    std::size_t shots,
+    BatchLog* log,
+    std::promise<void>* done = nullptr,
+    std::shared_future<void> gate = {},
+    std::atomic<int>* planned = nullptr
+) {
+    ScheduledJob work;
+    work.tenant = tenant;
+    work.plan = [shots, planned]() {
+        if (planned) {
+            planned->fetch_add(1);
+        }
+        return WorkPlan{shots, 0, 1.0};
+    };
+    work.run_batch = [tenant, log, gate](std::size_t, std::size_t) {
+        if (gate.valid()) {
+            gate.wait();
+        }
+        if (log) {
+            log->add(tenant);
+        }
+    };
+    work.complete = [done]() {
+        if (done) {
+            done->set_value();
+        }
+    };
+    return work;
+}
+
+FairShareOptions single_worker(std::size_t shots_per_batch) {
+    FairShareOptions options;
+    options.worker_threads = 1;
+    options.shots_per_batch = shots_per_batch;
+    return options;
+}
+
+JobRequest make_bell_job(int shots, const std::string& tenant) {
+    JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.metadata["tenant"] = tenant;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+// Plans run in their own stage; wait until `count` jobs have been planned.
+void wait_for_plans(const std::atomic<int>& planned, int count) {
+    while (planned.load() < count) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+service::JobResult wait_for_result(const JobService& service, const std::string& job_id) {
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        if (auto result = service.poll_result(job_id)) {
+            return *result;
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    ADD_FAILURE() << "job " << job_id << " did not finish";
+    return {};
+}
+
+}  // namespace
+
+TEST(FairShareSchedulerTests, SmallJobOvertakesLongJobOfAnotherTenant) {
+    BatchLog log;
+    std::promise<void> release;
+    std::promise<void> bulk_done;
+    std::promise<void> interactive_done;
+    FairShareScheduler scheduler(single_worker(1));
+
+    scheduler.submit(make_work("bulk", 6, &log, &bulk_done, release.get_future().share()));
+    // Let the bulk job occupy the only worker before the small job arrives.
+    while (scheduler.stats("bulk").virtual_time == 0.0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::atomic<int> planned{0};
+    scheduler.submit(make_work("interactive", 1, &log, &interactive_done, {}, &planned));
+    wait_for_plans(planned, 1);
+    release.set_value();
+    interactive_done.get_future().wait();
+    bulk_done.get_future().wait();
+
+    const auto order = log.order();
+    ASSERT_EQ(order.size(), 7u);
+    // The small job runs right after the bulk batch that was in flight.
+    EXPECT_EQ(order[0], "bulk");
+    EXPECT_EQ(order[1], "interactive");
+}
+
+TEST(FairShareSchedulerTests, SharesWorkersInProportionToWeight) {
+    BatchLog log;
+    std::promise<void> release;
+    std::promise<void> heavy_done;
+    std::promise<void> light_done;
+    FairShareScheduler scheduler(single_worker(1));
+    scheduler.set_policy("heavy", TenantPolicy{3.0, 0, 0, 0});
+    scheduler.set_policy("light", TenantPolicy{1.0, 0, 0, 0});
+
+    // Hold the worker so both tenants are queued before dispatch starts.
+    scheduler.submit(make_work("gate", 1, nullptr, nullptr, release.get_future().share()));
+    std::atomic<int> planned{0};
+    scheduler.submit(make_work("heavy", 8, &log, &heavy_done, {}, &planned));
+    scheduler.submit(make_work("light", 8, &log, &light_done, {}, &planned));
+    wait_for_plans(planned, 2);
+    release.set_value();
+    heavy_done.get_future().wait();
+    light_done.get_future().wait();
+
+    const auto order = log.order();
+    ASSERT_EQ(order.size(), 16u);
+    const auto heavy_first = std::count(order.begin(), order.begin() + 8, std::string("heavy"));
+    EXPECT_EQ(heavy_first, 6);
+}
+
+TEST(FairShareSchedulerTests, EnforcesTenantThreadCap) {
+    FairShareOptions options;
+    options.worker_threads = 3;
+    options.shots_per_batch = 1;
+    FairShareScheduler scheduler(options);
+    scheduler.set_policy("capped", TenantPolicy{1.0, 1, 0, 0});
+
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::promise<void> done;
+    ScheduledJob work;
+    work.tenant = "capped";
+    work.plan = []() { return WorkPlan{6, 0, 1.0}; };
+    work.run_batch = [&](std::size_t, std::size_t) {
+        const int now = running.fetch_add(1) + 1;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(2ms);
+        running.fetch_sub(1);
+    };
+    work.complete = [&]() { done.set_value(); };
+    scheduler.submit(std::move(work));
+    done.get_future().wait();
+    EXPECT_EQ(peak.load(), 1);
+}
+
+TEST(FairShareSchedulerTests, SplitsSmallJobAcrossItsWorkers) {
+    FairShareOptions options;
+    options.worker_threads = 4;
+    options.shots_per_batch = 64;
+    FairShareScheduler scheduler(options);
+
+    const auto batch_sizes = [&scheduler](std::size_t shots, std::size_t max_parallel) {
+        std::mutex mutex;
+        std::vector<std::size_t> sizes;
+        std::promise<void> done;
+        ScheduledJob work;
+        work.tenant = "solo";
+        work.max_parallel = max_parallel;
+        work.plan = [shots]() { return WorkPlan{shots, 0, 1.0}; };
+        work.run_batch = [&](std::size_t, std::size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sizes.push_back(count);
+        };
+        work.complete = [&]() { done.set_value(); };
+        scheduler.submit(std::move(work));
+        done.get_future().wait();
+        std::sort(sizes.begin(), sizes.end());
+        return sizes;
+    };
+
+    // One batch per worker instead of a single 64-shot batch.
+    EXPECT_EQ(batch_sizes(64, 0), (std::vector<std::size_t>{16, 16, 16, 16}));
+    EXPECT_EQ(batch_sizes(64, 2), (std::vector<std::size_t>{32, 32}));
+    // Large jobs keep the configured batch size.
+    EXPECT_EQ(batch_sizes(512, 0), std::vector<std::size_t>(8, 64));
+    EXPECT_EQ(batch_sizes(3, 0), (std::vector<std::size_t>{1, 1, 1}));
+}
+
+TEST(FairShareSchedulerTests, RejectsSubmissionsOverQueuedJobQuota) {
+    std::promise<void> release;
+    std::promise<void> done;
+    FairShareScheduler scheduler(single_worker(1));
+    scheduler.set_policy("tenant", TenantPolicy{1.0, 0, 0, 1});
+
+    scheduler.submit(make_work("tenant", 1, nullptr, &done, release.get_future().share()));
+    EXPECT_THROW(scheduler.submit(make_work("tenant", 1, nullptr)), QuotaExceeded);
+    // Other tenants are unaffected.
+    std::promise<void> other_done;
+    scheduler.submit(make_work("other", 1, nullptr, &other_done));
+    release.set_value();
+    done.get_future().wait();
+    other_done.get_future().wait();
+    EXPECT_EQ(scheduler.stats("tenant").queued_jobs, 0u);
+}
+
+TEST(FairShareSchedulerTests, NeverRunsBatchesOverMemoryCap) {
+    FairShareScheduler scheduler(single_worker(1));
+    scheduler.set_policy("small", TenantPolicy{1.0, 0, 16, 0});
+
+    std::atomic<int> batches{0};
+    std::promise<void> done;
+    ScheduledJob work;
+    work.tenant = "small";
+    work.plan = []() { return WorkPlan{4, 64, 1.0}; };
+    work.run_batch = [&](std::size_t, std::size_t) { batches.fetch_add(1); };
+    work.complete = [&]() { done.set_value(); };
+    scheduler.submit(std::move(work));
+    done.get_future().wait();
+    EXPECT_EQ(batches.load(), 0);
+    EXPECT_EQ(scheduler.stats("small").queued_jobs, 0u);
+}
+
+TEST(FairShareSchedulerTests, JobServiceRejectsBatchOverQuota) {
+    JobService service;
+    TenantPolicy policy;
+    policy.max_queued_jobs = 1;
+    service.set_tenant_policy("team-a", policy);
+
+    const auto base = make_bell_job(4, "team-a");
+    EXPECT_THROW(service.submit_batch(base, {{}, {}}), QuotaExceeded);
+    EXPECT_EQ(service.job_metrics()->rejected_jobs.value(), 2u);
+    EXPECT_EQ(service.job_metrics()->queued_jobs.value(), 0);
+    EXPECT_EQ(service.status("job-0").message, "job_id not found");
+}
+
+TEST(FairShareSchedulerTests, JobServiceFailsJobsOverMemoryQuota) {
+    JobService service;
+    TenantPolicy policy;
+    policy.max_memory_bytes = 16;  // a 2-qubit statevector needs 64 bytes
+    service.set_tenant_policy("small", policy);
+
+    const auto result = wait_for_result(service, service.submit(make_bell_job(4, "small")));
+    EXPECT_EQ(result.status, service::JobStatus::Failed);
+    EXPECT_NE(result.message.find("memory quota"), std::string::npos);
+}
+
+TEST(FairShareSchedulerTests, SeededResultsDoNotDependOnBatching) {
+    FairShareOptions options;
+    options.worker_threads = 2;
+    options.shots_per_batch = 3;
+    JobService service(options);
+    auto job = make_bell_job(10, "team-a");
+    job.seed = 1234;
+
+    const auto batched = wait_for_result(service, service.submit(job));
+    ASSERT_EQ(batched.status, service::JobStatus::Completed);
+
+    service::JobRunner runner;
+    const auto direct = runner.run(job, 1);
+    ASSERT_EQ(batched.measurements.size(), direct.measurements.size());
+    for (std::size_t idx = 0; idx < direct.measurements.size(); ++idx) {
+        EXPECT_EQ(batched.measurements[idx].bits, direct.measurements[idx].bits);
+    }
+}
+
+TEST(FairShareSchedulerTests, PlansNextJobWhileWorkerSimulates) {
+    FairShareScheduler scheduler(single_worker(4));
+    std::promise<void> second_planned;
+    std::promise<void> first_done;
+    std::promise<void> second_done;
+    auto planned = second_planned.get_future().share();
+
+    // The only worker stays in the first job until the second is compiled,
+    // which only the prepare stage can do meanwhile.
+    ScheduledJob first;
+    first.tenant = "a";
+    first.plan = []() { return WorkPlan{4, 0, 1.0}; };
+    first.run_batch = [planned](std::size_t, std::size_t) { planned.wait(); };
+    first.complete = [&first_done]() { first_done.set_value(); };
+    scheduler.submit(std::move(first));
+
+    ScheduledJob second;
+    second.tenant = "a";
+    second.plan = [&second_planned]() {
+        second_planned.set_value();
+        return WorkPlan{4, 0, 1.0};
+    };
+    second.run_batch = [](std::size_t, std::size_t) {};
+    second.complete = [&second_done]() { second_done.set_value(); };
+    scheduler.submit(std::move(second));
+
+    EXPECT_EQ(first_done.get_future().wait_for(10s), std::future_status::ready);
+    EXPECT_EQ(second_done.get_future().wait_for(10s), std::future_status::ready);
+}
+
+TEST(FairShareSchedulerTests, CompletesJobsOffTheWorkers) {
+    FairShareScheduler scheduler(single_worker(4));
+    std::promise<void> second_ran;
+    std::promise<void> first_done;
+    auto ran = second_ran.get_future().share();
+
+    // Completing the first job waits for a batch of the second one, so it
+    // must not occupy the only worker.
+    ScheduledJob first = make_work("a", 4, nullptr);
+    first.complete = [ran, &first_done]() {
+        ran.wait();
+        first_done.set_value();
+    };
+    scheduler.submit(std::move(first));
+    ScheduledJob second = make_work("a", 4, nullptr);
+    second.run_batch = [&second_ran](std::size_t, std::size_t) { second_ran.set_value(); };
+    scheduler.submit(std::move(second));
+
+    EXPECT_EQ(first_done.get_future().wait_for(10s), std::future_status::ready);
+}
@@ -0,0 +1,627 @@
+#include "service/http_server.hpp"
+#include "service/job_codec.hpp"
+#include "service/job_http_service.hpp"
+#include "service/job_journal.hpp"
+#include "service/job_json.hpp"
+#include "service/job_service.hpp"
+#include "service/json.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using service::HttpServer;
+using service::JobHttpService;
+using service::JobRequest;
+using service::JobService;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+JobRequest make_bell_job(int shots) {
+    JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    job.seed = 7;
+    return job;
+}
+
+const char* kBellJobJson = R"({
+    "job_id": "ignored",
+    "device_id": "state-vector",
+    "profile": "ideal_small_array",
+    "shots": 4,
+    "seed": 11,
+    "hardware": {"positions": [0.0, 1.0], "blockade_radius": 1.5},
+    "program": [
+        {"op": "AllocArray", "n_qubits": 2},
+        {"op": "ApplyGate", "name": "H", "targets": [0], "param": 0.0},
+        {"op": "ApplyGate", "name": "CX", "targets": [0, 1], "param": 0.0},
+        {"op": "Measure", "targets": [0, 1]}
+    ]
+})";
+
+struct Response {
+    int status = 0;
+    std::map<std::string, std::string> headers;
+    std::string body;
+};
+
+// Blocking loopback client that reads one response at a time so tests can
+// reuse a connection across requests.
+class Client {
+  public:
+    explicit Client(std::uint16_t port) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connected_ = ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+    ~Client() { ::close(fd_); }
+
+    bool connected() const { return connected_; }
+
+    void send_raw(const std::string& data) {
+        ASSERT_EQ(::send(fd_, data.data(), data.size(), MSG_NOSIGNAL),
+            static_cast<ssize_t>(data.size()));
+    }
+
+    void send_request(
+        const std::string& method,
+        const std::string& path,
+        const std::string& body = {},
+        const std::string& extra_headers = {}
+    ) {
+        std::ostringstream out;
+        out << method << " " << path << " HTTP/1.1\r\nHost: localhost\r\n" << extra_headers;
+        if (!body.empty()) {
+            out << "Content-Length: " << body.size() << "\r\n";
+        }
+        out << "\r\n" << body;
+        send_raw(out.str());
+    }
+
+    // Read one response; returns status 0 if the server closed first.
+    Response read_response() {
+        Response response;
+        std::size_t head_end;
+        while ((head_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) {
+                return response;
+            }
+        }
+        std::istringstream head(buffer_.substr(0, head_end));
+        buffer_.erase(0, head_end + 4);
+        std::string line;
+        std::getline(head, line);
+        response.status = std::stoi(line.substr(9, 3));
+        while (std::getline(head, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            const auto colon = line.find(':');
+            std::string name = line.substr(0, colon);
+            for (auto& ch : name) {
+                ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+            }
+            response.headers[name] = line.substr(colon + 2);
+        }
+        if (response.headers.count("content-length")) {
+            response.body = take(std::stoul(response.headers["content-length"]));
+        } else if (response.headers["transfer-encoding"] == "chunked") {
+            while (true) {
+                std::size_t line_end;
+                while ((line_end = buffer_.find("\r\n")) == std::string::npos) {
+                    if (!fill()) {
+                        return response;
+                    }
+                }
+                const std::size_t size = std::stoul(buffer_.substr(0, line_end), nullptr, 16);
+                buffer_.erase(0, line_end + 2);
+                std::string chunk = take(size + 2);
+                if (size == 0) {
+                    break;
+                }
+                response.body += chunk.substr(0, size);
+            }
+        }
+        return response;
+    }
+
+    // Half-close: tell the server no more requests follow.
+    void shutdown_write() { ::shutdown(fd_, SHUT_WR); }
+
+    // True once the server has closed its side of the connection.
+    bool closed_by_peer() {
+        char byte;
+        return buffer_.empty() && ::recv(fd_, &byte, 1, 0) == 0;
+    }
+
+  private:
+    bool fill() {
+        char chunk[4096];
+        const ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer_.append(chunk, static_cast<std::size_t>(received));
+        return true;
+    }
+
+    std::string take(std::size_t count) {
+        while (buffer_.size() < count && fill()) {
+        }
+        std::string out = buffer_.substr(0, count);
+        buffer_.erase(0, std::min(count, buffer_.size()));
+        return out;
+    }
+
+    int fd_ = -1;
+    bool connected_ = false;
+    std::string buffer_;
+};
+
+class HttpJobServerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        service::JobHttpOptions options;
+        options.devices_json = R"({"devices":[]})";
+        api_ = std::make_unique<JobHttpService>(jobs_, options);
+        server_ = std::make_unique<HttpServer>(
+            service::HttpServerOptions{}, [this](const service::HttpRequest& request) {
+                return api_->handle(request);
+            });
+        server_->start();
+    }
+
+    void TearDown() override { server_->stop(); }
+
+    std::string submit_json(Client& client, const std::string& body) {
+        client.send_request("POST", "/job", body, "Content-Type: application/json\r\n");
+        const Response response = client.read_response();
+        EXPECT_EQ(response.status, 200) << response.body;
+        return service::parse_json(response.body).find("job_id")->as_string();
+    }
+
+    Response wait_for_result(Client& client, const std::string& job_id, const std::string& headers = {}) {
+        for (int attempt = 0; attempt < 500; ++attempt) {
+            client.send_request("GET", "/job/" + job_id + "/result", {}, headers);
+            Response response = client.read_response();
+            if (response.status != 404) {
+                return response;
+            }
+            std::this_thread::sleep_for(10ms);
+        }
+        return {};
+    }
+
+    JobService jobs_;
+    std::unique_ptr<JobHttpService> api_;
+    std::unique_ptr<HttpServer> server_;
+};
+
+}  // namespace
+
+TEST(HttpCodecTests, JsonParserHandlesEscapesAndLargeIntegers) {
+    const auto doc = service::parse_json(
+        R"({"text": "a\"bé😀", "seed": 18446744073709551615, "list": [1, -2.5e1, true, null]})");
+    EXPECT_EQ(doc.find("text")->as_string(), "a\"b\xc3\xa9\xf0\x9f\x98\x80");
+    EXPECT_EQ(doc.find("seed")->as_uint64(), 18446744073709551615ULL);
+    const auto& list = doc.find("list")->as_array();
+    ASSERT_EQ(list.size(), 4u);
+    EXPECT_DOUBLE_EQ(list[1].as_double(), -25.0);
+    EXPECT_TRUE(list[2].as_bool());
+    EXPECT_TRUE(list[3].is_null());
+    EXPECT_THROW(service::parse_json("{\"a\": [1, 2}"), std::runtime_error);
+    EXPECT_THROW(service::parse_json("{} trailing"), std::runtime_error);
+}
+
+TEST(HttpCodecTests, JobJsonFlattensNestedRepeatBlocks) {
+    const JobRequest job = service::job_request_from_json(R"({
+        "program": [
+            {"op": "AllocArray", "n_qubits": 2},
+            {"op": "Repeat", "count": 4, "body": [
+                {"op": "ApplyGate", "name": "H", "targets": [0]},
+                {"op": "Repeat", "count": 2, "body": [{"op": "Measure", "targets": [0]}]}
+            ]},
+            {"op": "Repeat", "count": 3, "body_size": 1},
+            {"op": "Wait", "duration": 1.0}
+        ]
+    })");
+    ASSERT_EQ(job.program.size(), 7u);
+    EXPECT_EQ(std::get<RepeatInstruction>(job.program[1].payload).count, 4);
+    EXPECT_EQ(std::get<RepeatInstruction>(job.program[1].payload).body_size, 3);
+    EXPECT_EQ(std::get<RepeatInstruction>(job.program[3].payload).body_size, 1);
+    EXPECT_EQ(std::get<RepeatInstruction>(job.program[5].payload).count, 3);
+    EXPECT_EQ(job.program[6].op, Op::Wait);
+}
+
+TEST(HttpCodecTests, JobJsonReadsSymbolicGateParameters) {
+    const JobRequest job = service::job_request_from_json(R"({
+        "program": [
+            {"op": "AllocArray", "n_qubits": 1},
+            {"op": "ApplyGate", "name": "H", "targets": [0], "param": "theta"},
+            {"op": "ApplyGate", "name": "H", "targets": [0], "param": 0.5}
+        ],
+        "parameters": {"theta": 0.25}
+    })");
+    const auto& symbolic = std::get<Gate>(job.program[1].payload);
+    EXPECT_EQ(symbolic.symbol, "theta");
+    EXPECT_TRUE(std::get<Gate>(job.program[2].payload).symbol.empty());
+    EXPECT_DOUBLE_EQ(std::get<Gate>(job.program[2].payload).param, 0.5);
+    EXPECT_EQ(job.parameters, (service::ParameterSet{{"theta", 0.25}}));
+
+    // to_json nests the gate and keeps the symbol and the table.
+    const JobRequest reparsed = service::job_request_from_json(service::to_json(job));
+    EXPECT_EQ(std::get<Gate>(reparsed.program[1].payload).symbol, "theta");
+    EXPECT_EQ(reparsed.parameters, job.parameters);
+}
+
+TEST(HttpCodecTests, JobRequestBinaryCodecRoundTrips) {
+    JobRequest job = make_bell_job(16);
+    job.job_id = "job-codec";
+    job.metadata["tenant"] = "lab";
+    job.hardware.sites = {{0, 0.0, 0.0, 0.0, 0}, {1, 1.0, 0.0, 0.0, 1}};
+    job.hardware.site_ids = {0, 1};
+    job.hardware.native_gates = {{"CX", 2, 500.0, 0.0, 0.0, ConnectivityKind::NearestNeighborChain}};
+    job.hardware.timing_limits.max_parallel_two_qubit = 3;
+    job.program.push_back({Op::Wait, WaitInstruction{25.0}});
+    job.program.push_back({Op::MoveAtom, MoveAtomInstruction{1, 2.5}});
+    job.program.push_back({Op::Repeat, RepeatInstruction{8, 1}});
+    job.program.push_back({Op::Wait, WaitInstruction{5.0}});
+    job.program.push_back({Op::ApplyGate, Gate{"H", {1}, 0.0, "theta"}});
+    job.program.push_measure(std::vector<int>{0, 1, 0, 1, 0, 1, 0, 1, 0, 1});
+    job.parameters["theta"] = 0.75;
+    SimpleNoiseConfig noise;
+    noise.p_loss = 0.01;
+    noise.correlated_gate.matrix[5] = 0.002;
+    noise.loss_runtime.idle_rate = 3.0;
+    job.noise_config = noise;
+
+    const JobRequest decoded = service::decode_job_request(service::encode_job_request(job));
+    EXPECT_EQ(decoded.job_id, job.job_id);
+    EXPECT_EQ(decoded.shots, 16);
+    EXPECT_EQ(decoded.seed, job.seed);
+    EXPECT_EQ(decoded.metadata, job.metadata);
+    ASSERT_EQ(decoded.program.size(), job.program.size());
+    EXPECT_EQ(std::get<Gate>(decoded.program[2].payload).targets, (std::vector<int>{0, 1}));
+    EXPECT_DOUBLE_EQ(std::get<MoveAtomInstruction>(decoded.program[5].payload).position, 2.5);
+    EXPECT_EQ(std::get<RepeatInstruction>(decoded.program[6].payload).count, 8);
+    EXPECT_EQ(std::get<RepeatInstruction>(decoded.program[6].payload).body_size, 1);
+    EXPECT_EQ(std::get<Gate>(decoded.program[8].payload).symbol, "theta");
+    EXPECT_EQ(decoded.program.targets(decoded.program[9]).size(), 10u);
+    EXPECT_EQ(decoded.parameters, job.parameters);
+    EXPECT_EQ(decoded.hardware.sites.size(), 2u);
+    EXPECT_EQ(decoded.hardware.native_gates[0].connectivity, ConnectivityKind::NearestNeighborChain);
+    EXPECT_EQ(decoded.hardware.timing_limits.max_parallel_two_qubit, 3);
+    ASSERT_TRUE(decoded.noise_config.has_value());
+    EXPECT_DOUBLE_EQ(decoded.noise_config->correlated_gate.matrix[5], 0.002);
+    EXPECT_DOUBLE_EQ(decoded.noise_config->loss_runtime.idle_rate, 3.0);
+    // Re-encoding is byte-identical, so the codec is lossless.
+    EXPECT_EQ(service::encode_job_request(decoded), service::encode_job_request(job));
+
+    std::string truncated = service::encode_job_request(job);
+    truncated.resize(truncated.size() / 2);
+    EXPECT_THROW(service::decode_job_request(truncated), std::runtime_error);
+}
+
+TEST_F(HttpJobServerTest, KeepAliveServesPipelinedRequestsInOrder) {
+    Client client(server_->port());
+    ASSERT_TRUE(client.connected());
+    client.send_raw(
+        "GET /healthz HTTP/1.1\r\n\r\n"
+        "GET /devices HTTP/1.1\r\n\r\n");
+    const Response health = client.read_response();
+    const Response devices = client.read_response();
+    EXPECT_EQ(health.status, 200);
+    EXPECT_EQ(health.headers.at("connection"), "keep-alive");
+    EXPECT_EQ(health.body, R"({"status":"ok"})");
+    EXPECT_EQ(devices.status, 200);
+    EXPECT_EQ(devices.body, R"({"devices":[]})");
+
+    client.send_request("GET", "/healthz", {}, "Connection: close\r\n");
+    EXPECT_EQ(client.read_response().status, 200);
+    EXPECT_TRUE(client.closed_by_peer());
+}
+
+TEST_F(HttpJobServerTest, AnswersBufferedRequestsAfterClientHalfClose) {
+    Client client(server_->port());
+    client.send_raw(
+        "GET /healthz HTTP/1.1\r\n\r\n"
+        "GET /devices HTTP/1.1\r\n\r\n"
+        "GET /hea");
+    client.shutdown_write();
+    const Response health = client.read_response();
+    const Response devices = client.read_response();
+    EXPECT_EQ(health.status, 200);
+    EXPECT_EQ(devices.status, 200);
+    // The truncated third request is dropped and the connection closed.
+    EXPECT_TRUE(client.closed_by_peer());
+
+    // A streamed response in flight is finished before the close as well.
+    const std::string job_id = jobs_.submit(make_bell_job(64));
+    Client streaming(server_->port());
+    streaming.send_request("GET", "/job/" + job_id + "/stream");
+    streaming.shutdown_write();
+    const Response stream = streaming.read_response();
+    EXPECT_EQ(stream.status, 200);
+    EXPECT_TRUE(streaming.closed_by_peer());
+}
+
+TEST(HttpServerTests, DeferredReplyHoldsPipelinedRequests) {
+    std::vector<std::thread> completers;
+    HttpServer server(service::HttpServerOptions{}, [&completers](const service::HttpRequest& request) {
+        service::HttpReply reply;
+        if (request.path != "/slow") {
+            reply.response.body = R"({"fast":true})";
+            return reply;
+        }
+        reply.deferred = [&completers](service::ReplyCompletion complete) {
+            completers.emplace_back([complete]() {
+                std::this_thread::sleep_for(20ms);
+                service::HttpResponse response;
+                response.status = 202;
+                response.body = R"({"slow":true})";
+                complete(response);
+            });
+        };
+        return reply;
+    });
+    server.start();
+    {
+        Client client(server.port());
+        client.send_raw(
+            "GET /slow HTTP/1.1\r\n\r\n"
+            "GET /fast HTTP/1.1\r\n\r\n");
+        const Response slow = client.read_response();
+        const Response fast = client.read_response();
+        EXPECT_EQ(slow.status, 202);
+        EXPECT_EQ(slow.body, R"({"slow":true})");
+        EXPECT_EQ(fast.body, R"({"fast":true})");
+    }
+    server.stop();
+    for (auto& thread : completers) {
+        thread.join();
+    }
+}
+
+TEST(HttpServerTests, SubmitRepliesOnceTheJournalHasSynced) {
+    const auto dir = std::filesystem::temp_directory_path() / "na_vm_http_journal";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    service::JobJournalOptions journal_options;
+    journal_options.path = (dir / "jobs.journal").string();
+    journal_options.sync_interval = 20ms;
+    auto journal = std::make_shared<service::JobJournal>(journal_options);
+
+    JobService jobs;
+    jobs.attach_journal(journal);
+    JobHttpService api(jobs);
+    HttpServer server(service::HttpServerOptions{}, [&api](const service::HttpRequest& request) {
+        return api.handle(request);
+    });
+    server.start();
+    {
+        Client client(server.port());
+        client.send_request("POST", "/job", kBellJobJson, "Content-Type: application/json\r\n");
+        // Served while the submission waits for its sync.
+        Client other(server.port());
+        other.send_request("GET", "/healthz");
+        EXPECT_EQ(other.read_response().status, 200);
+
+        const Response submitted = client.read_response();
+        ASSERT_EQ(submitted.status, 200) << submitted.body;
+        EXPECT_GE(journal->stats().syncs, 1u);
+        const std::string job_id = service::parse_json(submitted.body).find("job_id")->as_string();
+        EXPECT_NE(jobs.status(job_id).status, service::JobStatus::Failed);
+    }
+    server.stop();
+}
+
+TEST_F(HttpJobServerTest, SubmitsJsonJobAndReturnsJsonOrBinaryResult) {
+    Client client(server_->port());
+    const std::string job_id = submit_json(client, kBellJobJson);
+
+    const Response json = wait_for_result(client, job_id);
+    ASSERT_EQ(json.status, 200);
+    // Encoded off the event loop and sent as it is produced.
+    EXPECT_EQ(json.headers.at("transfer-encoding"), "chunked");
+    const auto doc = service::parse_json(json.body);
+    EXPECT_EQ(doc.find("status")->as_string(), "completed");
+    EXPECT_EQ(doc.find("measurements")->as_array().size(), 4u);
+
+    client.send_request("GET", "/job/" + job_id + "/status");
+    const auto status = service::parse_json(client.read_response().body);
+    EXPECT_EQ(status.find("status")->as_string(), "completed");
+    EXPECT_DOUBLE_EQ(status.find("percent_complete")->as_double(), 1.0);
+
+    const Response binary = wait_for_result(
+        client, job_id, std::string("Accept: ") + service::kJobResultMediaType + "\r\n");
+    ASSERT_EQ(binary.status, 200);
+    EXPECT_EQ(binary.headers.at("content-type"), service::kJobResultMediaType);
+    const auto decoded = service::decode_job_result(binary.body);
+    EXPECT_EQ(decoded.job_id, job_id);
+    EXPECT_EQ(decoded.measurements.size(), 4u);
+
+    client.send_request("GET", "/metrics");
+    const Response metrics = client.read_response();
+    EXPECT_EQ(metrics.status, 200);
+    EXPECT_NE(metrics.body.find("na_vm_job_stage_seconds_count{stage=\"serialize\"} 2"), std::string::npos)
+        << metrics.body;
+}
+
+TEST_F(HttpJobServerTest, AcceptsBinaryJobRequests) {
+    Client client(server_->port());
+    client.send_request("POST", "/job", service::encode_job_request(make_bell_job(3)),
+        std::string("Content-Type: ") + service::kJobRequestMediaType + "\r\n");
+    const Response submitted = client.read_response();
+    ASSERT_EQ(submitted.status, 200) << submitted.body;
+    const std::string job_id = service::parse_json(submitted.body).find("job_id")->as_string();
+
+    const Response result = wait_for_result(client, job_id);
+    ASSERT_EQ(result.status, 200);
+    EXPECT_EQ(service::parse_json(result.body).find("measurements")->as_array().size(), 3u);
+}
+
+TEST(HttpCodecTests, ChunkedResultEncodingMatchesWholeEncoding) {
+    service::JobResult result;
+    result.job_id = "job-chunks";
+    result.status = service::JobStatus::Completed;
+    for (int shot = 0; shot < 64; ++shot) {
+        result.measurements.push_back({{0, 1, 2}, {shot & 1, 0, 1}});
+    }
+    result.metadata["tenant"] = "lab";
+
+    std::vector<std::string> chunks;
+    const auto sink = [&chunks](std::string_view bytes) { chunks.emplace_back(bytes); };
+    service::encode_job_result(result, sink, 32);
+    EXPECT_GT(chunks.size(), 1u);
+    std::string joined;
+    for (const auto& chunk : chunks) {
+        joined += chunk;
+    }
+    EXPECT_EQ(joined, service::encode_job_result(result));
+
+    chunks.clear();
+    service::JsonWriter writer(sink, 32);
+    service::write_job_result(writer, result);
+    writer.flush();
+    EXPECT_GT(chunks.size(), 1u);
+    joined.clear();
+    for (const auto& chunk : chunks) {
+        joined += chunk;
+    }
+    EXPECT_EQ(joined, service::job_result_to_json(result));
+}
+
+TEST(HttpServerTests, RefusesStreamsPastTheLimit) {
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool started = false;
+    bool release = false;
+    service::HttpServerOptions options;
+    options.max_streams = 1;
+    HttpServer server(options, [&](const service::HttpRequest&) {
+        service::HttpReply reply;
+        reply.stream = [&](service::ChunkWriter& out) {
+            std::unique_lock<std::mutex> lock(mutex);
+            started = true;
+            changed.notify_all();
+            changed.wait(lock, [&]() { return release; });
+            out.write("done");
+        };
+        return reply;
+    });
+    server.start();
+    {
+        Client first(server.port());
+        first.send_request("GET", "/stream");
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return started; });
+        }
+        Client second(server.port());
+        second.send_request("GET", "/stream");
+        const Response refused = second.read_response();
+        EXPECT_EQ(refused.status, 503);
+        EXPECT_EQ(refused.headers.at("retry-after"), "1");
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            release = true;
+        }
+        changed.notify_all();
+        EXPECT_EQ(first.read_response().body, "done");
+
+        // The slot is free again once the first stream has ended.
+        second.send_request("GET", "/stream");
+        EXPECT_EQ(second.read_response().body, "done");
+    }
+    server.stop();
+}
+
+TEST_F(HttpJobServerTest, StreamsShotBatchesAsChunkedNdjson) {
+    const int shots = 512;
+    const std::string job_id = jobs_.submit(make_bell_job(shots));
+    Client client(server_->port());
+    client.send_request("GET", "/job/" + job_id + "/stream");
+    const Response response = client.read_response();
+    ASSERT_EQ(response.status, 200);
+    EXPECT_EQ(response.headers.at("transfer-encoding"), "chunked");
+    EXPECT_EQ(response.headers.at("content-type"), "application/x-ndjson");
+
+    std::size_t streamed = 0;
+    std::size_t completed = 0;
+    std::istringstream lines(response.body);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const auto batch = service::parse_json(line);
+        streamed += batch.find("shots")->as_array().size();
+        completed = static_cast<std::size_t>(batch.find("completed_shots")->as_int());
+        EXPECT_EQ(batch.find("total_shots")->as_int(), shots);
+    }
+    // Shots finished before the subscription count towards completed_shots
+    // but are not replayed, so only the final total is exact.
+    EXPECT_LE(streamed, static_cast<std::size_t>(shots));
+    if (streamed > 0) {
+        EXPECT_EQ(completed, static_cast<std::size_t>(shots));
+    }
+
+    // The connection stays usable after the chunked response.
+    client.send_request("GET", "/healthz");
+    EXPECT_EQ(client.read_response().status, 200);
+}
+
+TEST_F(HttpJobServerTest, RejectsBadRequests) {
+    Client client(server_->port());
+    client.send_request("POST", "/job", "{not json", "Content-Type: application/json\r\n");
+    EXPECT_EQ(client.read_response().status, 400);
+    client.send_request("POST", "/job",
+        R"({"program": [{"op": "Repeat", "count": 2147483647, "body_size": 0}]})",
+        "Content-Type: application/json\r\n");
+    EXPECT_EQ(client.read_response().status, 400);
+    client.send_request("POST", "/job",
+        R"({"program": [{"op": "ApplyGate", "name": "NoSuchGate", "targets": [0]}]})",
+        "Content-Type: application/json\r\n");
+    EXPECT_EQ(client.read_response().status, 400);
+    client.send_request("GET", "/job/job-missing/result");
+    EXPECT_EQ(client.read_response().status, 404);
+    client.send_request("GET", "/job/job-missing/stream");
+    EXPECT_EQ(client.read_response().status, 404);
+    client.send_request("GET", "/nowhere");
+    EXPECT_EQ(client.read_response().status, 404);
+    client.send_request("GET", "/job");
+    EXPECT_EQ(client.read_response().status, 405);
+
+    client.send_raw("garbage\r\n\r\n");
+    EXPECT_EQ(client.read_response().status, 400);
+    EXPECT_TRUE(client.closed_by_peer());
+}
@@ -0,0 +1,243 @@
+#include "service/job_journal.hpp"
+#include "service/job_service.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using service::JobJournal;
+using service::JobJournalOptions;
+using service::JobRequest;
+using service::JobResult;
+using service::JobService;
+using service::JobStatus;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::string fresh_journal(const std::string& name) {
+    const auto dir = std::filesystem::temp_directory_path() / ("na_vm_journal_" + name);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return (dir / "jobs.journal").string();
+}
+
+JobJournalOptions journal_options(const std::string& path) {
+    JobJournalOptions options;
+    options.path = path;
+    return options;
+}
+
+JobRequest make_bell_job(const std::string& job_id, int shots) {
+    JobRequest job;
+    job.job_id = job_id;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+// A range whose shots all read `bits`, which a Bell pair never produces
+// for {1, 0}; lets tests tell restored shots from re-simulated ones.
+HardwareVM::RunResult fake_range(std::size_t count, std::vector<int> bits) {
+    HardwareVM::RunResult run;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        run.measurements.push_back(MeasurementRecord{{0, 1}, bits});
+    }
+    return run;
+}
+
+}  // namespace
+
+TEST(JobJournalTests, ReplaysSubmissionsRangesAndResults) {
+    const std::string path = fresh_journal("replay");
+    {
+        JobJournal journal(journal_options(path));
+        EXPECT_TRUE(journal.take_recovered().empty());
+
+        auto seeded = make_bell_job("job-0", 8);
+        seeded.seed = 7;
+        journal.record_submit(seeded, "", 2);
+        journal.record_start("job-0");
+        journal.record_range("job-0", 0, 4, fake_range(4, {1, 0}));
+
+        journal.record_submit(make_bell_job("job-1", 4), "batch-3", 0);
+        JobResult finished;
+        finished.job_id = "job-1";
+        finished.status = JobStatus::Completed;
+        finished.measurements = fake_range(4, {1, 1}).measurements;
+        journal.record_finish(finished);
+
+        journal.record_submit(make_bell_job("job-2", 4), "", 0);
+        journal.record_discard("job-2");
+
+        // Unseeded ranges cannot be reproduced and are dropped on replay.
+        journal.record_submit(make_bell_job("job-3", 4), "", 0);
+        journal.record_range("job-3", 0, 2, fake_range(2, {0, 0}));
+        journal.flush();
+        EXPECT_EQ(journal.stats().records, 9u);
+    }
+
+    JobJournal reopened(journal_options(path));
+    const auto jobs = reopened.take_recovered();
+    ASSERT_EQ(jobs.size(), 3u);
+    EXPECT_EQ(jobs[0].request.job_id, "job-0");
+    EXPECT_EQ(jobs[0].max_threads, 2u);
+    EXPECT_FALSE(jobs[0].result.has_value());
+    ASSERT_EQ(jobs[0].ranges.size(), 1u);
+    EXPECT_EQ(jobs[0].ranges[0].first, 0u);
+    EXPECT_EQ(jobs[0].ranges[0].count, 4u);
+    EXPECT_EQ(jobs[0].ranges[0].run.measurements[3].bits, (std::vector<int>{1, 0}));
+
+    EXPECT_EQ(jobs[1].batch_id, "batch-3");
+    ASSERT_TRUE(jobs[1].result.has_value());
+    EXPECT_EQ(jobs[1].result->measurements.size(), 4u);
+
+    EXPECT_EQ(jobs[2].request.job_id, "job-3");
+    EXPECT_TRUE(jobs[2].ranges.empty());
+}
+
+TEST(JobJournalTests, DiscardsTornTailAndCompacts) {
+    const std::string path = fresh_journal("torn");
+    {
+        JobJournal journal(journal_options(path));
+        journal.record_submit(make_bell_job("job-0", 4), "", 0);
+        journal.record_submit(make_bell_job("job-1", 4), "", 0);
+        journal.record_discard("job-1");
+        journal.flush();
+    }
+    const auto full_size = std::filesystem::file_size(path);
+    {
+        // A crash mid-append leaves a partial frame behind.
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x40\x00\x00\x00\x01\x02", 6);
+    }
+
+    JobJournal reopened(journal_options(path));
+    const auto jobs = reopened.take_recovered();
+    ASSERT_EQ(jobs.size(), 1u);
+    EXPECT_EQ(jobs[0].request.job_id, "job-0");
+    // Compaction dropped the discarded job and the torn frame.
+    EXPECT_LT(std::filesystem::file_size(path), full_size);
+}
+
+TEST(JobJournalTests, JobServiceResumesFromJournaledShotRanges) {
+    const std::string path = fresh_journal("resume");
+    auto job = make_bell_job("job-5", 10);
+    job.seed = 99;
+    {
+        // State left behind by a service that crashed after four shots.
+        JobJournal journal(journal_options(path));
+        journal.record_submit(job, "", 1);
+        journal.record_start("job-5");
+        journal.record_range("job-5", 0, 4, fake_range(4, {1, 0}));
+        journal.flush();
+    }
+
+    service::FairShareOptions options;
+    options.shots_per_batch = 3;
+    JobService jobs(options);
+    EXPECT_EQ(jobs.attach_journal(std::make_shared<JobJournal>(journal_options(path))), 1u);
+
+    std::optional<JobResult> result;
+    for (int attempt = 0; attempt < 1000 && !(result = jobs.poll_result("job-5")); ++attempt) {
+        std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->status, JobStatus::Completed) << result->message;
+    ASSERT_EQ(result->measurements.size(), 10u);
+
+    service::JobRunner runner;
+    const auto direct = runner.run(job, 1);
+    for (std::size_t shot = 0; shot < 10; ++shot) {
+        const auto& expected = shot < 4 ? std::vector<int>{1, 0} : direct.measurements[shot].bits;
+        EXPECT_EQ(result->measurements[shot].bits, expected) << "shot " << shot;
+    }
+
+    // New IDs continue after the recovered ones.
+    EXPECT_EQ(jobs.submit(make_bell_job("", 1)), "job-6");
+}
+
+TEST(JobJournalTests, RestartRestoresFinishedResults) {
+    const std::string path = fresh_journal("restart");
+    std::string job_id;
+    {
+        JobService jobs;
+        jobs.attach_journal(std::make_shared<JobJournal>(journal_options(path)));
+        job_id = jobs.submit(make_bell_job("", 4));
+        for (int attempt = 0; attempt < 1000 && !jobs.poll_result(job_id); ++attempt) {
+            std::this_thread::sleep_for(5ms);
+        }
+        ASSERT_TRUE(jobs.poll_result(job_id).has_value());
+    }
+
+    JobService restarted;
+    EXPECT_EQ(restarted.attach_journal(std::make_shared<JobJournal>(journal_options(path))), 0u);
+    const auto result = restarted.poll_result(job_id);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->status, JobStatus::Completed);
+    EXPECT_EQ(result->measurements.size(), 4u);
+}
+
+TEST(JobJournalTests, CompactionKeepsOnlyRecentFinishedJobs) {
+    const std::string path = fresh_journal("retention");
+    {
+        JobJournal journal(journal_options(path));
+        for (int idx = 0; idx < 4; ++idx) {
+            const std::string job_id = "job-" + std::to_string(idx);
+            journal.record_submit(make_bell_job(job_id, 1), "", 0);
+            JobResult result;
+            result.job_id = job_id;
+            result.status = JobStatus::Completed;
+            journal.record_finish(result);
+        }
+        journal.record_submit(make_bell_job("job-4", 1), "", 0);
+        journal.flush();
+    }
+
+    auto options = journal_options(path);
+    options.retain_finished = 2;
+    JobJournal reopened(options);
+    const auto jobs = reopened.take_recovered();
+    ASSERT_EQ(jobs.size(), 3u);
+    EXPECT_EQ(jobs[0].request.job_id, "job-2");
+    EXPECT_EQ(jobs[1].request.job_id, "job-3");
+    EXPECT_EQ(jobs[2].request.job_id, "job-4");
+    EXPECT_FALSE(jobs[2].result.has_value());
+}
+
+TEST(JobJournalTests, DurableCallbacksRunBeforeWaitersReturn) {
+    auto options = journal_options(fresh_journal("callbacks"));
+    options.sync_interval = 5ms;
+    JobJournal journal(options);
+    std::atomic<int> synced{0};
+    const std::uint64_t first = journal.record_submit(make_bell_job("job-0", 1), "", 0);
+    journal.on_durable(first, [&synced](std::exception_ptr error) {
+        EXPECT_FALSE(error);
+        ++synced;
+    });
+    journal.wait_durable(first);
+    EXPECT_EQ(synced.load(), 1);
+
+    // Already durable: runs inline.
+    journal.on_durable(first, [&synced](std::exception_ptr) { ++synced; });
+    EXPECT_EQ(synced.load(), 2);
+}
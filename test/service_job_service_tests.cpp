@@ -5,7 +5,10 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 using service::JobRequest;
 using service::JobResult;
@@ -53,3 +56,31 @@ TEST(ServiceJobServiceTests, SubmitsAsyncJobAndReturnsResult) {
     EXPECT_EQ(result->measurements.size(), 1u);
     EXPECT_FALSE(result->measurements[0].bits.empty());
 }
+
+TEST(ServiceJobServiceTests, CompletionCallbacksFireOnceWithTheFinalStatus) {
+    JobService service;
+    const std::string job_id = service.submit(make_simple_job(), 1);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<JobStatus> fired;
+    auto record = [&](const std::string& id, JobStatus status) {
+        EXPECT_EQ(id, job_id);
+        // The result is visible by the time the callback runs.
+        EXPECT_TRUE(service.poll_result(id).has_value());
+        std::lock_guard<std::mutex> lock(mutex);
+        fired.push_back(status);
+        cv.notify_all();
+    };
+    ASSERT_TRUE(service.on_completion(job_id, record));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(10), [&] { return !fired.empty(); }));
+    }
+
+    // Registered after the job finished: runs before on_completion returns.
+    ASSERT_TRUE(service.on_completion(job_id, record));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(fired, (std::vector<JobStatus>{JobStatus::Completed, JobStatus::Completed}));
+    EXPECT_FALSE(service.on_completion("missing", record));
+}
@@ -212,3 +212,29 @@ TEST(ServiceJobValidationTests, MoveLimitsRejectTooManyMovesPerAtom) {
     EXPECT_FALSE(result.message.empty());
     EXPECT_NE(result.message.find("move limit"), std::string::npos);
 }
+
+TEST(ServiceJobValidationTests, RepeatBodiesAreValidatedOnceAndMustBeWellFormed) {
+    service::JobRunner runner;
+    auto job = make_blockade_job();
+    job.hardware.blockade_radius = 1.5;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::Repeat, RepeatInstruction{1000, 1}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    auto result = runner.run(job);
+    EXPECT_EQ(result.status, service::JobStatus::Failed);
+    EXPECT_NE(result.message.find("blockade radius"), std::string::npos);
+
+    job.hardware.blockade_radius = 0.0;
+    job.program[1] = {Op::Repeat, RepeatInstruction{2, 3}};
+    result = runner.run(job);
+    EXPECT_EQ(result.status, service::JobStatus::Failed);
+    EXPECT_NE(result.message.find("Repeat at instruction 1"), std::string::npos);
+
+    job.program[1] = {Op::Repeat, RepeatInstruction{0, 1}};
+    result = runner.run(job);
+    EXPECT_EQ(result.status, service::JobStatus::Failed);
+    EXPECT_NE(result.message.find("positive count"), std::string::npos);
+}
@@ -0,0 +1,120 @@
+#include "service/job_service.hpp"
+#include "service/metrics.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using service::JobRequest;
+using service::JobService;
+using service::MetricsRegistry;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+JobRequest make_bell_job(int shots) {
+    JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+}  // namespace
+
+TEST(MetricsTests, RendersCountersGaugesAndCumulativeHistograms) {
+    MetricsRegistry registry;
+    registry.counter("requests_total", "Requests.", {{"route", "a\"b"}}).add(3);
+    registry.gauge("depth", "Depth.").set(-2);
+    auto& latency = registry.histogram("latency_seconds", "Latency.", {}, {0.1, 1.0});
+    latency.observe(0.05);
+    latency.observe(0.5);
+    latency.observe(5.0);
+
+    const std::string text = registry.render_prometheus();
+    EXPECT_TRUE(contains(text, "# TYPE requests_total counter\n"));
+    EXPECT_TRUE(contains(text, "requests_total{route=\"a\\\"b\"} 3\n"));
+    EXPECT_TRUE(contains(text, "depth -2\n"));
+    EXPECT_TRUE(contains(text, "latency_seconds_bucket{le=\"0.1\"} 1\n"));
+    EXPECT_TRUE(contains(text, "latency_seconds_bucket{le=\"1\"} 2\n"));
+    EXPECT_TRUE(contains(text, "latency_seconds_bucket{le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(contains(text, "latency_seconds_sum 5.55\n"));
+    EXPECT_TRUE(contains(text, "latency_seconds_count 3\n"));
+}
+
+TEST(MetricsTests, ReturnsSameSeriesAndRejectsTypeConflicts) {
+    MetricsRegistry registry;
+    auto& first = registry.counter("hits_total", "Hits.", {{"tier", "memory"}});
+    auto& again = registry.counter("hits_total", "Hits.", {{"tier", "memory"}});
+    auto& other = registry.counter("hits_total", "Hits.", {{"tier", "disk"}});
+    EXPECT_EQ(&first, &again);
+    EXPECT_NE(&first, &other);
+    EXPECT_THROW(registry.gauge("hits_total", "Hits."), std::invalid_argument);
+}
+
+TEST(MetricsTests, ConcurrentObservationsAreNotLost) {
+    service::Histogram histogram({1.0});
+    service::Counter counter;
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < 4; ++worker) {
+        workers.emplace_back([&]() {
+            for (int idx = 0; idx < 10000; ++idx) {
+                histogram.observe(0.5);
+                counter.add();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 40000u);
+    EXPECT_EQ(snapshot.buckets[0], 40000u);
+    EXPECT_DOUBLE_EQ(snapshot.sum, 20000.0);
+    EXPECT_EQ(counter.value(), 40000u);
+}
+
+TEST(MetricsTests, JobServiceRecordsStagesAndThroughput) {
+    JobService service;
+    const std::string job_id = service.submit(make_bell_job(8), 1);
+    for (int attempt = 0; attempt < 500 && !service.poll_result(job_id); ++attempt) {
+        std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_TRUE(service.poll_result(job_id).has_value());
+
+    const auto& metrics = *service.job_metrics();
+    // store_result runs before the result becomes visible, so counters are final.
+    EXPECT_EQ(metrics.completed_jobs.value(), 1u);
+    EXPECT_EQ(metrics.shots.value(), 8u);
+    EXPECT_EQ(metrics.gates.value(), 16u);
+    EXPECT_EQ(metrics.amplitude_updates.value(), 64u);  // 2 gates x 4 amplitudes x 8 shots
+    EXPECT_EQ(metrics.queued_jobs.value(), 0);
+    EXPECT_EQ(metrics.running_jobs.value(), 0);
+    EXPECT_EQ(metrics.active_shots.value(), 0);
+    EXPECT_EQ(metrics.statevector_bytes.value(), 0);
+    EXPECT_EQ(metrics.validate_seconds.snapshot().count, 1u);
+    EXPECT_EQ(metrics.schedule_seconds.snapshot().count, 1u);
+    EXPECT_EQ(metrics.simulate_seconds.snapshot().count, 1u);
+
+    const std::string text = service.render_metrics();
+    EXPECT_TRUE(contains(text, "na_vm_jobs_total{status=\"completed\"} 1\n"));
+    EXPECT_TRUE(contains(text, "na_vm_job_stage_seconds_count{stage=\"simulate\"} 1\n"));
+}
@@ -0,0 +1,131 @@
+#include "service/packed_program.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using service::PackedInstruction;
+using service::PackedProgram;
+
+namespace {
+
+Program sample_program() {
+    return {
+        {Op::AllocArray, 3},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::ApplyGate, Gate{"H", {2}, 0.25}},
+        {Op::MoveAtom, MoveAtomInstruction{2, 1.5}},
+        {Op::Wait, WaitInstruction{120.0}},
+        {Op::Pulse, PulseInstruction{1, -0.5, 40.0}},
+        {Op::Measure, std::vector<int>{0, 1, 2}},
+        {Op::Repeat, RepeatInstruction{5, 1}},
+        {Op::Measure, std::vector<int>{2}},
+    };
+}
+
+void expect_same_program(const Program& actual, const Program& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t idx = 0; idx < expected.size(); ++idx) {
+        SCOPED_TRACE("instruction " + std::to_string(idx));
+        ASSERT_EQ(actual[idx].op, expected[idx].op);
+        switch (expected[idx].op) {
+            case Op::AllocArray:
+                EXPECT_EQ(std::get<int>(actual[idx].payload), std::get<int>(expected[idx].payload));
+                break;
+            case Op::ApplyGate: {
+                const auto& lhs = std::get<Gate>(actual[idx].payload);
+                const auto& rhs = std::get<Gate>(expected[idx].payload);
+                EXPECT_EQ(lhs.name, rhs.name);
+                EXPECT_EQ(lhs.targets, rhs.targets);
+                EXPECT_DOUBLE_EQ(lhs.param, rhs.param);
+                break;
+            }
+            case Op::Measure:
+                EXPECT_TRUE(std::ranges::equal(actual.targets(actual[idx]), expected.targets(expected[idx])));
+                break;
+            case Op::MoveAtom:
+                EXPECT_EQ(std::get<MoveAtomInstruction>(actual[idx].payload).atom,
+                    std::get<MoveAtomInstruction>(expected[idx].payload).atom);
+                EXPECT_DOUBLE_EQ(std::get<MoveAtomInstruction>(actual[idx].payload).position,
+                    std::get<MoveAtomInstruction>(expected[idx].payload).position);
+                break;
+            case Op::Wait:
+                EXPECT_DOUBLE_EQ(std::get<WaitInstruction>(actual[idx].payload).duration,
+                    std::get<WaitInstruction>(expected[idx].payload).duration);
+                break;
+            case Op::Repeat:
+                EXPECT_EQ(std::get<RepeatInstruction>(actual[idx].payload).count,
+                    std::get<RepeatInstruction>(expected[idx].payload).count);
+                EXPECT_EQ(std::get<RepeatInstruction>(actual[idx].payload).body_size,
+                    std::get<RepeatInstruction>(expected[idx].payload).body_size);
+                break;
+            case Op::Pulse: {
+                const auto& lhs = std::get<PulseInstruction>(actual[idx].payload);
+                const auto& rhs = std::get<PulseInstruction>(expected[idx].payload);
+                EXPECT_EQ(lhs.target, rhs.target);
+                EXPECT_DOUBLE_EQ(lhs.detuning, rhs.detuning);
+                EXPECT_DOUBLE_EQ(lhs.duration, rhs.duration);
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(PackedProgramTests, PackInternsGateNamesAndFlattensTargets) {
+    const PackedProgram packed = service::pack_program(sample_program());
+    EXPECT_EQ(packed.gates, (std::vector<std::string>{"H", "CX"}));
+    ASSERT_EQ(packed.instructions.size(), 10u);
+    EXPECT_EQ(packed.instructions[3].gate, 0);
+    EXPECT_DOUBLE_EQ(packed.instructions[3].value0, 0.25);
+    EXPECT_EQ(packed.targets, (std::vector<std::int32_t>{3, 0, 0, 1, 2, 2, 1, 0, 1, 2, 5, 1, 2}));
+}
+
+TEST(PackedProgramTests, RoundTripsThroughViewAndWireFormat) {
+    const auto program = sample_program();
+    const PackedProgram packed = service::pack_program(program);
+    expect_same_program(service::unpack_program(packed.view()), program);
+
+    const std::string bytes = service::encode_packed_program(packed.view());
+    const PackedProgram decoded = service::decode_packed_program(bytes);
+    expect_same_program(service::unpack_program(decoded.view()), program);
+}
+
+TEST(PackedProgramTests, UnpackRejectsMalformedPrograms) {
+    PackedProgram packed = service::pack_program(sample_program());
+
+    PackedProgram bad_op = packed;
+    bad_op.instructions[1].op = 42;
+    EXPECT_THROW(service::unpack_program(bad_op.view()), std::runtime_error);
+
+    PackedProgram bad_gate = packed;
+    bad_gate.instructions[1].gate = 7;
+    EXPECT_THROW(service::unpack_program(bad_gate.view()), std::runtime_error);
+
+    PackedProgram short_targets = packed;
+    short_targets.targets.pop_back();
+    EXPECT_THROW(service::unpack_program(short_targets.view()), std::runtime_error);
+
+    PackedProgram extra_targets = packed;
+    extra_targets.targets.push_back(0);
+    EXPECT_THROW(service::unpack_program(extra_targets.view()), std::runtime_error);
+
+    PackedProgram wide_wait = packed;
+    wide_wait.instructions[5].target_count = 1;
+    wide_wait.instructions[6].target_count = 0;
+    EXPECT_THROW(service::unpack_program(wide_wait.view()), std::runtime_error);
+}
+
+TEST(PackedProgramTests, DecodeRejectsMalformedBytes) {
+    const std::string bytes = service::encode_packed_program(service::pack_program(sample_program()).view());
+    EXPECT_THROW(service::decode_packed_program(bytes.substr(0, bytes.size() - 1)), std::runtime_error);
+    EXPECT_THROW(service::decode_packed_program(bytes + "x"), std::runtime_error);
+    std::string wrong_magic = bytes;
+    wrong_magic[0] = 'Z';
+    EXPECT_THROW(service::decode_packed_program(wrong_magic), std::runtime_error);
+}
@@ -0,0 +1,96 @@
+#include "service/job_service.hpp"
+#include "service/mpsc_ring_buffer.hpp"
+#include "service/sharded_counter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Entry {
+    int producer = 0;
+    int sequence = 0;
+};
+
+}  // namespace
+
+TEST(ProgressPrimitivesTests, RingKeepsNewestEntriesInOrder) {
+    service::MpscRingBuffer<Entry, 8> ring;
+    for (int idx = 0; idx < 20; ++idx) {
+        ring.push(Entry{0, idx});
+    }
+    const auto newest = ring.snapshot(4);
+    ASSERT_EQ(newest.size(), 4u);
+    EXPECT_EQ(newest.front().sequence, 16);
+    EXPECT_EQ(newest.back().sequence, 19);
+    EXPECT_EQ(ring.snapshot().size(), 8u);
+    EXPECT_EQ(ring.total_pushed(), 20u);
+}
+
+TEST(ProgressPrimitivesTests, RingSurvivesConcurrentProducers) {
+    service::MpscRingBuffer<Entry, 16> ring;
+    constexpr int kProducers = 8;
+    constexpr int kPerProducer = 5000;
+    std::vector<std::thread> producers;
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            for (const auto& entry : ring.snapshot()) {
+                ASSERT_GE(entry.producer, 0);
+                ASSERT_LT(entry.producer, kProducers);
+                ASSERT_LT(entry.sequence, kPerProducer);
+            }
+        }
+    });
+    for (int producer = 0; producer < kProducers; ++producer) {
+        producers.emplace_back([&ring, producer]() {
+            for (int idx = 0; idx < kPerProducer; ++idx) {
+                ring.push(Entry{producer, idx});
+            }
+        });
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    done.store(true);
+    reader.join();
+    EXPECT_EQ(ring.total_pushed(), static_cast<std::uint64_t>(kProducers * kPerProducer));
+    EXPECT_EQ(ring.snapshot().size(), 16u);
+}
+
+TEST(ProgressPrimitivesTests, ShardedCounterSumsAllThreads) {
+    service::ShardedCounter counter;
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < 8; ++worker) {
+        workers.emplace_back([&counter]() {
+            for (int idx = 0; idx < 10000; ++idx) {
+                counter.add(1);
+            }
+        });
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.load(), 80000u);
+}
+
+TEST(ProgressPrimitivesTests, ReporterReturnsLastLogsTruncated) {
+    JobProgressReporter reporter;
+    for (int idx = 0; idx < 12; ++idx) {
+        reporter.record_log(ExecutionLog{idx, 0.5 * idx, "Gate", "entry " + std::to_string(idx)});
+    }
+    reporter.record_log(ExecutionLog{12, 6.0, "Noise", std::string(400, 'x')});
+    const auto logs = reporter.recent_logs();
+    ASSERT_EQ(logs.size(), 8u);
+    EXPECT_EQ(logs.front().shot, 5);
+    EXPECT_EQ(logs.front().message, "entry 5");
+    EXPECT_EQ(logs.back().category, "Noise");
+    EXPECT_LT(logs.back().message.size(), 400u);
+
+    reporter.increment_completed_steps(64);
+    reporter.increment_completed_steps(3);
+    EXPECT_EQ(reporter.completed_steps(), 67u);
+}
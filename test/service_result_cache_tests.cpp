@@ -0,0 +1,214 @@
+#include "service/job.hpp"
+#include "service/job_codec.hpp"
+#include "service/result_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using service::JobRequest;
+using service::JobResult;
+using service::JobRunner;
+using service::JobStatus;
+using service::ResultCache;
+using service::ResultCacheOptions;
+
+namespace {
+
+JobRequest make_seeded_job(std::uint64_t seed) {
+    JobRequest job;
+    job.job_id = "cache-job";
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.shots = 16;
+    job.seed = seed;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"H", {1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+std::filesystem::path fresh_cache_dir(const std::string& name) {
+    const auto dir = std::filesystem::temp_directory_path() / ("na_vm_cache_" + name);
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+}  // namespace
+
+TEST(ResultCacheTests, DerivedShotSeedsAreRangeIndependent) {
+    const auto full = service::derive_shot_seeds(99, 0, 8);
+    const auto tail = service::derive_shot_seeds(99, 5, 3);
+    ASSERT_EQ(full.size(), 8u);
+    ASSERT_EQ(tail.size(), 3u);
+    EXPECT_EQ(tail[0], full[5]);
+    EXPECT_EQ(tail[2], full[7]);
+    EXPECT_NE(full[0], full[1]);
+}
+
+TEST(ResultCacheTests, SeededJobsAreReproducible) {
+    JobRunner runner;
+    const auto first = runner.run(make_seeded_job(7));
+    const auto second = runner.run(make_seeded_job(7));
+    ASSERT_EQ(first.status, JobStatus::Completed);
+    ASSERT_EQ(first.measurements.size(), second.measurements.size());
+    for (std::size_t idx = 0; idx < first.measurements.size(); ++idx) {
+        EXPECT_EQ(first.measurements[idx].bits, second.measurements[idx].bits);
+    }
+}
+
+TEST(ResultCacheTests, CodecRoundTripsJobResult) {
+    JobRunner runner;
+    auto result = runner.run(make_seeded_job(3));
+    result.metadata["note"] = "roundtrip";
+    const JobResult decoded = service::decode_job_result(service::encode_job_result(result));
+    EXPECT_EQ(decoded.job_id, result.job_id);
+    EXPECT_EQ(decoded.status, result.status);
+    ASSERT_EQ(decoded.measurements.size(), result.measurements.size());
+    EXPECT_EQ(decoded.measurements.back().bits, result.measurements.back().bits);
+    ASSERT_EQ(decoded.logs.size(), result.logs.size());
+    EXPECT_EQ(decoded.logs.front().message, result.logs.front().message);
+    EXPECT_EQ(decoded.timeline, result.timeline);
+    EXPECT_EQ(decoded.metadata.at("note"), "roundtrip");
+    EXPECT_THROW(service::decode_job_result("garbage"), std::runtime_error);
+}
+
+TEST(ResultCacheTests, CacheKeyIgnoresJobIdButTracksSeedAndNoise) {
+    const HardwareConfig hw;
+    JobRequest a = make_seeded_job(1);
+    JobRequest b = make_seeded_job(1);
+    b.job_id = "other";
+    b.max_threads = 4;
+    const auto key_a = service::canonical_cache_key(a, hw, BackendKind::kCpu);
+    EXPECT_EQ(key_a, service::canonical_cache_key(b, hw, BackendKind::kCpu));
+    EXPECT_EQ(key_a.size(), 32u);
+
+    b.seed = 2;
+    EXPECT_NE(key_a, service::canonical_cache_key(b, hw, BackendKind::kCpu));
+
+    b = make_seeded_job(1);
+    b.noise_config = SimpleNoiseConfig{};
+    b.noise_config->p_loss = 0.1;
+    EXPECT_NE(key_a, service::canonical_cache_key(b, hw, BackendKind::kCpu));
+    EXPECT_NE(key_a, service::canonical_cache_key(a, hw, BackendKind::kStabilizer));
+}
+
+TEST(ResultCacheTests, CacheKeyDistinguishesAdjacentDoubles) {
+    HardwareConfig hw;
+    hw.positions = {0.0, 1.0};
+    JobRequest a = make_seeded_job(1);
+    std::get<Gate>(a.program[1].payload).param = 0.1;
+    JobRequest b = a;
+    std::get<Gate>(b.program[1].payload).param = std::nextafter(0.1, 1.0);
+    EXPECT_NE(service::canonical_cache_key(a, hw, BackendKind::kCpu),
+        service::canonical_cache_key(b, hw, BackendKind::kCpu));
+
+    b = a;
+    b.noise_config = SimpleNoiseConfig{};
+    b.noise_config->p_loss = 0.1;
+    JobRequest c = b;
+    c.noise_config->p_loss = std::nextafter(0.1, 1.0);
+    EXPECT_NE(service::canonical_cache_key(b, hw, BackendKind::kCpu),
+        service::canonical_cache_key(c, hw, BackendKind::kCpu));
+
+    // Sweep points bound from a parameter table.
+    JobRequest parametric = make_seeded_job(1);
+    std::get<Gate>(parametric.program[1].payload).symbol = "theta";
+    service::JobOverride first;
+    first.parameters = {{"theta", 0.1}};
+    service::JobOverride second;
+    second.parameters = {{"theta", std::nextafter(0.1, 1.0)}};
+    EXPECT_NE(service::canonical_cache_key(service::apply_override(parametric, first), hw, BackendKind::kCpu),
+        service::canonical_cache_key(service::apply_override(parametric, second), hw, BackendKind::kCpu));
+    parametric.parameters = first.parameters;
+    JobRequest other_point = parametric;
+    other_point.parameters = second.parameters;
+    EXPECT_NE(service::canonical_cache_key(parametric, hw, BackendKind::kCpu),
+        service::canonical_cache_key(other_point, hw, BackendKind::kCpu));
+
+    HardwareConfig shifted = hw;
+    shifted.positions[1] = std::nextafter(1.0, 2.0);
+    EXPECT_NE(service::canonical_cache_key(a, hw, BackendKind::kCpu),
+        service::canonical_cache_key(a, shifted, BackendKind::kCpu));
+}
+
+TEST(ResultCacheTests, RunnerServesRepeatedSeededJobsFromMemory) {
+    JobRunner runner;
+    auto cache = std::make_shared<ResultCache>();
+    runner.set_result_cache(cache);
+
+    const auto first = runner.run(make_seeded_job(11));
+    ASSERT_EQ(first.status, JobStatus::Completed);
+    EXPECT_EQ(first.metadata.at("cache_hit"), "false");
+
+    JobRequest again = make_seeded_job(11);
+    again.job_id = "cache-job-again";
+    const auto second = runner.run(again);
+    EXPECT_EQ(second.metadata.at("cache_hit"), "true");
+    EXPECT_EQ(second.job_id, "cache-job-again");
+    ASSERT_EQ(second.measurements.size(), first.measurements.size());
+    EXPECT_EQ(second.measurements.front().bits, first.measurements.front().bits);
+
+    const auto stats = cache->stats();
+    EXPECT_EQ(stats.memory_hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.memory_entries, 1u);
+}
+
+TEST(ResultCacheTests, UnseededJobsBypassCache) {
+    JobRunner runner;
+    auto cache = std::make_shared<ResultCache>();
+    runner.set_result_cache(cache);
+    JobRequest job = make_seeded_job(0);
+    job.seed.reset();
+    const auto result = runner.run(job);
+    EXPECT_EQ(result.status, JobStatus::Completed);
+    EXPECT_EQ(result.metadata.count("cache_hit"), 0u);
+    EXPECT_EQ(cache->stats().stores, 0u);
+}
+
+TEST(ResultCacheTests, DiskTierSurvivesNewCacheInstance) {
+    const auto dir = fresh_cache_dir("disk_tier");
+    ResultCacheOptions options;
+    options.disk_directory = dir.string();
+    {
+        JobRunner runner;
+        runner.set_result_cache(std::make_shared<ResultCache>(options));
+        ASSERT_EQ(runner.run(make_seeded_job(5)).status, JobStatus::Completed);
+    }
+    auto cache = std::make_shared<ResultCache>(options);
+    EXPECT_EQ(cache->stats().disk_entries, 1u);
+    JobRunner runner;
+    runner.set_result_cache(cache);
+    const auto result = runner.run(make_seeded_job(5));
+    EXPECT_EQ(result.metadata.at("cache_hit"), "true");
+    EXPECT_EQ(cache->stats().disk_hits, 1u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(ResultCacheTests, EvictsLeastRecentlyUsedWithinBudget) {
+    JobRunner runner;
+    const auto sample = runner.run(make_seeded_job(1));
+    const std::size_t entry_bytes = service::encode_job_result(sample).size();
+
+    ResultCacheOptions options;
+    options.memory_budget_bytes = entry_bytes * 2 + entry_bytes / 2;
+    ResultCache cache(options);
+    cache.store("a", sample);
+    cache.store("b", sample);
+    ASSERT_TRUE(cache.lookup("a").has_value());  // refresh "a"
+    cache.store("c", sample);
+
+    EXPECT_TRUE(cache.lookup("a").has_value());
+    EXPECT_FALSE(cache.lookup("b").has_value());
+    EXPECT_TRUE(cache.lookup("c").has_value());
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_LE(cache.stats().memory_bytes, options.memory_budget_bytes);
+}
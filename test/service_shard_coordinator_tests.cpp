@@ -0,0 +1,170 @@
+#include "service/job_codec.hpp"
+#include "service/job_service.hpp"
+#include "service/packed_measurements.hpp"
+#include "service/shard_coordinator.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using service::JobRequest;
+using service::JobResult;
+using service::JobService;
+using service::JobStatus;
+using service::ShardCoordinator;
+using service::ShardCoordinatorOptions;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+JobRequest make_ghz_job(int shots, std::uint64_t seed) {
+    JobRequest job;
+    job.job_id = "sharded";
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0, 2.0};
+    job.hardware.blockade_radius = 2.5;
+    job.shots = shots;
+    job.seed = seed;
+    job.program = {
+        {Op::AllocArray, 3},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::ApplyGate, Gate{"CX", {1, 2}}},
+        {Op::Measure, std::vector<int>{0, 1, 2}},
+    };
+    return job;
+}
+
+void expect_same_shots(const JobResult& actual, const JobResult& expected) {
+    ASSERT_EQ(actual.status, JobStatus::Completed) << actual.message;
+    ASSERT_EQ(actual.measurements.size(), expected.measurements.size());
+    for (std::size_t shot = 0; shot < expected.measurements.size(); ++shot) {
+        EXPECT_EQ(actual.measurements[shot].targets, expected.measurements[shot].targets);
+        EXPECT_EQ(actual.measurements[shot].bits, expected.measurements[shot].bits) << "shot " << shot;
+    }
+}
+
+}  // namespace
+
+TEST(ShardCoordinatorTests, PackedRangesRoundTripIncludingLostAtoms) {
+    HardwareVM::RunResult run;
+    for (int shot = 0; shot < 70; ++shot) {
+        run.measurements.push_back(MeasurementRecord{{0, 2}, {shot % 2, shot % 3 == 0 ? -1 : 1}});
+        run.measurements.push_back(MeasurementRecord{{1}, {shot % 5 == 0 ? 1 : 0}});
+    }
+    run.logs.push_back(ExecutionLog{3, 1.5, "noise", "loss"});
+    run.backend_timeline.push_back(BackendTimelineEvent{0.0, 2.0, "ApplyGate", "H"});
+
+    const auto packed = service::pack_measurements(run.measurements, 70);
+    ASSERT_TRUE(packed.has_value());
+    EXPECT_EQ(packed->bits_per_shot, 3u);
+    EXPECT_EQ(packed->values.size(), 4u);
+    EXPECT_FALSE(packed->lost.empty());
+
+    const auto decoded = service::decode_run_range(service::encode_run_range(run, 70));
+    ASSERT_EQ(decoded.measurements.size(), run.measurements.size());
+    for (std::size_t idx = 0; idx < run.measurements.size(); ++idx) {
+        EXPECT_EQ(decoded.measurements[idx].targets, run.measurements[idx].targets);
+        EXPECT_EQ(decoded.measurements[idx].bits, run.measurements[idx].bits);
+    }
+    ASSERT_EQ(decoded.logs.size(), 1u);
+    EXPECT_EQ(decoded.logs[0].message, "loss");
+    ASSERT_EQ(decoded.backend_timeline.size(), 1u);
+    EXPECT_EQ(decoded.backend_timeline[0].detail, "H");
+
+    // Shots with different layouts fall back to plain records.
+    run.measurements.pop_back();
+    EXPECT_FALSE(service::pack_measurements(run.measurements, 70).has_value());
+    EXPECT_EQ(
+        service::decode_run_range(service::encode_run_range(run, 70)).measurements.size(),
+        run.measurements.size());
+}
+
+TEST(ShardCoordinatorTests, SeededJobMatchesInProcessRun) {
+    ShardCoordinatorOptions options;
+    options.workers = 3;
+    ShardCoordinator coordinator(options);
+
+    const auto job = make_ghz_job(40, 1234);
+    service::JobRunner runner;
+    const auto direct = runner.run(job, 1);
+    expect_same_shots(coordinator.run(job, 7), direct);
+    expect_same_shots(coordinator.run(job), direct);
+    EXPECT_EQ(coordinator.restarts(), 0u);
+}
+
+TEST(ShardCoordinatorTests, RedispatchesRangesOfKilledWorkers) {
+    ShardCoordinatorOptions options;
+    options.workers = 2;
+    ShardCoordinator coordinator(options);
+    const auto pids = coordinator.worker_pids();
+    for (const pid_t pid : pids) {
+        ::kill(pid, SIGKILL);
+    }
+
+    const auto job = make_ghz_job(24, 77);
+    service::JobRunner runner;
+    expect_same_shots(coordinator.run(job, 4), runner.run(job, 1));
+    EXPECT_EQ(coordinator.restarts(), 2u);
+    for (const pid_t pid : coordinator.worker_pids()) {
+        EXPECT_EQ(std::find(pids.begin(), pids.end(), pid), pids.end());
+    }
+}
+
+TEST(ShardCoordinatorTests, RedispatchesRangesOfHungWorkers) {
+    ShardCoordinatorOptions options;
+    options.workers = 1;
+    options.range_timeout = 200ms;
+    ShardCoordinator coordinator(options);
+    const auto pids = coordinator.worker_pids();
+    ::kill(pids.front(), SIGSTOP);
+
+    const auto job = make_ghz_job(12, 91);
+    service::JobRunner runner;
+    expect_same_shots(coordinator.run(job, 4), runner.run(job, 1));
+    EXPECT_EQ(coordinator.restarts(), 1u);
+    EXPECT_NE(coordinator.worker_pids().front(), pids.front());
+}
+
+TEST(ShardCoordinatorTests, ReportsJobErrorsWithoutRestartingWorkers) {
+    ShardCoordinator coordinator;
+    auto job = make_ghz_job(4, 5);
+    job.program.push_back({Op::ApplyGate, Gate{"H", {9}}});
+    const auto request = service::encode_job_request(job);
+    EXPECT_THROW(coordinator.run_range(request, 0, 4), std::runtime_error);
+    EXPECT_EQ(coordinator.restarts(), 0u);
+}
+
+TEST(ShardCoordinatorTests, JobServiceRunsBatchesInWorkerProcesses) {
+    ShardCoordinatorOptions shard_options;
+    shard_options.workers = 2;
+    auto coordinator = std::make_shared<ShardCoordinator>(shard_options);
+
+    service::FairShareOptions options;
+    options.worker_threads = 2;
+    options.shots_per_batch = 5;
+    JobService jobs(options);
+    jobs.set_shard_coordinator(coordinator);
+
+    const auto job = make_ghz_job(32, 42);
+    const std::string job_id = jobs.submit(job);
+    std::optional<JobResult> result;
+    for (int attempt = 0; attempt < 2000 && !(result = jobs.poll_result(job_id)); ++attempt) {
+        std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_TRUE(result.has_value());
+    service::JobRunner runner;
+    expect_same_shots(*result, runner.run(job, 1));
+    // Progress is replayed from the worker replies.
+    EXPECT_DOUBLE_EQ(jobs.status(job_id).percent_complete, 1.0);
+}
@@ -0,0 +1,202 @@
+#include "service/job_service.hpp"
+#include "service/packed_measurements.hpp"
+#include "service/shard_coordinator.hpp"
+#include "service/shared_result.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using service::JobRequest;
+using service::JobResult;
+using service::JobStatus;
+using service::SharedResultSegment;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::vector<MeasurementRecord> make_records(int shots) {
+    std::vector<MeasurementRecord> records;
+    for (int shot = 0; shot < shots; ++shot) {
+        records.push_back(MeasurementRecord{{0, 1}, {shot % 2, shot % 7 == 0 ? -1 : 1}});
+    }
+    return records;
+}
+
+JobRequest make_bell_job(int shots, std::uint64_t seed) {
+    JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = shots;
+    job.seed = seed;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+bool segment_exists(const std::string& name) {
+    return std::filesystem::exists("/dev/shm" + name);
+}
+
+}  // namespace
+
+TEST(SharedResultTests, ReadersMapTheSegmentUntilTheOwnerReleasesIt) {
+    const auto records = make_records(100);
+    const auto packed = service::pack_measurements(records, 100);
+    ASSERT_TRUE(packed.has_value());
+
+    std::string name;
+    {
+        auto segment = SharedResultSegment::create(*packed);
+        name = segment->name();
+        EXPECT_EQ(segment->shots(), 100u);
+        EXPECT_EQ(segment->bits_per_shot(), 2u);
+        EXPECT_EQ(segment->values().size(), 4u);
+        EXPECT_EQ(segment->lost().size(), 4u);
+
+        auto reader = SharedResultSegment::open(name);
+        EXPECT_EQ(reader->layout(), (std::vector<std::vector<int>>{{0, 1}}));
+        EXPECT_EQ(reader->bit(3, 0), 1);
+        EXPECT_EQ(reader->bit(7, 1), -1);
+        const auto unpacked = reader->unpack();
+        ASSERT_EQ(unpacked.size(), records.size());
+        for (std::size_t idx = 0; idx < records.size(); ++idx) {
+            EXPECT_EQ(unpacked[idx].bits, records[idx].bits);
+        }
+
+        segment.reset();
+        EXPECT_FALSE(segment_exists(name));
+        // The mapping outlives the name.
+        EXPECT_EQ(reader->bit(8, 0), 0);
+    }
+    EXPECT_THROW(SharedResultSegment::open(name), std::runtime_error);
+}
+
+TEST(SharedResultTests, AnotherProcessReadsTheBits) {
+    const auto packed = service::pack_measurements(make_records(64), 64);
+    ASSERT_TRUE(packed.has_value());
+    const auto segment = SharedResultSegment::create(*packed);
+
+    const pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        int failures = 0;
+        try {
+            const auto reader = SharedResultSegment::open(segment->name());
+            for (std::size_t shot = 0; shot < 64; ++shot) {
+                const int expected_lost = shot % 7 == 0 ? -1 : 1;
+                failures += reader->bit(shot, 0) != static_cast<int>(shot % 2);
+                failures += reader->bit(shot, 1) != expected_lost;
+            }
+        } catch (...) {
+            failures = 1;
+        }
+        ::_exit(failures == 0 ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(SharedResultTests, MergeConcatenatesUnalignedPlanes) {
+    // 37 shots of 2 bits leave the second part starting mid-word.
+    const auto records = make_records(100);
+    const std::vector<MeasurementRecord> head(records.begin(), records.begin() + 37);
+    const std::vector<MeasurementRecord> tail(records.begin() + 37, records.end());
+    std::vector<MeasurementRecord> no_loss = make_records(5);
+    for (auto& record : no_loss) {
+        record.bits[1] = 0;
+    }
+    const std::vector<std::shared_ptr<const SharedResultSegment>> parts = {
+        SharedResultSegment::create(*service::pack_measurements(head, 37)),
+        SharedResultSegment::create(*service::pack_measurements(no_loss, 5)),
+        SharedResultSegment::create(*service::pack_measurements(tail, 63)),
+    };
+    ASSERT_TRUE(parts[1]->lost().empty());
+
+    const auto merged = SharedResultSegment::merge(parts);
+    ASSERT_NE(merged, nullptr);
+    EXPECT_EQ(merged->shots(), 105u);
+    std::vector<MeasurementRecord> expected = head;
+    expected.insert(expected.end(), no_loss.begin(), no_loss.end());
+    expected.insert(expected.end(), tail.begin(), tail.end());
+    const auto unpacked = merged->unpack();
+    ASSERT_EQ(unpacked.size(), expected.size());
+    for (std::size_t shot = 0; shot < expected.size(); ++shot) {
+        EXPECT_EQ(unpacked[shot].bits, expected[shot].bits) << "shot " << shot;
+    }
+
+    const std::vector<std::shared_ptr<const SharedResultSegment>> mismatched = {
+        parts[0],
+        SharedResultSegment::create(*service::pack_measurements({MeasurementRecord{{3}, {1}}}, 1)),
+    };
+    EXPECT_EQ(SharedResultSegment::merge(mismatched), nullptr);
+}
+
+TEST(SharedResultTests, ShardWorkersHandRangesOverInSharedMemory) {
+    service::ShardCoordinatorOptions options;
+    options.workers = 2;
+    options.shared_memory_min_bytes = 1;
+    service::ShardCoordinator coordinator(options);
+
+    const auto job = make_bell_job(300, 11);
+    service::JobRunner runner;
+    const auto direct = runner.run(job, 1);
+    const auto sharded = coordinator.run(job, 128);
+    ASSERT_EQ(sharded.status, JobStatus::Completed) << sharded.message;
+    ASSERT_EQ(sharded.measurements.size(), direct.measurements.size());
+    for (std::size_t shot = 0; shot < direct.measurements.size(); ++shot) {
+        EXPECT_EQ(sharded.measurements[shot].bits, direct.measurements[shot].bits) << "shot " << shot;
+    }
+    // The worker planes are merged into one segment without re-packing.
+    ASSERT_NE(sharded.segment, nullptr);
+    EXPECT_EQ(sharded.segment->shots(), 300u);
+    EXPECT_EQ(direct.segment, nullptr);
+    // Adopted segments are unlinked once merged.
+    for (const auto& pid : coordinator.worker_pids()) {
+        for (int idx = 0; idx < 4; ++idx) {
+            EXPECT_FALSE(segment_exists("/na_vm_result_" + std::to_string(pid) + "_" + std::to_string(idx)));
+        }
+    }
+}
+
+TEST(SharedResultTests, JobServicePublishesCompletedResults) {
+    service::JobService jobs;
+    const std::string job_id = jobs.submit(make_bell_job(50, 3));
+    std::optional<JobResult> result;
+    for (int attempt = 0; attempt < 1000 && !(result = jobs.poll_result(job_id)); ++attempt) {
+        std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->status, JobStatus::Completed) << result->message;
+
+    const auto segment = jobs.result_segment(job_id);
+    ASSERT_NE(segment, nullptr);
+    EXPECT_EQ(jobs.result_segment(job_id), segment);
+    EXPECT_TRUE(segment->lost().empty());
+    const auto reader = SharedResultSegment::open(segment->name());
+    const auto unpacked = reader->unpack();
+    ASSERT_EQ(unpacked.size(), result->measurements.size());
+    for (std::size_t shot = 0; shot < unpacked.size(); ++shot) {
+        EXPECT_EQ(unpacked[shot].bits, result->measurements[shot].bits);
+    }
+    EXPECT_EQ(jobs.result_segment("job-missing"), nullptr);
+}
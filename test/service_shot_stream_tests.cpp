@@ -0,0 +1,140 @@
+#include "service/job_service.hpp"
+#include "service/shot_stream.hpp"
+
+#include "vm/isa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using service::JobRequest;
+using service::JobService;
+using service::ShotRecord;
+using service::ShotStream;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+ShotRecord make_shot(int shot, int bit) {
+    return ShotRecord{shot, {MeasurementRecord{{0}, {bit}}}};
+}
+
+JobRequest make_streaming_job(int shots) {
+    JobRequest job;
+    job.device_id = "state-vector";
+    job.profile = "ideal_small_array";
+    job.hardware.positions = {0.0, 1.0};
+    job.shots = shots;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+    return job;
+}
+
+}  // namespace
+
+TEST(ShotStreamTests, OutcomeKeyRendersLostAtoms) {
+    EXPECT_EQ(service::shot_outcome_key({{{0, 1}, {1, 0}}, {{2}, {-1}}}), "10x");
+}
+
+TEST(ShotStreamTests, FullStreamCoalescesShotsIntoCounts) {
+    ShotStream stream(1, 3, 0);
+    // Nothing consumes yet; the producer still never waits.
+    for (int shot = 0; shot < 3; ++shot) {
+        ASSERT_TRUE(stream.push(make_shot(shot, shot % 2)));
+    }
+    stream.finish();
+
+    const auto batch = stream.next(1ms);
+    ASSERT_TRUE(batch.has_value());
+    ASSERT_EQ(batch->shots.size(), 1u);
+    EXPECT_EQ(batch->shots[0].shot, 0);
+    EXPECT_EQ(batch->coalesced_shots, 2u);
+    EXPECT_EQ(batch->completed_shots, 3u);
+    EXPECT_EQ(batch->counts.at("0"), 2u);
+    EXPECT_EQ(batch->counts.at("1"), 1u);
+    EXPECT_FALSE(stream.next(1ms).has_value());
+}
+
+TEST(ShotStreamTests, HistogramIsBoundedByOutcomeCount) {
+    const std::size_t shots = service::kMaxHistogramOutcomes + 3;
+    ShotStream stream(shots, shots, 0);
+    for (std::size_t shot = 0; shot < shots; ++shot) {
+        // A distinct outcome per shot: the shot index in binary.
+        MeasurementRecord record;
+        for (int bit = 0; bit < 16; ++bit) {
+            record.targets.push_back(bit);
+            record.bits.push_back(static_cast<int>((shot >> bit) & 1u));
+        }
+        ASSERT_TRUE(stream.push(ShotRecord{static_cast<int>(shot), {record}}));
+    }
+    const auto batch = stream.next(1ms);
+    ASSERT_TRUE(batch.has_value());
+    EXPECT_EQ(batch->counts.size(), service::kMaxHistogramOutcomes + 1);
+    EXPECT_EQ(batch->counts.at(service::kOverflowOutcome), 3u);
+    EXPECT_EQ(batch->completed_shots, shots);
+}
+
+TEST(ShotStreamTests, DroppedSubscriptionRejectsShots) {
+    auto stream = std::make_shared<ShotStream>(1, 4, 0);
+    ASSERT_TRUE(stream->push(make_shot(0, 0)));
+    {
+        service::ShotSubscription subscription(stream);
+    }
+    EXPECT_FALSE(stream->push(make_shot(1, 1)));
+    EXPECT_TRUE(stream->cancelled());
+    EXPECT_FALSE(stream->next(1ms).has_value());
+}
+
+TEST(ShotStreamTests, JobServiceStreamsEveryShotIntoTheHistogram) {
+    JobService service;
+    const std::string job_id = service.submit(make_streaming_job(64), 2);
+    auto subscription = service.subscribe(job_id, 4);
+    ASSERT_TRUE(subscription.has_value());
+
+    std::size_t streamed = 0;
+    std::size_t coalesced = 0;
+    std::size_t completed = 0;
+    std::map<std::string, std::size_t> counts;
+    while (auto batch = subscription->next(1000ms)) {
+        if (batch->shots.empty()) {
+            continue;
+        }
+        for (const auto& shot : batch->shots) {
+            ASSERT_EQ(shot.measurements.size(), 1u);
+        }
+        streamed += batch->shots.size();
+        coalesced = batch->coalesced_shots;
+        completed = batch->completed_shots;
+        counts = batch->counts;
+    }
+    // The histogram covers the streamed and coalesced shots; shots finished
+    // before the subscription only count towards completed_shots.
+    std::size_t total = 0;
+    for (const auto& [key, count] : counts) {
+        EXPECT_TRUE(key == "00" || key == "11") << key;
+        total += count;
+    }
+    EXPECT_EQ(total, streamed + coalesced);
+    if (streamed > 0) {
+        EXPECT_EQ(completed, 64u);
+    }
+    ASSERT_TRUE(service.poll_result(job_id).has_value());
+}
+
+TEST(ShotStreamTests, SubscribingToFinishedJobEndsImmediately) {
+    JobService service;
+    const std::string job_id = service.submit(make_streaming_job(8), 1);
+    for (int attempt = 0; attempt < 400 && !service.poll_result(job_id); ++attempt) {
+        std::this_thread::sleep_for(5ms);
+    }
+    auto subscription = service.subscribe(job_id);
+    ASSERT_TRUE(subscription.has_value());
+    EXPECT_FALSE(subscription->next(10ms).has_value());
+    EXPECT_FALSE(service.subscribe("job-missing").has_value());
+}
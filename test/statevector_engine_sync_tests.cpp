@@ -55,7 +55,7 @@ TEST(StatevectorEngineSync, ApplyGateWithoutNoiseSkipsDeviceSync) {
     auto* tracker = backend.get();
     StatevectorEngine engine(make_simple_config(), std::move(backend));
 
-    std::vector<Instruction> program = {
+    Program program = {
         {Op::AllocArray, 3},
         {Op::ApplyGate, Gate{"H", {0}}},
         {Op::ApplyGate, Gate{"X", {1}}},
@@ -0,0 +1,105 @@
+#include "trace.hpp"
+
+#include "service/job.hpp"
+#include "service/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trace = neutral_atom_vm::trace;
+
+namespace {
+
+std::vector<service::JsonValue> trace_events() {
+    const service::JsonValue doc = service::parse_json(trace::chrome_trace_json());
+    return doc.find("traceEvents")->as_array();
+}
+
+bool has_span(const std::vector<service::JsonValue>& events, const std::string& category, const std::string& name) {
+    for (const auto& event : events) {
+        if (event.find("cat")->as_string() == category && event.find("name")->as_string() == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(TraceTests, StoppedTracingRecordsNothing) {
+    trace::start();
+    trace::stop();
+    {
+        trace::Span span("test", "ignored");
+    }
+    EXPECT_EQ(trace::recorded_events(), 0u);
+    EXPECT_TRUE(trace_events().empty());
+}
+
+TEST(TraceTests, KeepsTheFirstSpansOfEachThread) {
+    trace::start(4);
+    for (int idx = 0; idx < 10; ++idx) {
+        trace::Span span("test", "span", idx);
+    }
+    std::thread other([]() {
+        trace::Span span("test", "other");
+    });
+    other.join();
+    trace::stop();
+
+    EXPECT_EQ(trace::recorded_events(), 5u);
+    EXPECT_EQ(trace::dropped_events(), 6u);
+    const auto events = trace_events();
+    ASSERT_EQ(events.size(), 5u);
+    std::set<std::uint64_t> threads;
+    for (const auto& event : events) {
+        EXPECT_EQ(event.find("ph")->as_string(), "X");
+        EXPECT_GE(event.find("ts")->as_double(), 0.0);
+        EXPECT_GE(event.find("dur")->as_double(), 0.0);
+        threads.insert(event.find("tid")->as_uint64());
+    }
+    EXPECT_EQ(threads.size(), 2u);
+    EXPECT_EQ(events[3].find("args")->find("index")->as_int(), 3);
+}
+
+TEST(TraceTests, TracesJobStagesShotsAndKernels) {
+    service::JobRequest job;
+    job.device_id = "state-vector";
+    job.hardware.positions = {0.0, 1.0};
+    job.hardware.blockade_radius = 1.5;
+    job.shots = 3;
+    job.seed = 7;
+    job.program = {
+        {Op::AllocArray, 2},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::Measure, std::vector<int>{0, 1}},
+    };
+
+    trace::start();
+    service::JobRunner runner;
+    const auto result = runner.run(job, 2);
+    trace::stop();
+    ASSERT_EQ(result.status, service::JobStatus::Completed) << result.message;
+
+    const auto events = trace_events();
+    EXPECT_TRUE(has_span(events, "job", "validate"));
+    EXPECT_TRUE(has_span(events, "job", "schedule"));
+    EXPECT_TRUE(has_span(events, "job", "simulate"));
+    EXPECT_TRUE(has_span(events, "job", "convert"));
+    EXPECT_TRUE(has_span(events, "instruction", "ApplyGate"));
+    EXPECT_TRUE(has_span(events, "kernel", "H"));
+    EXPECT_TRUE(has_span(events, "kernel", "CX"));
+    EXPECT_TRUE(has_span(events, "measurement", "sample"));
+    std::set<int> shots;
+    for (const auto& event : events) {
+        if (event.find("cat")->as_string() == "shot") {
+            shots.insert(event.find("args")->find("index")->as_int());
+        }
+    }
+    EXPECT_EQ(shots, (std::set<int>{0, 1, 2}));
+}
@@ -9,7 +9,7 @@ TEST(ValidatorRegistryTests, PropagatesValidatorExceptions) {
     service::ValidatorRegistry registry;
     registry.register_validator(std::make_unique<service::LambdaValidator>(
         "throws",
-        [](const HardwareConfig&, const std::vector<Instruction>&) {
+        [](const HardwareConfig&, const Program&) {
             throw std::runtime_error("boom");
         }
     ));
@@ -27,13 +27,13 @@ TEST(ValidatorRegistryTests, RunsLambdaValidatorsInOrder) {
     bool second = false;
     registry.register_validator(std::make_unique<service::LambdaValidator>(
         "first",
-        [&](const HardwareConfig&, const std::vector<Instruction>&) {
+        [&](const HardwareConfig&, const Program&) {
             first = true;
         }
     ));
     registry.register_validator(std::make_unique<service::LambdaValidator>(
         "second",
-        [&](const HardwareConfig&, const std::vector<Instruction>&) {
+        [&](const HardwareConfig&, const Program&) {
             if (!first) {
                 throw std::runtime_error("order");
             }
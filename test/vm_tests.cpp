@@ -4,10 +4,14 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <random>
+#include <span>
+#include <stdexcept>
 
 namespace {
 
@@ -50,7 +54,7 @@ TEST(StatevectorEngineTests, BellState) {
 
     StatevectorEngine engine(cfg);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -79,7 +83,7 @@ TEST(StatevectorEngineTests, MoveAtomInstruction) {
 
     StatevectorEngine engine(cfg);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 3});
     program.push_back(Instruction{
         Op::MoveAtom,
@@ -103,7 +107,7 @@ TEST(StatevectorEngineTests, WaitInstruction) {
     cfg.positions = {0.0};
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::Wait,
@@ -128,7 +132,7 @@ TEST(StatevectorEngineTests, GateDurationsAdvanceLogicalTime) {
     cfg.native_gates.push_back(x);
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{Op::ApplyGate, Gate{"X", {0}}});
 
@@ -142,7 +146,7 @@ TEST(StatevectorEngineTests, MeasurementDurationsAdvanceLogicalTime) {
     cfg.timing_limits.measurement_duration_ns = 3.25;
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{Op::Measure, std::vector<int>{0}});
 
@@ -156,7 +160,7 @@ TEST(StatevectorEngineTests, PulseInstruction) {
     cfg.positions = {0.0, 1.0};
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::Pulse,
@@ -180,7 +184,7 @@ TEST(StatevectorEngineTests, MeasureSingleQubitTargets) {
     cfg.positions = {0.0, 1.0};
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -211,7 +215,7 @@ TEST(StatevectorEngineTests, MeasureAllQubitsRecordsBits) {
     cfg.positions = {0.0, 1.0};
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -239,7 +243,7 @@ TEST(StatevectorEngineTests, BlockadeAllowsCloseQubits) {
     cfg.blockade_radius = 1.0;
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -255,7 +259,7 @@ TEST(StatevectorEngineTests, BlockadeBlocksDistantQubits) {
     cfg.blockade_radius = 1.0;
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -272,7 +276,7 @@ TEST(StatevectorEngineTests, BlockadeHonorsCoordinates) {
     cfg.blockade_radius = 1.5;
 
     StatevectorEngine engine(cfg);
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -294,7 +298,7 @@ TEST(StatevectorEngineTests, EnforcesNativeGateConnectivityForNearestNeighborCha
     StatevectorEngine engine(cfg);
 
     // Neighboring qubits 0-1 are allowed.
-    std::vector<Instruction> ok_program;
+    Program ok_program;
     ok_program.push_back(Instruction{Op::AllocArray, 3});
     ok_program.push_back(Instruction{
         Op::ApplyGate,
@@ -303,7 +307,7 @@ TEST(StatevectorEngineTests, EnforcesNativeGateConnectivityForNearestNeighborCha
     EXPECT_NO_THROW(engine.run(ok_program));
 
     // Non-neighboring qubits 0-2 violate the chain connectivity.
-    std::vector<Instruction> bad_program;
+    Program bad_program;
     bad_program.push_back(Instruction{Op::AllocArray, 3});
     bad_program.push_back(Instruction{
         Op::ApplyGate,
@@ -320,7 +324,7 @@ TEST(StatevectorEngineTests, EnforcesWaitDurationLimitsWhenConfigured) {
 
     StatevectorEngine engine(cfg);
 
-    std::vector<Instruction> short_wait_prog;
+    Program short_wait_prog;
     short_wait_prog.push_back(Instruction{Op::AllocArray, 1});
     short_wait_prog.push_back(Instruction{
         Op::Wait,
@@ -328,7 +332,7 @@ TEST(StatevectorEngineTests, EnforcesWaitDurationLimitsWhenConfigured) {
     });
     EXPECT_THROW(engine.run(short_wait_prog), std::invalid_argument);
 
-    std::vector<Instruction> long_wait_prog;
+    Program long_wait_prog;
     long_wait_prog.push_back(Instruction{Op::AllocArray, 1});
     long_wait_prog.push_back(Instruction{
         Op::Wait,
@@ -336,7 +340,7 @@ TEST(StatevectorEngineTests, EnforcesWaitDurationLimitsWhenConfigured) {
     });
     EXPECT_THROW(engine.run(long_wait_prog), std::invalid_argument);
 
-    std::vector<Instruction> ok_wait_prog;
+    Program ok_wait_prog;
     ok_wait_prog.push_back(Instruction{Op::AllocArray, 1});
     ok_wait_prog.push_back(Instruction{
         Op::Wait,
@@ -355,7 +359,7 @@ TEST(StatevectorEngineTests, EnforcesPulseLimitsWhenConfigured) {
 
     StatevectorEngine engine(cfg);
 
-    std::vector<Instruction> bad_detuning_prog;
+    Program bad_detuning_prog;
     bad_detuning_prog.push_back(Instruction{Op::AllocArray, 1});
     bad_detuning_prog.push_back(Instruction{
         Op::Pulse,
@@ -363,7 +367,7 @@ TEST(StatevectorEngineTests, EnforcesPulseLimitsWhenConfigured) {
     });
     EXPECT_THROW(engine.run(bad_detuning_prog), std::invalid_argument);
 
-    std::vector<Instruction> bad_duration_prog;
+    Program bad_duration_prog;
     bad_duration_prog.push_back(Instruction{Op::AllocArray, 1});
     bad_duration_prog.push_back(Instruction{
         Op::Pulse,
@@ -371,7 +375,7 @@ TEST(StatevectorEngineTests, EnforcesPulseLimitsWhenConfigured) {
     });
     EXPECT_THROW(engine.run(bad_duration_prog), std::invalid_argument);
 
-    std::vector<Instruction> ok_pulse_prog;
+    Program ok_pulse_prog;
     ok_pulse_prog.push_back(Instruction{Op::AllocArray, 1});
     ok_pulse_prog.push_back(Instruction{
         Op::Pulse,
@@ -387,7 +391,7 @@ TEST(StatevectorEngineTests, EnforcesMeasurementCooldown) {
 
     StatevectorEngine engine(cfg);
 
-    std::vector<Instruction> bad_prog;
+    Program bad_prog;
     bad_prog.push_back(Instruction{Op::AllocArray, 1});
     bad_prog.push_back(Instruction{
         Op::Measure,
@@ -401,7 +405,7 @@ TEST(StatevectorEngineTests, EnforcesMeasurementCooldown) {
     EXPECT_THROW(engine.run(bad_prog), std::runtime_error);
 
     StatevectorEngine engine_ok(cfg);
-    std::vector<Instruction> ok_prog;
+    Program ok_prog;
     ok_prog.push_back(Instruction{Op::AllocArray, 1});
     ok_prog.push_back(Instruction{
         Op::Measure,
@@ -432,7 +436,7 @@ TEST(StatevectorEngineTests, MeasurementNoiseBitFlipAllOnes) {
     auto noise = std::make_shared<SimpleNoiseEngine>(noise_cfg);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::Measure,
@@ -459,7 +463,7 @@ TEST(StatevectorEngineTests, MeasurementNoiseLossMarksMinusOne) {
     auto noise = std::make_shared<SimpleNoiseEngine>(noise_cfg);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::Measure,
@@ -486,7 +490,7 @@ TEST(StatevectorEngineTests, SingleQubitGatePauliNoiseActsAfterGate) {
     auto noise = std::make_shared<SimpleNoiseEngine>(noise_cfg);
     engine.set_noise_model(noise);
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -507,13 +511,133 @@ TEST(StatevectorEngineTests, SingleQubitGatePauliNoiseActsAfterGate) {
     EXPECT_EQ(records[0].bits, std::vector<int>({0}));
 }
 
+TEST(StatevectorEngineTests, SteppingMatchesRun) {
+    HardwareConfig cfg;
+    cfg.positions = {0.0, 1.0, 2.0};
+    cfg.blockade_radius = 1.5;
+    const Program program{
+        {Op::AllocArray, 3},
+        {Op::ApplyGate, Gate{"H", {0}, 0.0}},
+        {Op::ApplyGate, Gate{"CX", {0, 1}, 0.0}},
+        {Op::Wait, WaitInstruction{50.0}},
+        {Op::ApplyGate, Gate{"CX", {1, 2}, 0.0}},
+        {Op::Measure, std::vector<int>{0, 1, 2}},
+    };
+
+    StatevectorEngine whole(cfg, nullptr, 11);
+    whole.run(program);
+
+    StatevectorEngine stepped(cfg, nullptr, 11);
+    const std::span<const Instruction> all(program);
+    stepped.step(all.first(3));
+    ASSERT_EQ(stepped.state_vector().size(), 8u);
+    const auto& bell = stepped.state_vector();
+    EXPECT_EQ(std::count_if(bell.begin(), bell.end(), [](const auto& amp) { return std::abs(amp) > 1e-9; }), 2);
+    for (std::size_t idx = 3; idx < program.size(); ++idx) {
+        stepped.step(all.subspan(idx, 1));
+    }
+
+    ASSERT_EQ(stepped.state().measurements.size(), 1u);
+    EXPECT_EQ(stepped.state().measurements[0].bits, whole.state().measurements[0].bits);
+    EXPECT_EQ(stepped.logs().size(), whole.logs().size());
+    EXPECT_DOUBLE_EQ(stepped.state().logical_time, whole.state().logical_time);
+}
+
+TEST(StatevectorEngineTests, RepeatRunsNestedBodiesWithoutUnrolling) {
+    HardwareConfig cfg;
+    cfg.positions = {0.0};
+    StatevectorEngine engine(cfg);
+    // Two rounds of (three X gates, measure): the qubit reads 1 then 0.
+    const Program program{
+        {Op::AllocArray, 1},
+        {Op::Repeat, RepeatInstruction{2, 3}},
+        {Op::Repeat, RepeatInstruction{3, 1}},
+        {Op::ApplyGate, Gate{"X", {0}}},
+        {Op::Measure, std::vector<int>{0}},
+    };
+    engine.run(program);
+    const auto& records = engine.state().measurements;
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].bits, std::vector<int>({1}));
+    EXPECT_EQ(records[1].bits, std::vector<int>({0}));
+    EXPECT_EQ(engine.counters().amplitude_updates, 6u * 2u);
+
+    const Program truncated{
+        {Op::AllocArray, 1},
+        {Op::Repeat, RepeatInstruction{2, 2}},
+        {Op::ApplyGate, Gate{"X", {0}}},
+    };
+    EXPECT_THROW(engine.run(truncated), std::invalid_argument);
+}
+
+TEST(ISATests, GateNamesAreInternedAndBuiltinsMapToOpcodes) {
+    const Gate cx{"CX", {0, 1}, 0.0};
+    EXPECT_EQ(cx.name.op(), GateOp::CX);
+    EXPECT_EQ(cx.name, GateName(GateOp::CX));
+    EXPECT_EQ(cx.name, "CX");
+
+    // Requests cannot add names; trusted code declares custom gates.
+    EXPECT_THROW(GateName("RydbergPhase"), std::invalid_argument);
+    GateRegistry::instance().declare("RydbergPhase");
+    const GateName custom("RydbergPhase");
+    EXPECT_EQ(custom.op(), GateOp::kFirstCustom);
+    EXPECT_EQ(GateName(std::string("RydbergPhase")).id(), custom.id());
+    EXPECT_EQ(custom.str(), "RydbergPhase");
+    EXPECT_EQ("Unsupported gate: " + custom, "Unsupported gate: RydbergPhase");
+    EXPECT_TRUE(Gate{}.name.empty());
+}
+
+TEST(ISATests, ParamSymbolsStayOutOfTheGateRegistry) {
+    Gate gate{"X", {0}, 0.0};
+    gate.symbol = "theta_layer_0";
+    EXPECT_EQ(gate.symbol, "theta_layer_0");
+    EXPECT_EQ("param=" + gate.symbol, "param=theta_layer_0");
+    EXPECT_THROW(GateName("theta_layer_0"), std::invalid_argument);
+    EXPECT_THROW(ParamSymbol(std::string(ParamSymbol::kCapacity + 1, 'p')), std::invalid_argument);
+    EXPECT_TRUE(Gate{}.symbol.empty());
+}
+
+TEST(ISATests, TargetListStoresOperandsInline) {
+    const TargetList targets{3, 1, 2};
+    EXPECT_EQ(targets.size(), 3u);
+    EXPECT_EQ(targets.to_vector(), (std::vector<int>{3, 1, 2}));
+    EXPECT_EQ(targets, TargetList(std::vector<int>{3, 1, 2}));
+    EXPECT_THROW(TargetList(std::vector<int>{0, 1, 2, 3, 4}), std::invalid_argument);
+}
+
+TEST(ISATests, WideMeasuresLiveInTheProgramOperandTable) {
+    std::vector<int> wide(10);
+    std::iota(wide.begin(), wide.end(), 0);
+    Program program{{Op::AllocArray, 10}};
+    program.push_measure(std::vector<int>{1, 0});
+    program.push_measure(wide);
+    EXPECT_FALSE(std::get<MeasureTargets>(program[1].payload).is_spilled());
+    EXPECT_TRUE(std::get<MeasureTargets>(program[2].payload).is_spilled());
+    EXPECT_TRUE(std::ranges::equal(program.targets(program[1]), std::vector<int>{1, 0}));
+    EXPECT_TRUE(std::ranges::equal(program.targets(program[2]), wide));
+    EXPECT_EQ(program.operands().size(), wide.size());
+    // A lone instruction has no table to spill into.
+    EXPECT_THROW((Instruction{Op::Measure, wide}), std::invalid_argument);
+
+    const Program copy = program;
+    EXPECT_TRUE(std::ranges::equal(copy.targets(copy[2]), wide));
+
+    HardwareConfig cfg;
+    cfg.positions.assign(10, 0.0);
+    StatevectorEngine engine(cfg);
+    engine.run(copy);
+    ASSERT_EQ(engine.state().measurements.size(), 2u);
+    EXPECT_EQ(engine.state().measurements[1].targets, wide);
+    EXPECT_EQ(engine.state().measurements[1].bits, std::vector<int>(10, 0));
+}
+
 TEST(HardwareVMTests, RunsProgramWithIdealEngine) {
     DeviceProfile profile;
     profile.id = "ideal-statevector";
     profile.hardware.positions = {0.0, 1.0};
     profile.hardware.blockade_radius = 1.0;
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 2});
     program.push_back(Instruction{
         Op::ApplyGate,
@@ -540,7 +664,7 @@ TEST(HardwareVMTests, RejectsUnsupportedISAVersion) {
     profile.hardware.positions = {0.0};
     profile.hardware.blockade_radius = 1.0;
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::Measure,
@@ -565,7 +689,7 @@ TEST(HardwareVMTests, RespectsShotSeeds) {
     profile.hardware.blockade_radius = 1.0;
     profile.noise_engine = std::make_shared<SeededFlipNoiseEngine>();
 
-    std::vector<Instruction> program;
+    Program program;
     program.push_back(Instruction{Op::AllocArray, 1});
     program.push_back(Instruction{
         Op::ApplyGate,